@@ -0,0 +1,141 @@
+#!/bin/sh
+#
+# Headless regression check.
+#
+# Builds the test ROMs and input movie with testroms.py, plays the movie on every
+# ROM in several emulation modes and collects the RAM, frame and sound CRCs that
+# fceux-headless --hash prints.
+#
+# The plain, --newppu and sound runs are the reference results.  To compare
+# against another build, record them with that build and check this one
+# against the file:
+#   run.sh <baseline fceux-headless> <work dir> record ref.txt
+#   run.sh <fceux-headless> <work dir> check ref.txt
+# The high quality sound CRCs also depend on the filter the build designs, so
+# they only match a reference recorded by a build with the same filter.
+#
+# Other than in record mode, the options that are meant to change nothing
+# are run too and compared with the matching reference run:
+#   --idle-skip        against the plain, --newppu and high quality sound runs
+#   --ppu-catchup      against --newppu
+#   --no-video         RAM against the plain run
+#   --check-states     against the plain run; the emulator also fails the run
+#                      if an incremental savestate does not restore the state
+#   --sound-steps      on the sound ROMs, RAM and frame against the high quality
+#                      sound run, and the sound RMS within 2% of it (the step
+#                      synthesis is band limited differently, so it is not
+#                      sample identical)
+#
+# usage: run.sh <fceux-headless> <work dir> [record|check <reference file>]
+
+if [ $# -ne 2 ] && [ $# -ne 4 ]; then
+	echo "usage: $0 <fceux-headless> <work dir> [record|check <reference file>]"
+	exit 2
+fi
+
+EMU=$1
+WORK=$2
+ACTION=$3
+REF=$4
+
+python3 "`dirname "$0"`/testroms.py" "$WORK" || exit 2
+
+OUT="$WORK/hashes.txt"
+: > "$OUT"
+
+FAIL=0
+
+# run <rom> <mode name> <options...>
+run()
+{
+	ROM=$1
+	NAME=$2
+	shift 2
+	"$EMU" --movie "$WORK/input.fm2" --hash "$@" "$WORK/$ROM.nes" > "$WORK/log.txt" 2>&1
+	RAM=`sed -n 's/^ram crc32: //p' "$WORK/log.txt"`
+	FRAME=`sed -n 's/^frame crc32: //p' "$WORK/log.txt"`
+	SOUND=`sed -n 's/^sound crc32: //p' "$WORK/log.txt"`
+	RMS=`sed -n 's/^sound rms: //p' "$WORK/log.txt"`
+	if [ -z "$RAM" ]; then
+		echo "$ROM $NAME: fceux-headless failed"
+		cat "$WORK/log.txt"
+		FAIL=1
+	fi
+	echo "$ROM $NAME $RAM $FRAME ${SOUND:--} ${RMS:--}" >> "$OUT"
+}
+
+# same <rom> <mode> <mode> <fields>
+same()
+{
+	A=`grep "^$1 $2 " "$OUT" | cut -d' ' -f$4`
+	B=`grep "^$1 $3 " "$OUT" | cut -d' ' -f$4`
+	if [ "$A" != "$B" ]; then
+		echo "$1: $2 and $3 differ ($A / $B)"
+		FAIL=1
+	fi
+}
+
+# near <rom> <mode> <mode> <percent>: sound RMS within the given tolerance
+near()
+{
+	A=`grep "^$1 $2 " "$OUT" | cut -d' ' -f6`
+	B=`grep "^$1 $3 " "$OUT" | cut -d' ' -f6`
+	if ! awk -v a="$A" -v b="$B" -v t="$4" 'BEGIN { d = a - b; if (d < 0) d = -d; exit !(a > 0 && d * 100 <= a * t) }'; then
+		echo "$1: $2 and $3 sound RMS differ by more than $4% ($A / $B)"
+		FAIL=1
+	fi
+}
+
+for ROM in `sed -n "s/^    ('\([a-z0-9_]*\)'.*/\1/p" "\`dirname "$0"\`/testroms.py"`; do
+	run $ROM plain
+	run $ROM newppu --newppu
+	run $ROM sound-lq --sound 48000 --soundq 0
+	run $ROM sound-hq --sound 48000 --soundq 1
+
+	if [ "$ACTION" = record ]; then
+		continue
+	fi
+
+	run $ROM idle-skip --idle-skip
+	run $ROM newppu-idle-skip --newppu --idle-skip
+	run $ROM sound-hq-idle-skip --sound 48000 --soundq 1 --idle-skip
+	run $ROM ppu-catchup --ppu-catchup
+	run $ROM no-video --no-video
+	run $ROM check-states --check-states 60
+
+	same $ROM plain idle-skip 3,4
+	same $ROM newppu newppu-idle-skip 3,4
+	same $ROM sound-hq sound-hq-idle-skip 3-5
+	same $ROM newppu ppu-catchup 3,4
+	same $ROM plain no-video 3
+	same $ROM plain check-states 3,4
+
+	case $ROM in
+		snd|snd_vrc6|snd_mmc5|snd_n163)
+			run $ROM sound-hq-steps --sound 48000 --soundq 1 --sound-steps
+			same $ROM sound-hq sound-hq-steps 3,4
+			near $ROM sound-hq sound-hq-steps 2
+			;;
+	esac
+done
+
+case "$ACTION" in
+	record)
+		cut -d' ' -f1-5 "$OUT" > "$REF"
+		echo "Reference written to $REF"
+		;;
+	check)
+		grep -e ' plain ' -e ' newppu ' -e ' sound-lq ' -e ' sound-hq ' "$OUT" | cut -d' ' -f1-5 > "$WORK/base.txt"
+		if ! diff "$REF" "$WORK/base.txt"; then
+			echo "CRCs differ from $REF"
+			FAIL=1
+		fi
+		;;
+esac
+
+if [ $FAIL -ne 0 ]; then
+	echo "FAILED"
+	exit 1
+fi
+
+echo "OK (`wc -l < "$OUT"` runs)"
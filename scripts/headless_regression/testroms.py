@@ -0,0 +1,390 @@
+#!/usr/bin/env python3
+# Builds the test ROMs and the input movie used by run.sh.
+# The ROMs come from a minimal 6502 assembler below, so nothing copyrighted is needed.
+#
+# usage: testroms.py <output dir>
+import os, random, struct, sys
+
+OPS = {
+ # name: {mode: opcode}
+ 'LDA':{'imm':0xA9,'zp':0xA5,'abs':0xAD,'absx':0xBD,'absy':0xB9,'zpx':0xB5,'indy':0xB1},
+ 'LDX':{'imm':0xA2,'zp':0xA6,'abs':0xAE},
+ 'LDY':{'imm':0xA0,'zp':0xA4,'abs':0xAC},
+ 'STA':{'zp':0x85,'abs':0x8D,'absx':0x9D,'absy':0x99,'zpx':0x95,'indy':0x91},
+ 'STX':{'zp':0x86,'abs':0x8E},'STY':{'zp':0x84,'abs':0x8C},
+ 'ADC':{'imm':0x69,'zp':0x65,'abs':0x6D,'absx':0x7D},'SBC':{'imm':0xE9,'zp':0xE5},
+ 'AND':{'imm':0x29,'zp':0x25},'ORA':{'imm':0x09,'zp':0x05},'EOR':{'imm':0x49,'zp':0x45,'absx':0x5D},
+ 'CMP':{'imm':0xC9,'zp':0xC5},'CPX':{'imm':0xE0},'CPY':{'imm':0xC0},
+ 'INC':{'zp':0xE6,'abs':0xEE,'absx':0xFE},'DEC':{'zp':0xC6},
+ 'ASL':{'acc':0x0A,'zp':0x06},'LSR':{'acc':0x4A,'zp':0x46},'ROL':{'acc':0x2A,'zp':0x26},'ROR':{'acc':0x6A,'zp':0x66},
+ 'BIT':{'zp':0x24,'abs':0x2C},
+ 'JMP':{'abs':0x4C},'JSR':{'abs':0x20},
+}
+IMPL = {'SEI':0x78,'CLI':0x58,'CLD':0xD8,'CLC':0x18,'SEC':0x38,'TXS':0x9A,'TAX':0xAA,'TAY':0xA8,'TXA':0x8A,'TYA':0x98,
+ 'INX':0xE8,'INY':0xC8,'DEX':0xCA,'DEY':0x88,'PHA':0x48,'PLA':0x68,'RTI':0x40,'RTS':0x60,'NOP':0xEA,'PHP':0x08,'PLP':0x28}
+BR = {'BPL':0x10,'BMI':0x30,'BVC':0x50,'BVS':0x70,'BCC':0x90,'BCS':0xB0,'BNE':0xD0,'BEQ':0xF0}
+class Asm:
+    def __init__(s, org): s.org=org; s.b=bytearray(); s.labels={}; s.fix=[]
+    def pc(s): return s.org+len(s.b)
+    def L(s,name): s.labels[name]=s.pc()
+    def __call__(s, op, arg=None, mode=None):
+        if op in IMPL: s.b.append(IMPL[op]); return
+        if op in BR:
+            s.b.append(BR[op]); s.fix.append(('rel',len(s.b),arg)); s.b.append(0); return
+        if mode is None:
+            if arg is None: mode='acc'
+            elif isinstance(arg,str) and arg.startswith('#'): mode='imm'; arg=int(arg[1:],0)
+            elif isinstance(arg,str): mode='abs'
+            elif arg<0x100: mode='zp'
+            else: mode='abs'
+        o=OPS[op][mode]; s.b.append(o)
+        if mode=='acc': return
+        if mode in('imm','zp','zpx','indy'): s.b.append(arg&0xff); return
+        if isinstance(arg,str): s.fix.append(('abs',len(s.b),arg)); s.b+=b'\0\0'
+        else: s.b+=struct.pack('<H',arg)
+    def resolve(s):
+        for k,pos,lab in s.fix:
+            t=s.labels[lab]
+            if k=='abs': s.b[pos:pos+2]=struct.pack('<H',t)
+            else:
+                d=t-(s.org+pos+1); assert -128<=d<128,(lab,d); s.b[pos]=d&0xff
+def rom(prg_asm, mapper, vectors, prgsize=32768, chr8k=1, seed=1):
+    prg_asm.resolve()
+    prg=bytearray(b'\xff'*prgsize)
+    off=prg_asm.org-(0x10000-prgsize)
+    prg[off:off+len(prg_asm.b)]=prg_asm.b
+    n,r,i=[prg_asm.labels[v] for v in vectors]
+    prg[-6:]=struct.pack('<HHH',n,r,i)
+    random.seed(seed)
+    chr_=bytes(random.getrandbits(8) for _ in range(8192*chr8k))
+    hdr=b'NES\x1a'+bytes([prgsize//16384,chr8k,(mapper&15)<<4,mapper&0xf0])+b'\0'*8
+    return hdr+bytes(prg)+chr_
+
+# Background, sprite 0 polling, APU writes and (on MMC3) scanline IRQ splits.
+def build_basic(mmc3):
+    a=Asm(0x8000)
+    a.L('reset'); a('SEI'); a('CLD'); a('LDX','#0xFF'); a('TXS'); a('LDA','#0'); a('STA',0x2000); a('STA',0x2001)
+    if mmc3:
+        a('STA',0xE000); a('STA',0xA000)
+        for r,v in enumerate([0,2,4,5,6,7]):
+            a('LDA','#%d'%r); a('STA',0x8000); a('LDA','#%d'%v); a('STA',0x8001)
+    a.L('vw1'); a('BIT',0x2002); a('BPL','vw1')
+    a.L('vw2'); a('BIT',0x2002); a('BPL','vw2')
+    a('LDA','#0x3F'); a('STA',0x2006); a('LDA','#0'); a('STA',0x2006); a('LDX','#0')
+    a.L('pl'); a('TXA'); a('STA',0x2007); a('INX'); a('CPX','#32'); a('BNE','pl')
+    a('LDA','#0x20'); a('STA',0x2006); a('LDA','#0'); a('STA',0x2006); a('LDY','#8'); a('LDX','#0')
+    a.L('nt'); a('STX',0x2007); a('INX'); a('BNE','nt'); a('DEY'); a('BNE','nt')
+    a('LDX','#0'); a('LDA','#0x35')
+    a.L('ob'); a('ASL'); a('ADC','#0x1D'); a('STA',0x0200,'absx'); a('INX'); a('BNE','ob')
+    a('LDA','#40'); a('STA',0x200); a('LDA','#1'); a('STA',0x201); a('LDA','#0'); a('STA',0x202); a('LDA','#100'); a('STA',0x203)
+    a('LDA','#0x0F'); a('STA',0x4015)
+    a('LDA','#0x88'); a('STA',0x2000); a('LDA','#0x1E'); a('STA',0x2001); a('CLI')
+    a.L('main')
+    a.L('s0c'); a('INC',0x20); a('BNE','s0c1'); a('INC',0x21); a.L('s0c1'); a('BIT',0x2002); a('BVS','s0c')
+    a.L('s0s'); a('INC',0x22); a('BNE','s0s1'); a('INC',0x23); a('LDA',0x23); a('CMP','#0x08'); a('BEQ','s0out'); a.L('s0s1'); a('BIT',0x2002); a('BVC','s0s')
+    a.L('s0out'); a('LDA',0x22); a('LDX',0x10); a('STA',0x0600,'absx'); a('LDA','#0'); a('STA',0x23)
+    a('LDA',0x10); a('STA',0x2005); a('STA',0x2005)
+    a('LDX','#0')
+    a.L('bl'); a('LDA',0x0300,'absx'); a('ADC',0x11); a('STA',0x0300,'absx'); a('INC',0x11); a('EOR',0x0400,'absx'); a('STA',0x0400,'absx'); a('INX'); a('BNE','bl')
+    a('JSR','sub')
+    a('LDA','#1'); a('STA',0x4016); a('LDA','#0'); a('STA',0x4016); a('LDA',0x4016); a('STA',0x13)
+    a('INC',0x0205); a('INC',0x0209)
+    a('JMP','main')
+    a.L('sub'); a('LDY','#0x40')
+    a.L('sl'); a('LDA',0x14); a('ROR'); a('ADC',0x15); a('STA',0x14); a('DEY'); a('BNE','sl'); a('RTS')
+    a.L('nmi'); a('PHA'); a('TXA'); a('PHA')
+    a('LDA','#0'); a('STA',0x2003); a('LDA','#2'); a('STA',0x4014)
+    a('LDA',0x10); a('STA',0x2005); a('LDA','#0'); a('STA',0x2005); a('LDA','#0x88'); a('STA',0x2000)
+    a('LDA',0x10); a('AND','#0x3F'); a('ORA','#0x80'); a('STA',0x4000); a('LDA',0x10); a('STA',0x4002); a('LDA','#0x08'); a('STA',0x4003)
+    a('INC',0x10)
+    if mmc3:
+        a('LDA','#19'); a('STA',0xC000); a('STA',0xC001); a('STA',0xE001)
+    a('PLA'); a('TAX'); a('PLA'); a('RTI')
+    a.L('irq'); a('PHA')
+    if mmc3:
+        a('STA',0xE000); a('STA',0xE001)
+        a('INC',0x12); a('LDA',0x12); a('STA',0x2005); a('STA',0x2005)
+        a('LDA','#1'); a('STA',0x8000); a('LDA',0x12); a('AND','#7'); a('ASL'); a('STA',0x8001)
+        a('LDA',0x12); a('AND','#1'); a('ORA','#0x1E'); a('STA',0x2001)
+    a('PLA'); a('RTI')
+    return rom(a, 4 if mmc3 else 0, ('nmi','reset','irq'), chr8k=1)
+
+# Main loops that poll a RAM flag, a masked RAM flag or $2002, and one that spins on JMP *.
+def idle_init(a, mmc3):
+    a.L('reset'); a('SEI'); a('CLD'); a('LDX','#0xFF'); a('TXS'); a('LDA','#0'); a('STA',0x2000); a('STA',0x2001)
+    if mmc3:
+        a('STA',0xE000); a('STA',0xA000)
+    a.L('vw1'); a('BIT',0x2002); a('BPL','vw1')
+    a.L('vw2'); a('BIT',0x2002); a('BPL','vw2')
+    a('LDA','#0x3F'); a('STA',0x2006); a('LDA','#0'); a('STA',0x2006); a('LDX','#0')
+    a.L('pl'); a('TXA'); a('STA',0x2007); a('INX'); a('CPX','#32'); a('BNE','pl')
+    a('LDA','#0x20'); a('STA',0x2006); a('LDA','#0'); a('STA',0x2006); a('LDY','#8'); a('LDX','#0')
+    a.L('nt'); a('STX',0x2007); a('INX'); a('BNE','nt'); a('DEY'); a('BNE','nt')
+    a('LDX','#0'); a('LDA','#0x35')
+    a.L('ob'); a('ASL'); a('ADC','#0x1D'); a('STA',0x0200,'absx'); a('INX'); a('BNE','ob')
+    a('LDA','#0x0F'); a('STA',0x4015); a('LDA','#0x40'); a('STA',0x4017)
+def idle_work(a, n):
+    a('LDX','#0'); a('LDY','#%d'%n)
+    a.L('w%d'%n); a('LDA',0x0300,'absx'); a('ADC',0x11); a('STA',0x0300,'absx'); a('INC',0x11); a('INX'); a('BNE','w%d'%n); a('DEY'); a('BNE','w%d'%n)
+def idle_nmi(a, mmc3, jmpmain=False):
+    a.L('idle_nmi'); a('PHA'); a('TXA'); a('PHA'); a('TYA'); a('PHA')
+    a('LDA','#0'); a('STA',0x2003); a('LDA','#2'); a('STA',0x4014)
+    a('LDA',0x10); a('STA',0x2005); a('LDA','#0'); a('STA',0x2005)
+    a('LDA',0x10); a('AND','#0x3F'); a('ORA','#0x80'); a('STA',0x4000); a('LDA',0x10); a('STA',0x4002); a('LDA','#0x08'); a('STA',0x4003)
+    a('INC',0x10); a('LDA','#1'); a('STA',0x30)
+    if mmc3:
+        a('LDA','#40'); a('STA',0xC000); a('STA',0xC001); a('STA',0xE001)
+    if jmpmain:
+        idle_work(a, 2)
+        a('LDA',0x2002); a('STA',0x0500,'absx')
+    a('PLA'); a('TAY'); a('PLA'); a('TAX'); a('PLA'); a('RTI')
+    a.L('irq'); a('PHA')
+    if mmc3:
+        a('STA',0xE000); a('INC',0x12); a('LDA',0x12); a('STA',0x2005); a('STA',0x2005)
+    a('PLA'); a('RTI')
+def build_idle(kind, pats=('ram','and','vbl')):
+    mmc3 = kind=='mmc3'
+    a=Asm(0x8000); idle_init(a, mmc3)
+    a('LDA','#0x80'); a('STA',0x2000); a('LDA','#0x1E'); a('STA',0x2001); a('CLI')
+    if kind=='jmp':
+        a.L('forever'); a('JMP','forever')
+        idle_nmi(a, False, True)
+    else:
+        a.L('main')
+        idle_work(a, 3)
+        # RAM flag wait
+        if 'ram' in pats:
+            a.L('wf'); a('LDA',0x30); a('BEQ','wf')
+            a('LDA','#0'); a('STA',0x30)
+        idle_work(a, 1)
+        if 'and' in pats:
+            a.L('wf2'); a('LDA',0x30); a('AND','#1'); a('BEQ','wf2')
+            a('LDA','#0'); a('STA',0x30)
+        # vblank poll with NMI off, every frame
+        if 'vbl' in pats:
+            a('LDA','#0'); a('STA',0x2000)
+            a.L('wv'); a('BIT',0x2002); a('BPL','wv')
+            a('LDA',0x2002); a.L('wv2'); a('LDX',0x2002); a('BPL','wv2'); a('STX',0x31)
+            a('LDA','#0x80'); a('STA',0x2000)
+        a('LDA',0x11); a('STA',0x0400,'absx'); a('INC',0x0203)
+        a('JMP','main')
+        idle_nmi(a, mmc3)
+    return rom(a, 4 if mmc3 else 0, ('idle_nmi','reset','irq'))
+
+# 64 moving sprites, including Y values that wrap past 255, with 8x16 and left clipping toggled.
+def build_sprites(mmc3):
+    a=Asm(0x8000)
+    a.L('reset'); a('SEI'); a('CLD'); a('LDX','#0xFF'); a('TXS'); a('LDA','#0'); a('STA',0x2000); a('STA',0x2001)
+    if mmc3:
+        a('STA',0xE000); a('STA',0xA000)
+        for r,v in enumerate([0,2,4,5,6,7]):
+            a('LDA','#%d'%r); a('STA',0x8000); a('LDA','#%d'%v); a('STA',0x8001)
+    a.L('vw1'); a('BIT',0x2002); a('BPL','vw1')
+    a.L('vw2'); a('BIT',0x2002); a('BPL','vw2')
+    a('LDA','#0x3F'); a('STA',0x2006); a('LDA','#0'); a('STA',0x2006); a('LDX','#0')
+    a.L('pl'); a('TXA'); a('STA',0x2007); a('INX'); a('CPX','#32'); a('BNE','pl')
+    a('LDA','#0x20'); a('STA',0x2006); a('LDA','#0'); a('STA',0x2006); a('LDY','#8'); a('LDX','#0')
+    a.L('nt'); a('STX',0x2007); a('INX'); a('BNE','nt'); a('DEY'); a('BNE','nt')
+    a('LDX','#0'); a('LDA','#0x35')
+    a.L('ob'); a('ASL'); a('ADC','#0x1D'); a('STA',0x0200,'absx'); a('INX'); a('BNE','ob')
+    a('LDA','#40'); a('STA',0x200); a('LDA','#1'); a('STA',0x201); a('LDA','#0'); a('STA',0x202); a('LDA','#100'); a('STA',0x203)
+    a('LDA','#0x0F'); a('STA',0x4015)
+    a('LDA','#0x88'); a('STA',0x2000); a('LDA','#0x1E'); a('STA',0x2001); a('CLI')
+    a.L('main')
+    a.L('s0c'); a('INC',0x20); a('BNE','s0c1'); a('INC',0x21); a.L('s0c1'); a('BIT',0x2002); a('BVS','s0c')
+    a.L('s0s'); a('INC',0x22); a('BNE','s0s1'); a('INC',0x23); a('LDA',0x23); a('CMP','#0x08'); a('BEQ','s0out'); a.L('s0s1'); a('BIT',0x2002); a('BVC','s0s')
+    a.L('s0out'); a('LDA',0x22); a('LDX',0x10); a('STA',0x0600,'absx'); a('LDA','#0'); a('STA',0x23)
+    a('LDA',0x10); a('STA',0x2005); a('STA',0x2005)
+    a('LDX','#0')
+    a.L('bl'); a('LDA',0x0300,'absx'); a('ADC',0x11); a('STA',0x0300,'absx'); a('INC',0x11); a('EOR',0x0400,'absx'); a('STA',0x0400,'absx'); a('INX'); a('BNE','bl')
+    a('JSR','sub')
+    a('LDA','#1'); a('STA',0x4016); a('LDA','#0'); a('STA',0x4016); a('LDA',0x4016); a('STA',0x13)
+    a('INC',0x0205); a('INC',0x0209)
+    a('LDX','#0')
+    a.L('oy'); a('TXA'); a('LSR'); a('LSR'); a('AND','#3'); a('SEC'); a('ADC',0x0200,'absx'); a('STA',0x0200,'absx'); a('INX'); a('INX'); a('INX'); a('INX'); a('BNE','oy')
+    a('JMP','main')
+    a.L('sub'); a('LDY','#0x40')
+    a.L('sl'); a('LDA',0x14); a('ROR'); a('ADC',0x15); a('STA',0x14); a('DEY'); a('BNE','sl'); a('RTS')
+    a.L('nmi'); a('PHA'); a('TXA'); a('PHA')
+    a('LDA','#0'); a('STA',0x2003); a('LDA','#2'); a('STA',0x4014)
+    a('LDA',0x10); a('STA',0x2005); a('LDA','#0'); a('STA',0x2005); a('LDA',0x10); a('LSR'); a('AND','#0x20'); a('ORA','#0x88'); a('STA',0x2000)
+    a('LDA',0x10); a('LSR'); a('LSR'); a('AND','#0x06'); a('ORA','#0x18'); a('STA',0x2001)
+    a('LDA',0x10); a('AND','#0x3F'); a('ORA','#0x80'); a('STA',0x4000); a('LDA',0x10); a('STA',0x4002); a('LDA','#0x08'); a('STA',0x4003)
+    a('INC',0x10)
+    if mmc3:
+        a('LDA','#19'); a('STA',0xC000); a('STA',0xC001); a('STA',0xE001)
+    a('PLA'); a('TAX'); a('PLA'); a('RTI')
+    a.L('irq'); a('PHA')
+    if mmc3:
+        a('STA',0xE000); a('STA',0xE001)
+        a('INC',0x12); a('LDA',0x12); a('STA',0x2005); a('STA',0x2005)
+        a('LDA','#1'); a('STA',0x8000); a('LDA',0x12); a('AND','#7'); a('ASL'); a('STA',0x8001)
+        a('LDA',0x12); a('AND','#1'); a('ORA','#0x1E'); a('STA',0x2001)
+    a('PLA'); a('RTI')
+    return rom(a, 4 if mmc3 else 0, ('nmi','reset','irq'), chr8k=1)
+
+# CHR RAM written through $2007 every frame.
+def build_chrram(mmc3):
+    a=Asm(0x8000)
+    a.L('reset'); a('SEI'); a('CLD'); a('LDX','#0xFF'); a('TXS'); a('LDA','#0'); a('STA',0x2000); a('STA',0x2001)
+    if mmc3:
+        a('STA',0xE000); a('STA',0xA000)
+        for r,v in enumerate([0,2,4,5,6,7]):
+            a('LDA','#%d'%r); a('STA',0x8000); a('LDA','#%d'%v); a('STA',0x8001)
+    a.L('vw1'); a('BIT',0x2002); a('BPL','vw1')
+    a.L('vw2'); a('BIT',0x2002); a('BPL','vw2')
+    a('LDA','#0x3F'); a('STA',0x2006); a('LDA','#0'); a('STA',0x2006); a('LDX','#0')
+    a.L('pl'); a('TXA'); a('STA',0x2007); a('INX'); a('CPX','#32'); a('BNE','pl')
+    a('LDA','#0x20'); a('STA',0x2006); a('LDA','#0'); a('STA',0x2006); a('LDY','#8'); a('LDX','#0')
+    a.L('nt'); a('STX',0x2007); a('INX'); a('BNE','nt'); a('DEY'); a('BNE','nt')
+    a('LDX','#0'); a('LDA','#0x35')
+    a.L('ob'); a('ASL'); a('ADC','#0x1D'); a('STA',0x0200,'absx'); a('INX'); a('BNE','ob')
+    a('LDA','#40'); a('STA',0x200); a('LDA','#1'); a('STA',0x201); a('LDA','#0'); a('STA',0x202); a('LDA','#100'); a('STA',0x203)
+    a('LDA','#0x0F'); a('STA',0x4015)
+    a('LDA','#0x88'); a('STA',0x2000); a('LDA','#0x1E'); a('STA',0x2001); a('CLI')
+    a.L('main')
+    a.L('s0c'); a('INC',0x20); a('BNE','s0c1'); a('INC',0x21); a.L('s0c1'); a('BIT',0x2002); a('BVS','s0c')
+    a.L('s0s'); a('INC',0x22); a('BNE','s0s1'); a('INC',0x23); a('LDA',0x23); a('CMP','#0x08'); a('BEQ','s0out'); a.L('s0s1'); a('BIT',0x2002); a('BVC','s0s')
+    a.L('s0out'); a('LDA',0x22); a('LDX',0x10); a('STA',0x0600,'absx'); a('LDA','#0'); a('STA',0x23)
+    a('LDA',0x10); a('STA',0x2005); a('STA',0x2005)
+    a('LDX','#0')
+    a.L('bl'); a('LDA',0x0300,'absx'); a('ADC',0x11); a('STA',0x0300,'absx'); a('INC',0x11); a('EOR',0x0400,'absx'); a('STA',0x0400,'absx'); a('INX'); a('BNE','bl')
+    a('JSR','sub')
+    a('LDA','#1'); a('STA',0x4016); a('LDA','#0'); a('STA',0x4016); a('LDA',0x4016); a('STA',0x13)
+    a('INC',0x0205); a('INC',0x0209)
+    a('JMP','main')
+    a.L('sub'); a('LDY','#0x40')
+    a.L('sl'); a('LDA',0x14); a('ROR'); a('ADC',0x15); a('STA',0x14); a('DEY'); a('BNE','sl'); a('RTS')
+    a.L('nmi'); a('PHA'); a('TXA'); a('PHA')
+    a('LDA','#0'); a('STA',0x2003); a('LDA','#2'); a('STA',0x4014)
+    a('LDA',0x10); a('STA',0x2005); a('LDA','#0'); a('STA',0x2005); a('LDA','#0x88'); a('STA',0x2000)
+    a('LDA',0x10); a('AND','#0x3F'); a('ORA','#0x80'); a('STA',0x4000); a('LDA',0x10); a('STA',0x4002); a('LDA','#0x08'); a('STA',0x4003)
+    a('LDA',0x2002); a('LDA',0x10); a('AND','#0x1F'); a('STA',0x2006); a('LDA',0x10); a('STA',0x2006)
+    a('LDX','#0')
+    a.L('cw'); a('TXA'); a('ADC',0x10); a('STA',0x2007); a('INX'); a('CPX','#24'); a('BNE','cw')
+    a('LDA',0x10); a('STA',0x2005); a('LDA','#0'); a('STA',0x2005)
+    a('INC',0x10)
+    if mmc3:
+        a('LDA','#19'); a('STA',0xC000); a('STA',0xC001); a('STA',0xE001)
+    a('PLA'); a('TAX'); a('PLA'); a('RTI')
+    a.L('irq'); a('PHA')
+    if mmc3:
+        a('STA',0xE000); a('STA',0xE001)
+        a('INC',0x12); a('LDA',0x12); a('STA',0x2005); a('STA',0x2005)
+        a('LDA','#1'); a('STA',0x8000); a('LDA',0x12); a('AND','#7'); a('ASL'); a('STA',0x8001)
+        a('LDA',0x12); a('AND','#1'); a('ORA','#0x1E'); a('STA',0x2001)
+    a('PLA'); a('RTI')
+    return rom(a, 4 if mmc3 else 0, ('nmi','reset','irq'), chr8k=0)
+
+# All APU channels, mid-frame $4011 writes, and VRC6, MMC5 and N163 expansion sound.
+def build_sound(mapper,nopcm=False,nodmc=False):
+    a=Asm(0xE000)
+    a.L('reset'); a('SEI'); a('CLD'); a('LDX','#0xFF'); a('TXS'); a('LDA','#0'); a('STA',0x2000); a('STA',0x2001)
+    a.L('vw1'); a('BIT',0x2002); a('BPL','vw1')
+    a.L('vw2'); a('BIT',0x2002); a('BPL','vw2')
+    a('LDA','#0x1F'); a('STA',0x4015)
+    if mapper==5:
+        a('LDA','#3'); a('STA',0x5015)
+    if mapper==19:
+        # wave: 32 4-bit samples at 0..15, autoinc
+        a('LDA','#0x80'); a('STA',0xF800); a('LDX','#0')
+        a.L('wv'); a('TXA'); a('ASL'); a('ASL'); a('ASL'); a('EOR','#0x5A'); a('STA',0x4800); a('INX'); a('CPX','#16'); a('BNE','wv')
+    a('LDA','#0x80'); a('STA',0x2000); a('CLI')
+    a.L('main')
+    if nopcm: a('JMP','main')
+    # mid-frame PCM-ish writes to $4011
+    a('LDX','#0')
+    a.L('pcm'); a('TXA'); a('ADC',0x10); a('LSR'); a('STA',0x4011)
+    if mapper==5:
+        a('STA',0x5011)
+    a('LDY','#20'); a.L('dl'); a('DEY'); a('BNE','dl')
+    a('INX'); a('CPX','#64'); a('BNE','pcm')
+    a('JMP','main')
+    a.L('nmi'); a('PHA'); a('TXA'); a('PHA')
+    a('INC',0x10); a('LDA',0x10)
+    # square 1
+    a('AND','#0x0F'); a('ORA','#0x70'); a('STA',0x4000)
+    a('LDA',0x10); a('ASL'); a('ASL'); a('STA',0x4002)
+    a('LDA',0x10); a('AND','#0x0F'); a('BNE','n1'); a('LDA','#0x09'); a('STA',0x4003); a.L('n1')
+    # square 2 with envelope
+    a('LDA','#0x84'); a('STA',0x4004); a('LDA',0x10); a('EOR','#0xFF'); a('STA',0x4006)
+    a('LDA',0x10); a('AND','#0x1F'); a('BNE','n2'); a('LDA','#0x0A'); a('STA',0x4007); a.L('n2')
+    # triangle
+    a('LDA','#0xFF'); a('STA',0x4008); a('LDA',0x10); a('ADC','#0x30'); a('STA',0x400A)
+    a('LDA',0x10); a('AND','#0x3F'); a('BNE','n3'); a('LDA','#0xF8'); a('STA',0x400B); a.L('n3')
+    # noise
+    a('LDA',0x10); a('AND','#0x0F'); a('ORA','#0x30'); a('STA',0x400C)
+    a('LDA',0x10); a('LSR'); a('LSR'); a('AND','#0x8F'); a('STA',0x400E); a('LDA','#0xF8'); a('STA',0x400F)
+    # dmc restart every 8 frames
+    a('LDA',0x10); a('AND','#7' if not nodmc else '#0'); a('BEQ' if nodmc else 'BNE','n4')
+    a('LDA','#0x0D'); a('STA',0x4010); a('LDA',0x10); a('AND','#0x0F'); a('STA',0x4012); a('LDA','#0x10'); a('STA',0x4013)
+    a('LDA','#0x1F'); a('STA',0x4015); a.L('n4')
+    if mapper==24:
+        a('LDA',0x10); a('AND','#0x7F'); a('STA',0x9000); a('LDA',0x10); a('ASL'); a('STA',0x9001); a('LDA','#0x81'); a('STA',0x9002)
+        a('LDA',0x10); a('ORA','#0x8C'); a('STA',0xA000); a('LDA',0x10); a('EOR','#0x55'); a('STA',0xA001); a('LDA','#0x82'); a('STA',0xA002)
+        a('LDA',0x10); a('AND','#0x3F'); a('STA',0xB000); a('LDA',0x10); a('STA',0xB001); a('LDA','#0x80'); a('STA',0xB002)
+    if mapper==5:
+        a('LDA',0x10); a('AND','#0x0F'); a('ORA','#0x70'); a('STA',0x5000); a('LDA',0x10); a('STA',0x5002)
+        a('LDA',0x10); a('AND','#0x0F'); a('BNE','m1'); a('LDA','#0x09'); a('STA',0x5003); a('LDA','#0x0A'); a('STA',0x5007); a.L('m1')
+        a('LDA','#0xBA'); a('STA',0x5004); a('LDA',0x10); a('EOR','#0x33'); a('STA',0x5006)
+    if mapper==19:
+        # channels 7 and 8 (regs $70-$7F), autoinc from $F0
+        a('LDA','#0xF0'); a('STA',0xF800)
+        for v in [0x10, 0, 0x02, 0, 0xE0, 0, 0, 0x0F]:
+            if v=='f': pass
+            a('LDA','#%d'%v) if v!=0x10 else (a('LDA',0x10)); a('STA',0x4800)
+        a('LDA','#0xF8'); a('STA',0xF800)
+        for v in [0x40, 0, 0x01, 0, 0xE0, 0, 0, 0x1A]:
+            a('LDA','#%d'%v); a('STA',0x4800)
+    a('PLA'); a('TAX'); a('PLA'); a('RTI')
+    a.L('irq'); a('RTI')
+    r=bytearray(rom(a, mapper, ('nmi','reset','irq')))
+    random.seed(7)
+    for i in range(16,16+0x6000): r[i]=random.getrandbits(8)
+    return bytes(r)
+
+ROMS = [
+    ('nrom', lambda: build_basic(False)),
+    ('mmc3', lambda: build_basic(True)),
+    ('idle', lambda: build_idle('idle')),
+    ('jmp', lambda: build_idle('jmp')),
+    ('mmc3_idle', lambda: build_idle('mmc3')),
+    ('idle_ram', lambda: build_idle('idle', ('ram',))),
+    ('idle_and', lambda: build_idle('idle', ('and',))),
+    ('idle_vbl', lambda: build_idle('idle', ('vbl',))),
+    ('mmc3_ram', lambda: build_idle('mmc3', ('ram',))),
+    ('mmc3_and', lambda: build_idle('mmc3', ('and',))),
+    ('mmc3_vbl', lambda: build_idle('mmc3', ('vbl',))),
+    ('spr', lambda: build_sprites(False)),
+    ('spr_mmc3', lambda: build_sprites(True)),
+    ('chrram', lambda: build_chrram(False)),
+    ('chrram_mmc3', lambda: build_chrram(True)),
+    ('snd', lambda: build_sound(0)),
+    ('snd_dmconly', lambda: build_sound(0, nopcm=True)),
+    ('snd_pcmonly', lambda: build_sound(0, nodmc=True)),
+    ('snd_vrc6', lambda: build_sound(24)),
+    ('snd_mmc5', lambda: build_sound(5)),
+    ('snd_n163', lambda: build_sound(19)),
+]
+
+# Two gamepads, 2000 frames of pseudo-random presses.
+def build_movie(frames=2000):
+    random.seed(1234)
+    def joy():
+        return ''.join(c if random.random() < 0.2 else '.' for c in 'RLDUTSBA')
+    lines = ['version 3', 'emuVersion 22020', 'rerecordCount 0', 'palFlag 0', 'romFilename test',
+             'romChecksum base64:AAAAAAAAAAAAAAAAAAAAAA==', 'guid 452DE2C3-EF43-2FA9-77AC-0677FC51543B',
+             'fourscore 0', 'microphone 0', 'port0 1', 'port1 1', 'port2 0', 'FDS 0', 'NewPPU 0']
+    lines += ['|0|%s|%s||' % (joy(), joy()) for _ in range(frames)]
+    return ('\n'.join(lines) + '\n').encode()
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        sys.exit('usage: %s <output dir>' % sys.argv[0])
+    out = sys.argv[1]
+    os.makedirs(out, exist_ok=True)
+    for name, build in ROMS:
+        with open(os.path.join(out, name + '.nes'), 'wb') as f:
+            f.write(build())
+    with open(os.path.join(out, 'input.fm2'), 'wb') as f:
+        f.write(build_movie())
@@ -257,7 +257,7 @@ int Assemble(unsigned char *output, int addr, char *str) {
 
 ///disassembles the opcodes in the buffer assuming the provided address. Uses GetMem() and 6502 current registers to query referenced values. returns a static string buffer.
 char *Disassemble(int addr, uint8 *opcode) {
-	static char str[64]={0};
+	static FCEU_THREAD_LOCAL char str[64]={0};
 	const char *chr;
 	char indReg;
 	uint16 tmp,tmp2;
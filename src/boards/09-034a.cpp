@@ -32,10 +32,10 @@
 
 #include "mapinc.h"
 
-static uint8 prg;
-static uint32 IRQCount, IRQa;
+static FCEU_THREAD_LOCAL uint8 prg;
+static FCEU_THREAD_LOCAL uint32 IRQCount, IRQa;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &IRQCount, 4, "IRQC" },
 	{ &IRQa, 4, "IRQA" },
@@ -20,12 +20,12 @@
 
 #include "mapinc.h"
 
-static uint8 reg[16], IRQa;
-static uint32 IRQCount;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE;
+static FCEU_THREAD_LOCAL uint8 reg[16], IRQa;
+static FCEU_THREAD_LOCAL uint32 IRQCount;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &IRQa, 1, "IRQA" },
 	{ &IRQCount, 4, "IRQC" },
@@ -23,11 +23,11 @@
 
 #include "mapinc.h"
 
-static uint8 reg[8];
-static uint8 mirror, cmd, bank;
-static uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint8 reg[8];
+static FCEU_THREAD_LOCAL uint8 mirror, cmd, bank;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &cmd, 1, "CMD" },
 	{ &mirror, 1, "MIRR" },
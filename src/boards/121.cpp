@@ -95,7 +95,7 @@ static DECLFW(M121Write) {
 	}
 }
 
-static uint8 prot_array[16] = { 0x83, 0x83, 0x42, 0x00 };
+static FCEU_THREAD_LOCAL uint8 prot_array[16] = { 0x83, 0x83, 0x42, 0x00 };
 static DECLFW(M121LoWrite) {
 	EXPREGS[4] = prot_array[V & 3];	// 0x100 bit in address seems to be switch arrays 0, 2, 2, 3 (Contra Fighter)
 	if ((A & 0x5180) == 0x5180) {	// A9713 multigame extension
@@ -24,8 +24,8 @@
 
 #include "mapinc.h"
 
-static uint8 prgchr[2], ctrl;
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL uint8 prgchr[2], ctrl;
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ prgchr, 2, "REGS" },
 	{ &ctrl, 1, "CTRL" },
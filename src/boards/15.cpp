@@ -21,11 +21,11 @@
 
 #include "mapinc.h"
 
-static uint16 latchea;
-static uint8 latched;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL uint16 latchea;
+static FCEU_THREAD_LOCAL uint8 latched;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &latchea, 2, "AREG" },
 	{ &latched, 1, "DREG" },
@@ -20,11 +20,11 @@
 
 #include "mapinc.h"
 
-static uint8 chrlo[8], chrhi[8], prg, mirr, mirrisused = 0;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE;
+static FCEU_THREAD_LOCAL uint8 chrlo[8], chrhi[8], prg, mirr, mirrisused = 0;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &prg, 1, "PREG" },
 	{ chrlo, 8, "CRGL" },
@@ -24,16 +24,16 @@
 
 #include "mapinc.h"
 
-static uint8 laststrobe, trigger;
-static uint8 reg[8];
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 laststrobe, trigger;
+static FCEU_THREAD_LOCAL uint8 reg[8];
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
 
-static writefunc pcmwrite;
+static FCEU_THREAD_LOCAL writefunc pcmwrite;
 
-static void (*WSync)(void);
+static FCEU_THREAD_LOCAL void (*WSync)(void);
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &laststrobe, 1, "STB" },
 	{ &trigger, 1, "TRG" },
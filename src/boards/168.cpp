@@ -20,11 +20,11 @@
 
 #include "mapinc.h"
 
-static uint8 reg;
-static uint8 *CHRRAM = NULL;
-static uint32 CHRRAMSIZE;
+static FCEU_THREAD_LOCAL uint8 reg;
+static FCEU_THREAD_LOCAL uint8 *CHRRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 CHRRAMSIZE;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &reg, 1, "REGS" },
 	{ 0 }
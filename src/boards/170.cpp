@@ -20,9 +20,9 @@
 
 #include "mapinc.h"
 
-static uint8 reg;
+static FCEU_THREAD_LOCAL uint8 reg;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &reg, 1, "REGS" },
 	{ 0 }
@@ -21,13 +21,13 @@
 
 #include "mapinc.h"
 
-extern uint32 ROM_size;
+extern FCEU_THREAD_LOCAL uint32 ROM_size;
 
-static uint8 prg[4], chr, sbw, we_sram;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE;
+static FCEU_THREAD_LOCAL uint8 prg[4], chr, sbw, we_sram;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
 
-static SFORMAT StateRegs[]=
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[]=
 {
   {prg, 4, "PRG"},
   {&chr, 1, "CHR"},
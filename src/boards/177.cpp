@@ -20,12 +20,12 @@
 
 #include "mapinc.h"
 
-static uint8 reg;
+static FCEU_THREAD_LOCAL uint8 reg;
 
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &reg, 1, "REG" },
 	{ 0 }
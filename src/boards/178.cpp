@@ -24,23 +24,23 @@
 
 #include "mapinc.h"
 
-static uint8 reg[4];
+static FCEU_THREAD_LOCAL uint8 reg[4];
 
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
 
 // Tennis with VR sensor, very simple behaviour
 extern void GetMouseData(uint32 (&md)[3]);
-static uint32 MouseData[3], click, lastclick;
-static int32 SensorDelay;
+static FCEU_THREAD_LOCAL uint32 MouseData[3], click, lastclick;
+static FCEU_THREAD_LOCAL int32 SensorDelay;
 
 // highly experimental, not actually working, just curious if it hapen to work with some other decoder
 // SND Registers
-static uint8 pcm_enable = 0;
+static FCEU_THREAD_LOCAL uint8 pcm_enable = 0;
 //static int16 pcm_latch = 0x3F6, pcm_clock = 0x3F6;
 //static writefunc pcmwrite;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ reg, 4, "REGS" },
 	{ 0 }
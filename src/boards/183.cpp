@@ -22,12 +22,12 @@
 
 #include "mapinc.h"
 
-static uint8 prg[4], chr[8], mirr;
-static uint8 IRQCount;
-static uint8 IRQPre;
-static uint8 IRQa;
+static FCEU_THREAD_LOCAL uint8 prg[4], chr[8], mirr;
+static FCEU_THREAD_LOCAL uint8 IRQCount;
+static FCEU_THREAD_LOCAL uint8 IRQPre;
+static FCEU_THREAD_LOCAL uint8 IRQa;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ prg, 4, "PRG" },
 	{ chr, 8, "CHR" },
@@ -21,12 +21,12 @@
 
 #include "mapinc.h"
 
-static uint8 *DummyCHR = NULL;
-static uint8 datareg;
-static void (*Sync)(void);
+static FCEU_THREAD_LOCAL uint8 *DummyCHR = NULL;
+static FCEU_THREAD_LOCAL uint8 datareg;
+static FCEU_THREAD_LOCAL void (*Sync)(void);
 
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &datareg, 1, "DREG" },
 	{ 0 }
@@ -26,8 +26,8 @@
 #include "mapinc.h"
 #include "mmc3.h"
 
-static uint8 *CHRRAM = NULL;
-static uint32 CHRRAMSIZE;
+static FCEU_THREAD_LOCAL uint8 *CHRRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 CHRRAMSIZE;
 
 static void M199PW(uint32 A, uint8 V) {
 	setprg8(A, V);
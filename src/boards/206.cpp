@@ -20,10 +20,10 @@
 
 #include "mapinc.h"
 
-static uint8 cmd;
-static uint8 DRegs[8];
+static FCEU_THREAD_LOCAL uint8 cmd;
+static FCEU_THREAD_LOCAL uint8 DRegs[8];
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &cmd, 1, "CMD" },
 	{ DRegs, 8, "DREG" },
@@ -23,13 +23,13 @@
 
 #include "mapinc.h"
 
-static uint8 IRQCount;
-static uint8 IRQa;
-static uint8 prg_reg[2];
-static uint8 chr_reg[8];
-static uint8 mirr;
+static FCEU_THREAD_LOCAL uint8 IRQCount;
+static FCEU_THREAD_LOCAL uint8 IRQa;
+static FCEU_THREAD_LOCAL uint8 prg_reg[2];
+static FCEU_THREAD_LOCAL uint8 chr_reg[8];
+static FCEU_THREAD_LOCAL uint8 mirr;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &IRQCount, 1, "IRQC" },
 	{ &IRQa, 1, "IRQA" },
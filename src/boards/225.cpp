@@ -30,9 +30,9 @@
 
 #include "mapinc.h"
 
-static uint8 extraRAM[4], prg, mode, chr, mirr;
+static FCEU_THREAD_LOCAL uint8 extraRAM[4], prg, mode, chr, mirr;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ extraRAM, 4, "PROT" },
 	{ &prg, 1, "PRG" },
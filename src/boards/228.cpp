@@ -20,10 +20,10 @@
 
 #include "mapinc.h"
 
-static uint8 mram[4], vreg;
-static uint16 areg;
+static FCEU_THREAD_LOCAL uint8 mram[4], vreg;
+static FCEU_THREAD_LOCAL uint16 areg;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ mram, 4, "MRAM" },
 	{ &areg, 2, "AREG" },
@@ -20,8 +20,8 @@
 
 #include "mapinc.h"
 
-static uint8 bank, preg;
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL uint8 bank, preg;
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &bank, 1, "BANK" },
 	{ &preg, 1, "PREG" },
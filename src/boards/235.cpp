@@ -21,16 +21,16 @@
 #include "mapinc.h"
 #include "ines.h"
 
-static uint16 cmdreg = 0;
-static uint8 openbus = 0;
+static FCEU_THREAD_LOCAL uint16 cmdreg = 0;
+static FCEU_THREAD_LOCAL uint8 openbus = 0;
 
 // For carts with extra 128K prg rom (Contra)
-static uint8 unrom = 0;
-static uint8 unromData = 0;
+static FCEU_THREAD_LOCAL uint8 unrom = 0;
+static FCEU_THREAD_LOCAL uint8 unromData = 0;
 
-static uint32 PRGROMSize = 0;
+static FCEU_THREAD_LOCAL uint32 PRGROMSize = 0;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &cmdreg, 2, "CREG" },
 	{ &openbus, 1, "OB" },
@@ -20,14 +20,14 @@
 
 #include "mapinc.h"
 
-static uint8 creg[8], preg[2];
-static int32 IRQa, IRQCount, IRQClock, IRQLatch;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
-static uint8 *CHRRAM = NULL;
-static uint32 CHRRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 creg[8], preg[2];
+static FCEU_THREAD_LOCAL int32 IRQa, IRQCount, IRQClock, IRQLatch;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 *CHRRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 CHRRAMSIZE=0;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ creg, 8, "CREG" },
 	{ preg, 2, "PREG" },
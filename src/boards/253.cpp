@@ -20,14 +20,14 @@
 
 #include "mapinc.h"
 
-static uint8 chrlo[8], chrhi[8], prg[2], mirr, vlock;
-static int32 IRQa, IRQCount, IRQLatch, IRQClock;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
-static uint8 *CHRRAM = NULL;
-static uint32 CHRRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 chrlo[8], chrhi[8], prg[2], mirr, vlock;
+static FCEU_THREAD_LOCAL int32 IRQa, IRQCount, IRQLatch, IRQClock;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 *CHRRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 CHRRAMSIZE=0;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ chrlo, 8, "CHRL" },
 	{ chrhi, 8, "CHRH" },
@@ -20,14 +20,14 @@
 // http://wiki.nesdev.com/w/index.php/INES_Mapper_028
 
 //config
-static int prg_mask_16k;
+static FCEU_THREAD_LOCAL int prg_mask_16k;
 
 // state
-uint8 reg;
-uint8 chr;
-uint8 prg;
-uint8 mode;
-uint8 outer;
+FCEU_THREAD_LOCAL uint8 reg;
+FCEU_THREAD_LOCAL uint8 chr;
+FCEU_THREAD_LOCAL uint8 prg;
+FCEU_THREAD_LOCAL uint8 mode;
+FCEU_THREAD_LOCAL uint8 outer;
 
 void SyncMirror()
 {
@@ -192,7 +192,7 @@ static void M28Close(void)
 {
 }
 
-static SFORMAT StateRegs[]=
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[]=
 {
 	{&reg, 1, "REG"},
 	{&chr, 1, "CHR"},
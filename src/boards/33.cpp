@@ -20,12 +20,12 @@
 
 #include "mapinc.h"
 
-static uint8 is48;
-static uint8 regs[8], mirr;
-static uint8 IRQa;
-static int16 IRQCount, IRQLatch;
+static FCEU_THREAD_LOCAL uint8 is48;
+static FCEU_THREAD_LOCAL uint8 regs[8], mirr;
+static FCEU_THREAD_LOCAL uint8 IRQa;
+static FCEU_THREAD_LOCAL int16 IRQCount, IRQLatch;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ regs, 8, "PREG" },
 	{ &mirr, 1, "MIRR" },
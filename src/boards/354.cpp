@@ -20,11 +20,11 @@
 
 #include "mapinc.h"
 
-static uint16 latchAddr;
-static uint8  latchData;
-static uint8  submapper;
+static FCEU_THREAD_LOCAL uint16 latchAddr;
+static FCEU_THREAD_LOCAL uint8  latchData;
+static FCEU_THREAD_LOCAL uint8  submapper;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &latchAddr, 2, "ADDR" },
 	{ &latchData, 1, "DATA" },
@@ -22,9 +22,9 @@
 
 #include "mapinc.h"
 
-static uint8 latche, mirr;
+static FCEU_THREAD_LOCAL uint8 latche, mirr;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &latche, 1, "LATC" },
 	{ &mirr, 1, "MIRR" },
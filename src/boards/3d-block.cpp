@@ -20,12 +20,12 @@
 
 #include "mapinc.h"
 
-static uint8 reg[4], IRQa;
-static int16 IRQCount, IRQPause;
+static FCEU_THREAD_LOCAL uint8 reg[4], IRQa;
+static FCEU_THREAD_LOCAL int16 IRQCount, IRQPause;
 
-static int16 Count = 0x0000;
+static FCEU_THREAD_LOCAL int16 Count = 0x0000;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ reg, 4, "REGS" },
 	{ &IRQa, 1, "IRQA" },
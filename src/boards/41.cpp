@@ -20,9 +20,9 @@
 
 #include "mapinc.h"
 
-static uint8 mainreg, chrreg, mirror;
+static FCEU_THREAD_LOCAL uint8 mainreg, chrreg, mirror;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &mainreg, 1, "MREG" },
 	{ &chrreg, 1, "CREG" },
@@ -21,14 +21,14 @@
 #include "mapinc.h"
 #include "../ines.h"
 
-static uint8 reg[4];
-static uint8 IRQCount;
-static uint8 IRQReload;
-static uint8 IRQa;
-static uint8 serialControl;
-static uint32 serialAddress;
-
-static SFORMAT StateRegs[] = {
+static FCEU_THREAD_LOCAL uint8 reg[4];
+static FCEU_THREAD_LOCAL uint8 IRQCount;
+static FCEU_THREAD_LOCAL uint8 IRQReload;
+static FCEU_THREAD_LOCAL uint8 IRQa;
+static FCEU_THREAD_LOCAL uint8 serialControl;
+static FCEU_THREAD_LOCAL uint32 serialAddress;
+
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] = {
 	{ reg,            4, "REGS" },
 	{ &IRQCount,      1, "IRQC" },
 	{ &IRQReload,     1, "IRQR" },
@@ -51,8 +51,8 @@ static void Sync(void) {
 	setchr4(0x1000, ~0x02);
 }
 
-static uint64 lreset;
-static uint32 laddr;
+static FCEU_THREAD_LOCAL uint64 lreset;
+static FCEU_THREAD_LOCAL uint32 laddr;
 static DECLFR(M413ReadPCM) {
 	uint8 ret = X.DB;
 	if ((A == laddr) && ((timestampbase + timestamp) < (lreset + 4))) {
@@ -24,10 +24,10 @@
 
 #include "mapinc.h"
 
-static uint8 preg, creg, mirr;
-static uint32 IRQCount, IRQa;
+static FCEU_THREAD_LOCAL uint8 preg, creg, mirr;
+static FCEU_THREAD_LOCAL uint32 IRQCount, IRQa;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &preg, 1, "PREG" },
 	{ &creg, 1, "CREG" },
@@ -34,11 +34,11 @@ const int FLASH_SECTOR_SIZE = 64 * 1024;
 const int magic_addr1 = 0x0555;
 const int magic_addr2 = 0x02AA;
 
-static uint8 flash_state, flash_id_mode;
-static uint8 *flash_data;
-static uint16 flash_buffer_a[10];
-static uint8 flash_buffer_v[10];
-static uint8 flash_id[2];
+static FCEU_THREAD_LOCAL uint8 flash_state, flash_id_mode;
+static FCEU_THREAD_LOCAL uint8 *flash_data;
+static FCEU_THREAD_LOCAL uint16 flash_buffer_a[10];
+static FCEU_THREAD_LOCAL uint8 flash_buffer_v[10];
+static FCEU_THREAD_LOCAL uint8 flash_id[2];
 
 static DECLFW(M451FlashWrite)
 {
@@ -24,7 +24,7 @@
 
 #include "mapinc.h"
 
-static uint32 latch;
+static FCEU_THREAD_LOCAL uint32 latch;
 
 static void Sync() {
 	setprg32(0x8000, latch);
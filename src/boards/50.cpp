@@ -24,10 +24,10 @@
 
 #include "mapinc.h"
 
-static uint8 reg;
-static uint32 IRQCount, IRQa;
+static FCEU_THREAD_LOCAL uint8 reg;
+static FCEU_THREAD_LOCAL uint32 IRQCount, IRQa;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &IRQCount, 4, "IRQC" },
 	{ &IRQa, 4, "IRQA" },
@@ -21,11 +21,11 @@
 
 #include "mapinc.h"
 
-static uint8 prg_reg;
-static uint8 chr_reg;
-static uint8 hrd_flag;
+static FCEU_THREAD_LOCAL uint8 prg_reg;
+static FCEU_THREAD_LOCAL uint8 chr_reg;
+static FCEU_THREAD_LOCAL uint8 hrd_flag;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &hrd_flag, 1, "DPSW" },
 	{ &prg_reg, 1, "PRG" },
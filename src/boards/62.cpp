@@ -20,9 +20,9 @@
 
 #include "mapinc.h"
 
-static uint8 bank;
-static uint16 mode;
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL uint8 bank;
+static FCEU_THREAD_LOCAL uint16 mode;
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &bank, 1, "BANK" },
 	{ &mode, 2, "MODE" },
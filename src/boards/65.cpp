@@ -21,11 +21,11 @@
 
 #include "mapinc.h"
 
-static uint8 preg[3], creg[8], mirr;
-static uint8 IRQa;
-static int16 IRQCount, IRQLatch;
+static FCEU_THREAD_LOCAL uint8 preg[3], creg[8], mirr;
+static FCEU_THREAD_LOCAL uint8 IRQa;
+static FCEU_THREAD_LOCAL int16 IRQCount, IRQLatch;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ preg, 3, "PREG" },
 	{ creg, 8, "CREG" },
@@ -21,11 +21,11 @@
 
 #include "mapinc.h"
 
-static uint8 preg, creg[4], mirr, suntoggle = 0;
-static uint8 IRQa;
-static int16 IRQCount, IRQLatch;
+static FCEU_THREAD_LOCAL uint8 preg, creg[4], mirr, suntoggle = 0;
+static FCEU_THREAD_LOCAL uint8 IRQa;
+static FCEU_THREAD_LOCAL int16 IRQCount, IRQLatch;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &preg, 1, "PREG" },
 	{ &suntoggle, 1, "STOG" },
@@ -21,13 +21,13 @@
 
 #include "mapinc.h"
 
-static uint8 cmdreg, preg[4], creg[8], mirr;
-static uint8 IRQa;
-static int32 IRQCount;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 cmdreg, preg[4], creg[8], mirr;
+static FCEU_THREAD_LOCAL uint8 IRQa;
+static FCEU_THREAD_LOCAL int32 IRQCount;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &cmdreg, 1, "CMDR" },
 	{ preg, 4, "PREG" },
@@ -102,12 +102,12 @@ static void AYSoundHQ(void);
 static void DoAYSQ(int x);
 static void DoAYSQHQ(int x);
 
-static uint8 sndcmd, sreg[14];
-static int32 vcount[3];
-static int32 dcount[3];
-static int CAYBC[3];
+static FCEU_THREAD_LOCAL uint8 sndcmd, sreg[14];
+static FCEU_THREAD_LOCAL int32 vcount[3];
+static FCEU_THREAD_LOCAL int32 dcount[3];
+static FCEU_THREAD_LOCAL int CAYBC[3];
 
-static SFORMAT SStateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT SStateRegs[] =
 {
 	{ &sndcmd, 1, "SCMD" },
 	{ sreg, 14, "SREG" },
@@ -250,6 +250,12 @@ static void M69IRQHook(int a) {
 	}
 }
 
+static int32 M69IRQNext(void) {
+	if (!IRQa)
+		return X6502_MAX_EVENT_CYCLES;
+	return IRQCount;
+}
+
 static void StateRestore(int version) {
 	Sync();
 }
@@ -258,6 +264,7 @@ void Mapper69_Init(CartInfo *info) {
 	info->Power = M69Power;
 	info->Close = M69Close;
 	MapIRQHook = M69IRQHook;
+	MapIRQHookNext = M69IRQNext;
 	if(info->ines2)
 		WRAMSIZE = info->wram_size + info->battery_wram_size;
 	else
@@ -20,10 +20,10 @@
 
 #include "mapinc.h"
 
-static uint8 preg, mirr;
-static int hardmirr;
+static FCEU_THREAD_LOCAL uint8 preg, mirr;
+static FCEU_THREAD_LOCAL int hardmirr;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &preg, 1, "PREG" },
 	{ &mirr, 1, "MIRR" },
@@ -23,10 +23,10 @@
 
 #include "mapinc.h"
 
-static uint8 preg, creg;
-static void (*Sync)(void);
+static FCEU_THREAD_LOCAL uint8 preg, creg;
+static FCEU_THREAD_LOCAL void (*Sync)(void);
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &preg, 1, "PREG" },
 	{ &creg, 1, "CREG" },
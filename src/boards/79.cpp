@@ -21,8 +21,8 @@
 
 #include "mapinc.h"
 
-static uint8 creg, preg;
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL uint8 creg, preg;
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &creg, 1, "CREG" },
 	{ &preg, 1, "PREG" },
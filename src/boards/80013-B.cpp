@@ -20,9 +20,9 @@
 
 #include "mapinc.h"
 
-static uint8 bios_prg, rom_prg, rom_mode, mirror;
+static FCEU_THREAD_LOCAL uint8 bios_prg, rom_prg, rom_mode, mirror;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &bios_prg, 1, "BREG" },
 	{ &rom_prg, 1, "RREG" },
@@ -23,9 +23,9 @@
 
 #include "mapinc.h"
 
-static uint16 cmdreg;
-static uint8 reset;
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL uint16 cmdreg;
+static FCEU_THREAD_LOCAL uint8 reset;
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &reset, 1, "REST" },
 	{ &cmdreg, 2, "CREG" },
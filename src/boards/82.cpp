@@ -23,11 +23,11 @@
 
 #include "mapinc.h"
 
-static uint8 regs[9], ctrl;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 regs[9], ctrl;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ regs, 9, "REGS" },
 	{ &ctrl, 1, "CTRL" },
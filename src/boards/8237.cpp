@@ -24,9 +24,9 @@
 #include "mapinc.h"
 #include "mmc3.h"
 
-static uint8 cmdin;
+static FCEU_THREAD_LOCAL uint8 cmdin;
 
-static uint8 regperm[8][8] =
+static FCEU_THREAD_LOCAL uint8 regperm[8][8] =
 {
 	{ 0, 1, 2, 3, 4, 5, 6, 7 },
 	{ 0, 2, 6, 1, 7, 3, 4, 5 },
@@ -38,7 +38,7 @@ static uint8 regperm[8][8] =
 	{ 0, 1, 2, 3, 4, 5, 6, 7 },   // empty
 };
 
-static uint8 adrperm[8][8] =
+static FCEU_THREAD_LOCAL uint8 adrperm[8][8] =
 {
 	{ 0, 1, 2, 3, 4, 5, 6, 7 },
 	{ 3, 2, 0, 4, 1, 5, 6, 7 },
@@ -26,30 +26,30 @@
 // Mapper 209 much compicated hardware with decribed above features disabled by default and switchable by command
 // Mapper 211 the same mapper 209 but with forced nametable control
 
-static int is209;
-static int is211;
+static FCEU_THREAD_LOCAL int is209;
+static FCEU_THREAD_LOCAL int is211;
 
-static uint8 IRQMode;        // from $c001
-static uint8 IRQPre;         // from $c004
-static uint8 IRQPreSize;     // from $c007
-static uint8 IRQCount;       // from $c005
-static uint8 IRQXOR;         // Loaded from $C006
-static uint8 IRQa;           // $c002, $c003, and $c000
+static FCEU_THREAD_LOCAL uint8 IRQMode;        // from $c001
+static FCEU_THREAD_LOCAL uint8 IRQPre;         // from $c004
+static FCEU_THREAD_LOCAL uint8 IRQPreSize;     // from $c007
+static FCEU_THREAD_LOCAL uint8 IRQCount;       // from $c005
+static FCEU_THREAD_LOCAL uint8 IRQXOR;         // Loaded from $C006
+static FCEU_THREAD_LOCAL uint8 IRQa;           // $c002, $c003, and $c000
 
-static uint8 mul[2];
-static uint8 regie;
+static FCEU_THREAD_LOCAL uint8 mul[2];
+static FCEU_THREAD_LOCAL uint8 regie;
 
-static uint8 tkcom[4];
-static uint8 prgb[4];
-static uint8 chrlow[8];
-static uint8 chrhigh[8];
+static FCEU_THREAD_LOCAL uint8 tkcom[4];
+static FCEU_THREAD_LOCAL uint8 prgb[4];
+static FCEU_THREAD_LOCAL uint8 chrlow[8];
+static FCEU_THREAD_LOCAL uint8 chrhigh[8];
 
-static uint8 chr[2];
+static FCEU_THREAD_LOCAL uint8 chr[2];
 
-static uint16 names[4];
-static uint8 tekker;
+static FCEU_THREAD_LOCAL uint16 names[4];
+static FCEU_THREAD_LOCAL uint8 tekker;
 
-static SFORMAT Tek_StateRegs[] = {
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT Tek_StateRegs[] = {
 	{ &IRQMode, 1, "IRQM" },
 	{ &IRQPre, 1, "IRQP" },
 	{ &IRQPreSize, 1, "IRQR" },
@@ -378,7 +378,7 @@ static void SLWrap(void)
   if((IRQMode&3)==1) for(x=0;x<8;x++) ClockCounter();
 }
 
-static uint32 lastread;
+static FCEU_THREAD_LOCAL uint32 lastread;
 static void M90PPU(uint32 A)
 {
   if((IRQMode&3)==2)
@@ -20,10 +20,10 @@
 
 #include "mapinc.h"
 
-static uint8 cregs[4], pregs[2];
-static uint8 IRQCount, IRQa;
+static FCEU_THREAD_LOCAL uint8 cregs[4], pregs[2];
+static FCEU_THREAD_LOCAL uint8 IRQCount, IRQa;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ cregs, 4, "CREG" },
 	{ pregs, 2, "PREG" },
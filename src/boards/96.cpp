@@ -22,9 +22,9 @@
 
 #include "mapinc.h"
 
-static uint8 reg, ppulatch;
+static FCEU_THREAD_LOCAL uint8 reg, ppulatch;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &reg, 1, "REG" },
 	{ &ppulatch, 1, "PPUL" },
@@ -20,12 +20,12 @@
 
 #include "mapinc.h"
 
-static uint8 latch;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE;
-static writefunc old4016;
+static FCEU_THREAD_LOCAL uint8 latch;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
+static FCEU_THREAD_LOCAL writefunc old4016;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &latch, 1, "LATC" },
 	{ 0 }
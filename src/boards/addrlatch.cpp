@@ -20,14 +20,14 @@
 
 #include "mapinc.h"
 
-static uint16 latche, latcheinit;
-static uint16 addrreg0, addrreg1;
-static uint8 dipswitch;
-static void (*WSync)(void);
-static readfunc defread;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
-static uint8 hasBattery = 0;
+static FCEU_THREAD_LOCAL uint16 latche, latcheinit;
+static FCEU_THREAD_LOCAL uint16 addrreg0, addrreg1;
+static FCEU_THREAD_LOCAL uint8 dipswitch;
+static FCEU_THREAD_LOCAL void (*WSync)(void);
+static FCEU_THREAD_LOCAL readfunc defread;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 hasBattery = 0;
 
 static DECLFW(LatchWrite) {
 	latche = A;
@@ -24,14 +24,14 @@
 
 #include "mapinc.h"
 
-static uint8 reg[16], is153, x24c02;
-static uint8 IRQa;
-static int16 IRQCount, IRQLatch;
+static FCEU_THREAD_LOCAL uint8 reg[16], is153, x24c02;
+static FCEU_THREAD_LOCAL uint8 IRQa;
+static FCEU_THREAD_LOCAL int16 IRQCount, IRQLatch;
 
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ reg, 16, "REGS" },
 	{ &IRQa, 1, "IRQA" },
@@ -48,17 +48,17 @@ static SFORMAT StateRegs[] =
 #define X24C0X_READ			3
 #define X24C0X_WRITE		4
 
-static uint8 x24c0x_data[512];
+static FCEU_THREAD_LOCAL uint8 x24c0x_data[512];
 
-static uint8 x24c01_state;
-static uint8 x24c01_addr, x24c01_word, x24c01_latch, x24c01_bitcount;
-static uint8 x24c01_sda, x24c01_scl, x24c01_out;
+static FCEU_THREAD_LOCAL uint8 x24c01_state;
+static FCEU_THREAD_LOCAL uint8 x24c01_addr, x24c01_word, x24c01_latch, x24c01_bitcount;
+static FCEU_THREAD_LOCAL uint8 x24c01_sda, x24c01_scl, x24c01_out;
 
-static uint8 x24c02_state;
-static uint8 x24c02_addr, x24c02_word, x24c02_latch, x24c02_bitcount;
-static uint8 x24c02_sda, x24c02_scl, x24c02_out;
+static FCEU_THREAD_LOCAL uint8 x24c02_state;
+static FCEU_THREAD_LOCAL uint8 x24c02_addr, x24c02_word, x24c02_latch, x24c02_bitcount;
+static FCEU_THREAD_LOCAL uint8 x24c02_sda, x24c02_scl, x24c02_out;
 
-static SFORMAT x24c01StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT x24c01StateRegs[] =
 {
 	{ &x24c01_addr, 1, "ADDR" },
 	{ &x24c01_word, 1, "WORD" },
@@ -71,7 +71,7 @@ static SFORMAT x24c01StateRegs[] =
 	{ 0 }
 };
 
-static SFORMAT x24c02StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT x24c02StateRegs[] =
 {
 	{ &x24c02_addr, 1, "ADDR" },
 	{ &x24c02_word, 1, "WORD" },
@@ -297,6 +297,12 @@ static void BandaiIRQHook(int a) {
 	}
 }
 
+static int32 BandaiIRQNext(void) {
+	if (!IRQa)
+		return X6502_MAX_EVENT_CYCLES;
+	return IRQCount + 1;
+}
+
 static void BandaiPower(void) {
 	IRQa = 0;
 	if(x24c02)
@@ -318,6 +324,7 @@ void Mapper16_Init(CartInfo *info) {
 	is153 = 0;
 	info->Power = BandaiPower;
 	MapIRQHook = BandaiIRQHook;
+	MapIRQHookNext = BandaiIRQNext;
 
 	info->battery = 1;
 	info->addSaveGameBuf( x24c0x_data + 256, 256 );
@@ -333,6 +340,7 @@ void Mapper159_Init(CartInfo *info) {
 	is153 = 0;
 	info->Power = BandaiPower;
 	MapIRQHook = BandaiIRQHook;
+	MapIRQHookNext = BandaiIRQNext;
 
 	info->battery = 1;
 	info->addSaveGameBuf( x24c0x_data, 128 );
@@ -372,6 +380,7 @@ void Mapper153_Init(CartInfo *info) {
 	info->Power = M153Power;
 	info->Close = M153Close;
 	MapIRQHook = BandaiIRQHook;
+	MapIRQHookNext = BandaiIRQNext;
 
 	WRAMSIZE = 8192;
 	WRAM = (uint8*)FCEU_gmalloc(WRAMSIZE);
@@ -388,10 +397,10 @@ void Mapper153_Init(CartInfo *info) {
 
 // Datach Barcode Battler
 
-static uint8 BarcodeData[256];
-static int BarcodeReadPos;
-static int BarcodeCycleCount;
-static uint32 BarcodeOut;
+static FCEU_THREAD_LOCAL uint8 BarcodeData[256];
+static FCEU_THREAD_LOCAL int BarcodeReadPos;
+static FCEU_THREAD_LOCAL int BarcodeCycleCount;
+static FCEU_THREAD_LOCAL uint32 BarcodeOut;
 
 // #define INTERL2OF5
 
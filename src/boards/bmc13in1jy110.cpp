@@ -22,10 +22,10 @@
 
 #include "mapinc.h"
 
-static uint8 bank_mode;
-static uint8 bank_value;
-static uint8 prgb[4];
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL uint8 bank_mode;
+static FCEU_THREAD_LOCAL uint8 bank_value;
+static FCEU_THREAD_LOCAL uint8 prgb[4];
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &bank_mode, 1, "BNM" },
 	{ &bank_value, 1, "BMV" },
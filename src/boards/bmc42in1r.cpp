@@ -24,9 +24,9 @@
 
 #include "mapinc.h"
 
-static uint8 isresetbased = 0;
-static uint8 latche[2], reset;
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL uint8 isresetbased = 0;
+static FCEU_THREAD_LOCAL uint8 latche[2], reset;
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &reset, 1, "RST" },
 	{ latche, 2, "LATC" },
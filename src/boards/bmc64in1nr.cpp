@@ -22,9 +22,9 @@
 
 #include "mapinc.h"
 
-static uint8 regs[4];
+static FCEU_THREAD_LOCAL uint8 regs[4];
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ regs, 4, "REGS" },
 	{ 0 }
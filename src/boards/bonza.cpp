@@ -22,9 +22,9 @@
 
 #define CARD_EXTERNAL_INSERED 0x80
 
-static uint8 prg_reg;
-static uint8 chr_reg;
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL uint8 prg_reg;
+static FCEU_THREAD_LOCAL uint8 chr_reg;
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &prg_reg, 1, "PREG" },
 	{ &chr_reg, 1, "CREG" },
@@ -24,10 +24,10 @@
 #include "mapinc.h"
 #include "mmc3.h"
 
-static uint8 pointer;
-static uint8 offset;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE;
+static FCEU_THREAD_LOCAL uint8 pointer;
+static FCEU_THREAD_LOCAL uint8 offset;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
 
 static int getPRGBankBS4XXXR(int bank)
 {
@@ -32,25 +32,25 @@
 #include "mapinc.h"
 #include "../ines.h"
 
-static uint8 reg;
-static uint8 *CHRRAM = NULL;
+static FCEU_THREAD_LOCAL uint8 reg;
+static FCEU_THREAD_LOCAL uint8 *CHRRAM = NULL;
 const uint32 CHRRAMSIZE = 1024 * 32;
 
-static bool flash = false;
-static uint8 flash_mode;
-static uint8 flash_sequence;
-static uint8 flash_id;
-static uint8 *FLASHROM = NULL;
+static FCEU_THREAD_LOCAL bool flash = false;
+static FCEU_THREAD_LOCAL uint8 flash_mode;
+static FCEU_THREAD_LOCAL uint8 flash_sequence;
+static FCEU_THREAD_LOCAL uint8 flash_id;
+static FCEU_THREAD_LOCAL uint8 *FLASHROM = NULL;
 const uint32 FLASHROMSIZE = 1024 * 512;
 
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &reg, 1, "REG" },
 	{ 0 }
 };
 
-static SFORMAT FlashRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT FlashRegs[] =
 {
 	{ &flash_mode, 1, "FMOD" },
 	{ &flash_sequence, 1, "FSEQ" },
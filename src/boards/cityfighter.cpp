@@ -22,13 +22,13 @@
 
 #include "mapinc.h"
 
-static int32 IRQCount;
-static uint8 IRQa;
-static uint8 prg_reg, prg_mode, mirr;
-static uint8 chr_reg[8];
-static writefunc pcmwrite;
+static FCEU_THREAD_LOCAL int32 IRQCount;
+static FCEU_THREAD_LOCAL uint8 IRQa;
+static FCEU_THREAD_LOCAL uint8 prg_reg, prg_mode, mirr;
+static FCEU_THREAD_LOCAL uint8 chr_reg[8];
+static FCEU_THREAD_LOCAL writefunc pcmwrite;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &IRQCount, 4, "IRQC" },
 	{ &IRQa, 1, "IRQA" },
@@ -83,21 +83,21 @@ const int FLASH_CHIP = 0x12;
 
 const uint32 FLASH_SECTOR_SIZE = 128 * 1024;
 
-extern uint8* WRAM;
-static uint8* CFI = NULL;
-static uint8* Flash = NULL;
-
-static uint8 flash_save = 0;
-static uint8 flash_state = 0;
-static uint16 flash_buffer_a[10];
-static uint8 flash_buffer_v[10];
-static uint8 cfi_mode = 0;
-
-static uint16 regs_base = 0;
-static uint8 flag23 = 0;
-static uint8 flag45 = 0;
-static uint8 flag67 = 0;
-static uint8 flag89 = 0;
+extern FCEU_THREAD_LOCAL uint8* WRAM;
+static FCEU_THREAD_LOCAL uint8* CFI = NULL;
+static FCEU_THREAD_LOCAL uint8* Flash = NULL;
+
+static FCEU_THREAD_LOCAL uint8 flash_save = 0;
+static FCEU_THREAD_LOCAL uint8 flash_state = 0;
+static FCEU_THREAD_LOCAL uint16 flash_buffer_a[10];
+static FCEU_THREAD_LOCAL uint8 flash_buffer_v[10];
+static FCEU_THREAD_LOCAL uint8 cfi_mode = 0;
+
+static FCEU_THREAD_LOCAL uint16 regs_base = 0;
+static FCEU_THREAD_LOCAL uint8 flag23 = 0;
+static FCEU_THREAD_LOCAL uint8 flag45 = 0;
+static FCEU_THREAD_LOCAL uint8 flag67 = 0;
+static FCEU_THREAD_LOCAL uint8 flag89 = 0;
 
 // Macronix 256-mbit memory CFI data
 const uint8 cfi_data[] =
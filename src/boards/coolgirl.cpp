@@ -105,126 +105,126 @@ const int WRAM_CHIP = 0x10;
 const int FLASH_CHIP = 0x11;
 const int CFI_CHIP = 0x13;
 
-static int CHR_SIZE = 0;
-static uint32 WRAM_SIZE = 0;
-static uint8* WRAM = NULL;
-static uint8* SAVE_FLASH = NULL;
-static uint8* CFI;
-
-static uint8 sram_enabled = 0;
-static uint8 sram_page = 0;		// [1:0]
-static uint8 can_write_chr = 0;
-static uint8 map_rom_on_6000 = 0;
-static uint8 flags = 0;			// [2:0]
-static uint8 mapper = 0;		// [5:0]
-static uint8 can_write_flash = 0;
-static uint8 mirroring = 0;		// [1:0]
-static uint8 four_screen = 0;
-static uint8 lockout = 0;
-
-static uint32 prg_base = 0;		// [26:14]
-static uint32 prg_mask = 0b11111000 << 14; // 11111000, 128KB		// [20:14]
-static uint8 prg_mode = 0;		// [2:0]
-static uint8 prg_bank_6000 = 0;	// [7:0]
-static uint8 prg_bank_a = 0;	// [7:0]
-static uint8 prg_bank_b = 1;	// [7:0]
-static uint8 prg_bank_c = ~1;	// [7:0]
-static uint8 prg_bank_d = ~0;	// [7:0]
-
-static uint32 chr_mask = 0;		// [18:13]
-static uint8 chr_mode = 0;		// [2:0]
-static uint16 chr_bank_a = 0;	// [8:0]
-static uint16 chr_bank_b = 1;	// [8:0]
-static uint16 chr_bank_c = 2;	// [8:0]
-static uint16 chr_bank_d = 3;	// [8:0]
-static uint16 chr_bank_e = 4;	// [8:0]
-static uint16 chr_bank_f = 5;	// [8:0]
-static uint16 chr_bank_g = 6;	// [8:0]
-static uint16 chr_bank_h = 7;	// [8:0]
-
-static uint8 TKSMIR[8];
-
-static uint32 prg_bank_6000_mapped = 0;
-static uint32 prg_bank_a_mapped = 0;
-static uint32 prg_bank_b_mapped = 0;
-static uint32 prg_bank_c_mapped = 0;
-static uint32 prg_bank_d_mapped = 0;
+static FCEU_THREAD_LOCAL int CHR_SIZE = 0;
+static FCEU_THREAD_LOCAL uint32 WRAM_SIZE = 0;
+static FCEU_THREAD_LOCAL uint8* WRAM = NULL;
+static FCEU_THREAD_LOCAL uint8* SAVE_FLASH = NULL;
+static FCEU_THREAD_LOCAL uint8* CFI;
+
+static FCEU_THREAD_LOCAL uint8 sram_enabled = 0;
+static FCEU_THREAD_LOCAL uint8 sram_page = 0;		// [1:0]
+static FCEU_THREAD_LOCAL uint8 can_write_chr = 0;
+static FCEU_THREAD_LOCAL uint8 map_rom_on_6000 = 0;
+static FCEU_THREAD_LOCAL uint8 flags = 0;			// [2:0]
+static FCEU_THREAD_LOCAL uint8 mapper = 0;		// [5:0]
+static FCEU_THREAD_LOCAL uint8 can_write_flash = 0;
+static FCEU_THREAD_LOCAL uint8 mirroring = 0;		// [1:0]
+static FCEU_THREAD_LOCAL uint8 four_screen = 0;
+static FCEU_THREAD_LOCAL uint8 lockout = 0;
+
+static FCEU_THREAD_LOCAL uint32 prg_base = 0;		// [26:14]
+static FCEU_THREAD_LOCAL uint32 prg_mask = 0b11111000 << 14; // 11111000, 128KB		// [20:14]
+static FCEU_THREAD_LOCAL uint8 prg_mode = 0;		// [2:0]
+static FCEU_THREAD_LOCAL uint8 prg_bank_6000 = 0;	// [7:0]
+static FCEU_THREAD_LOCAL uint8 prg_bank_a = 0;	// [7:0]
+static FCEU_THREAD_LOCAL uint8 prg_bank_b = 1;	// [7:0]
+static FCEU_THREAD_LOCAL uint8 prg_bank_c = ~1;	// [7:0]
+static FCEU_THREAD_LOCAL uint8 prg_bank_d = ~0;	// [7:0]
+
+static FCEU_THREAD_LOCAL uint32 chr_mask = 0;		// [18:13]
+static FCEU_THREAD_LOCAL uint8 chr_mode = 0;		// [2:0]
+static FCEU_THREAD_LOCAL uint16 chr_bank_a = 0;	// [8:0]
+static FCEU_THREAD_LOCAL uint16 chr_bank_b = 1;	// [8:0]
+static FCEU_THREAD_LOCAL uint16 chr_bank_c = 2;	// [8:0]
+static FCEU_THREAD_LOCAL uint16 chr_bank_d = 3;	// [8:0]
+static FCEU_THREAD_LOCAL uint16 chr_bank_e = 4;	// [8:0]
+static FCEU_THREAD_LOCAL uint16 chr_bank_f = 5;	// [8:0]
+static FCEU_THREAD_LOCAL uint16 chr_bank_g = 6;	// [8:0]
+static FCEU_THREAD_LOCAL uint16 chr_bank_h = 7;	// [8:0]
+
+static FCEU_THREAD_LOCAL uint8 TKSMIR[8];
+
+static FCEU_THREAD_LOCAL uint32 prg_bank_6000_mapped = 0;
+static FCEU_THREAD_LOCAL uint32 prg_bank_a_mapped = 0;
+static FCEU_THREAD_LOCAL uint32 prg_bank_b_mapped = 0;
+static FCEU_THREAD_LOCAL uint32 prg_bank_c_mapped = 0;
+static FCEU_THREAD_LOCAL uint32 prg_bank_d_mapped = 0;
 
 // for MMC2/MMC4
-static uint8 ppu_latch0 = 0;
-static uint8 ppu_latch1 = 0;
+static FCEU_THREAD_LOCAL uint8 ppu_latch0 = 0;
+static FCEU_THREAD_LOCAL uint8 ppu_latch1 = 0;
 // for MMC1
-static uint64 lreset = 0;
-static uint8 mmc1_load_register = 0;	// [5:0]
+static FCEU_THREAD_LOCAL uint64 lreset = 0;
+static FCEU_THREAD_LOCAL uint8 mmc1_load_register = 0;	// [5:0]
 // for MMC3
-static uint8 mmc3_internal = 0;			// [2:0]
+static FCEU_THREAD_LOCAL uint8 mmc3_internal = 0;			// [2:0]
 // for mapper #69
-static uint8 mapper69_internal = 0;		// [3:0]
+static FCEU_THREAD_LOCAL uint8 mapper69_internal = 0;		// [3:0]
 // for mapper #112
-static uint8 mapper112_internal = 0;	// [2:0]
+static FCEU_THREAD_LOCAL uint8 mapper112_internal = 0;	// [2:0]
 // for mapper #163
-static uint8 mapper_163_latch = 0;
-static uint8 mapper163_r0 = 0;			// [7:0]
-static uint8 mapper163_r1 = 0;			// [7:0]
-static uint8 mapper163_r2 = 0;			// [7:0]
-static uint8 mapper163_r3 = 0;			// [7:0]
-static uint8 mapper163_r4 = 0;			// [7:0]
-static uint8 mapper163_r5 = 0;			// [7:0]
+static FCEU_THREAD_LOCAL uint8 mapper_163_latch = 0;
+static FCEU_THREAD_LOCAL uint8 mapper163_r0 = 0;			// [7:0]
+static FCEU_THREAD_LOCAL uint8 mapper163_r1 = 0;			// [7:0]
+static FCEU_THREAD_LOCAL uint8 mapper163_r2 = 0;			// [7:0]
+static FCEU_THREAD_LOCAL uint8 mapper163_r3 = 0;			// [7:0]
+static FCEU_THREAD_LOCAL uint8 mapper163_r4 = 0;			// [7:0]
+static FCEU_THREAD_LOCAL uint8 mapper163_r5 = 0;			// [7:0]
 
 // For mapper #90
-static uint8 mul1 = 0;
-static uint8 mul2 = 0;
+static FCEU_THREAD_LOCAL uint8 mul1 = 0;
+static FCEU_THREAD_LOCAL uint8 mul2 = 0;
 
 // for MMC3 scanline-based interrupts, counts A12 rises after long A12 falls
-static uint8 mmc3_irq_enabled = 0;				// register to enable/disable counter
-static uint8 mmc3_irq_latch = 0;				// [7:0], stores counter reload latch value
-static uint8 mmc3_irq_counter = 0;				// [7:0], counter itself (downcounting)
-static uint8 mmc3_irq_reload = 0;				// flag to reload counter from latch
+static FCEU_THREAD_LOCAL uint8 mmc3_irq_enabled = 0;				// register to enable/disable counter
+static FCEU_THREAD_LOCAL uint8 mmc3_irq_latch = 0;				// [7:0], stores counter reload latch value
+static FCEU_THREAD_LOCAL uint8 mmc3_irq_counter = 0;				// [7:0], counter itself (downcounting)
+static FCEU_THREAD_LOCAL uint8 mmc3_irq_reload = 0;				// flag to reload counter from latch
 // for MMC5 scanline-based interrupts, counts dummy PPU reads
-static uint8 mmc5_irq_enabled = 0;				// register to enable/disable counter
-static uint8 mmc5_irq_line = 0;					// [7:0], scanline on which IRQ will be triggered
-static uint8 mmc5_irq_out = 0;					// stores 1 when IRQ is triggered
+static FCEU_THREAD_LOCAL uint8 mmc5_irq_enabled = 0;				// register to enable/disable counter
+static FCEU_THREAD_LOCAL uint8 mmc5_irq_line = 0;					// [7:0], scanline on which IRQ will be triggered
+static FCEU_THREAD_LOCAL uint8 mmc5_irq_out = 0;					// stores 1 when IRQ is triggered
 // for mapper #18
-static uint16 mapper18_irq_value = 0;			// [15:0], counter itself (downcounting)
-static uint8 mapper18_irq_control = 0;			// [3:0], IRQ settings
-static uint16 mapper18_irq_latch = 0;			// [15:0], stores counter reload latch value
+static FCEU_THREAD_LOCAL uint16 mapper18_irq_value = 0;			// [15:0], counter itself (downcounting)
+static FCEU_THREAD_LOCAL uint8 mapper18_irq_control = 0;			// [3:0], IRQ settings
+static FCEU_THREAD_LOCAL uint16 mapper18_irq_latch = 0;			// [15:0], stores counter reload latch value
 // for mapper #65
-static uint8 mapper65_irq_enabled = 0;			// register to enable/disable IRQ
-static uint16 mapper65_irq_value = 0;			// [15:0], counter itself (downcounting)
-static uint16 mapper65_irq_latch = 0;			// [15:0], stores counter reload latch value 
+static FCEU_THREAD_LOCAL uint8 mapper65_irq_enabled = 0;			// register to enable/disable IRQ
+static FCEU_THREAD_LOCAL uint16 mapper65_irq_value = 0;			// [15:0], counter itself (downcounting)
+static FCEU_THREAD_LOCAL uint16 mapper65_irq_latch = 0;			// [15:0], stores counter reload latch value 
 // reg mapper65_irq_out = 0;
 // for Sunsoft FME-7
-static uint8 mapper69_irq_enabled = 0;			// register to enable/disable IRQ
-static uint8 mapper69_counter_enabled = 0;			// register to enable/disable counter
-static uint16 mapper69_irq_value = 0;				// counter itself (downcounting)
+static FCEU_THREAD_LOCAL uint8 mapper69_irq_enabled = 0;			// register to enable/disable IRQ
+static FCEU_THREAD_LOCAL uint8 mapper69_counter_enabled = 0;			// register to enable/disable counter
+static FCEU_THREAD_LOCAL uint16 mapper69_irq_value = 0;				// counter itself (downcounting)
 // for VRC4 CPU-based interrupts
-static uint8 vrc4_irq_value = 0;				// [7:0], counter itself (upcounting)
-static uint8 vrc4_irq_control = 0;				// [2:0]� IRQ settings
-static uint8 vrc4_irq_latch = 0;				// [7:0], stores counter reload latch value
-static uint8 vrc4_irq_prescaler = 0;			// [6:0], prescaler counter for VRC4
-static uint8 vrc4_irq_prescaler_counter = 0;	// prescaler cicles counter for VRC4
+static FCEU_THREAD_LOCAL uint8 vrc4_irq_value = 0;				// [7:0], counter itself (upcounting)
+static FCEU_THREAD_LOCAL uint8 vrc4_irq_control = 0;				// [2:0]� IRQ settings
+static FCEU_THREAD_LOCAL uint8 vrc4_irq_latch = 0;				// [7:0], stores counter reload latch value
+static FCEU_THREAD_LOCAL uint8 vrc4_irq_prescaler = 0;			// [6:0], prescaler counter for VRC4
+static FCEU_THREAD_LOCAL uint8 vrc4_irq_prescaler_counter = 0;	// prescaler cicles counter for VRC4
 // for VRC3 CPU-based interrupts
-static uint16 vrc3_irq_value = 0;				// [15:0], counter itself (upcounting)
-static uint8 vrc3_irq_control = 0;				// [3:0], IRQ settings
-static uint16 vrc3_irq_latch = 0;				// [15:0], stores counter reload latch value
+static FCEU_THREAD_LOCAL uint16 vrc3_irq_value = 0;				// [15:0], counter itself (upcounting)
+static FCEU_THREAD_LOCAL uint8 vrc3_irq_control = 0;				// [3:0], IRQ settings
+static FCEU_THREAD_LOCAL uint16 vrc3_irq_latch = 0;				// [15:0], stores counter reload latch value
 // for mapper #42 (only Baby Mario)
-static uint8 mapper42_irq_enabled = 0;			// register to enable/disable counter
-static uint16 mapper42_irq_value = 0;			// [14:0], counter itself (upcounting)
+static FCEU_THREAD_LOCAL uint8 mapper42_irq_enabled = 0;			// register to enable/disable counter
+static FCEU_THREAD_LOCAL uint16 mapper42_irq_value = 0;			// [14:0], counter itself (upcounting)
 // for mapper #83
-static uint8 mapper83_irq_enabled_latch = 0;
-static uint8 mapper83_irq_enabled = 0;
-static uint16 mapper83_irq_counter = 0;
+static FCEU_THREAD_LOCAL uint8 mapper83_irq_enabled_latch = 0;
+static FCEU_THREAD_LOCAL uint8 mapper83_irq_enabled = 0;
+static FCEU_THREAD_LOCAL uint16 mapper83_irq_counter = 0;
 // for mapper #90
-static uint8 mapper90_xor = 0;
+static FCEU_THREAD_LOCAL uint8 mapper90_xor = 0;
 // for mapper #67
-static uint8 mapper67_irq_enabled = 0;
-static uint8 mapper67_irq_latch = 0;
-static uint16 mapper67_irq_counter = 0;
-
-static uint8 flash_state = 0;
-static uint16 flash_buffer_a[10];
-static uint8 flash_buffer_v[10];
-static uint8 cfi_mode = 0;
+static FCEU_THREAD_LOCAL uint8 mapper67_irq_enabled = 0;
+static FCEU_THREAD_LOCAL uint8 mapper67_irq_latch = 0;
+static FCEU_THREAD_LOCAL uint16 mapper67_irq_counter = 0;
+
+static FCEU_THREAD_LOCAL uint8 flash_state = 0;
+static FCEU_THREAD_LOCAL uint16 flash_buffer_a[10];
+static FCEU_THREAD_LOCAL uint8 flash_buffer_v[10];
+static FCEU_THREAD_LOCAL uint8 cfi_mode = 0;
 
 // Micron 4-gbit memory CFI data
 static const uint8 cfi_data[] =
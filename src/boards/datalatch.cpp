@@ -21,12 +21,12 @@
 #include "mapinc.h"
 #include "../ines.h"
 
-static uint8 latche=0, latcheinit=0, bus_conflict=0;
-static uint16 addrreg0=0, addrreg1=0;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
-static void (*WSync)(void) = nullptr;
-static uint8 submapper;
+static FCEU_THREAD_LOCAL uint8 latche=0, latcheinit=0, bus_conflict=0;
+static FCEU_THREAD_LOCAL uint16 addrreg0=0, addrreg1=0;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL void (*WSync)(void) = nullptr;
+static FCEU_THREAD_LOCAL uint8 submapper;
 
 static DECLFW(LatchWrite) {
 //	FCEU_printf("bs %04x %02x\n",A,V);
@@ -488,6 +488,7 @@ void Mapper218_Init(CartInfo *info)
 	};
 	for(int i=0;i<8;i++)
 		VPageR[i] = &NTARAM[mapping[info->mirrorAs2Bits*8+i]];
+	FCEUPPU_InvalidateCHRSlots(0, 8);
 
 	PPUCHRRAM = 0xFF;
 }
@@ -20,7 +20,7 @@
 
 #include "mapinc.h"
 
-static uint8 latche;
+static FCEU_THREAD_LOCAL uint8 latche;
 
 static void Sync(void) {
 	setprg16(0x8000, latche);
@@ -20,10 +20,10 @@
 
 #include "mapinc.h"
 
-static uint16 addrlatch;
-static uint8 datalatch, hw_mode;
+static FCEU_THREAD_LOCAL uint16 addrlatch;
+static FCEU_THREAD_LOCAL uint8 datalatch, hw_mode;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &addrlatch, 2, "ADRL" },
 	{ &datalatch, 1, "DATL" },
@@ -52,6 +52,13 @@
 #include <math.h>
 #include "emu2413.h"
 
+/* FCEUX: tables are per thread in multi-instance builds, see FCEU_THREAD_LOCAL in types.h */
+#if defined(__FCEU_MULTI_INSTANCE__)
+#define FCEU_THREAD_LOCAL _Thread_local
+#else
+#define FCEU_THREAD_LOCAL
+#endif
+
 static const unsigned char default_inst[15][8] = {
 	/* VRC7 instruments, March 15, 2019 dumped by Nuke.YKT */
 	{ 0x03, 0x21, 0x05, 0x06, 0xE8, 0x81, 0x42, 0x27 },
@@ -159,45 +166,45 @@ static const unsigned char default_inst[15][8] = {
 #define BIT(s, b) (((s) >> (b)) & 1)
 
 /* Input clock */
-static uint32 clk = 844451141;
+static FCEU_THREAD_LOCAL uint32 clk = 844451141;
 /* Sampling rate */
-static uint32 rate = 3354932;
+static FCEU_THREAD_LOCAL uint32 rate = 3354932;
 
 /* WaveTable for each envelope amp */
-static uint16 fullsintable[PG_WIDTH];
-static uint16 halfsintable[PG_WIDTH];
+static FCEU_THREAD_LOCAL uint16 fullsintable[PG_WIDTH];
+static FCEU_THREAD_LOCAL uint16 halfsintable[PG_WIDTH];
 
-static uint16 *waveform[2] = { fullsintable, halfsintable };
+static FCEU_THREAD_LOCAL uint16 *waveform[2];
 
 /* LFO Table */
-static int32 pmtable[PM_PG_WIDTH];
-static int32 amtable[AM_PG_WIDTH];
+static FCEU_THREAD_LOCAL int32 pmtable[PM_PG_WIDTH];
+static FCEU_THREAD_LOCAL int32 amtable[AM_PG_WIDTH];
 
 /* Phase delta for LFO */
-static uint32 pm_dphase;
-static uint32 am_dphase;
+static FCEU_THREAD_LOCAL uint32 pm_dphase;
+static FCEU_THREAD_LOCAL uint32 am_dphase;
 
 /* dB to Liner table */
-static int16 DB2LIN_TABLE[(DB_MUTE + DB_MUTE) * 2];
+static FCEU_THREAD_LOCAL int16 DB2LIN_TABLE[(DB_MUTE + DB_MUTE) * 2];
 
 /* Liner to Log curve conversion table (for Attack rate). */
-static uint16 AR_ADJUST_TABLE[1 << EG_BITS];
+static FCEU_THREAD_LOCAL uint16 AR_ADJUST_TABLE[1 << EG_BITS];
 
 /* Definition of envelope mode */
 enum
 { SETTLE, ATTACK, DECAY, SUSHOLD, SUSTINE, RELEASE, FINISH };
 
 /* Phase incr table for Attack */
-static uint32 dphaseARTable[16][16];
+static FCEU_THREAD_LOCAL uint32 dphaseARTable[16][16];
 /* Phase incr table for Decay and Release */
-static uint32 dphaseDRTable[16][16];
+static FCEU_THREAD_LOCAL uint32 dphaseDRTable[16][16];
 
 /* KSL + TL Table */
-static uint32 tllTable[16][8][1 << TL_BITS][4];
-static int32 rksTable[2][8][2];
+static FCEU_THREAD_LOCAL uint32 tllTable[16][8][1 << TL_BITS][4];
+static FCEU_THREAD_LOCAL int32 rksTable[2][8][2];
 
 /* Phase incr table for PG */
-static uint32 dphaseTable[512][8][16];
+static FCEU_THREAD_LOCAL uint32 dphaseTable[512][8][16];
 
 /***************************************************
 
@@ -261,6 +268,9 @@ static void makeSinTable(void) {
 		halfsintable[i] = fullsintable[i];
 	for (i = PG_WIDTH / 2; i < PG_WIDTH; i++)
 		halfsintable[i] = fullsintable[0];
+
+	waveform[0] = fullsintable;
+	waveform[1] = halfsintable;
 }
 
 /* Table for Pitch Modulator */
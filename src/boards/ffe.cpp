@@ -23,13 +23,13 @@
 
 #include "mapinc.h"
 
-static uint8 preg[4], creg[8], latch, ffemode;
-static uint8 IRQa, mirr;
-static int32 IRQCount, IRQLatch;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE;
+static FCEU_THREAD_LOCAL uint8 preg[4], creg[8], latch, ffemode;
+static FCEU_THREAD_LOCAL uint8 IRQa, mirr;
+static FCEU_THREAD_LOCAL int32 IRQCount, IRQLatch;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ preg, 4, "PREG" },
 	{ creg, 8, "CREG" },
@@ -22,11 +22,11 @@
 #include "mmc3.h"
 #include "../ines.h"
 
-static bool is_BMCFK23CA;
-static uint8 unromchr;
-static uint32 dipswitch;
-static uint8 *CHRRAM=NULL;
-static uint32 CHRRAMSize;
+static FCEU_THREAD_LOCAL bool is_BMCFK23CA;
+static FCEU_THREAD_LOCAL uint8 unromchr;
+static FCEU_THREAD_LOCAL uint32 dipswitch;
+static FCEU_THREAD_LOCAL uint8 *CHRRAM=NULL;
+static FCEU_THREAD_LOCAL uint32 CHRRAMSize;
 
 static void BMCFK23CCW(uint32 A, uint8 V)
 {
@@ -51,8 +51,8 @@ static void BMCFK23CCW(uint32 A, uint8 V)
 //some games are wired differently, and this will need to be changed.
 //all the WXN games require prg_bonus = 1, and cah4e3's multicarts require prg_bonus = 0
 //we'll populate this from a game database
-static int prg_bonus;
-static int prg_mask;
+static FCEU_THREAD_LOCAL int prg_bonus;
+static FCEU_THREAD_LOCAL int prg_mask;
 
 //prg_bonus = 0
 //4-in-1 (FK23C8021)[p1][!].nes
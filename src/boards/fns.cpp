@@ -25,14 +25,14 @@
 
 #include "mapinc.h"
 
-static uint8 DRegs[4];
-static uint8 Buffer, BufferShift;
+static FCEU_THREAD_LOCAL uint8 DRegs[4];
+static FCEU_THREAD_LOCAL uint8 Buffer, BufferShift;
 
-static uint32 WRAMSIZE=0;
-static uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
 
-static int kanji_pos, kanji_page, r40C0;
-static int IRQa, IRQCount;
+static FCEU_THREAD_LOCAL int kanji_pos, kanji_page, r40C0;
+static FCEU_THREAD_LOCAL int IRQa, IRQCount;
 
 FCEU_MAYBE_UNUSED
 static DECLFW(MBWRAM) {
@@ -83,7 +83,7 @@ static void MMC1MIRROR(void) {
 	}
 }
 
-static uint64 lreset;
+static FCEU_THREAD_LOCAL uint64 lreset;
 static DECLFW(MMC1_write) {
 	int n = (A >> 13) - 4;
 	if ((timestampbase + timestamp) < (lreset + 2))
@@ -20,9 +20,9 @@
 
 #include "mapinc.h"
 
-static uint8 regs[2];
+static FCEU_THREAD_LOCAL uint8 regs[2];
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ regs, 2, "REGS" },
 	{ 0 }
@@ -20,8 +20,8 @@
 
 #include "mapinc.h"
 
-extern uint32 ROM_size;
-static uint8 latche;
+extern FCEU_THREAD_LOCAL uint32 ROM_size;
+static FCEU_THREAD_LOCAL uint8 latche;
 
 static void Sync(void) {
 	if (latche) {
@@ -26,9 +26,9 @@
 
 #include "mapinc.h"
 
-static uint8 preg;
+static FCEU_THREAD_LOCAL uint8 preg;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &preg, 1, "PREG" },
 	{ 0 }
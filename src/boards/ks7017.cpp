@@ -23,12 +23,12 @@
 
 #include "mapinc.h"
 
-static uint8 reg, mirr;
-static int32 IRQa, IRQCount, IRQLatch;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE;
+static FCEU_THREAD_LOCAL uint8 reg, mirr;
+static FCEU_THREAD_LOCAL int32 IRQa, IRQCount, IRQLatch;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &mirr, 1, "MIRR" },
 	{ &reg, 1, "REGS" },
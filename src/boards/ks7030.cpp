@@ -27,11 +27,11 @@
 
 #include "mapinc.h"
 
-static uint8 reg0, reg1;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE;
+static FCEU_THREAD_LOCAL uint8 reg0, reg1;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &reg0, 1, "REG0" },
 	{ &reg1, 1, "REG1" },
@@ -20,10 +20,10 @@
 
 #include "mapinc.h"
 
-static uint8 reg[8], cmd, IRQa = 0, isirqused = 0;
-static int32 IRQCount;
+static FCEU_THREAD_LOCAL uint8 reg[8], cmd, IRQa = 0, isirqused = 0;
+static FCEU_THREAD_LOCAL int32 IRQCount;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &cmd, 1, "CMD" },
 	{ reg, 8, "REGS" },
@@ -23,13 +23,13 @@
 
 #include "mapinc.h"
 
-static uint8 reg[8], cmd;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE;
+static FCEU_THREAD_LOCAL uint8 reg[8], cmd;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
 
-static void (*WSync)(void);
+static FCEU_THREAD_LOCAL void (*WSync)(void);
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &cmd, 1, "CMD" },
 	{ reg, 8, "REGS" },
@@ -23,12 +23,12 @@
 
 #include "mapinc.h"
 
-static uint8 reg, IRQa;
-static int32 IRQCount;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE;
+static FCEU_THREAD_LOCAL uint8 reg, IRQa;
+static FCEU_THREAD_LOCAL int32 IRQCount;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &reg, 1, "REG" },
 	{ &IRQa, 1, "IRQA" },
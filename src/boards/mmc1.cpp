@@ -24,18 +24,18 @@
 static void GenMMC1Power(void);
 static void GenMMC1Init(CartInfo *info, int prg, int chr, int wram, int bram);
 
-static uint8 DRegs[4];
-static uint8 Buffer, BufferShift;
+static FCEU_THREAD_LOCAL uint8 DRegs[4];
+static FCEU_THREAD_LOCAL uint8 Buffer, BufferShift;
 
-static uint32 WRAMSIZE;
-static uint32 NONBRAMSIZE; // size of non-battery-backed portion of WRAM
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
+static FCEU_THREAD_LOCAL uint32 NONBRAMSIZE; // size of non-battery-backed portion of WRAM
 
-static void (*MMC1CHRHook4)(uint32 A, uint8 V);
-static void (*MMC1PRGHook16)(uint32 A, uint8 V);
+static FCEU_THREAD_LOCAL void (*MMC1CHRHook4)(uint32 A, uint8 V);
+static FCEU_THREAD_LOCAL void (*MMC1PRGHook16)(uint32 A, uint8 V);
 
-static uint8 *WRAM = NULL;
-static uint8 *CHRRAM = NULL;
-static int is155, is171;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint8 *CHRRAM = NULL;
+static FCEU_THREAD_LOCAL int is155, is171;
 
 static DECLFW(MBWRAM) {
 	if (!(DRegs[3] & 0x10) || is155)
@@ -121,7 +121,7 @@ static void MMC1MIRROR(void) {
 		}
 }
 
-static uint64 lreset;
+static FCEU_THREAD_LOCAL uint64 lreset;
 static DECLFW(MMC1_write) {
 	int n = (A >> 13) - 4;
 
@@ -215,8 +215,8 @@ static int DetectMMC1WRAMSize(CartInfo *info, int *bs) {
 	return ws;
 }
 
-static uint32 NWCIRQCount;
-static uint8 NWCRec;
+static FCEU_THREAD_LOCAL uint32 NWCIRQCount;
+static FCEU_THREAD_LOCAL uint8 NWCRec;
 #define NWCDIP 0xE
 
 static void NWCIRQHook(int a) {
@@ -22,12 +22,12 @@
 
 #include "mapinc.h"
 
-static uint8 is10;
-static uint8 creg[4], latch0, latch1, preg, mirr;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 is10;
+static FCEU_THREAD_LOCAL uint8 creg[4], latch0, latch1, preg, mirr;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ creg, 4, "CREG" },
 	{ &preg, 1, "PREG" },
@@ -27,24 +27,24 @@
 #include "mapinc.h"
 #include "mmc3.h"
 
-uint8 MMC3_cmd;
-uint8 kt_extra;
-uint8 *WRAM;
-uint32 WRAMSIZE;
-uint8 *CHRRAM;
-uint32 CHRRAMSIZE;
-uint8 DRegBuf[8];
-uint8 EXPREGS[8];	/* For bootleg games, mostly. */
-uint8 A000B, A001B;
-uint8 mmc3opts = 0;
+FCEU_THREAD_LOCAL uint8 MMC3_cmd;
+FCEU_THREAD_LOCAL uint8 kt_extra;
+FCEU_THREAD_LOCAL uint8 *WRAM;
+FCEU_THREAD_LOCAL uint32 WRAMSIZE;
+FCEU_THREAD_LOCAL uint8 *CHRRAM;
+FCEU_THREAD_LOCAL uint32 CHRRAMSIZE;
+FCEU_THREAD_LOCAL uint8 DRegBuf[8];
+FCEU_THREAD_LOCAL uint8 EXPREGS[8];	/* For bootleg games, mostly. */
+FCEU_THREAD_LOCAL uint8 A000B, A001B;
+FCEU_THREAD_LOCAL uint8 mmc3opts = 0;
 
 #undef IRQCount
 #undef IRQLatch
 #undef IRQa
-uint8 IRQCount, IRQLatch, IRQa;
-uint8 IRQReload;
+FCEU_THREAD_LOCAL uint8 IRQCount, IRQLatch, IRQa;
+FCEU_THREAD_LOCAL uint8 IRQReload;
 
-static SFORMAT MMC3_StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT MMC3_StateRegs[] =
 {
 	{ DRegBuf, 8, "REGS" },
 	{ &MMC3_cmd, 1, "CMD" },
@@ -57,11 +57,11 @@ static SFORMAT MMC3_StateRegs[] =
 	{ 0 }
 };
 
-static int isRevB = 1;
+static FCEU_THREAD_LOCAL int isRevB = 1;
 
-void (*pwrap)(uint32 A, uint8 V);
-void (*cwrap)(uint32 A, uint8 V);
-void (*mwrap)(uint8 V);
+FCEU_THREAD_LOCAL void (*pwrap)(uint32 A, uint8 V);
+FCEU_THREAD_LOCAL void (*cwrap)(uint32 A, uint8 V);
+FCEU_THREAD_LOCAL void (*mwrap)(uint8 V);
 
 void GenMMC3Power(void);
 void FixMMC3PRG(int V);
@@ -352,7 +352,7 @@ void GenMMC3_Init(CartInfo *info, int prg, int chr, int wram, int battery) {
 
 // ---------------------------- Mapper 4 --------------------------------
 
-static int hackm4 = 0;	/* For Karnov, maybe others.  BLAH.  Stupid iNES format.*/
+static FCEU_THREAD_LOCAL int hackm4 = 0;	/* For Karnov, maybe others.  BLAH.  Stupid iNES format.*/
 
 static void M4Power(void) {
 	GenMMC3Power();
@@ -725,8 +725,8 @@ void Mapper74_Init(CartInfo *info) {
 
 // ---------------------------- Mapper 114 ------------------------------
 
-static uint8 cmdin;
-uint8 m114_perm[8] = { 0, 3, 1, 5, 6, 7, 2, 4 };
+static FCEU_THREAD_LOCAL uint8 cmdin;
+FCEU_THREAD_LOCAL uint8 m114_perm[8] = { 0, 3, 1, 5, 6, 7, 2, 4 };
 
 static void M114PWRAP(uint32 A, uint8 V) {
 	if (EXPREGS[0] & 0x80) {
@@ -827,8 +827,8 @@ void Mapper115_Init(CartInfo *info) {
 
 // ---------------------------- Mapper 118 ------------------------------
 
-static uint8 PPUCHRBus;
-static uint8 TKSMIR[8];
+static FCEU_THREAD_LOCAL uint8 PPUCHRBus;
+static FCEU_THREAD_LOCAL uint8 TKSMIR[8];
 
 static void TKSPPU(uint32 A) {
 	A &= 0x1FFF;
@@ -1,19 +1,19 @@
-extern uint8 MMC3_cmd;
-extern uint8 mmc3opts;
-extern uint8 A000B;
-extern uint8 A001B;
-extern uint8 EXPREGS[8];
-extern uint8 DRegBuf[8];
+extern FCEU_THREAD_LOCAL uint8 MMC3_cmd;
+extern FCEU_THREAD_LOCAL uint8 mmc3opts;
+extern FCEU_THREAD_LOCAL uint8 A000B;
+extern FCEU_THREAD_LOCAL uint8 A001B;
+extern FCEU_THREAD_LOCAL uint8 EXPREGS[8];
+extern FCEU_THREAD_LOCAL uint8 DRegBuf[8];
 
 #undef IRQCount
 #undef IRQLatch
 #undef IRQa
-extern uint8 IRQCount,IRQLatch,IRQa;
-extern uint8 IRQReload;
+extern FCEU_THREAD_LOCAL uint8 IRQCount,IRQLatch,IRQa;
+extern FCEU_THREAD_LOCAL uint8 IRQReload;
 
-extern void (*pwrap)(uint32 A, uint8 V);
-extern void (*cwrap)(uint32 A, uint8 V);
-extern void (*mwrap)(uint8 V);
+extern FCEU_THREAD_LOCAL void (*pwrap)(uint32 A, uint8 V);
+extern FCEU_THREAD_LOCAL void (*cwrap)(uint32 A, uint8 V);
+extern FCEU_THREAD_LOCAL void (*mwrap)(uint8 V);
 
 void GenMMC3Power(void);
 void GenMMC3Restore(int version);
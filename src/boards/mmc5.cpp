@@ -31,11 +31,12 @@
 #define PPUON       (PPU[1] & 0x18)	//PPU should operate
 #define Sprite16    (PPU[0] & 0x20)	//Sprites 8x16/8x8
 
-static void (*sfun)(int P);
-static void (*psfun)(void);
+static FCEU_THREAD_LOCAL void (*sfun)(int P);
+static FCEU_THREAD_LOCAL void (*psfun)(void);
 
 void MMC5RunSound(int Count);
 void MMC5RunSoundHQ(void);
+void MMC5RunSoundStep(void);
 
 static INLINE void MMC5SPRVROM_BANK1(uint32 A, uint32 V) {
 	if (CHRptr[0]) {
@@ -83,33 +84,33 @@ static INLINE void MMC5BGVROM_BANK8(uint32 V) {
 	}
 }
 
-static std::array<uint8,4> PRGBanks;
-static uint8 WRAMPage;
-static std::array<uint16,8> CHRBanksA;
-static std::array<uint16,4> CHRBanksB;
-static std::array<uint8,2> WRAMMaskEnable;
-uint8 mmc5ABMode;                /* A=0, B=1 */
+static FCEU_THREAD_LOCAL std::array<uint8,4> PRGBanks;
+static FCEU_THREAD_LOCAL uint8 WRAMPage;
+static FCEU_THREAD_LOCAL std::array<uint16,8> CHRBanksA;
+static FCEU_THREAD_LOCAL std::array<uint16,4> CHRBanksB;
+static FCEU_THREAD_LOCAL std::array<uint8,2> WRAMMaskEnable;
+FCEU_THREAD_LOCAL uint8 mmc5ABMode;                /* A=0, B=1 */
 
-static uint8 IRQScanline, IRQEnable;
-static uint8 CHRMode, NTAMirroring, NTFill, ATFill;
+static FCEU_THREAD_LOCAL uint8 IRQScanline, IRQEnable;
+static FCEU_THREAD_LOCAL uint8 CHRMode, NTAMirroring, NTFill, ATFill;
 
-static uint8 MMC5IRQR;
-static uint8 MMC5LineCounter;
-static uint8 mmc5psize, mmc5vsize;
-static std::array<uint8,2> mul;
+static FCEU_THREAD_LOCAL uint8 MMC5IRQR;
+static FCEU_THREAD_LOCAL uint8 MMC5LineCounter;
+static FCEU_THREAD_LOCAL uint8 mmc5psize, mmc5vsize;
+static FCEU_THREAD_LOCAL std::array<uint8,2> mul;
 
-static uint32 WRAMSIZE = 0;
-static uint8 *WRAM = NULL;
-static uint8 *MMC5fill = NULL;
-static uint8 *ExRAM = NULL;
-static uint8 MMC5battery = 0;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE = 0;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint8 *MMC5fill = NULL;
+static FCEU_THREAD_LOCAL uint8 *ExRAM = NULL;
+static FCEU_THREAD_LOCAL uint8 MMC5battery = 0;
 
 const int MMC5WRAMMAX = 1<<7; // 7 bits in register interface (real MMC5 has only 4 pins, however)
-static uint8 MMC5WRAMsize=0; //configuration, not state
-static uint8 MMC5WRAMIndex[MMC5WRAMMAX]; //configuration, not state
+static FCEU_THREAD_LOCAL uint8 MMC5WRAMsize=0; //configuration, not state
+static FCEU_THREAD_LOCAL uint8 MMC5WRAMIndex[MMC5WRAMMAX]; //configuration, not state
 
-static std::array<uint8,4> MMC5ROMWrProtect;
-static std::array<uint8,5> MMC5MemIn;
+static FCEU_THREAD_LOCAL std::array<uint8,4> MMC5ROMWrProtect;
+static FCEU_THREAD_LOCAL std::array<uint8,5> MMC5MemIn;
 
 static void MMC5CHRA(void);
 static void MMC5CHRB(void);
@@ -150,8 +151,8 @@ uint8* MMC5BGVRAMADR(uint32 A)
 
 static void mmc5_PPUWrite(uint32 A, uint8 V) {
 	uint32 tmp = A;
-	extern uint8 PALRAM[0x20];
-	extern uint8 UPALRAM[0x03];
+	extern FCEU_THREAD_LOCAL uint8 PALRAM[0x20];
+	extern FCEU_THREAD_LOCAL uint8 UPALRAM[0x03];
 
 	if (tmp >= 0x3F00) {
 		if (!(tmp & 3)) {
@@ -164,15 +165,19 @@ static void mmc5_PPUWrite(uint32 A, uint8 V) {
 		} else
 			PALRAM[tmp & 0x1F] = V & 0x3F;
 	} else if (tmp < 0x2000) {
-		if (PPUCHRRAM & (1 << (tmp >> 10)))
+		if (PPUCHRRAM & (1 << (tmp >> 10))) {
 			VPage[tmp >> 10][tmp] = V;
+			FCEUPPU_InvalidateCHR(tmp);
+		}
 	} else {
-		if (PPUNTARAM & (1 << ((tmp & 0xF00) >> 10)))
+		if (PPUNTARAM & (1 << ((tmp & 0xF00) >> 10))) {
 			vnapage[((tmp & 0xF00) >> 10)][tmp & 0x3FF] = V;
+			FCEUPPU_InvalidateNametable(vnapage[((tmp & 0xF00) >> 10)], tmp);
+		}
 	}
 }
 
-extern uint32 NTRefreshAddr;
+extern FCEU_THREAD_LOCAL uint32 NTRefreshAddr;
 uint8 FASTCALL mmc5_PPURead(uint32 A)
 {
 	bool split = false;
@@ -275,7 +280,7 @@ uint8 FASTCALL mmc5_PPURead(uint32 A)
 	}
 }
 
-cartdata MMC5CartList[] =
+FCEU_THREAD_LOCAL cartdata MMC5CartList[] =
 {
 	{ 0x6f4e4312, 4 }, /* Aoki Ookami to Shiroki Mejika - Genchou Hishi */
 	{ 0x15fe6d0f, 2 }, /* Bandit Kings of Ancient China */
@@ -707,7 +712,15 @@ typedef struct {
 	int32 vcount[2];
 } MMC5APU;
 
-static MMC5APU MMC5Sound;
+static FCEU_THREAD_LOCAL MMC5APU MMC5Sound;
+static FCEU_THREAD_LOCAL int32 MMC5StepOut[3];
+
+static INLINE void MMC5Step(int x, int32 t, int32 out) {
+	if (out != MMC5StepOut[x]) {
+		StepSynthAdd(t, out - MMC5StepOut[x]);
+		MMC5StepOut[x] = out;
+	}
+}
 
 
 static void Do5PCM() {
@@ -732,12 +745,18 @@ static void Do5PCMHQ() {
 	MMC5Sound.BC[2] = SOUNDTS;
 }
 
+static void Do5PCMStep() {
+	MMC5Step(2, MMC5Sound.BC[2], (MMC5Sound.rawcontrol & 0x40) ? 0 : MMC5Sound.raw << 5);
+	MMC5Sound.BC[2] = SOUNDTS;
+}
+
 
 static DECLFW(Mapper5_SW) {
 	A &= 0x1F;
 
 	GameExpSound.Fill = MMC5RunSound;
 	GameExpSound.HiFill = MMC5RunSoundHQ;
+	GameExpSound.StepFill = MMC5RunSoundStep;
 
 	switch (A) {
 	case 0x10: if (psfun) psfun(); MMC5Sound.rawcontrol = V; break;
@@ -772,7 +791,7 @@ static DECLFW(Mapper5_SW) {
 }
 
 static void Do5SQ(int P) {
-	static int tal[4] = { 1, 2, 4, 6 };
+	static FCEU_THREAD_LOCAL int tal[4] = { 1, 2, 4, 6 };
 	int32 V, amp, rthresh, wl;
 	int32 start, end;
 
@@ -807,7 +826,7 @@ static void Do5SQ(int P) {
 }
 
 static void Do5SQHQ(int P) {
-	static int tal[4] = { 1, 2, 4, 6 };
+	static FCEU_THREAD_LOCAL int tal[4] = { 1, 2, 4, 6 };
 	uint32 V;
 	int32 amp, rthresh, wl;
 
@@ -837,6 +856,63 @@ static void Do5SQHQ(int P) {
 	MMC5Sound.BC[P] = SOUNDTS;
 }
 
+// Step synthesis: Do5SQHQ reporting only where the output changes.
+static void Do5SQStep(int P) {
+	static FCEU_THREAD_LOCAL int tal[4] = { 1, 2, 4, 6 };
+	int32 t = MMC5Sound.BC[P], end = SOUNDTS;
+	int32 amp, rthresh, wl;
+
+	wl = MMC5Sound.wl[P] + 1;
+	amp = ((MMC5Sound.env[P] & 0xF) << 8);
+	rthresh = tal[(MMC5Sound.env[P] & 0xC0) >> 6];
+
+	if (wl >= 8 && (MMC5Sound.running & (P + 1))) {
+		int32 dc, vc;
+
+		wl <<= 1;
+
+		dc = MMC5Sound.dcount[P];
+		vc = MMC5Sound.vcount[P];
+		if (vc < 1) /* Reloads on the next cycle, the same as 1. */
+			vc = 1;
+		for (;;) {
+			int32 n;
+
+			// Duty steps until the output flips, then the cycles to get there.
+			if (dc < rthresh) {
+				MMC5Step(P, t, amp);
+				n = rthresh - dc;
+			} else {
+				MMC5Step(P, t, 0);
+				n = 8 - dc;
+			}
+			n = vc + (n - 1) * wl;
+			if (t + n > end)
+				n = end - t;
+			t += n;
+			if (n < vc)
+				vc -= n;
+			else {
+				n -= vc;
+				dc = (dc + 1 + n / wl) & 7;
+				vc = wl - n % wl;
+			}
+			if (t >= end)
+				break;
+		}
+		MMC5Sound.dcount[P] = dc;
+		MMC5Sound.vcount[P] = vc;
+	} else
+		MMC5Step(P, t, 0);
+	MMC5Sound.BC[P] = SOUNDTS;
+}
+
+void MMC5RunSoundStep(void) {
+	Do5SQStep(0);
+	Do5SQStep(1);
+	Do5PCMStep();
+}
+
 void MMC5RunSoundHQ(void) {
 	Do5SQHQ(0);
 	Do5SQHQ(1);
@@ -861,7 +937,10 @@ void MMC5RunSound(int Count) {
 void Mapper5_ESI(void) {
 	GameExpSound.RChange = Mapper5_ESI;
 	if (FSettings.SndRate) {
-		if (FSettings.soundq >= 1) {
+		if (FSettings.soundq >= 1 && FSettings.stepsynth) {
+			sfun = Do5SQStep;
+			psfun = Do5PCMStep;
+		} else if (FSettings.soundq >= 1) {
 			sfun = Do5SQHQ;
 			psfun = Do5PCMHQ;
 		} else {
@@ -874,6 +953,7 @@ void Mapper5_ESI(void) {
 	}
 	memset(MMC5Sound.BC, 0, sizeof(MMC5Sound.BC));
 	memset(MMC5Sound.vcount, 0, sizeof(MMC5Sound.vcount));
+	memset(MMC5StepOut, 0, sizeof(MMC5StepOut));
 	GameExpSound.HiSync = MMC5HiSync;
 }
 
@@ -951,7 +1031,7 @@ static void GenMMC5Power(void) {
 	FCEU_CheatAddRAM(1, 0x5c00, ExRAM);
 }
 
-static SFORMAT MMC5_StateRegs[] = {
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT MMC5_StateRegs[] = {
 	{ &PRGBanks, 4, "PRGB" },
 	{ &CHRBanksA, 16, "CHRA" },
 	{ &CHRBanksB, 8, "CHRB" },
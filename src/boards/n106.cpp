@@ -20,11 +20,11 @@
 
 #include "mapinc.h"
 
-static uint16 IRQCount;
-static uint8 IRQa;
+static FCEU_THREAD_LOCAL uint16 IRQCount;
+static FCEU_THREAD_LOCAL uint8 IRQa;
 
-static uint8 WRAM[8192];
-static uint8 IRAM[128];
+static FCEU_THREAD_LOCAL uint8 WRAM[8192];
+static FCEU_THREAD_LOCAL uint8 IRAM[128];
 
 static DECLFR(AWRAM) {
 	return(WRAM[A - 0x6000]);
@@ -36,24 +36,25 @@ static DECLFW(BWRAM) {
 
 void Mapper19_ESI(void);
 
-static uint8 NTAPage[4];
+static FCEU_THREAD_LOCAL uint8 NTAPage[4];
 
-static uint8 dopol;
-static uint8 gorfus;
-static uint8 gorko;
+static FCEU_THREAD_LOCAL uint8 dopol;
+static FCEU_THREAD_LOCAL uint8 gorfus;
+static FCEU_THREAD_LOCAL uint8 gorko;
 
 static void NamcoSound(int Count);
 static void NamcoSoundHack(void);
 static void DoNamcoSound(int32 *Wave, int Count);
 static void DoNamcoSoundHQ(void);
+static void DoNamcoSoundStep(void);
 static void SyncHQ(int32 ts);
 
-static int is210;        /* Lesser mapper. */
+static FCEU_THREAD_LOCAL int is210;        /* Lesser mapper. */
 
-static uint8 PRG[3];
-static uint8 CHR[8];
+static FCEU_THREAD_LOCAL uint8 PRG[3];
+static FCEU_THREAD_LOCAL uint8 CHR[8];
 
-static SFORMAT N106_StateRegs[] = {
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT N106_StateRegs[] = {
 	{ PRG, 3, "PRG" },
 	{ CHR, 8, "CHR" },
 	{ NTAPage, 4, "NTA" },
@@ -92,6 +93,12 @@ static void NamcoIRQHook(int a) {
 	}
 }
 
+static int32 NamcoIRQNext(void) {
+	if (!IRQa)
+		return X6502_MAX_EVENT_CYCLES;
+	return 0x7FFF - IRQCount;
+}
+
 static DECLFR(Namco_Read4800) {
 	uint8 ret = IRAM[dopol & 0x7f];
 	/* Maybe I should call NamcoSoundHack() here? */
@@ -146,9 +153,9 @@ static DECLFW(Mapper19C0D8_write) {
 	DoNTARAMROM((A - 0xC000) >> 11, V);
 }
 
-static uint32 FreqCache[8];
-static uint32 EnvCache[8];
-static uint32 LengthCache[8];
+static FCEU_THREAD_LOCAL uint32 FreqCache[8];
+static FCEU_THREAD_LOCAL uint32 EnvCache[8];
+static FCEU_THREAD_LOCAL uint32 LengthCache[8];
 
 static void FixCache(int a, int V) {
 	int w = (a >> 3) & 0x7;
@@ -178,6 +185,7 @@ static DECLFW(Mapper19_write) {
 					NamcoSoundHack();
 					GameExpSound.Fill = NamcoSound;
 					GameExpSound.HiFill = DoNamcoSoundHQ;
+					GameExpSound.StepFill = DoNamcoSoundStep;
 					GameExpSound.HiSync = SyncHQ;
 				}
 				FixCache(dopol, V);
@@ -216,12 +224,15 @@ static DECLFW(Mapper19_write) {
 		}
 }
 
-static int dwave = 0;
+static FCEU_THREAD_LOCAL int dwave = 0;
 
 static void NamcoSoundHack(void) {
 	int32 z, a;
 	if (FSettings.soundq >= 1) {
-		DoNamcoSoundHQ();
+		if (FSettings.stepsynth)
+			DoNamcoSoundStep();
+		else
+			DoNamcoSoundHQ();
 		return;
 	}
 	z = ((SOUNDTS << 16) / soundtsinc) >> 4;
@@ -238,9 +249,10 @@ static void NamcoSound(int Count) {
 	dwave = 0;
 }
 
-static uint32 PlayIndex[8];
-static int32 vcount[8];
-static int32 CVBC;
+static FCEU_THREAD_LOCAL uint32 PlayIndex[8];
+static FCEU_THREAD_LOCAL int32 vcount[8];
+static FCEU_THREAD_LOCAL int32 CVBC;
+static FCEU_THREAD_LOCAL int32 StepOut[8];
 
 #define TOINDEX        (16 + 1)
 
@@ -300,6 +312,53 @@ static void DoNamcoSoundHQ(void) {
 	CVBC = SOUNDTS;
 }
 
+// Step synthesis.  DoNamcoSoundHQ adds a channel's output to WaveHi every
+// half cycle, so a change at an odd half cycle is half in one cycle and half
+// in the next.
+static INLINE void NamcoStep(int32 P, int32 H, int32 duff2) {
+	int32 d = duff2 - StepOut[P];
+
+	if (d) {
+		if (H & 1) {
+			StepSynthAdd(H >> 1, d);
+			StepSynthAdd((H >> 1) + 1, d);
+		} else
+			StepSynthAdd(H >> 1, d * 2);
+		StepOut[P] = duff2;
+	}
+}
+
+static void DoNamcoSoundStep(void) {
+	int32 P, H, end = SOUNDTS << 1;
+	int32 cyclesuck = (((IRAM[0x7F] >> 4) & 7) + 1) * 15;
+
+	for (P = 7; P >= 0; P--) {
+		H = CVBC << 1;
+		if (P >= (7 - ((IRAM[0x7F] >> 4) & 7)) && (IRAM[0x44 + (P << 3)] & 0xE0) && (IRAM[0x47 + (P << 3)] & 0xF)) {
+			uint32 freq, lengo, envelope;
+			int32 vco;
+
+			vco = vcount[P] < 0 ? 0 : vcount[P];
+			freq = FreqCache[P];
+			envelope = EnvCache[P];
+			lengo = LengthCache[P];
+
+			NamcoStep(P, H, FetchDuff(P, envelope));
+			// The half cycle where vco runs out still plays the old sample.
+			while (H + vco < end) {
+				H += vco + 1;
+				PlayIndex[P] += freq;
+				while ((PlayIndex[P] >> TOINDEX) >= lengo) PlayIndex[P] -= lengo << TOINDEX;
+				NamcoStep(P, H, FetchDuff(P, envelope));
+				vco = cyclesuck - 1;
+			}
+			vcount[P] = vco - (end - H);
+		} else
+			NamcoStep(P, H, 0);
+	}
+	CVBC = SOUNDTS;
+}
+
 
 static void DoNamcoSound(int32 *Wave, int Count) {
 	int P, V;
@@ -369,6 +428,7 @@ void Mapper19_ESI(void) {
 	memset(vcount, 0, sizeof(vcount));
 	memset(PlayIndex, 0, sizeof(PlayIndex));
 	CVBC = 0;
+	memset(StepOut, 0, sizeof(StepOut));
 }
 
 void NSFN106_Init(void) {
@@ -378,7 +438,7 @@ void NSFN106_Init(void) {
 	Mapper19_ESI();
 }
 
-static int battery = 0;
+static FCEU_THREAD_LOCAL int battery = 0;
 
 static void N106_Power(void) {
 	int x;
@@ -416,6 +476,7 @@ void Mapper19_Init(CartInfo *info) {
 	info->Power = N106_Power;
 
 	MapIRQHook = NamcoIRQHook;
+	MapIRQHookNext = NamcoIRQNext;
 	GameStateRestore = Mapper19_StateRestore;
 	GameExpSound.RChange = M19SC;
 
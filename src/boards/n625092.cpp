@@ -24,9 +24,9 @@
 
 #include "mapinc.h"
 
-static uint16 cmd, bank;
+static FCEU_THREAD_LOCAL uint16 cmd, bank;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &cmd, 2, "CMD" },
 	{ &bank, 2, "BANK" },
@@ -50,7 +50,7 @@ static void Sync(void) {
 	}
 }
 
-static uint16 ass = 0;
+static FCEU_THREAD_LOCAL uint16 ass = 0;
 
 static DECLFW(UNLN625092WriteCommand) {
 	cmd = A;
@@ -20,17 +20,17 @@
 
 #include "mapinc.h"
 
-static uint8 preg[8];
-static uint8 IRQa;
-static int16 IRQCount, IRQLatch;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 preg[8];
+static FCEU_THREAD_LOCAL uint8 IRQa;
+static FCEU_THREAD_LOCAL int16 IRQCount, IRQLatch;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
 /*
 static uint8 *CHRRAM = NULL;
 static uint32 CHRRAMSIZE;
 */
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ preg, 8, "PREG" },
 	{ &IRQa, 1, "IRQA" },
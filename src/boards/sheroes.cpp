@@ -21,8 +21,8 @@
 #include "mapinc.h"
 #include "mmc3.h"
 
-static uint8 *CHRRAM;
-static uint8 tekker;
+static FCEU_THREAD_LOCAL uint8 *CHRRAM;
+static FCEU_THREAD_LOCAL uint8 tekker;
 
 static void MSHCW(uint32 A, uint8 V) {
 	if (EXPREGS[0] & 0x40)
@@ -21,8 +21,8 @@
 #include "mapinc.h"
 #include "mmc3.h"
 
-static uint8 chrcmd[8], prg0, prg1, bbrk, mirr, swap;
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL uint8 chrcmd[8], prg0, prg1, bbrk, mirr, swap;
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ chrcmd, 8, "CHRC" },
 	{ &prg0, 1, "PRG0" },
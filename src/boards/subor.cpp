@@ -20,9 +20,9 @@
 
 #include "mapinc.h"
 
-static uint8 is167, regs[4];
+static FCEU_THREAD_LOCAL uint8 is167, regs[4];
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ regs, 4, "DREG" },
 	{ 0 }
@@ -21,8 +21,8 @@
 #include "mapinc.h"
 #include "mmc3.h"
 
-static uint8 *CHRRAM = NULL;
-static int masko8[8] = { 63, 31, 15, 1, 3, 0, 0, 0 };
+static FCEU_THREAD_LOCAL uint8 *CHRRAM = NULL;
+static FCEU_THREAD_LOCAL int masko8[8] = { 63, 31, 15, 1, 3, 0, 0, 0 };
 
 static void Super24PW(uint32 A, uint8 V) {
 	uint32 NV = V & masko8[EXPREGS[0] & 7];
@@ -20,8 +20,8 @@
 
 #include "mapinc.h"
 
-static uint8 cmd0, cmd1;
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL uint8 cmd0, cmd1;
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &cmd0, 1, "L1" },
 	{ &cmd1, 1, "L2" },
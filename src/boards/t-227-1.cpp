@@ -23,7 +23,7 @@
 #include "mapinc.h"
 #include "mmc3.h"
 
-static uint8 reset_flag = 0x07;
+static FCEU_THREAD_LOCAL uint8 reset_flag = 0x07;
 
 static void BMCT2271CW(uint32 A, uint8 V) {
 	uint32 va = V;
@@ -20,10 +20,10 @@
 
 #include "mapinc.h"
 
-static uint8 cmd, mirr, regs[11];
-static uint8 rmode, IRQmode, IRQCount, IRQa, IRQLatch;
+static FCEU_THREAD_LOCAL uint8 cmd, mirr, regs[11];
+static FCEU_THREAD_LOCAL uint8 rmode, IRQmode, IRQCount, IRQa, IRQLatch;
 
-static SFORMAT StateRegs[] = {
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] = {
 	{ regs, 11, "REGS" },
 	{ &cmd, 1, "CMDR" },
 	{ &mirr, 1, "MIRR" },
@@ -36,7 +36,7 @@ static SFORMAT StateRegs[] = {
 };
 
 static void M64IRQHook(int a) {
-	static int32 smallcount;
+	static FCEU_THREAD_LOCAL int32 smallcount;
 	if (IRQmode) {
 		smallcount += a;
 		while (smallcount >= 4) {
@@ -22,13 +22,13 @@
 
 #include "mapinc.h"
 
-static uint8 prg0, prg1, mirr, swap;
-static uint8 chr[8];
-static uint8 IRQCount;
-static uint8 IRQPre;
-static uint8 IRQa;
+static FCEU_THREAD_LOCAL uint8 prg0, prg1, mirr, swap;
+static FCEU_THREAD_LOCAL uint8 chr[8];
+static FCEU_THREAD_LOCAL uint8 IRQCount;
+static FCEU_THREAD_LOCAL uint8 IRQPre;
+static FCEU_THREAD_LOCAL uint8 IRQa;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &prg0, 1, "PRG0" },
 	{ &prg0, 1, "PRG1" },
@@ -20,13 +20,13 @@
 
 #include "mapinc.h"
 
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
 
 unsigned int *GetKeyboard(void);	// FIXME: 10/28 - now implemented in SDL as well.  should we rename this to a FCEUI_* function?
 
-static unsigned int *TransformerKeys, oldkeys[256];
-static int TransformerCycleCount, TransformerChar = 0;
+static FCEU_THREAD_LOCAL unsigned int *TransformerKeys, oldkeys[256];
+static FCEU_THREAD_LOCAL int TransformerCycleCount, TransformerChar = 0;
 
 static void TransformerIRQHook(int a) {
 	TransformerCycleCount += a;
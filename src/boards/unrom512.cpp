@@ -42,12 +42,12 @@ const int FLASH_CHIP = 0x11;
 
 const int FLASH_SECTOR_SIZE = 4 * 1024;
 
-static uint8 flash_save, flash_state, flash_id_mode, latche, bus_conflict;
-static uint16 latcha;
-static uint8 *flash_data;
-static uint16 flash_buffer_a[10];
-static uint8 flash_buffer_v[10];
-static uint8 flash_id[2];
+static FCEU_THREAD_LOCAL uint8 flash_save, flash_state, flash_id_mode, latche, bus_conflict;
+static FCEU_THREAD_LOCAL uint16 latcha;
+static FCEU_THREAD_LOCAL uint8 *flash_data;
+static FCEU_THREAD_LOCAL uint16 flash_buffer_a[10];
+static FCEU_THREAD_LOCAL uint8 flash_buffer_v[10];
+static FCEU_THREAD_LOCAL uint8 flash_id[2];
 
 static void UNROM512_Sync() {
 	int chip;
@@ -20,19 +20,19 @@
 
 #include "mapinc.h"
 
-static bool isPirate;
-static uint8 is22, reg1mask, reg2mask;
-static uint16 IRQCount;
-static uint8 IRQLatch, IRQa, IRQMode;
-static uint8 prgreg[2], chrreg[8];
-static uint16 chrhi[8];
-static uint8 regcmd, irqcmd, mirr, big_bank;
-static uint16 acount = 0;
-
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE;
-
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL bool isPirate;
+static FCEU_THREAD_LOCAL uint8 is22, reg1mask, reg2mask;
+static FCEU_THREAD_LOCAL uint16 IRQCount;
+static FCEU_THREAD_LOCAL uint8 IRQLatch, IRQa, IRQMode;
+static FCEU_THREAD_LOCAL uint8 prgreg[2], chrreg[8];
+static FCEU_THREAD_LOCAL uint16 chrhi[8];
+static FCEU_THREAD_LOCAL uint8 regcmd, irqcmd, mirr, big_bank;
+static FCEU_THREAD_LOCAL uint16 acount = 0;
+
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
+
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ prgreg, 2, "PREG" },
 	{ chrreg, 8, "CREG" },
@@ -163,6 +163,17 @@ void VRC24IRQHook(int a) {
 	}
 }
 
+static int32 VRC24IRQNext(void) {
+	int32 left;
+
+	if (!IRQa)
+		return X6502_MAX_EVENT_CYCLES;
+	left = 0x100 - IRQCount;
+	if (IRQMode)
+		return left - acount;
+	return (left * LCYCS - acount + 2) / 3;
+}
+
 static void StateRestore(int version) {
 	Sync();
 }
@@ -177,6 +188,7 @@ static void VRC24_Init(CartInfo *info) {
 	info->Power = VRC24Power;
 	info->Close = VRC24Close;
 	MapIRQHook = VRC24IRQHook;
+	MapIRQHookNext = VRC24IRQNext;
 	GameStateRestore = StateRestore;
 
 	WRAMSIZE = 8192;
@@ -23,15 +23,15 @@
 
 #include "mapinc.h"
 
-static uint8 preg;
-static uint8 IRQx;	//autoenable
-static uint8 IRQm;	//mode
-static uint8 IRQa;
-static uint16 IRQReload, IRQCount;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE;
+static FCEU_THREAD_LOCAL uint8 preg;
+static FCEU_THREAD_LOCAL uint8 IRQx;	//autoenable
+static FCEU_THREAD_LOCAL uint8 IRQm;	//mode
+static FCEU_THREAD_LOCAL uint8 IRQa;
+static FCEU_THREAD_LOCAL uint16 IRQReload, IRQCount;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &preg, 1, "PREG" },
 	{ &IRQa, 1, "IRQA" },
@@ -100,6 +100,14 @@ static void M73IRQHook(int a) {
 	}
 }
 
+static int32 M73IRQNext(void) {
+	if (!IRQa)
+		return X6502_MAX_EVENT_CYCLES;
+	if (IRQm)
+		return 0x100 - (IRQCount & 0xFF);
+	return 0x10000 - IRQCount;
+}
+
 static void M73Power(void) {
 	IRQReload = IRQm = IRQx = 0;
 	Sync();
@@ -124,6 +132,7 @@ void Mapper73_Init(CartInfo *info) {
 	info->Power = M73Power;
 	info->Close = M73Close;
 	MapIRQHook = M73IRQHook;
+	MapIRQHookNext = M73IRQNext;
 
 	WRAMSIZE = 8192;
 	WRAM = (uint8*)FCEU_gmalloc(WRAMSIZE);
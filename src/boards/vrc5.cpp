@@ -31,16 +31,16 @@
 // bankings here.
 // extra NT RAM handling is in PPU code now.
 
-static uint16 CHRSIZE = 8192;
+static FCEU_THREAD_LOCAL uint16 CHRSIZE = 8192;
 // there are two separate WRAMs 8K each, on main system cartridge (not battery
 // backed), and one on the daughter cart (with battery). both are accessed
 // via the same registers with additional selector flags.
-static uint16 WRAMSIZE = 8192 + 8192;
-static uint8 *CHRRAM = NULL;
-static uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint16 WRAMSIZE = 8192 + 8192;
+static FCEU_THREAD_LOCAL uint8 *CHRRAM = NULL;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
 
-static uint8 IRQa, K4IRQ;
-static uint32 IRQLatch, IRQCount;
+static FCEU_THREAD_LOCAL uint8 IRQa, K4IRQ;
+static FCEU_THREAD_LOCAL uint32 IRQLatch, IRQCount;
 
 // some kind of 16-bit text  encoding (actually 14-bit) used in game resources
 // may be converted by the hardware into the tile indexes for internal CHR ROM
@@ -52,7 +52,7 @@ static uint32 IRQLatch, IRQCount;
 // table read out from hardware registers as is
 
 ///*
-static uint8 conv_tbl[4][8] = {
+static FCEU_THREAD_LOCAL uint8 conv_tbl[4][8] = {
 	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
 	{ 0x00, 0x00, 0x40, 0x10, 0x28, 0x00, 0x18, 0x30 },
 	{ 0x00, 0x00, 0x48, 0x18, 0x30, 0x08, 0x20, 0x38 },
@@ -128,8 +128,8 @@ static uint8 conv_tbl[64][4] = {
 };
 */
 
-static uint8 regs[16];
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL uint8 regs[16];
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &IRQCount, 1, "IRQC" },
 	{ &IRQLatch, 1, "IRQL" },
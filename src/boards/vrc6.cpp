@@ -23,14 +23,14 @@
 
 #include "mapinc.h"
 
-static uint8 is26;
-static uint8 prg[2], chr[8], mirr;
-static uint8 IRQLatch, IRQa, IRQd, IRQMode;
-static int32 IRQCount, CycleCount;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
-
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL uint8 is26;
+static FCEU_THREAD_LOCAL uint8 prg[2], chr[8], mirr;
+static FCEU_THREAD_LOCAL uint8 IRQLatch, IRQa, IRQd, IRQMode;
+static FCEU_THREAD_LOCAL int32 IRQCount, CycleCount;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
+
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ prg, 2, "PRG" },
 	{ chr, 8, "CHR" },
@@ -44,14 +44,17 @@ static SFORMAT StateRegs[] =
 	{ 0 }
 };
 
-static void(*sfun[3]) (void);
-static uint8 vpsg1[8];
-static uint8 vpsg2[4];
-static int32 cvbc[3];
-static int32 vcount[3];
-static int32 dcount[2];
-
-static SFORMAT SStateRegs[] =
+static FCEU_THREAD_LOCAL void(*sfun[3]) (void);
+static FCEU_THREAD_LOCAL uint8 vpsg1[8];
+static FCEU_THREAD_LOCAL uint8 vpsg2[4];
+static FCEU_THREAD_LOCAL int32 cvbc[3];
+static FCEU_THREAD_LOCAL int32 vcount[3];
+static FCEU_THREAD_LOCAL int32 dcount[2];
+static FCEU_THREAD_LOCAL uint8 sawb3;
+static FCEU_THREAD_LOCAL int32 sawphaseacc;
+static FCEU_THREAD_LOCAL int32 vstepout[3];
+
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT SStateRegs[] =
 {
 	{ vpsg1, 8, "PSG1" },
 	{ vpsg2, 4, "PSG2" },
@@ -158,6 +161,17 @@ static void VRC6IRQHook(int a) {
 	}
 }
 
+static int32 VRC6IRQNext(void) {
+	int32 left;
+
+	if (!IRQa)
+		return X6502_MAX_EVENT_CYCLES;
+	left = 0x100 - IRQCount;
+	if (IRQMode)
+		return left - CycleCount;
+	return (left * 341 - CycleCount + 2) / 3;
+}
+
 static void VRC6Close(void)
 {
 	if (WRAM)
@@ -223,11 +237,11 @@ static void DoSawV(void) {
 	cvbc[2] = end;
 
 	if (vpsg2[2] & 0x80) {
-		static int32 saw1phaseacc = 0;
+		static FCEU_THREAD_LOCAL int32 saw1phaseacc = 0;
 		uint32 freq3;
-		static uint8 b3 = 0;
-		static int32 phaseacc = 0;
-		static uint32 duff = 0;
+		static FCEU_THREAD_LOCAL uint8 b3 = 0;
+		static FCEU_THREAD_LOCAL int32 phaseacc = 0;
+		static FCEU_THREAD_LOCAL uint32 duff = 0;
 
 		freq3 = (vpsg2[1] + ((vpsg2[2] & 15) << 8) + 1);
 
@@ -287,21 +301,19 @@ static void DoSQV2HQ(void) {
 }
 
 static void DoSawVHQ(void) {
-	static uint8 b3 = 0;
-	static int32 phaseacc = 0;
 	int32 V;
 
 	if (vpsg2[2] & 0x80) {
 		for (V = cvbc[2]; V < (int)SOUNDTS; V++) {
-			WaveHi[V] += (((phaseacc >> 3) & 0x1f) << 8) * 6 / 8;
+			WaveHi[V] += (((sawphaseacc >> 3) & 0x1f) << 8) * 6 / 8;
 			vcount[2]--;
 			if (vcount[2] <= 0) {
 				vcount[2] = (vpsg2[1] + ((vpsg2[2] & 15) << 8) + 1) << 1;
-				phaseacc += vpsg2[0] & 0x3f;
-				b3++;
-				if (b3 == 7) {
-					b3 = 0;
-					phaseacc = 0;
+				sawphaseacc += vpsg2[0] & 0x3f;
+				sawb3++;
+				if (sawb3 == 7) {
+					sawb3 = 0;
+					sawphaseacc = 0;
 				}
 			}
 		}
@@ -309,6 +321,93 @@ static void DoSawVHQ(void) {
 	cvbc[2] = SOUNDTS;
 }
 
+// Step synthesis: the same channels, reporting only where their output changes.
+
+static INLINE void VRC6Step(int x, int32 t, int32 out) {
+	if (out != vstepout[x]) {
+		StepSynthAdd(t, out - vstepout[x]);
+		vstepout[x] = out;
+	}
+}
+
+static INLINE void DoSQVStep(int x) {
+	int32 t = cvbc[x], end = SOUNDTS;
+	int32 amp = ((vpsg1[x << 2] & 15) << 8) * 6 / 8;
+
+	if (!(vpsg1[(x << 2) | 0x2] & 0x80))
+		VRC6Step(x, t, 0);
+	else if (vpsg1[x << 2] & 0x80)
+		VRC6Step(x, t, amp);
+	else {
+		int32 thresh = (vpsg1[x << 2] >> 4) & 7;
+		int32 period = (vpsg1[(x << 2) | 0x1] | ((vpsg1[(x << 2) | 0x2] & 15) << 8)) + 1;
+
+		// A count of 0 or less reloads on the next cycle, the same as 1.
+		if (vcount[x] < 1)
+			vcount[x] = 1;
+		for (;;) {
+			int32 n;
+
+			// Duty steps until the output flips, then the cycles to get there.
+			if (dcount[x] > thresh) {
+				VRC6Step(x, t, amp);
+				n = 16 - dcount[x];
+			} else {
+				VRC6Step(x, t, 0);
+				n = thresh + 1 - dcount[x];
+			}
+			n = vcount[x] + (n - 1) * period;
+			if (t + n > end)
+				n = end - t;
+			t += n;
+			if (n < vcount[x])
+				vcount[x] -= n;
+			else {
+				n -= vcount[x];
+				dcount[x] = (dcount[x] + 1 + n / period) & 15;
+				vcount[x] = period - n % period;
+			}
+			if (t >= end)
+				break;
+		}
+	}
+	cvbc[x] = SOUNDTS;
+}
+
+static void DoSQV1Step(void) {
+	DoSQVStep(0);
+}
+
+static void DoSQV2Step(void) {
+	DoSQVStep(1);
+}
+
+static void DoSawVStep(void) {
+	int32 t = cvbc[2], end = SOUNDTS;
+
+	if (vpsg2[2] & 0x80) {
+		if (vcount[2] < 1)
+			vcount[2] = 1;
+		for (;;) {
+			VRC6Step(2, t, (((sawphaseacc >> 3) & 0x1f) << 8) * 6 / 8);
+			if (t + vcount[2] > end) {
+				vcount[2] -= end - t;
+				break;
+			}
+			t += vcount[2];
+			vcount[2] = (vpsg2[1] + ((vpsg2[2] & 15) << 8) + 1) << 1;
+			sawphaseacc += vpsg2[0] & 0x3f;
+			sawb3++;
+			if (sawb3 == 7) {
+				sawb3 = 0;
+				sawphaseacc = 0;
+			}
+		}
+	} else
+		VRC6Step(2, t, 0);
+	cvbc[2] = SOUNDTS;
+}
+
 
 void VRC6Sound(int Count) {
 	int x;
@@ -326,6 +425,12 @@ void VRC6SoundHQ(void) {
 	DoSawVHQ();
 }
 
+void VRC6SoundStep(void) {
+	DoSQV1Step();
+	DoSQV2Step();
+	DoSawVStep();
+}
+
 void VRC6SyncHQ(int32 ts) {
 	int x;
 	for (x = 0; x < 3; x++) cvbc[x] = ts;
@@ -336,12 +441,18 @@ static void VRC6_ESI(void) {
 	GameExpSound.Fill = VRC6Sound;
 	GameExpSound.HiFill = VRC6SoundHQ;
 	GameExpSound.HiSync = VRC6SyncHQ;
+	GameExpSound.StepFill = VRC6SoundStep;
 
 	memset(cvbc, 0, sizeof(cvbc));
 	memset(vcount, 0, sizeof(vcount));
 	memset(dcount, 0, sizeof(dcount));
+	memset(vstepout, 0, sizeof(vstepout));
 	if (FSettings.SndRate) {
-		if (FSettings.soundq >= 1) {
+		if (FSettings.soundq >= 1 && FSettings.stepsynth) {
+			sfun[0] = DoSQV1Step;
+			sfun[1] = DoSQV2Step;
+			sfun[2] = DoSawVStep;
+		} else if (FSettings.soundq >= 1) {
 			sfun[0] = DoSQV1HQ;
 			sfun[1] = DoSQV2HQ;
 			sfun[2] = DoSawVHQ;
@@ -361,6 +472,7 @@ void Mapper24_Init(CartInfo *info) {
 	is26 = 0;
 	info->Power = VRC6Power;
 	MapIRQHook = VRC6IRQHook;
+	MapIRQHookNext = VRC6IRQNext;
 	VRC6_ESI();
 	GameStateRestore = StateRestore;
 	AddExState(&StateRegs, ~0, 0, 0);
@@ -371,6 +483,7 @@ void Mapper26_Init(CartInfo *info) {
 	info->Power = VRC6Power;
 	info->Close = VRC6Close;
 	MapIRQHook = VRC6IRQHook;
+	MapIRQHookNext = VRC6IRQNext;
 	VRC6_ESI();
 	GameStateRestore = StateRestore;
 
@@ -20,19 +20,19 @@
 
 #include "mapinc.h"
 
-static uint8 vrc7idx, preg[3], creg[8], mirr;
-static uint8 IRQLatch, IRQa, IRQd, IRQMode;
-static int32 IRQCount, CycleCount;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE=0;
+static FCEU_THREAD_LOCAL uint8 vrc7idx, preg[3], creg[8], mirr;
+static FCEU_THREAD_LOCAL uint8 IRQLatch, IRQa, IRQd, IRQMode;
+static FCEU_THREAD_LOCAL int32 IRQCount, CycleCount;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE=0;
 
 #include "emu2413.h"
 
-static int32 dwave = 0;
-static OPLL *VRC7Sound = NULL;
-static OPLL **VRC7Sound_saveptr = &VRC7Sound;
+static FCEU_THREAD_LOCAL int32 dwave = 0;
+static FCEU_THREAD_LOCAL OPLL *VRC7Sound = NULL;
+static FCEU_THREAD_LOCAL_OBJECT OPLL **VRC7Sound_saveptr = &VRC7Sound;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &vrc7idx, 1, "VRCI" },
 	{ preg, 3, "PREG" },
@@ -191,6 +191,17 @@ static void VRC7IRQHook(int a) {
 	}
 }
 
+static int32 VRC7IRQNext(void) {
+	int32 left;
+
+	if (!IRQa)
+		return X6502_MAX_EVENT_CYCLES;
+	left = 0x100 - IRQCount;
+	if (IRQMode)
+		return left - CycleCount;
+	return (left * 341 - CycleCount + 2) / 3;
+}
+
 static void StateRestore(int version) {
 	Sync();
 }
@@ -199,6 +210,7 @@ void Mapper85_Init(CartInfo *info) {
 	info->Power = VRC7Power;
 	info->Close = VRC7Close;
 	MapIRQHook = VRC7IRQHook;
+	MapIRQHookNext = VRC7IRQNext;
 	WRAMSIZE = 8192;
 	WRAM = (uint8*)FCEU_gmalloc(WRAMSIZE);
 	SetupCartPRGMapping(0x10, WRAM, WRAMSIZE, 1);
@@ -22,11 +22,11 @@
 
 #include "mapinc.h"
 
-static uint8 prg[3], chr[8], mirr;
-static uint8 IRQLatch, IRQa, IRQd;
-static int32 IRQCount, CycleCount;
+static FCEU_THREAD_LOCAL uint8 prg[3], chr[8], mirr;
+static FCEU_THREAD_LOCAL uint8 IRQLatch, IRQa, IRQd;
+static FCEU_THREAD_LOCAL int32 IRQCount, CycleCount;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ prg, 3, "PRG" },
 	{ chr, 8, "CHR" },
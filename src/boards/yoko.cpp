@@ -28,14 +28,14 @@
 
 #include "mapinc.h"
 
-static uint8 mode, bank, reg[11], low[4], dip, IRQa;
-static int32 IRQCount;
-static uint8 *WRAM = NULL;
-static uint32 WRAMSIZE;
+static FCEU_THREAD_LOCAL uint8 mode, bank, reg[11], low[4], dip, IRQa;
+static FCEU_THREAD_LOCAL int32 IRQCount;
+static FCEU_THREAD_LOCAL uint8 *WRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 WRAMSIZE;
 
-static uint8 is2kbank, isnot2kbank;
+static FCEU_THREAD_LOCAL uint8 is2kbank, isnot2kbank;
 
-static SFORMAT StateRegs[] =
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] =
 {
 	{ &mode, 1, "MODE" },
 	{ &bank, 1, "BANK" },
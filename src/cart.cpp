@@ -38,45 +38,45 @@
 #include <cstdio>
 #include <climits>
 
-uint8 *Page[32], *VPage[8];
-uint8 **VPageR = VPage;
-uint8 *VPageG[8];
-uint8 *MMC5SPRVPage[8];
-uint8 *MMC5BGVPage[8];
+FCEU_THREAD_LOCAL uint8 *Page[32], *VPage[8];
+FCEU_THREAD_LOCAL_OBJECT uint8 **VPageR = VPage;
+FCEU_THREAD_LOCAL uint8 *VPageG[8];
+FCEU_THREAD_LOCAL uint8 *MMC5SPRVPage[8];
+FCEU_THREAD_LOCAL uint8 *MMC5BGVPage[8];
 
-static uint8 PRGIsRAM[32];  /* This page is/is not PRG RAM. */
+FCEU_THREAD_LOCAL uint8 PRGIsRAM[32];  /* This page is/is not PRG RAM. */
 
 /* 16 are (sort of) reserved for UNIF/iNES and 16 to map other stuff. */
-uint8 CHRram[32];
-uint8 PRGram[32];
+FCEU_THREAD_LOCAL uint8 CHRram[32];
+FCEU_THREAD_LOCAL uint8 PRGram[32];
 
-uint8 *PRGptr[32];
-uint8 *CHRptr[32];
+FCEU_THREAD_LOCAL uint8 *PRGptr[32];
+FCEU_THREAD_LOCAL uint8 *CHRptr[32];
 
-uint32 PRGsize[32];
-uint32 CHRsize[32];
+FCEU_THREAD_LOCAL uint32 PRGsize[32];
+FCEU_THREAD_LOCAL uint32 CHRsize[32];
 
-uint32 PRGmask2[32];
-uint32 PRGmask4[32];
-uint32 PRGmask8[32];
-uint32 PRGmask16[32];
-uint32 PRGmask32[32];
+FCEU_THREAD_LOCAL uint32 PRGmask2[32];
+FCEU_THREAD_LOCAL uint32 PRGmask4[32];
+FCEU_THREAD_LOCAL uint32 PRGmask8[32];
+FCEU_THREAD_LOCAL uint32 PRGmask16[32];
+FCEU_THREAD_LOCAL uint32 PRGmask32[32];
 
-uint32 CHRmask1[32];
-uint32 CHRmask2[32];
-uint32 CHRmask4[32];
-uint32 CHRmask8[32];
+FCEU_THREAD_LOCAL uint32 CHRmask1[32];
+FCEU_THREAD_LOCAL uint32 CHRmask2[32];
+FCEU_THREAD_LOCAL uint32 CHRmask4[32];
+FCEU_THREAD_LOCAL uint32 CHRmask8[32];
 
-int geniestage = 0;
+FCEU_THREAD_LOCAL int geniestage = 0;
 
-int modcon;
+FCEU_THREAD_LOCAL int modcon;
 
-uint8 genieval[3];
-uint8 geniech[3];
+FCEU_THREAD_LOCAL uint8 genieval[3];
+FCEU_THREAD_LOCAL uint8 geniech[3];
 
-uint32 genieaddr[3];
+FCEU_THREAD_LOCAL uint32 genieaddr[3];
 
-CartInfo *currCartInfo;
+FCEU_THREAD_LOCAL CartInfo *currCartInfo;
 
 static INLINE void setpageptr(int s, uint32 A, uint8 *p, int ram) {
 	uint32 AB = A >> 11;
@@ -92,9 +92,11 @@ static INLINE void setpageptr(int s, uint32 A, uint8 *p, int ram) {
 			PRGIsRAM[AB + x] = 0;
 			Page[AB + x] = 0;
 		}
+
+	FCEU_SyncMemPages(A, A + (s << 10) - 1);
 }
 
-static uint8 nothing[8192];
+static FCEU_THREAD_LOCAL uint8 nothing[8192];
 void ResetCartMapping(void) {
 	int x;
 
@@ -108,6 +110,8 @@ void ResetCartMapping(void) {
 	for (x = 0; x < 8; x++) {
 		MMC5SPRVPage[x] = MMC5BGVPage[x] = VPageR[x] = nothing - 0x400 * x;
 	}
+	FCEUPPU_InvalidateCHRSlots(0, 8);
+	FCEU_SyncMemPages(0x0000, 0xFFFF);
 }
 
 void SetupCartPRGMapping(int chip, uint8 *p, uint32 size, int ram) {
@@ -234,6 +238,7 @@ void setchr1r(int r, uint32 A, uint32 V) {
 	else
 		PPUCHRRAM &= ~(1 << (A >> 10));
 	VPageR[(A) >> 10] = &CHRptr[r][(V) << 10] - (A);
+	FCEUPPU_InvalidateCHRSlots(A >> 10, 1);
 }
 
 void setchr2r(int r, uint32 A, uint32 V) {
@@ -241,6 +246,7 @@ void setchr2r(int r, uint32 A, uint32 V) {
 	FCEUPPU_LineUpdate();
 	V &= CHRmask2[r];
 	VPageR[(A) >> 10] = VPageR[((A) >> 10) + 1] = &CHRptr[r][(V) << 11] - (A);
+	FCEUPPU_InvalidateCHRSlots(A >> 10, 2);
 	if (CHRram[r])
 		PPUCHRRAM |= (3 << (A >> 10));
 	else
@@ -253,6 +259,7 @@ void setchr4r(int r, unsigned int A, unsigned int V) {
 	V &= CHRmask4[r];
 	VPageR[(A) >> 10] = VPageR[((A) >> 10) + 1] =
 							VPageR[((A) >> 10) + 2] = VPageR[((A) >> 10) + 3] = &CHRptr[r][(V) << 12] - (A);
+	FCEUPPU_InvalidateCHRSlots(A >> 10, 4);
 	if (CHRram[r])
 		PPUCHRRAM |= (15 << (A >> 10));
 	else
@@ -267,6 +274,7 @@ void setchr8r(int r, uint32 V) {
 	V &= CHRmask8[r];
 	for (x = 7; x >= 0; x--)
 		VPageR[x] = &CHRptr[r][V << 13];
+	FCEUPPU_InvalidateCHRSlots(0, 8);
 	if (CHRram[r])
 		PPUCHRRAM |= (255);
 	else
@@ -299,7 +307,7 @@ void setntamem(uint8 *p, int ram, uint32 b) {
 		PPUNTARAM |= 1 << b;
 }
 
-static int mirrorhard = 0;
+static FCEU_THREAD_LOCAL int mirrorhard = 0;
 void setmirrorw(int a, int b, int c, int d) {
 	FCEUPPU_LineUpdate();
 	vnapage[0] = NTARAM + a * 0x400;
@@ -343,7 +351,7 @@ void SetupCartMirroring(int m, int hard, uint8 *extra) {
 	mirrorhard = hard;
 }
 
-static uint8 *GENIEROM = 0;
+static FCEU_THREAD_LOCAL uint8 *GENIEROM = 0;
 
 void FixGenieMap(void);
 
@@ -454,7 +462,7 @@ static DECLFW(GenieWrite) {
 	}
 }
 
-static readfunc GenieBackup[3];
+static FCEU_THREAD_LOCAL readfunc GenieBackup[3];
 
 static DECLFR(GenieFix1) {
 	uint8 r = GenieBackup[0](A);
@@ -497,6 +505,7 @@ void FixGenieMap(void) {
 
 	for (x = 0; x < 8; x++)
 		VPage[x] = VPageG[x];
+	FCEUPPU_InvalidateCHRSlots(0, 8);
 
 	VPageR = VPage;
 	FlushGenieRW();
@@ -528,6 +537,7 @@ void FCEU_GeniePower(void) {
 
 	for (x = 0; x < 8; x++)
 		VPage[x] = GENIEROM + 4096 - 0x400 * x;
+	FCEUPPU_InvalidateCHRSlots(0, 8);
 
 	if (AllocGenieRW())
 		VPageR = VPageG;
@@ -563,7 +573,7 @@ void FCEU_SaveGameSave(CartInfo *LocalHWInfo)
 }
 
 // hack, movie.cpp has to communicate with this function somehow
-int disableBatteryLoading = 0;
+FCEU_THREAD_LOCAL int disableBatteryLoading = 0;
 
 void FCEU_LoadGameSave(CartInfo *LocalHWInfo)
 {
@@ -36,10 +36,10 @@
 
 using namespace std;
 
-static uint8 *CheatRPtrs[64];
+static FCEU_THREAD_LOCAL uint8 *CheatRPtrs[64];
 
-vector<uint16> FrozenAddresses;			//List of addresses that are currently frozen
-unsigned int FrozenAddressCount = 0;		//Keeps up with the Frozen address count, necessary for using in other dialogs (such as hex editor)
+FCEU_THREAD_LOCAL_OBJECT vector<uint16> FrozenAddresses;			//List of addresses that are currently frozen
+FCEU_THREAD_LOCAL unsigned int FrozenAddressCount = 0;		//Keeps up with the Frozen address count, necessary for using in other dialogs (such as hex editor)
 
 void FCEU_CheatResetRAM(void)
 {
@@ -59,8 +59,8 @@ void FCEU_CheatAddRAM(int s, uint32 A, uint8 *p)
 }
 
 // Cheat change event callback. Called whenever cheat map is changed or recalculated.
-static void (*cheatsChangeEventCB)(void*) = nullptr;
-static void*  cheatsChangeEventUserData = nullptr;
+static FCEU_THREAD_LOCAL void (*cheatsChangeEventCB)(void*) = nullptr;
+static FCEU_THREAD_LOCAL void*  cheatsChangeEventUserData = nullptr;
 
 void FCEU_SetCheatChangeEventCallback( void (*func)(void*), void* userData )
 {
@@ -68,21 +68,21 @@ void FCEU_SetCheatChangeEventCallback( void (*func)(void*), void* userData )
 	cheatsChangeEventUserData = userData;
 }
 
-CHEATF_SUBFAST SubCheats[256];
-uint32 numsubcheats = 0;
-int globalCheatDisabled = 0;
-int disableAutoLSCheats = 0;
-bool disableShowGG = 0;
-static _8BYTECHEATMAP* cheatMap = NULL;
-struct CHEATF *cheats = 0, *cheatsl = 0;
+FCEU_THREAD_LOCAL_OBJECT CHEATF_SUBFAST SubCheats[256];
+FCEU_THREAD_LOCAL uint32 numsubcheats = 0;
+FCEU_THREAD_LOCAL int globalCheatDisabled = 0;
+FCEU_THREAD_LOCAL int disableAutoLSCheats = 0;
+FCEU_THREAD_LOCAL bool disableShowGG = 0;
+static FCEU_THREAD_LOCAL _8BYTECHEATMAP* cheatMap = NULL;
+FCEU_THREAD_LOCAL struct CHEATF *cheats = 0, *cheatsl = 0;
 
 
 #define CHEATC_NONE     0x8000
 #define CHEATC_EXCLUDED 0x4000
 #define CHEATC_NOSHOW   0xC000
 
-static uint16 *CheatComp = 0;
-int savecheats = 0;
+static FCEU_THREAD_LOCAL uint16 *CheatComp = 0;
+FCEU_THREAD_LOCAL int savecheats = 0;
 
 static DECLFR(SubCheatsRead)
 {
@@ -447,7 +447,11 @@ void FCEU_ApplyPeriodicCheats(void)
 	{
 		if(cur->status && !(cur->type))
 			if(CheatRPtrs[cur->addr>>10])
+			{
 				CheatRPtrs[cur->addr>>10][cur->addr]=cur->val;
+				if(cur->addr < 0x2000)
+					RAMDirtyPages[(cur->addr >> 8) & 7] = 1;
+			}
 		if(cur->next)
 			cur=cur->next;
 		else
@@ -498,7 +502,7 @@ int FCEUI_GetCheat(uint32 which, std::string *name, uint32 *a, uint8 *v, int *co
 
 static int GGtobin(char c)
 {
-	static char lets[16]={'A','P','Z','L','G','I','T','Y','E','O','X','U','K','S','V','N'};
+	static FCEU_THREAD_LOCAL char lets[16]={'A','P','Z','L','G','I','T','Y','E','O','X','U','K','S','V','N'};
 	int x;
 
 	for(x=0;x<16;x++)
@@ -879,7 +883,11 @@ int FCEU_CheatGetByte(uint32 A)
 void FCEU_CheatSetByte(uint32 A, uint8 V)
 {
    if(CheatRPtrs[A>>10])
+   {
     CheatRPtrs[A>>10][A]=V;
+    if(A < 0x2000)
+     RAMDirtyPages[(A >> 8) & 7] = 1;
+   }
    else if(A < 0x10000)
     BWrite[A](A, V);
 }
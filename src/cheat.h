@@ -21,14 +21,14 @@ extern void FCEUI_SetCheatMapByte(uint16 address, bool cheat);
 extern void FCEUI_CreateCheatMap(void);
 extern void FCEUI_RefreshCheatMap(void);
 extern void FCEUI_ReleaseCheatMap(void);
-extern unsigned int FrozenAddressCount;
+extern FCEU_THREAD_LOCAL unsigned int FrozenAddressCount;
 
 int FCEU_CheatGetByte(uint32 A);
 void FCEU_CheatSetByte(uint32 A, uint8 V);
 
-extern int savecheats;
-extern int globalCheatDisabled;
-extern int disableAutoLSCheats;
+extern FCEU_THREAD_LOCAL int savecheats;
+extern FCEU_THREAD_LOCAL int globalCheatDisabled;
+extern FCEU_THREAD_LOCAL int disableAutoLSCheats;
 
 int FCEU_DisableAllCheats(void);
 int FCEU_DeleteAllCheats(void);
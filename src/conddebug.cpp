@@ -51,11 +51,11 @@
 #include <cassert>
 #include <cctype>
 
-uint16 debugLastAddress = 0; // used by 'T' and 'R' conditions
-uint8 debugLastOpcode = 0; // used to evaluate 'W' condition
+FCEU_THREAD_LOCAL uint16 debugLastAddress = 0; // used by 'T' and 'R' conditions
+FCEU_THREAD_LOCAL uint8 debugLastOpcode = 0; // used to evaluate 'W' condition
 
 // Next non-whitespace character in string
-static char next = 0;
+static FCEU_THREAD_LOCAL char next = 0;
 
 static int ishex(char c)
 {
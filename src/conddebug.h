@@ -45,8 +45,8 @@
 #define OP_OR 11
 #define OP_AND 12
 
-extern uint16 debugLastAddress;
-extern uint8 debugLastOpcode;
+extern FCEU_THREAD_LOCAL uint16 debugLastAddress;
+extern FCEU_THREAD_LOCAL uint8 debugLastOpcode;
 
 //mbg merge 7/18/06 turned into sane c++
 struct Condition
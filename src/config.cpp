@@ -11,7 +11,7 @@
 #include <cstdio>
 #include <cstdlib>
 
-static std::string aboutString;
+static FCEU_THREAD_LOCAL_OBJECT std::string aboutString;
 
 #ifndef FCEUX_BUILD_TIMESTAMP
 #define FCEUX_BUILD_TIMESTAMP  __TIME__ " " __DATE__
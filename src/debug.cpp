@@ -15,9 +15,9 @@
 #include <cstdlib>
 #include <cstring>
 
-unsigned int debuggerPageSize = 14;
-int vblankScanLines = 0;	//Used to calculate scanlines 240-261 (vblank)
-int vblankPixel = 0;		//Used to calculate the pixels in vblank
+FCEU_THREAD_LOCAL unsigned int debuggerPageSize = 14;
+FCEU_THREAD_LOCAL int vblankScanLines = 0;	//Used to calculate scanlines 240-261 (vblank)
+FCEU_THREAD_LOCAL int vblankPixel = 0;		//Used to calculate the pixels in vblank
 
 
 struct TraceInstructionCallback
@@ -25,7 +25,7 @@ struct TraceInstructionCallback
 	void (*func)(uint8 *opcode, int size) = nullptr;
 	TraceInstructionCallback* next = nullptr;
 };
-static TraceInstructionCallback* traceInstructionCB = nullptr;
+static FCEU_THREAD_LOCAL TraceInstructionCallback* traceInstructionCB = nullptr;
 
 int offsetStringToInt(unsigned int type, const char* offsetBuffer, bool *conversionOk)
 {
@@ -492,12 +492,12 @@ int condition(watchpointinfo* wp)
 
 //---------------------
 
-volatile int codecount = 0, datacount = 0, undefinedcount = 0;
-unsigned char *cdloggerdata = NULL;
-unsigned int cdloggerdataSize = 0;
-static int indirectnext = 0;
+FCEU_THREAD_LOCAL volatile int codecount = 0, datacount = 0, undefinedcount = 0;
+FCEU_THREAD_LOCAL unsigned char *cdloggerdata = NULL;
+FCEU_THREAD_LOCAL unsigned int cdloggerdataSize = 0;
+static FCEU_THREAD_LOCAL int indirectnext = 0;
 
-int debug_loggingCD = 0;
+FCEU_THREAD_LOCAL int debug_loggingCD = 0;
 
 //called by the cpu to perform logging if CDLogging is enabled
 void LogCDVectors(int which){
@@ -519,8 +519,8 @@ void LogCDVectors(int which){
 	}
 }
 
-bool break_on_unlogged_code = false;
-bool break_on_unlogged_data = false;
+FCEU_THREAD_LOCAL bool break_on_unlogged_code = false;
+FCEU_THREAD_LOCAL bool break_on_unlogged_data = false;
 
 void LogCDData(uint8 *opcode, uint16 A, int size)
 {
@@ -601,25 +601,25 @@ void LogCDData(uint8 *opcode, uint16 A, int size)
 
 //-----------debugger stuff
 
-watchpointinfo watchpoint[65]; //64 watchpoints, + 1 reserved for step over
-int iaPC;
-uint32 iapoffset; //mbg merge 7/18/06 changed from int
-int u; //deleteme
-int skipdebug; //deleteme
-int numWPs;
+FCEU_THREAD_LOCAL watchpointinfo watchpoint[65]; //64 watchpoints, + 1 reserved for step over
+FCEU_THREAD_LOCAL int iaPC;
+FCEU_THREAD_LOCAL uint32 iapoffset; //mbg merge 7/18/06 changed from int
+FCEU_THREAD_LOCAL int u; //deleteme
+FCEU_THREAD_LOCAL int skipdebug; //deleteme
+FCEU_THREAD_LOCAL int numWPs;
 
-bool break_asap = false;
+FCEU_THREAD_LOCAL bool break_asap = false;
 // for CPU cycles and Instructions counters
-uint64 total_cycles_base = 0;
-uint64 delta_cycles_base = 0;
-bool break_on_cycles = false;
-uint64 break_cycles_limit = 0;
-uint64 total_instructions = 0;
-uint64 delta_instructions = 0;
-bool break_on_instructions = false;
-uint64 break_instructions_limit = 0;
+FCEU_THREAD_LOCAL uint64 total_cycles_base = 0;
+FCEU_THREAD_LOCAL uint64 delta_cycles_base = 0;
+FCEU_THREAD_LOCAL bool break_on_cycles = false;
+FCEU_THREAD_LOCAL uint64 break_cycles_limit = 0;
+FCEU_THREAD_LOCAL uint64 total_instructions = 0;
+FCEU_THREAD_LOCAL uint64 delta_instructions = 0;
+FCEU_THREAD_LOCAL bool break_on_instructions = false;
+FCEU_THREAD_LOCAL uint64 break_instructions_limit = 0;
 
-static DebuggerState dbgstate;
+static FCEU_THREAD_LOCAL DebuggerState dbgstate;
 
 DebuggerState &FCEUI_Debugger() { return dbgstate; }
 
@@ -684,8 +684,8 @@ void BreakHit(int bp_num)
 //#endif
 }
 
-int StackAddrBackup;
-uint16 StackNextIgnorePC = 0xFFFF;
+FCEU_THREAD_LOCAL int StackAddrBackup;
+FCEU_THREAD_LOCAL uint16 StackNextIgnorePC = 0xFFFF;
 
 ///fires a breakpoint
 static void breakpoint(uint8 *opcode, uint16 A, int size) {
@@ -1019,6 +1019,18 @@ void DebugCycle()
 #endif
 }
 
+///tells the CPU core whether DebugCycle has any work to do; when it does not,
+///X6502_Run uses an interpreter loop that skips the call entirely
+bool DebugCycleActive()
+{
+#ifdef __WIN_DRIVER__
+	return true;
+#else
+	return numWPs || dbgstate.step || dbgstate.runline || dbgstate.stepout || watchpoint[64].flags || dbgstate.badopbreak ||
+		break_on_cycles || break_on_instructions || break_asap || debug_loggingCD || (traceInstructionCB != nullptr);
+#endif
+}
+
 void* FCEUI_TraceInstructionRegister( void (*func)(uint8*,int) )
 {
 	TraceInstructionCallback* cb = nullptr;
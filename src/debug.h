@@ -60,9 +60,9 @@ typedef struct {
 } watchpointinfo;
 
 //mbg merge 7/18/06 had to make this extern
-extern watchpointinfo watchpoint[65]; //64 watchpoints, + 1 reserved for step over
+extern FCEU_THREAD_LOCAL watchpointinfo watchpoint[65]; //64 watchpoints, + 1 reserved for step over
 
-extern unsigned int debuggerPageSize;
+extern FCEU_THREAD_LOCAL unsigned int debuggerPageSize;
 int getBank(int offs);
 int GetNesFileAddress(int A);
 int GetPRGAddress(int A);
@@ -77,11 +77,11 @@ uint8 GetPPUMem(uint8 A);
 //---------CDLogger
 void LogCDVectors(int which);
 void LogCDData(uint8 *opcode, uint16 A, int size);
-extern volatile int codecount, datacount, undefinedcount;
-extern unsigned char *cdloggerdata;
-extern unsigned int cdloggerdataSize;
+extern FCEU_THREAD_LOCAL volatile int codecount, datacount, undefinedcount;
+extern FCEU_THREAD_LOCAL unsigned char *cdloggerdata;
+extern FCEU_THREAD_LOCAL unsigned int cdloggerdataSize;
 
-extern int debug_loggingCD;
+extern FCEU_THREAD_LOCAL int debug_loggingCD;
 static INLINE void FCEUI_SetLoggingCD(int val) { debug_loggingCD = val; }
 static INLINE int FCEUI_GetLoggingCD() { return debug_loggingCD; }
 //-------
@@ -94,23 +94,24 @@ static INLINE int FCEUI_GetLoggingCD() { return debug_loggingCD; }
 //---------
 
 //--------debugger
-extern int iaPC;
-extern uint32 iapoffset; //mbg merge 7/18/06 changed from int
+extern FCEU_THREAD_LOCAL int iaPC;
+extern FCEU_THREAD_LOCAL uint32 iapoffset; //mbg merge 7/18/06 changed from int
 void DebugCycle();
+bool DebugCycleActive();
 bool CondForbidTest(int bp_num);
 void BreakHit(int bp_num);
 
-extern bool break_asap;
-extern bool break_on_unlogged_code;
-extern bool break_on_unlogged_data;
-extern uint64 total_cycles_base;
-extern uint64 delta_cycles_base;
-extern bool break_on_cycles;
-extern uint64 break_cycles_limit;
-extern uint64 total_instructions;
-extern uint64 delta_instructions;
-extern bool break_on_instructions;
-extern uint64 break_instructions_limit;
+extern FCEU_THREAD_LOCAL bool break_asap;
+extern FCEU_THREAD_LOCAL bool break_on_unlogged_code;
+extern FCEU_THREAD_LOCAL bool break_on_unlogged_data;
+extern FCEU_THREAD_LOCAL uint64 total_cycles_base;
+extern FCEU_THREAD_LOCAL uint64 delta_cycles_base;
+extern FCEU_THREAD_LOCAL bool break_on_cycles;
+extern FCEU_THREAD_LOCAL uint64 break_cycles_limit;
+extern FCEU_THREAD_LOCAL uint64 total_instructions;
+extern FCEU_THREAD_LOCAL uint64 delta_instructions;
+extern FCEU_THREAD_LOCAL bool break_on_instructions;
+extern FCEU_THREAD_LOCAL uint64 break_instructions_limit;
 extern void ResetDebugStatisticsCounters();
 extern void ResetCyclesCounter();
 extern void ResetInstructionsCounter();
@@ -119,11 +120,11 @@ extern void IncrementInstructionsCounters();
 //-------------
 
 //internal variables that debuggers will want access to
-extern uint8 *vnapage[4],*VPage[8];
-extern uint8 PPU[4],PALRAM[0x20],UPALRAM[3],SPRAM[0x100],VRAMBuffer,PPUGenLatch,XOffset;
+extern FCEU_THREAD_LOCAL uint8 *vnapage[4],*VPage[8];
+extern FCEU_THREAD_LOCAL uint8 PPU[4],PALRAM[0x20],UPALRAM[3],SPRAM[0x100],VRAMBuffer,PPUGenLatch,XOffset;
 extern uint32 FCEUPPU_PeekAddress();
 extern uint8 READPAL_MOTHEROFALL(uint32 A);
-extern int numWPs;
+extern FCEU_THREAD_LOCAL int numWPs;
 
 ///encapsulates the operational state of the debugger core
 class DebuggerState {
@@ -150,17 +151,17 @@ public:
 	}
 };
 
-extern NSF_HEADER NSFHeader;
-
-extern uint8 PSG[0x10];
-extern uint8 DMCFormat;
-extern uint8 RawDALatch;
-extern uint8 DMCAddressLatch;
-extern uint8 DMCSizeLatch;
-extern uint8 EnabledChannels;
-extern uint8 SpriteDMA;
-extern uint8 RawReg4016;
-extern uint8 IRQFrameMode;
+extern FCEU_THREAD_LOCAL NSF_HEADER NSFHeader;
+
+extern FCEU_THREAD_LOCAL uint8 PSG[0x10];
+extern FCEU_THREAD_LOCAL uint8 DMCFormat;
+extern FCEU_THREAD_LOCAL uint8 RawDALatch;
+extern FCEU_THREAD_LOCAL uint8 DMCAddressLatch;
+extern FCEU_THREAD_LOCAL uint8 DMCSizeLatch;
+extern FCEU_THREAD_LOCAL uint8 EnabledChannels;
+extern FCEU_THREAD_LOCAL uint8 SpriteDMA;
+extern FCEU_THREAD_LOCAL uint8 RawReg4016;
+extern FCEU_THREAD_LOCAL uint8 IRQFrameMode;
 
 ///retrieves the core's DebuggerState
 DebuggerState &FCEUI_Debugger();
@@ -12,16 +12,16 @@
 #ifdef __QT_DRIVER__
 #include "Qt/ConsoleUtilities.h"
 #else
-extern char LoadedRomFName[4096];
+extern FCEU_THREAD_LOCAL char LoadedRomFName[4096];
 static inline const char* getRomFile() { return LoadedRomFName; }
 #endif
 
-extern FCEUGI *GameInfo;
+extern FCEU_THREAD_LOCAL FCEUGI *GameInfo;
 
-debugSymbolTable_t  debugSymbolTable;
+FCEU_THREAD_LOCAL_OBJECT debugSymbolTable_t  debugSymbolTable;
 
-static char dbgSymTblErrMsg[256] = {0};
-static bool dbgSymAllowDuplicateNames = true;
+static FCEU_THREAD_LOCAL char dbgSymTblErrMsg[256] = {0};
+static FCEU_THREAD_LOCAL bool dbgSymAllowDuplicateNames = true;
 //--------------------------------------------------------------
 // debugSymbol_t
 //--------------------------------------------------------------
@@ -4,6 +4,7 @@
 #include <string>
 #include <map>
 
+#include "types.h"
 #include "utils/mutex.h"
 #include "ld65dbg.h"
 
@@ -165,6 +166,6 @@ class debugSymbolTable_t
 		FCEU::mutex *cs;
 };
 
-extern  debugSymbolTable_t  debugSymbolTable;
+extern  FCEU_THREAD_LOCAL_OBJECT debugSymbolTable_t  debugSymbolTable;
 
 #endif
@@ -97,6 +97,12 @@ void FCEUI_DisableSpriteLimitation(int a);
 void FCEUI_SetRenderPlanes(bool sprites, bool bg);
 void FCEUI_GetRenderPlanes(bool& sprites, bool& bg);
 
+//No-video mode: the old PPU only works out what the CPU can see (sprite 0 hit,
+//sprite overflow, mapper fetches, $2002) and leaves XBuf stale. Emulation is
+//otherwise unchanged, so movies stay in sync.
+void FCEUI_SetNoVideo(bool on);
+bool FCEUI_GetNoVideo(void);
+
 //name=path and file to load.  returns null if it failed
 FCEUGI *FCEUI_LoadGame(const char *name, int OverwriteVidMode, bool silent = false);
 
@@ -110,6 +116,11 @@ bool FCEUI_Initialize();
 //Emulates a frame.
 void FCEUI_Emulate(uint8 **, int32 **, int32 *, int);
 
+//Emulates a frame with the input the movie or the input drivers provide, but without drawing
+//it, producing sound, running Lua callbacks or honoring pause and frame advance. For tools
+//that re-emulate a movie behind the user's back and put the state back afterwards.
+void FCEUI_EmulateQuiet(void);
+
 //Closes currently loaded game
 void FCEUI_CloseGame(void);
 
@@ -161,6 +172,11 @@ void FCEUI_SetPCMVolume(uint32 volume);
 
 void FCEUI_SetSoundQuality(int quality);
 
+//With high quality sound (quality 1 or 2), renders it from band-limited steps
+//placed where each channel's output changes, rather than from every channel
+//at every CPU cycle.  The passband and stopband are the same.
+void FCEUI_SetSoundStepSynth(int on);
+
 void FCEUD_SoundToggle(void);
 void FCEUD_SoundVolumeAdjust(int);
 
@@ -122,7 +122,7 @@ ConsoleSndConfDialog_t::ConsoleSndConfDialog_t(QWidget *parent)
 
 	lbl = new QLabel(tr("Buffer Size (in ms):"));
 
-	bufSizeLabel = new QLabel("128");
+	bufSizeLabel = new QLabel("48");
 	bufSizeSlider = new QSlider(Qt::Horizontal);
 
 	bufSizeSlider->setMinimum(15);
@@ -90,6 +90,8 @@ FrameTimingDialog_t::FrameTimingDialog_t(QWidget *parent)
 	frameLateCount = new QTreeWidgetItem();
 	videoTimeAbs = new QTreeWidgetItem();
 	emuSignalDelay = new QTreeWidgetItem();
+	audioBufferFill = new QTreeWidgetItem();
+	audioUnderrunCount = new QTreeWidgetItem();
 
 	tree->addTopLevelItem(frameTimeAbs);
 	tree->addTopLevelItem(frameTimeDel);
@@ -100,6 +102,8 @@ FrameTimingDialog_t::FrameTimingDialog_t(QWidget *parent)
 	tree->addTopLevelItem(videoTimeAbs);
 	tree->addTopLevelItem(emuSignalDelay);
 	tree->addTopLevelItem(frameLateCount);
+	tree->addTopLevelItem(audioBufferFill);
+	tree->addTopLevelItem(audioUnderrunCount);
 
 	frameTimeAbs->setFlags(Qt::ItemIsEnabled | Qt::ItemNeverHasChildren);
 	frameTimeDel->setFlags(Qt::ItemIsEnabled | Qt::ItemNeverHasChildren);
@@ -113,6 +117,8 @@ FrameTimingDialog_t::FrameTimingDialog_t(QWidget *parent)
 	frameLateCount->setText(0, tr("Frame Late Count"));
 	emuSignalDelay->setText(0, tr("EMU Signal Delay ms"));
 	videoTimeAbs->setText(0, tr("Video Period ms"));
+	audioBufferFill->setText(0, tr("Audio Buffer ms"));
+	audioUnderrunCount->setText(0, tr("Audio Underrun Count"));
 
 	frameTimeAbs->setTextAlignment(0, Qt::AlignLeft);
 	frameTimeDel->setTextAlignment(0, Qt::AlignLeft);
@@ -123,6 +129,8 @@ FrameTimingDialog_t::FrameTimingDialog_t(QWidget *parent)
 	frameLateCount->setTextAlignment(0, Qt::AlignLeft);
 	videoTimeAbs->setTextAlignment(0, Qt::AlignLeft);
 	emuSignalDelay->setTextAlignment(0, Qt::AlignLeft);
+	audioBufferFill->setTextAlignment(0, Qt::AlignLeft);
+	audioUnderrunCount->setTextAlignment(0, Qt::AlignLeft);
 
 	for (int i = 0; i < 4; i++)
 	{
@@ -135,6 +143,8 @@ FrameTimingDialog_t::FrameTimingDialog_t(QWidget *parent)
 		frameLateCount->setTextAlignment(i + 1, Qt::AlignCenter);
 		videoTimeAbs->setTextAlignment(i + 1, Qt::AlignCenter);
 		emuSignalDelay->setTextAlignment(i + 1, Qt::AlignCenter);
+		audioBufferFill->setTextAlignment(i + 1, Qt::AlignCenter);
+		audioUnderrunCount->setTextAlignment(i + 1, Qt::AlignCenter);
 	}
 
 	hbox = new QHBoxLayout();
@@ -317,6 +327,24 @@ void FrameTimingDialog_t::updateTimingStats(void)
 	frameLateCount->setText(1, tr("0"));
 	frameLateCount->setText(2, tr(stmp));
 
+	// Audio Buffer Fill
+	snprintf(stmp, sizeof(stmp), "%.3f", stats.audioBufferFill.tgt * 1e3);
+	audioBufferFill->setText(1, tr(stmp));
+
+	snprintf(stmp, sizeof(stmp), "%.3f", stats.audioBufferFill.cur * 1e3);
+	audioBufferFill->setText(2, tr(stmp));
+
+	snprintf(stmp, sizeof(stmp), "%.3f", stats.audioBufferFill.min * 1e3);
+	audioBufferFill->setText(3, tr(stmp));
+
+	snprintf(stmp, sizeof(stmp), "%.3f", stats.audioBufferFill.max * 1e3);
+	audioBufferFill->setText(4, tr(stmp));
+
+	// Audio Underrun Count
+	snprintf(stmp, sizeof(stmp), "%u", stats.audioUnderrunCount);
+	audioUnderrunCount->setText(1, tr("0"));
+	audioUnderrunCount->setText(2, tr(stmp));
+
 	statFrame->setEnabled(stats.enabled);
 
 	tree->viewport()->update();
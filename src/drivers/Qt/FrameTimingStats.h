@@ -41,6 +41,8 @@ protected:
 	QTreeWidgetItem *frameLateCount;
 	QTreeWidgetItem *videoTimeAbs;
 	QTreeWidgetItem *emuSignalDelay;
+	QTreeWidgetItem *audioBufferFill;
+	QTreeWidgetItem *audioUnderrunCount;
 	QGroupBox *statFrame;
 
 	QTreeWidget *tree;
@@ -357,10 +357,12 @@ static int writeMem( int mode, unsigned int addr, int value )
 			if (addr < 0x2000)
 			{
 				VPage[addr >> 10][addr] = value; //todo: detect if this is vrom and turn it red if so
+				FCEUPPU_InvalidateCHR(addr);
 			}
 			if ((addr >= 0x2000) && (addr < 0x3F00))
 			{
 				vnapage[(addr >> 10) & 0x3][addr & 0x3FF] = value; //todo: this causes 0x3000-0x3f00 to mirror 0x2000-0x2f00, is this correct?
+				FCEUPPU_InvalidateNametable(vnapage[(addr >> 10) & 0x3], addr);
 			}
 			if ((addr >= 0x3F00) && (addr < 0x3FFF))
 			{
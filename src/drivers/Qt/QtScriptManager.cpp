@@ -1647,26 +1647,37 @@ void MemoryScriptObject::registerCallback(int type, const QJSValue& func, int ad
 	int n=0;
 	int *numFuncsRegistered = nullptr;
 	QJSValue** funcArray = nullptr;
+	X6502_MemHook::Type hookType = X6502_MemHook::Read;
+	void (*hookFunc)(unsigned int address, unsigned int value, void *userData) = nullptr;
 
 	switch (type)
 	{
-		default:
 		case X6502_MemHook::Read:
 			funcArray = readFunc;
 			numFuncsRegistered = &numReadFuncsRegistered;
-			X6502_MemHook::Add(X6502_MemHook::Read, addressReadCallback, this);
+			hookType = X6502_MemHook::Read;
+			hookFunc = addressReadCallback;
 		break;
 		case X6502_MemHook::Write:
 			funcArray = writeFunc;
 			numFuncsRegistered = &numWriteFuncsRegistered;
-			X6502_MemHook::Add(X6502_MemHook::Write, addressWriteCallback, this);
+			hookType = X6502_MemHook::Write;
+			hookFunc = addressWriteCallback;
 		break;
 		case X6502_MemHook::Exec:
 			funcArray = execFunc;
 			numFuncsRegistered = &numExecFuncsRegistered;
-			X6502_MemHook::Add(X6502_MemHook::Exec, addressExecCallback, this);
+			hookType = X6502_MemHook::Exec;
+			hookFunc = addressExecCallback;
 		break;
+		default:
+		{
+			QString msg = "Invalid memory callback type " + QString::number(type) + "\n";
+			script->throwError(QJSValue::TypeError, msg);
+			return;
+		}
 	}
+	X6502_MemHook::Add(hookType, hookFunc, this);
 	n = *numFuncsRegistered;
 
 	if (func.isCallable())
@@ -1705,6 +1716,9 @@ void MemoryScriptObject::registerCallback(int type, const QJSValue& func, int ad
 		}
 	}
 	*numFuncsRegistered = n;
+
+	// Only have the CPU call back for the addresses that now have a function
+	X6502_MemHook::Watch(hookType, hookFunc, this, address, size, func.isCallable());
 }
 //----------------------------------------------------
 void MemoryScriptObject::registerRead(const QJSValue& func, int address, int size)
@@ -1727,22 +1741,35 @@ void MemoryScriptObject::unregisterCallback(int type, const QJSValue& func, int
 	int n=0;
 	int *numFuncsRegistered = nullptr;
 	QJSValue** funcArray = nullptr;
+	X6502_MemHook::Type hookType = X6502_MemHook::Read;
+	void (*hookFunc)(unsigned int address, unsigned int value, void *userData) = nullptr;
 
 	switch (type)
 	{
-		default:
 		case X6502_MemHook::Read:
 			funcArray = readFunc;
 			numFuncsRegistered = &numReadFuncsRegistered;
+			hookType = X6502_MemHook::Read;
+			hookFunc = addressReadCallback;
 		break;
 		case X6502_MemHook::Write:
 			funcArray = writeFunc;
 			numFuncsRegistered = &numWriteFuncsRegistered;
+			hookType = X6502_MemHook::Write;
+			hookFunc = addressWriteCallback;
 		break;
 		case X6502_MemHook::Exec:
 			funcArray = execFunc;
 			numFuncsRegistered = &numExecFuncsRegistered;
+			hookType = X6502_MemHook::Exec;
+			hookFunc = addressExecCallback;
 		break;
+		default:
+		{
+			QString msg = "Invalid memory callback type " + QString::number(type) + "\n";
+			script->throwError(QJSValue::TypeError, msg);
+			return;
+		}
 	}
 	n = *numFuncsRegistered;
 
@@ -1782,6 +1809,8 @@ void MemoryScriptObject::unregisterCallback(int type, const QJSValue& func, int
 	}
 	*numFuncsRegistered = n;
 
+	X6502_MemHook::Watch(hookType, hookFunc, this, address, size, false);
+
 	if (0 <= numReadFuncsRegistered)
 	{
 		X6502_MemHook::Remove(X6502_MemHook::Read, addressReadCallback, this);
@@ -140,6 +140,26 @@ StateRecorderDialog_t::StateRecorderDialog_t(QWidget *parent)
 	frame->setLayout(hbox);
 	grid->addWidget( frame, 1, 1 );
 
+	frame = new QGroupBox(tr("Full Snapshot Every:"));
+	hbox  = new QHBoxLayout();
+
+	keyFrameInterval = new QSpinBox();
+	keyFrameInterval->setMinimum(1);
+	keyFrameInterval->setMaximum(1000);
+	keyFrameInterval->setToolTip( tr("Snapshots in between full ones only hold what changed since the one before.") );
+
+	opt = 20;
+	g_config->getOption("SDL.StateRecorderKeyFrameInterval", &opt);
+	keyFrameInterval->setValue(opt);
+
+	connect( keyFrameInterval, SIGNAL(valueChanged(int)), this, SLOT(spinBoxValueChanged(int)) );
+
+	hbox->addWidget( keyFrameInterval );
+	hbox->addWidget( new QLabel( tr("Snapshots") ) );
+
+	frame->setLayout(hbox);
+	grid->addWidget( frame, 0, 1 );
+
 	frame1 = new QGroupBox(tr("Snapshot Timing Setting:"));
 	hbox1  = new QHBoxLayout();
 	frame1->setLayout(hbox1);
@@ -224,11 +244,13 @@ StateRecorderDialog_t::StateRecorderDialog_t(QWidget *parent)
 	numSnapsLbl      = new QLineEdit();
 	snapMemSizeLbl   = new QLineEdit();
 	totalMemUsageLbl = new QLineEdit();
+	perMinuteMemLbl  = new QLineEdit();
 	saveTimeLbl      = new QLineEdit();
 
 	     numSnapsLbl->setReadOnly(true);
 	  snapMemSizeLbl->setReadOnly(true);
 	totalMemUsageLbl->setReadOnly(true);
+	 perMinuteMemLbl->setReadOnly(true);
 	     saveTimeLbl->setReadOnly(true);
 
 	grid->addWidget(frame, 1, 3, 2, 2);
@@ -242,6 +264,9 @@ StateRecorderDialog_t::StateRecorderDialog_t(QWidget *parent)
 	memStatsGrid->addWidget( new QLabel( tr("Total Size:") ), 2, 0 );
 	memStatsGrid->addWidget( totalMemUsageLbl, 2, 1 );
 
+	memStatsGrid->addWidget( new QLabel( tr("Per Minute:") ), 3, 0 );
+	memStatsGrid->addWidget( perMinuteMemLbl, 3, 1 );
+
 	frame = new QGroupBox( tr("CPU Usage:") );
 	hbox  = new QHBoxLayout();
 	frame->setLayout(hbox);
@@ -378,6 +403,7 @@ void StateRecorderDialog_t::packConfig( StateRecorderConfigData &config )
 	config.timeBetweenSnapsMinutes = static_cast<float>( snapMinutes->value() ) +
 		                          ( static_cast<float>( snapSeconds->value() ) / 60.0f );
 	config.compressionLevel = cmprLvlCbox->currentData().toInt();
+	config.keyFrameInterval = keyFrameInterval->value();
 	config.loadPauseTimeSeconds = pauseDuration->value();
 	config.pauseOnLoad = static_cast<StateRecorderConfigData::PauseType>( pauseOnLoadCbox->currentData().toInt() );
 }
@@ -443,6 +469,7 @@ void StateRecorderDialog_t::applyChanges(void)
 	g_config->setOption("SDL.StateRecorderTimeBetweenSnapsMin", snapMinutes->value() );
 	g_config->setOption("SDL.StateRecorderTimeBetweenSnapsSec", snapSeconds->value() );
 	g_config->setOption("SDL.StateRecorderCompressionLevel", config.compressionLevel);
+	g_config->setOption("SDL.StateRecorderKeyFrameInterval", config.keyFrameInterval);
 	g_config->setOption("SDL.StateRecorderPauseOnLoad", config.pauseOnLoad);
 	g_config->setOption("SDL.StateRecorderPauseDuration", config.loadPauseTimeSeconds);
 	g_config->setOption("SDL.StateRecorderEnable", recorderEnable->isChecked() );
@@ -544,6 +571,7 @@ void StateRecorderDialog_t::updatePeriodic(void)
 {
 	FCEU_WRAPPER_LOCK();
 	updateStatusDisplay();
+	updateMemoryUsageDisplay();
 	FCEU_WRAPPER_UNLOCK();
 }
 //----------------------------------------------------------------------------
@@ -600,9 +628,6 @@ void StateRecorderDialog_t::recalcMemoryUsage(void)
 
 	float fnumSnaps = fhistMin / fsnapMin;
 	float fsnapSize = 10.0f * 1024.0f;
-	float ftotalSize;
-	constexpr float oneKiloByte = 1024.0f;
-	constexpr float oneMegaByte = 1024.0f * 1024.0f;
 
 	int inumSnaps = static_cast<int>( fnumSnaps + 0.5f );
 
@@ -640,35 +665,63 @@ void StateRecorderDialog_t::recalcMemoryUsage(void)
 		FCEU_WRAPPER_UNLOCK();
 	}
 
-	if (fsnapSize >= oneKiloByte)
-	{
-		snprintf( stmp, sizeof(stmp), "%.02f kB", fsnapSize / oneKiloByte );
-	}
-	else
-	{
-		snprintf( stmp, sizeof(stmp), "%.0f B", fsnapSize );
-	}
+	fullSnapSize = fsnapSize;
+	numSnapsEst  = inumSnaps;
 
-	snapMemSizeLbl->setText( tr(stmp) );
+	updateMemoryUsageDisplay();
 
-	ftotalSize = fsnapSize * static_cast<float>(inumSnaps);
+	snprintf( stmp, sizeof(stmp), "%.02f ms", saveTimeMs);
+	saveTimeLbl->setText( tr(stmp) );
+}
+//----------------------------------------------------------------------------
+static void formatMemSize( char *stmp, size_t len, float size )
+{
+	constexpr float oneKiloByte = 1024.0f;
+	constexpr float oneMegaByte = 1024.0f * 1024.0f;
 
-	if (ftotalSize >= oneMegaByte)
+	if (size >= oneMegaByte)
 	{
-		snprintf( stmp, sizeof(stmp), "%.02f MB", ftotalSize / oneMegaByte );
+		snprintf( stmp, len, "%.02f MB", size / oneMegaByte );
 	}
-	else if (ftotalSize >= oneKiloByte)
+	else if (size >= oneKiloByte)
 	{
-		snprintf( stmp, sizeof(stmp), "%.02f kB", ftotalSize / oneKiloByte );
+		snprintf( stmp, len, "%.02f kB", size / oneKiloByte );
 	}
 	else
 	{
-		snprintf( stmp, sizeof(stmp), "%.0f B", ftotalSize );
+		snprintf( stmp, len, "%.0f B", size );
+	}
+}
+//----------------------------------------------------------------------------
+void StateRecorderDialog_t::updateMemoryUsageDisplay(void)
+{
+	char stmp[64];
+
+	// Until the recorder has run, every snapshot is counted at full size. Once it
+	// has, the average of what is actually held is used, so snapshots stored as
+	// changes from the one before show up at what they really cost.
+	float fsnapSize = fullSnapSize;
+	int numSnapsSaved = FCEU_StateRecorderGetNumSnapsSaved();
+
+	if (numSnapsSaved > 0)
+	{
+		fsnapSize = static_cast<float>( FCEU_StateRecorderGetDataSize() ) / static_cast<float>(numSnapsSaved);
 	}
 
+	formatMemSize( stmp, sizeof(stmp), fsnapSize );
+
+	snapMemSizeLbl->setText( tr(stmp) );
+
+	float ftotalSize = fsnapSize * static_cast<float>(numSnapsEst);
+
+	formatMemSize( stmp, sizeof(stmp), ftotalSize );
+
 	totalMemUsageLbl->setText( tr(stmp) );
 
-	snprintf( stmp, sizeof(stmp), "%.02f ms", saveTimeMs);
-	saveTimeLbl->setText( tr(stmp) );
+	float fhistMin = static_cast<float>( historyDuration->value() );
+
+	formatMemSize( stmp, sizeof(stmp), ftotalSize / fhistMin );
+
+	perMinuteMemLbl->setText( tr(stmp) );
 }
 //----------------------------------------------------------------------------
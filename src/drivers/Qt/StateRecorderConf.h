@@ -37,11 +37,13 @@ protected:
 	QSpinBox     *snapSeconds;
 	QSpinBox     *snapFrames;
 	QSpinBox     *historyDuration;
+	QSpinBox     *keyFrameInterval;
 	QSpinBox     *pauseDuration;
 	QCheckBox    *recorderEnable;
 	QLineEdit    *numSnapsLbl;
 	QLineEdit    *snapMemSizeLbl;
 	QLineEdit    *totalMemUsageLbl;
+	QLineEdit    *perMinuteMemLbl;
 	QLineEdit    *saveTimeLbl;
 	QPushButton  *applyButton;
 	QPushButton  *closeButton;
@@ -58,10 +60,13 @@ protected:
 	QTimer       *updateTimer;
 
 	double       saveTimeMs;
+	float        fullSnapSize;
+	int          numSnapsEst;
 	bool         snapUseTime;
 
 	bool dataSavedCheck(void);
 	void recalcMemoryUsage(void);
+	void updateMemoryUsageDisplay(void);
 	void updateStartStopBuffon(void);
 	void updateRecorderStatusLabel(void);
 	void updateBufferSizeStatus(void);
@@ -125,6 +125,10 @@ bool isTaseditorRecording(void)
 	{
 		return false;
 	}
+	if (greenzone->isEmulatingInBackground())
+	{
+		return false;		// replay, Greenzone is being extended while the emulator is paused
+	}
 	if (movie_readonly || playback->getPauseFrame() >= 0 || (taseditorConfig->oldControlSchemeForBranching && !recorder->stateWasLoadedInReadWriteMode))
 	{
 		return false;		// replay
@@ -3433,7 +3437,7 @@ void TasEditorWindow::setGreenzoneCapacity(void)
 	dialog.setWindowTitle( tr("Greenzone Capacity") );
 	dialog.setInputMode( QInputDialog::IntInput );
 	dialog.setIntRange( GREENZONE_CAPACITY_MIN, GREENZONE_CAPACITY_MAX );
-	dialog.setLabelText( tr("Keep savestates for how many frames?\n(actual limit of savestates can be 5 times more than the number provided)") );
+	dialog.setLabelText( tr("Keep savestates in memory for how many frames around Playback cursor?\n(the rest are moved to a temporary file)") );
 	dialog.setIntValue( newValue );
 
 	ret = dialog.exec();
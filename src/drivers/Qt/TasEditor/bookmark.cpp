@@ -64,8 +64,8 @@ bool BOOKMARK::isDifferentFromCurrentMovie()
 
 void BOOKMARK::set()
 {
-	// copy Input and Hotchanges
-	snapshot.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges);
+	// copy Input and Hotchanges, the Input is the same as in current History snapshot
+	snapshot.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges, -1, &history->getCurrentSnapshot().inputlog, currMovieData.getNumRecords());
 	snapshot.keyFrame = currFrameCounter;
 	if (taseditorConfig->enableHotChanges)
 		snapshot.inputlog.copyHotChanges(&history->getCurrentSnapshot().inputlog);
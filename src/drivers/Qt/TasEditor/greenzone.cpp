@@ -14,17 +14,24 @@ Greenzone - Access zone
 * also stores LagLog of current movie Input
 * saves and loads the data from a project file. On error: truncates Greenzone to last successfully read savestate
 * regularly checks if there's a savestate of current emulation state, if there's no such savestate in array then creates one and updates lag info for previous frame
+* while emulation is paused, re-emulates the Input after the end of Greenzone in short time slices, so that it grows back after edits without waiting for Playback
 * implements the working of "Auto-adjust Input according to lag" feature
-* regularly runs gradual cleaning of the savestates array (for memory saving), deleting oldest savestates
+* keeps the latest savestates uncompressed for instant seeking, and has worker threads compress older ones
+* regularly moves savestates far from Playback cursor to a temporary spill file (for memory saving); if the file can't be used, runs gradual cleaning of the savestates array instead, deleting oldest savestates
 * on demand: (when movie Input was changed) truncates the size of Greenzone, deleting savestates that became irrelevant because of new Input. After truncating it may also move Playback cursor (which must always reside within Greenzone) and may launch Playback seeking
 * stores resources: save id, properties of gradual cleaning, timing of cleaning
 ------------------------------------------------------------------------------------ */
 
 #include <zlib.h>
 
+#include <QTemporaryFile>
+
 #include "fceu.h"
 #include "state.h"
 #include "driver.h"
+#include "fceulua.h"
+#include "movie.h"
+#include "debug.h"
 #include "Qt/TasEditor/taseditor_project.h"
 #include "Qt/TasEditor/TasEditorWindow.h"
 
@@ -33,9 +40,142 @@ extern char lagFlag;
 static char greenzone_save_id[GREENZONE_ID_LEN] = "GREENZONE";
 static char greenzone_skipsave_id[GREENZONE_ID_LEN] = "GREENZONX";
 
+// savestates logged with Z_NO_COMPRESSION have ~0 in place of the compressed size
+static bool isRawSavestate(const uint8_t* data, unsigned int size)
+{
+	return size >= 16 && data[12] == 0xFF && data[13] == 0xFF && data[14] == 0xFF && data[15] == 0xFF;
+}
+
+GREENZONE_SPILL_FILE::GREENZONE_SPILL_FILE()
+{
+	file = NULL;
+	used = 0;
+	failed = false;
+}
+GREENZONE_SPILL_FILE::~GREENZONE_SPILL_FILE()
+{
+	reset();
+	delete file;
+}
+// forgets everything in the file and gives the disk space back
+void GREENZONE_SPILL_FILE::reset()
+{
+	if (file)
+	{
+		for (size_t i = 0; i < segments.size(); ++i)
+			file->unmap(segments[i]);
+		file->resize(0);
+	}
+	segments.clear();
+	used = 0;
+	freeRanges.clear();
+	freeRangesBySize.clear();
+	failed = false;
+}
+// copies the data into the smallest released range it fits in, or else to the end of the file
+// returns false if the file couldn't be grown
+bool GREENZONE_SPILL_FILE::store(const std::vector<uint8_t>& data, uint64_t& offset)
+{
+	uint64_t size = data.size();
+	if (failed || !size || size > GREENZONE_SPILL_SEGMENT_SIZE)
+		return false;
+	std::set<std::pair<uint64_t, uint64_t>>::iterator fit = freeRangesBySize.lower_bound(std::make_pair(size, (uint64_t)0));
+	if (fit != freeRangesBySize.end())
+	{
+		uint64_t rangeSize = fit->first;
+		offset = fit->second;
+		removeFreeRange(freeRanges.find(offset));
+		if (rangeSize > size)
+			addFreeRange(offset + size, rangeSize - size);
+		memcpy(segments[offset / GREENZONE_SPILL_SEGMENT_SIZE] + offset % GREENZONE_SPILL_SEGMENT_SIZE, &data[0], size);
+		return true;
+	}
+	// a savestate never straddles two segments, the rest of this one is left for smaller ones
+	if (used % GREENZONE_SPILL_SEGMENT_SIZE + size > GREENZONE_SPILL_SEGMENT_SIZE)
+	{
+		uint64_t rest = GREENZONE_SPILL_SEGMENT_SIZE - used % GREENZONE_SPILL_SEGMENT_SIZE;
+		size_t lastSegment = used / GREENZONE_SPILL_SEGMENT_SIZE;
+		if (lastSegment < segments.size())
+			addFreeRange(used, rest);
+		used += rest;
+	}
+	size_t segment = used / GREENZONE_SPILL_SEGMENT_SIZE;
+	if (segment >= segments.size())
+	{
+		// the new segment is written out with zeros rather than left sparse, so a full disk shows up here instead of as a fault on the mapping
+		static const std::vector<char> zeros(1 << 20, 0);
+		qint64 start = (qint64)segment * GREENZONE_SPILL_SEGMENT_SIZE;
+		uint8_t* view = NULL;
+		if (!file)
+			file = new QTemporaryFile();
+		bool ok = (file->isOpen() || file->open()) && file->seek(start);
+		for (qint64 pos = start; ok && pos < start + GREENZONE_SPILL_SEGMENT_SIZE; pos += zeros.size())
+			ok = file->write(&zeros[0], zeros.size()) == (qint64)zeros.size();
+		if (ok && file->flush())
+			view = file->map(start, GREENZONE_SPILL_SEGMENT_SIZE);
+		if (!view)
+		{
+			FCEU_printf("Greenzone spill file could not be grown, thinning out old savestates instead\n");
+			failed = true;
+			return false;
+		}
+		segments.push_back(view);
+	}
+	offset = used;
+	memcpy(segments[segment] + used % GREENZONE_SPILL_SEGMENT_SIZE, &data[0], size);
+	used += size;
+	return true;
+}
+// gives the range back for storing other savestates
+void GREENZONE_SPILL_FILE::release(uint64_t offset, uint64_t size)
+{
+	if (size)
+		addFreeRange(offset, size);
+}
+// adds the range to the free ones, merging it with its neighbours in the same segment
+void GREENZONE_SPILL_FILE::addFreeRange(uint64_t offset, uint64_t size)
+{
+	uint64_t segmentStart = offset - offset % GREENZONE_SPILL_SEGMENT_SIZE;
+	std::map<uint64_t, uint64_t>::iterator next = freeRanges.lower_bound(offset);
+	if (next != freeRanges.begin())
+	{
+		std::map<uint64_t, uint64_t>::iterator prev = next;
+		--prev;
+		if (prev->first >= segmentStart && prev->first + prev->second == offset)
+		{
+			offset = prev->first;
+			size += prev->second;
+			removeFreeRange(prev);
+		}
+	}
+	if (next != freeRanges.end() && next->first == offset + size && offset + size < segmentStart + GREENZONE_SPILL_SEGMENT_SIZE)
+	{
+		size += next->second;
+		removeFreeRange(next);
+	}
+	freeRanges[offset] = size;
+	freeRangesBySize.insert(std::make_pair(size, offset));
+}
+void GREENZONE_SPILL_FILE::removeFreeRange(std::map<uint64_t, uint64_t>::iterator range)
+{
+	freeRangesBySize.erase(std::make_pair(range->second, range->first));
+	freeRanges.erase(range);
+}
+const uint8_t* GREENZONE_SPILL_FILE::at(uint64_t offset)
+{
+	return segments[offset / GREENZONE_SPILL_SEGMENT_SIZE] + offset % GREENZONE_SPILL_SEGMENT_SIZE;
+}
+bool GREENZONE_SPILL_FILE::isUsable()
+{
+	return !failed;
+}
+// -------------------------------------------------------------------------------------------------
 GREENZONE::GREENZONE()
 {
 	nextCleaningTime = 0;
+	spilledCount = 0;
+	emulatingInBackground = false;
+	backgroundBlockedAt = -1;
 }
 
 void GREENZONE::init()
@@ -46,6 +186,12 @@ void GREENZONE::init()
 void GREENZONE::free()
 {
 	savestates.resize(0);
+	pendingSavestates.clear();
+	hotFrames.clear();
+	spilledSavestates.resize(0);
+	spilledCount = 0;
+	spillFile.reset();
+	backgroundBlockedAt = -1;
 	greenzoneSize = 0;
 	lagLog.reset();
 }
@@ -55,6 +201,9 @@ void GREENZONE::reset()
 }
 void GREENZONE::update()
 {
+	// take in the savestates that worker threads have finished compressing
+	collectCompressedSavestates();
+
 	// keep collecting savestates, this code must be executed at the end of every frame
 	if (taseditorConfig->enableGreenzoning)
 	{
@@ -102,36 +251,213 @@ void GREENZONE::update()
 			}
 		}
 	}
+
+	runBackgroundEmulation();
 }
+// emulates the frames after the end of Greenzone while the emulator is paused, then puts the emulation state back
+// stops at the end of the time slice, at the end of the movie, or where Auto-adjust would have to change the Input
+void GREENZONE::runBackgroundEmulation()
+{
+	if (!taseditorConfig->enableGreenzoning || !taseditorConfig->enableBackgroundGreenzoning)
+		return;
+	if (!FCEUI_EmulationPaused() || playback->getPauseFrame() >= 0 || FCEU_LuaRunning())
+		return;
+	// a breakpoint would block inside the slice, and the trace and CDL loggers would log frames nobody asked for
+	if (DebugCycleActive())
+		return;
+	// recording mode would write the current joypad state into the frames being emulated
+	if (isTaseditorRecording())
+		return;
+	// emulating the last frame of the movie would pad it with an empty frame
+	if (greenzoneSize <= 0 || greenzoneSize >= currMovieData.getNumRecords() || greenzoneSize == backgroundBlockedAt)
+		return;
+	if (isSavestateEmpty(greenzoneSize - 1))
+		return;
 
-void GREENZONE::collectCurrentState()
+	liveSavestate.resize(0);
+	EMUFILE_MEMORY live(&liveSavestate);
+	if (!FCEUSS_SaveMS(&live, Z_NO_COMPRESSION))
+		return;
+	live.trim();
+	char liveLagFlag = lagFlag;
+	if (!loadSavestateOfFrame(greenzoneSize - 1))
+	{
+		EMUFILE_MEMORY ms(&liveSavestate);
+		FCEUSS_LoadFP(&ms, SSLOADPARAM_NOBACKUP);
+		return;
+	}
+
+	// every emulated frame goes through FCEUMOV_AddInputState, which drops the commands (reset, power...) queued for the live frame
+	int liveCommands = FCEUMOV_GetCommands();
+	emulatingInBackground = true;
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(BACKGROUND_EMULATION_TIME_SLICE);
+	while (currFrameCounter < currMovieData.getNumRecords() - 1 && std::chrono::steady_clock::now() < deadline)
+	{
+		FCEUI_EmulateQuiet();
+		int old_lagFlag = lagLog.getLagInfoAtFrame(currFrameCounter - 1);
+		if (taseditorConfig->autoAdjustInputAccordingToLag && old_lagFlag != LAGGED_UNKNOWN && (old_lagFlag == LAGGED_YES) != (lagFlag != 0))
+		{
+			// the Input has to be shifted, leave it to Playback
+			backgroundBlockedAt = greenzoneSize;
+			break;
+		}
+		if (old_lagFlag != (lagFlag ? LAGGED_YES : LAGGED_NO))
+		{
+			lagLog.setLagInfo(currFrameCounter - 1, lagFlag != 0);
+			// keep current snapshot laglog in touch
+			history->getCurrentSnapshot().laglog.setLagInfo(currFrameCounter - 1, lagFlag != 0);
+		}
+		collectCurrentState(false);
+	}
+	emulatingInBackground = false;
+
+	EMUFILE_MEMORY ms(&liveSavestate);
+	FCEUSS_LoadFP(&ms, SSLOADPARAM_NOBACKUP);
+	lagFlag = liveLagFlag;
+	FCEUMOV_SetCommands(liveCommands);
+}
+bool GREENZONE::isEmulatingInBackground()
+{
+	return emulatingInBackground;
+}
+
+// "hot" savestates are kept uncompressed for a while, others are handed to the worker threads right away
+void GREENZONE::collectCurrentState(bool hot)
 {
 	if ((int)savestates.size() <= currFrameCounter)
 		savestates.resize(currFrameCounter + 1);
 	// if frame is not saved - log savestate
-	if (!savestates[currFrameCounter].size())
+	if (!savestates[currFrameCounter].size() && !isSavestateSpilled(currFrameCounter))
 	{
+		// log it uncompressed, so it can be loaded right away; it gets compressed when it's no longer among the latest ones
 		EMUFILE_MEMORY ms(&savestates[currFrameCounter]);
-		FCEUSS_SaveMS(&ms, Z_DEFAULT_COMPRESSION);
+		FCEUSS_SaveMS(&ms, Z_NO_COMPRESSION);
 		ms.trim();
+		dropPendingSavestate(currFrameCounter);
+		if (!hot)
+		{
+			compressSavestate(currFrameCounter);
+			if (greenzoneSize <= currFrameCounter)
+				greenzoneSize = currFrameCounter + 1;
+			return;
+		}
+		hotFrames.push_back(currFrameCounter);
+		int hotLimit = taseditorConfig->greenzoneHotFrames > 0 ? taseditorConfig->greenzoneHotFrames : 0;
+		while ((int)hotFrames.size() > hotLimit)
+		{
+			compressSavestate(hotFrames.front());
+			hotFrames.pop_front();
+		}
 	}
 	if (greenzoneSize <= currFrameCounter)
 		greenzoneSize = currFrameCounter + 1;
 }
+// moves the savestates that have been compressed in place of their uncompressed copies
+// if "wait" is true, waits for the ones that are still being compressed
+void GREENZONE::collectCompressedSavestates(bool wait)
+{
+	for (int i = pendingSavestates.size() - 1; i >= 0; i--)
+	{
+		PendingSavestate& pending = pendingSavestates[i];
+		if (!wait && pending.compressed.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			continue;
+		std::vector<uint8_t> compressed = pending.compressed.get();
+		// if compression failed, the uncompressed savestate is kept
+		if (compressed.size() && pending.frame < (int)savestates.size() && savestates[pending.frame].size())
+			savestates[pending.frame].swap(compressed);
+		pendingSavestates.erase(pendingSavestates.begin() + i);
+	}
+}
+// lets a worker thread compress the savestate of the frame, if it's still uncompressed
+void GREENZONE::compressSavestate(int frame)
+{
+	if (frame >= (int)savestates.size() || !isRawSavestate(savestates[frame].data(), savestates[frame].size()))
+		return;
+	for (size_t i = 0; i < pendingSavestates.size(); ++i)
+	{
+		if (pendingSavestates[i].frame == frame)
+			return;
+	}
+	PendingSavestate pending;
+	pending.frame = frame;
+	pending.compressed = FCEUSS_CompressMSAsync(&savestates[frame][0], savestates[frame].size(), Z_DEFAULT_COMPRESSION);
+	pendingSavestates.push_back(std::move(pending));
+}
+// forgets about the compression of a savestate that is being replaced or cleared
+void GREENZONE::dropPendingSavestate(int frame)
+{
+	for (int i = pendingSavestates.size() - 1; i >= 0; i--)
+	{
+		if (pendingSavestates[i].frame == frame)
+			pendingSavestates.erase(pendingSavestates.begin() + i);
+	}
+}
 
 bool GREENZONE::loadSavestateOfFrame(unsigned int frame)
 {
-	if (frame >= savestates.size() || !savestates[frame].size())
+	if (frame < savestates.size() && savestates[frame].size())
+	{
+		EMUFILE_MEMORY ms(&savestates[frame]);
+		return FCEUSS_LoadFP(&ms, SSLOADPARAM_NOBACKUP);
+	}
+	if (!isSavestateSpilled(frame))
 		return false;
-	EMUFILE_MEMORY ms(&savestates[frame]);
+	EMUFILE_MEMORY ms((void*)spillFile.at(spilledSavestates[frame].offset), spilledSavestates[frame].size);
 	return FCEUSS_LoadFP(&ms, SSLOADPARAM_NOBACKUP);
 }
 
 void GREENZONE::runGreenzoneCleaning()
+{
+	// move the savestates far from Playback cursor to the spill file, or thin them out if it can't be used
+	bool changed = false;
+	if (!spillDistantSavestates())
+		changed = thinOutSavestates();
+	if (changed)
+	{
+		//pianoRoll.redraw();
+		bookmarks->redrawBookmarksList();
+	}
+	// shedule next cleaning
+	nextCleaningTime = getTasEditorTime() + TIME_BETWEEN_CLEANINGS;
+}
+// moves the compressed savestates that are more than greenzoneCapacity frames away from Playback cursor to the spill file
+// returns false if the spill file can't be used
+bool GREENZONE::spillDistantSavestates()
+{
+	if (!taseditorConfig->greenzoneSpillToDisk || !spillFile.isUsable())
+		return false;
+	int nearStart = currFrameCounter - taseditorConfig->greenzoneCapacity;
+	int nearEnd = currFrameCounter + taseditorConfig->greenzoneCapacity;
+	if (spilledSavestates.size() < savestates.size())
+		spilledSavestates.resize(savestates.size());
+	// zeroth frame stays in memory
+	for (int i = 1; i < (int)savestates.size(); ++i)
+	{
+		if (i >= nearStart && i <= nearEnd)
+		{
+			i = nearEnd;
+			continue;
+		}
+		// uncompressed savestates are waiting for a worker thread, they can go next time
+		if (!savestates[i].size() || isRawSavestate(&savestates[i][0], savestates[i].size()))
+			continue;
+		uint64_t offset;
+		if (!spillFile.store(savestates[i], offset))
+			return false;
+		spilledSavestates[i].offset = offset;
+		spilledSavestates[i].size = savestates[i].size();
+		spilledCount++;
+		savestates[i].clear();
+		savestates[i].shrink_to_fit();
+	}
+	return true;
+}
+// deletes older savestates, keeping 1/2, then 1/4, 1/8 and 1/16 of them, returns true if anything was deleted
+bool GREENZONE::thinOutSavestates()
 {
 	bool changed = false;
 	int i = currFrameCounter - taseditorConfig->greenzoneCapacity;
-	if (i <= 0) goto finish;	// zeroth frame should not be cleaned
+	if (i <= 0) return changed;	// zeroth frame should not be cleaned
 	int limit;
 	// 2x of 1/2
 	limit = i - 2 * taseditorConfig->greenzoneCapacity;
@@ -141,7 +467,7 @@ void GREENZONE::runGreenzoneCleaning()
 		if (i & 0x1)
 			changed = changed | clearSavestateAndFreeMemory(i);
 	}
-	if (i < 0) goto finish;
+	if (i < 0) return changed;
 	// 4x of 1/4
 	limit = i - 4 * taseditorConfig->greenzoneCapacity;
 	if (limit < 0) limit = 0;
@@ -150,7 +476,7 @@ void GREENZONE::runGreenzoneCleaning()
 		if (i & 0x3)
 			changed = changed | clearSavestateAndFreeMemory(i);
 	}
-	if (i < 0) goto finish;
+	if (i < 0) return changed;
 	// 8x of 1/8
 	limit = i - 8 * taseditorConfig->greenzoneCapacity;
 	if (limit < 0) limit = 0;
@@ -159,7 +485,7 @@ void GREENZONE::runGreenzoneCleaning()
 		if (i & 0x7)
 			changed = changed | clearSavestateAndFreeMemory(i);
 	}
-	if (i < 0) goto finish;
+	if (i < 0) return changed;
 	// 16x of 1/16
 	limit = i - 16 * taseditorConfig->greenzoneCapacity;
 	if (limit < 0) limit = 0;
@@ -173,33 +499,30 @@ void GREENZONE::runGreenzoneCleaning()
 	{
 		changed = changed | clearSavestateAndFreeMemory(i);
 	}
-finish:
-	if (changed)
-	{
-		//pianoRoll.redraw();
-		bookmarks->redrawBookmarksList();
-	}
-	// shedule next cleaning
-	nextCleaningTime = getTasEditorTime() + TIME_BETWEEN_CLEANINGS;
+	return changed;
 }
 
 // returns true if actually cleared savestate data
 bool GREENZONE::clearSavestateOfFrame(unsigned int frame)
 {
+	bool spilled = forgetSpilledSavestate(frame);
 	if (frame < savestates.size() && savestates[frame].size())
 	{
+		dropPendingSavestate(frame);
 	    savestates[frame].resize(0);
 		return true;
 	}
 	else
 	{
-		return false;
+		return spilled;
 	}
 }
 bool GREENZONE::clearSavestateAndFreeMemory(unsigned int frame)
 {
+	bool spilled = forgetSpilledSavestate(frame);
 	if (frame < savestates.size() && savestates[frame].size())
 	{
+		dropPendingSavestate(frame);
 		//savestates[frame].swap(std::vector<uint8_t>()); //FIXME
 		savestates[frame].clear();
 		savestates[frame].shrink_to_fit();
@@ -207,9 +530,21 @@ bool GREENZONE::clearSavestateAndFreeMemory(unsigned int frame)
 	}
 	else
 	{
-		return false;
+		return spilled;
 	}
 }
+// returns true if the frame had a savestate in the spill file
+bool GREENZONE::forgetSpilledSavestate(unsigned int frame)
+{
+	if (!isSavestateSpilled(frame))
+		return false;
+	spillFile.release(spilledSavestates[frame].offset, spilledSavestates[frame].size);
+	spilledSavestates[frame].size = 0;
+	// the disk space itself only comes back once nothing in the file is used
+	if (--spilledCount == 0)
+		spillFile.reset();
+	return true;
+}
 
 void GREENZONE::ungreenzoneSelectedFrames()
 {
@@ -238,6 +573,7 @@ void GREENZONE::save(EMUFILE *os, int save_type)
 	{
 		setTasProjectProgressBarText("Saving Greenzone...");
 		collectCurrentState();		// in case the project is being saved before the greenzone.update() was called within current frame
+		collectCompressedSavestates(true);
 		runGreenzoneCleaning();
 		if (greenzoneSize > (int)savestates.size())
 			greenzoneSize = savestates.size();
@@ -252,7 +588,9 @@ void GREENZONE::save(EMUFILE *os, int save_type)
 
 		setTasProjectProgressBar( 0, greenzoneSize );
 	}
-	int frame, size;
+	int frame;
+	unsigned int size;
+	const uint8_t* data;
 	int last_tick = -1;
 
 	switch (save_type)
@@ -269,12 +607,12 @@ void GREENZONE::save(EMUFILE *os, int save_type)
 					playback->setProgressbar(frame, greenzoneSize);
 					last_tick = frame / PROGRESSBAR_UPDATE_RATE;
 				}
-				if (!savestates[frame].size()) continue;
+				data = getSavestateForSaving(frame, size);
+				if (!data) continue;
 				write32le(frame, os);
 				// write savestate
-				size = savestates[frame].size();
 				write32le(size, os);
-				os->fwrite(&savestates[frame][0], size);
+				os->fwrite(data, size);
 			}
 			// write -1 as eof for greenzone
 			write32le(-1, os);
@@ -294,12 +632,12 @@ void GREENZONE::save(EMUFILE *os, int save_type)
 						playback->setProgressbar(frame, greenzoneSize);
 						last_tick = frame / PROGRESSBAR_UPDATE_RATE;
 					}
-					if (!savestates[frame].size()) continue;
+					data = getSavestateForSaving(frame, size);
+					if (!data) continue;
 					write32le(frame, os);
 					// write savestate
-					size = savestates[frame].size();
 					write32le(size, os);
-					os->fwrite(&savestates[frame][0], size);
+					os->fwrite(data, size);
 				}
 			}
 			// write -1 as eof for greenzone
@@ -320,12 +658,12 @@ void GREENZONE::save(EMUFILE *os, int save_type)
 						playback->setProgressbar(frame, greenzoneSize);
 						last_tick = frame / PROGRESSBAR_UPDATE_RATE;
 					}
-					if (!savestates[frame].size()) continue;
+					data = getSavestateForSaving(frame, size);
+					if (!data) continue;
 					write32le(frame, os);
 					// write savestate
-					size = savestates[frame].size();
 					write32le(size, os);
-					os->fwrite(&savestates[frame][0], size);
+					os->fwrite(data, size);
 				}
 			}
 			// write -1 as eof for greenzone
@@ -344,9 +682,10 @@ void GREENZONE::save(EMUFILE *os, int save_type)
 			{
 				// write ONE savestate for currFrameCounter
 				collectCurrentState();
-				int size = savestates[currFrameCounter].size();
+				collectCompressedSavestates(true);
+				data = getSavestateForSaving(currFrameCounter, size);
 				write32le(size, os);
-				os->fwrite(&savestates[currFrameCounter][0], size);
+				os->fwrite(data, size);
 			}
 			break;
 		}
@@ -433,6 +772,8 @@ bool GREENZONE::load(EMUFILE *is, unsigned int offset)
 			int greenzone_tail_frame4 = greenzone_tail_frame - 4 * taseditorConfig->greenzoneCapacity;
 			int greenzone_tail_frame8 = greenzone_tail_frame - 8 * taseditorConfig->greenzoneCapacity;
 			int greenzone_tail_frame16 = greenzone_tail_frame - 16 * taseditorConfig->greenzoneCapacity;
+			int greenzone_head_frame = currFrameCounter + taseditorConfig->greenzoneCapacity;
+			bool spill = taseditorConfig->greenzoneSpillToDisk;
 			// read savestates
 			while(1)
 			{
@@ -448,7 +789,29 @@ bool GREENZONE::load(EMUFILE *is, unsigned int offset)
 				// read savestate
 				if (!read32le(&size, is)) break;
 				if (size < 0) break;
-				if (frame <= greenzone_tail_frame16
+				if (spill && frame > 0 && (frame < greenzone_tail_frame || frame > greenzone_head_frame))
+				{
+					// put this savestate straight into the spill file
+					savingBuffer.resize(size);
+					if (is->fread(&savingBuffer[0], size) < size) break;
+					if ((int)savestates.size() <= frame)
+						savestates.resize(frame + 1);
+					if ((int)spilledSavestates.size() <= frame)
+						spilledSavestates.resize(frame + 1);
+					uint64_t offset;
+					if (spillFile.store(savingBuffer, offset))
+					{
+						spilledSavestates[frame].offset = offset;
+						spilledSavestates[frame].size = size;
+						spilledCount++;
+					} else
+					{
+						// keep it in memory, cleaning will thin them out
+						savestates[frame] = savingBuffer;
+						spill = false;
+					}
+					prev_frame = frame;			// successfully read one Greenzone frame info
+				} else if (frame <= greenzone_tail_frame16
 					|| (frame <= greenzone_tail_frame8 && (frame & 0xF))
 					|| (frame <= greenzone_tail_frame4 && (frame & 0x7))
 					|| (frame <= greenzone_tail_frame2 && (frame & 0x3))
@@ -604,6 +967,8 @@ void GREENZONE::invalidate(int after)
 		// clear all savestates that became irrelevant
 		for (int i = savestates.size() - 1; i > after; i--)
 			clearSavestateOfFrame(i);
+		// the Input has changed, so background emulation may go on
+		backgroundBlockedAt = -1;
 		if (greenzoneSize > after + 1)
 		{
 			greenzoneSize = after + 1;
@@ -624,6 +989,7 @@ void GREENZONE::invalidateAndUpdatePlayback(int after)
 		// clear all savestates that became irrelevant
 		for (int i = savestates.size() - 1; i > after; i--)
 			clearSavestateOfFrame(i);
+		backgroundBlockedAt = -1;
 		if (greenzoneSize > after + 1 || currFrameCounter > after)
 		{
 			greenzoneSize = after + 1;
@@ -655,7 +1021,7 @@ void GREENZONE::invalidateAndUpdatePlayback(int after)
 int GREENZONE::findFirstGreenzonedFrame(int starting_index)
 {
 	for (int i = starting_index; i < greenzoneSize; ++i)
-		if (savestates[i].size()) return i;
+		if (savestates[i].size() || isSavestateSpilled(i)) return i;
 	return -1;	// error
 }
 
@@ -668,13 +1034,53 @@ int GREENZONE::getSize()
 // this should only be used by Bookmark Set procedure
 std::vector<uint8>& GREENZONE::getSavestateOfFrame(int frame)
 {
-	return savestates[frame];
+	collectCompressedSavestates(true);
+	unsigned int size;
+	const uint8_t* data = getSavestateForSaving(frame, size);
+	if (!data)
+		savingBuffer.clear();
+	else if (frame < (int)savestates.size() && data == savestates[frame].data())
+		return savestates[frame];
+	else if (data != savingBuffer.data())
+		savingBuffer.assign(data, data + size);
+	return savingBuffer;
+}
+// returns the compressed savestate of the frame, from memory or from the spill file, or NULL if there's none
+const uint8_t* GREENZONE::getSavestateForSaving(int frame, unsigned int& size)
+{
+	const uint8_t* data;
+	if (frame < (int)savestates.size() && savestates[frame].size())
+	{
+		data = &savestates[frame][0];
+		size = savestates[frame].size();
+	} else if (isSavestateSpilled(frame))
+	{
+		data = spillFile.at(spilledSavestates[frame].offset);
+		size = spilledSavestates[frame].size;
+	} else
+	{
+		size = 0;
+		return NULL;
+	}
+	if (isRawSavestate(data, size))
+	{
+		std::vector<uint8_t> compressed = FCEUSS_CompressMSAsync(data, size, Z_DEFAULT_COMPRESSION).get();
+		if (compressed.size())
+		{
+			savingBuffer.swap(compressed);
+			data = &savingBuffer[0];
+			size = savingBuffer.size();
+		}
+	}
+	return data;
 }
 // this function should only be used by Bookmark Deploy procedure
 void GREENZONE::writeSavestateForFrame(int frame, std::vector<uint8>& savestate)
 {
 	if ((int)savestates.size() <= frame)
 		savestates.resize(frame + 1);
+	dropPendingSavestate(frame);
+	forgetSpilledSavestate(frame);
 	savestates[frame] = savestate;
 	if (greenzoneSize <= frame)
 		greenzoneSize = frame + 1;
@@ -682,9 +1088,13 @@ void GREENZONE::writeSavestateForFrame(int frame, std::vector<uint8>& savestate)
 
 bool GREENZONE::isSavestateEmpty(unsigned int frame)
 {
-	if ((int)frame < greenzoneSize && frame < savestates.size() && savestates[frame].size())
+	if ((int)frame < greenzoneSize && ((frame < savestates.size() && savestates[frame].size()) || isSavestateSpilled(frame)))
 		return false;
 	else
 		return true;
 }
+bool GREENZONE::isSavestateSpilled(unsigned int frame)
+{
+	return frame < spilledSavestates.size() && spilledSavestates[frame].size;
+}
 
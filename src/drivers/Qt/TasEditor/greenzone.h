@@ -2,6 +2,10 @@
 #pragma once
 #include <stdint.h>
 #include <vector>
+#include <deque>
+#include <future>
+#include <map>
+#include <set>
 
 #include "Qt/TasEditor/laglog.h"
 
@@ -17,6 +21,38 @@
 
 #define PROGRESSBAR_UPDATE_RATE 1000	// progressbar is updated after every 1000 savestates loaded from FM3 file
 
+#define GREENZONE_SPILL_SEGMENT_SIZE (64 << 20)	// the spill file grows and is mapped this many bytes at a time
+
+#define BACKGROUND_EMULATION_TIME_SLICE 10		// milliseconds of every paused frame update spent on extending the Greenzone
+
+class QTemporaryFile;
+
+// Temporary file for the savestates that are far from Playback cursor
+// the space of released savestates is reused before the file is grown
+class GREENZONE_SPILL_FILE
+{
+public:
+	GREENZONE_SPILL_FILE();
+	~GREENZONE_SPILL_FILE();
+	void reset();
+
+	bool store(const std::vector<uint8_t>& data, uint64_t& offset);
+	void release(uint64_t offset, uint64_t size);
+	const uint8_t* at(uint64_t offset);
+	bool isUsable();
+
+private:
+	void addFreeRange(uint64_t offset, uint64_t size);
+	void removeFreeRange(std::map<uint64_t, uint64_t>::iterator range);
+
+	QTemporaryFile* file;
+	std::vector<uint8_t*> segments;		// mapped views of the file
+	uint64_t used;
+	std::map<uint64_t, uint64_t> freeRanges;		// offset -> size of the released ranges below used
+	std::set<std::pair<uint64_t, uint64_t>> freeRangesBySize;		// (size, offset) of the same ranges, for best fit
+	bool failed;
+};
+
 class GREENZONE
 {
 public:
@@ -25,6 +61,8 @@ public:
 	void reset();
 	void free();
 	void update();
+	void runBackgroundEmulation();
+	bool isEmulatingInBackground();
 
 	void save(EMUFILE *os, int save_type = GREENZONE_SAVING_MODE_ALL);
 	bool load(EMUFILE *is, unsigned int offset);
@@ -44,12 +82,20 @@ public:
 	std::vector<uint8_t>& getSavestateOfFrame(int frame);
 	void writeSavestateForFrame(int frame, std::vector<uint8>& savestate);
 	bool isSavestateEmpty(unsigned int frame);
+	bool isSavestateSpilled(unsigned int frame);
 
 	// saved data
 	LAGLOG lagLog;
 
 private:
-	void collectCurrentState();
+	void collectCurrentState(bool hot = true);
+	void collectCompressedSavestates(bool wait = false);
+	void compressSavestate(int frame);
+	void dropPendingSavestate(int frame);
+	bool spillDistantSavestates();
+	bool thinOutSavestates();
+	bool forgetSpilledSavestate(unsigned int frame);
+	const uint8_t* getSavestateForSaving(int frame, unsigned int& size);
 	bool clearSavestateOfFrame(unsigned int frame);
 	bool clearSavestateAndFreeMemory(unsigned int frame);
 
@@ -61,6 +107,25 @@ private:
 	std::vector<std::vector<uint8_t>> savestates;
 
 	// not saved data
+	struct PendingSavestate
+	{
+		int frame;
+		std::future<std::vector<uint8_t>> compressed;
+	};
+	std::vector<PendingSavestate> pendingSavestates;		// savestates being compressed by worker threads
+	std::deque<int> hotFrames;		// frames whose savestates were logged uncompressed, oldest first
+	struct SpilledSavestate
+	{
+		uint64_t offset;
+		uint32_t size;		// 0 = the savestate is not in the spill file
+	};
+	std::vector<SpilledSavestate> spilledSavestates;
+	int spilledCount;
+	GREENZONE_SPILL_FILE spillFile;
+	std::vector<uint8_t> savingBuffer;
+	std::vector<uint8_t> liveSavestate;		// emulation state of Playback cursor while the Greenzone is extended in background
+	bool emulatingInBackground;
+	int backgroundBlockedAt;		// Greenzone size at which background emulation found a lag change for Auto-adjust, -1 = none
 	uint64_t nextCleaningTime;
 	
 };
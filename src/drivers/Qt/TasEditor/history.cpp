@@ -472,9 +472,42 @@ void HISTORY::addItemToHistoryLog(SNAPSHOT &snap, int cur_branch, BOOKMARK &book
 // returns frame of first actual change
 int HISTORY::registerChanges(int mod_type, int start, int end, int size, const char* comment, int consecutivenessTag, RowsSelection* frameset)
 {
+	// find the frames the change can have touched, the new snapshot shares the Input around them with the current one
+	int last_change = end, shift = 0;
+	switch (mod_type)
+	{
+		case MODTYPE_INSERTNUM:
+			last_change = start + size - 1;
+			shift = size;
+			break;
+		case MODTYPE_INSERT:
+		case MODTYPE_CLONE:
+			// the frameset is the Selection before the frames were inserted
+			if (frameset && frameset->size())
+			{
+				last_change = *frameset->rbegin() + frameset->size();
+				shift = frameset->size();
+			}
+			break;
+		case MODTYPE_DELETE:
+			if (frameset && frameset->size())
+			{
+				last_change = *frameset->rbegin() - frameset->size();
+				shift = -(int)frameset->size();
+			}
+			break;
+		case MODTYPE_PASTEINSERT:
+			// the frameset is the inserted frames
+			if (frameset && frameset->size())
+			{
+				last_change = *frameset->rbegin();
+				shift = frameset->size();
+			}
+			break;
+	}
 	// create new snapshot
 	SNAPSHOT snap;
-	snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges);
+	snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges, -1, &getCurrentSnapshot().inputlog, start, last_change, shift);
 	// check if there are Input differences from latest snapshot
 	int real_pos = (historyStartPos + historyCursorPos) % historySize;
 	int first_changes = snap.inputlog.findFirstChange(snapshots[real_pos].inputlog, start, end);
@@ -629,9 +662,9 @@ int HISTORY::registerChanges(int mod_type, int start, int end, int size, const c
 }
 int HISTORY::registerAdjustLag(int start, int size)
 {
-	// create new snapshot
+	// create new snapshot, size frames were inserted (or deleted if negative) at start
 	SNAPSHOT snap;
-	snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges);
+	snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges, -1, &getCurrentSnapshot().inputlog, start, size > 0 ? start + size - 1 : start - 1, size);
 	// check if there are Input differences from latest snapshot
 	int real_pos = (historyStartPos + historyCursorPos) % historySize;
 	SNAPSHOT& current_snap = snapshots[real_pos];
@@ -669,9 +702,9 @@ int HISTORY::registerAdjustLag(int start, int size)
 }
 void HISTORY::registerMarkersChange(int modificationType, int start, int end, const char* comment)
 {
-	// create new snapshot
+	// create new snapshot, the Input is the same
 	SNAPSHOT snap;
-	snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges);
+	snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges, -1, &getCurrentSnapshot().inputlog, currMovieData.getNumRecords());
 	// fill description:
 	snap.modificationType = modificationType;
 	strcat(snap.description, modCaptions[modificationType]);
@@ -709,9 +742,9 @@ void HISTORY::registerMarkersChange(int modificationType, int start, int end, co
 }
 void HISTORY::registerBookmarkSet(int slot, BOOKMARK& backupCopy, int oldCurrentBranch)
 {
-	// create new snapshot
+	// create new snapshot, the Input is the same
 	SNAPSHOT snap;
-	snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges);
+	snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges, -1, &getCurrentSnapshot().inputlog, currMovieData.getNumRecords());
 	// fill description: modification type + keyframe of the Bookmark
 	snap.modificationType = MODTYPE_BOOKMARK_0 + slot;
 	strcat(snap.description, modCaptions[snap.modificationType]);
@@ -727,9 +760,10 @@ void HISTORY::registerBookmarkSet(int slot, BOOKMARK& backupCopy, int oldCurrent
 }
 int HISTORY::registerBranching(int slot, bool markers_changed)
 {
-	// create new snapshot
+	// create new snapshot, the Input was taken from the Branch, entirely or up to its keyframe
+	SNAPSHOT& branch_snap = bookmarks->bookmarksArray[slot].snapshot;
 	SNAPSHOT snap;
-	snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges);
+	snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges, -1, &branch_snap.inputlog, taseditorConfig->branchesRestoreEntireMovie ? currMovieData.getNumRecords() : branch_snap.keyFrame);
 	// check if there are Input differences from latest snapshot
 	int real_pos = (historyStartPos + historyCursorPos) % historySize;
 	int first_changes = snap.inputlog.findFirstChange(snapshots[real_pos].inputlog);
@@ -836,7 +870,7 @@ void HISTORY::registerRecording(int frameOfChange, uint32 joypadDifferenceBits)
 	{
 		// not consecutive - create new snapshot and add it to history
 		SNAPSHOT snap;
-		snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges);
+		snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges, -1, &getCurrentSnapshot().inputlog, frameOfChange, frameOfChange);
 		snap.recordedJoypadDifferenceBits = joypadDifferenceBits;
 		// fill description:
 		snap.modificationType = MODTYPE_RECORD;
@@ -909,9 +943,9 @@ int HISTORY::registerImport(MovieData& md, const char* filename)
 }
 int HISTORY::registerLuaChanges(const char* name, int start, bool insertionOrDeletionWasDone)
 {
-	// create new snapshot
+	// create new snapshot, Lua can have changed anything after start
 	SNAPSHOT snap;
-	snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges);
+	snap.init(currMovieData, greenzone->lagLog, taseditorConfig->enableHotChanges, -1, &getCurrentSnapshot().inputlog, start);
 	// check if there are Input differences from latest snapshot
 	int real_pos = (historyStartPos + historyCursorPos) % historySize;
 	int first_changes = snap.inputlog.findFirstChange(snapshots[real_pos].inputlog, start);
@@ -13,7 +13,8 @@ InputLog - Log of Input
 * optionally can store map of Hot Changes
 * implements InputLog creation: copying Input, copying Hot Changes
 * implements full/partial restoring of data from InputLog: Input, Hot Changes
-* implements compression and decompression of stored data
+* keeps Input in chunks of frames, the chunks that didn't change are shared with the InputLog the new one was made from
+* implements compression and decompression of stored data, compressing only the chunks that weren't compressed before
 * saves and loads the data from a project file. On error: sends warning to caller
 * implements searching of first mismatch comparing two InputLogs or comparing this InputLog to a movie
 * provides interface for reading specific data: reading Input of any given frame, reading value at any point of Hot Changes map
@@ -21,6 +22,8 @@ InputLog - Log of Input
 ------------------------------------------------------------------------------------ */
 
 #include <zlib.h>
+#include <algorithm>
+#include <cassert>
 #include "Qt/TasEditor/inputlog.h"
 #include "Qt/TasEditor/taseditor_project.h"
 
@@ -28,15 +31,69 @@ extern SELECTION selection;
 
 int joysticksPerFrame[INPUT_TYPES_TOTAL] = {1, 2, 4};
 
+// reads Input of movie frames
+struct MOVIE_INPUT_SOURCE
+{
+	MovieData& md;
+	int frames;
+	int numJoys;
+	MOVIE_INPUT_SOURCE(MovieData& movie, int joys) : md(movie), frames(movie.getNumRecords()), numJoys(joys) {}
+	void read(int frame, uint8_t* joys, uint8_t& cmd)
+	{
+		for (int joy = numJoys - 1; joy >= 0; joy--)
+			joys[joy * BYTES_PER_JOYSTICK] = md.records[frame].joysticks[joy];
+		cmd = md.records[frame].commands;
+	}
+};
+// reads Input of frames from the arrays stored in project file
+struct ARRAY_INPUT_SOURCE
+{
+	const uint8_t* joysticks;
+	const uint8_t* commands;
+	int frames;
+	int numJoys;
+	void read(int frame, uint8_t* joys, uint8_t& cmd)
+	{
+		memcpy(joys, &joysticks[frame * numJoys * BYTES_PER_JOYSTICK], numJoys * BYTES_PER_JOYSTICK);
+		cmd = commands[frame];
+	}
+};
+
+// compresses the data into raw deflate blocks that end with a full flush
+static void deflateChunkData(const std::vector<uint8_t>& data, std::vector<uint8_t>& compressed, uint32_t& adler)
+{
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+	compressed.resize(deflateBound(&zs, data.size()) + 16);
+	zs.next_in = (Bytef*)data.data();
+	zs.avail_in = data.size();
+	zs.next_out = &compressed[0];
+	zs.avail_out = compressed.size();
+	deflate(&zs, Z_FULL_FLUSH);
+	compressed.resize(compressed.size() - zs.avail_out);
+	deflateEnd(&zs);
+	adler = adler32(adler32(0, NULL, 0), data.data(), data.size());
+}
+
+INPUTLOG_CHUNK::INPUTLOG_CHUNK()
+{
+	joysticksAdler = commandsAdler = 0;
+	compressed = false;
+}
+
 INPUTLOG::INPUTLOG()
 {
 	size = 0;
 	inputType = 0;
 	hasHotChanges = 0;
 	alreadyCompressed = false;
+	hotChangesCompressed = false;
 }
 
-void INPUTLOG::init(MovieData& md, bool hotchanges, int force_input_type)
+// if sharedChunksSource is given, the chunks outside the changed frames are shared with it instead of copied
+// firstChange, lastChange and shift describe the edit that was made to the Input of sharedChunksSource, see buildChunks
+void INPUTLOG::init(MovieData& md, bool hotchanges, int force_input_type, INPUTLOG* sharedChunksSource, int firstChange, int lastChange, int shift)
 {
 	hasHotChanges = hotchanges;
 	if (force_input_type < 0)
@@ -45,20 +102,10 @@ void INPUTLOG::init(MovieData& md, bool hotchanges, int force_input_type)
 		inputType = force_input_type;
 	int num_joys = joysticksPerFrame[inputType];
 	// retrieve Input data from movie data
-	size = md.getNumRecords();
-	joysticks.resize(BYTES_PER_JOYSTICK * num_joys * size);		// it's much faster to have this format than have [frame][joy] or other structures
-	commands.resize(size);				// commands take 1 byte per frame
+	MOVIE_INPUT_SOURCE source(md, num_joys);
+	buildChunks(source, sharedChunksSource, firstChange, lastChange, shift);
 	if (hasHotChanges)
 		initHotChanges();
-
-	// fill Input vector
-	int joy;
-	for (int frame = 0; frame < size; ++frame)
-	{
-		for (joy = num_joys - 1; joy >= 0; joy--)
-			joysticks[frame * num_joys * BYTES_PER_JOYSTICK + joy * BYTES_PER_JOYSTICK] = md.records[frame].joysticks[joy];
-		commands[frame] = md.records[frame].commands;
-	}
 	alreadyCompressed = false;
 }
 
@@ -70,9 +117,7 @@ void INPUTLOG::reinit(MovieData& md, bool hotchanges, int frame_of_change)
 	int num_joys = joysticksPerFrame[inputType];
 	int joy;
 	// retrieve Input data from movie data
-	size = md.getNumRecords();
-	joysticks.resize(BYTES_PER_JOYSTICK * num_joys * size, 0);
-	commands.resize(size);
+	resizeChunks(md.getNumRecords());
 	if (hasHotChanges)
 	{
 		// resize Hot Changes
@@ -93,9 +138,12 @@ void INPUTLOG::reinit(MovieData& md, bool hotchanges, int frame_of_change)
 	}
 
 	// update Input vector
+	int index = findChunk(frame_of_change);
+	INPUTLOG_CHUNK& chunk = getWritableChunk(index);
+	int pos = frame_of_change - chunkStarts[index];
 	for (joy = num_joys - 1; joy >= 0; joy--)
-		joysticks[frame_of_change * num_joys * BYTES_PER_JOYSTICK + joy * BYTES_PER_JOYSTICK] = md.records[frame_of_change].joysticks[joy];
-	commands[frame_of_change] = md.records[frame_of_change].commands;
+		chunk.joysticks[pos * num_joys * BYTES_PER_JOYSTICK + joy * BYTES_PER_JOYSTICK] = md.records[frame_of_change].joysticks[joy];
+	chunk.commands[pos] = md.records[frame_of_change].commands;
 	alreadyCompressed = false;
 }
 
@@ -104,38 +152,197 @@ void INPUTLOG::toMovie(MovieData& md, int start, int end)
 	if (end < 0 || end >= size) end = size - 1;
 	// write Input data to movie data
 	md.records.resize(end + 1);
+	if (start > end) return;
 	int num_joys = joysticksPerFrame[inputType];
 	int joy;
-	for (int frame = start; frame <= end; ++frame)
+	int index = findChunk(start);
+	for (int frame = start; frame <= end; ++index)
 	{
-		for (joy = num_joys - 1; joy >= 0; joy--)
-			md.records[frame].joysticks[joy] = joysticks[frame * num_joys * BYTES_PER_JOYSTICK + joy * BYTES_PER_JOYSTICK];
-		md.records[frame].commands = commands[frame];
+		INPUTLOG_CHUNK& chunk = *chunks[index];
+		int chunk_end = chunkStarts[index] + chunk.commands.size();
+		for (; frame < chunk_end && frame <= end; ++frame)
+		{
+			int pos = frame - chunkStarts[index];
+			for (joy = num_joys - 1; joy >= 0; joy--)
+				md.records[frame].joysticks[joy] = chunk.joysticks[pos * num_joys * BYTES_PER_JOYSTICK + joy * BYTES_PER_JOYSTICK];
+			md.records[frame].commands = chunk.commands[pos];
+		}
 	}
 }
+// -----------------------------------------------------------------------------------------------
+// builds the chunks of Input from the source, taking the frames outside the changed range from sharedChunksSource
+// the frames before firstChange are the same as in sharedChunksSource, and the frames after lastChange are its frames moved by shift
+// lastChange = -1 means the changes may go on to the end of the Input
+template<class SOURCE> void INPUTLOG::buildChunks(SOURCE& source, INPUTLOG* sharedChunksSource, int firstChange, int lastChange, int shift)
+{
+	int frames = source.frames;
+	std::vector<std::shared_ptr<INPUTLOG_CHUNK>> new_chunks;
+	int head_chunks = 0, head_end = 0, tail_chunks = 0, tail_start = frames, tail_end = frames;
 
+	INPUTLOG* shared = sharedChunksSource;
+	if (shared && shared != this && shared->inputType == inputType && shared->size > 0)
+	{
+		int shared_chunks = shared->chunks.size();
+		int prefix = firstChange < 0 ? 0 : firstChange;
+		if (prefix > frames)
+			prefix = frames;
+		if (prefix > shared->size)
+			prefix = shared->size;
+		// take the chunks that lie entirely inside the same beginning
+		while (head_chunks < shared_chunks && head_end + (int)shared->chunks[head_chunks]->commands.size() <= prefix)
+			head_end += shared->chunks[head_chunks++]->commands.size();
+		// and those that lie entirely inside the moved end, frames appended after it are copied from the source
+		if (lastChange >= 0 && shared->size + shift <= frames)
+		{
+			int shared_tail_from = (lastChange + 1 > head_end ? lastChange + 1 : head_end) - shift;
+			int shared_tail_start = shared->size;
+			while (head_chunks + tail_chunks < shared_chunks && shared_tail_start - (int)shared->chunks[shared_chunks - 1 - tail_chunks]->commands.size() >= shared_tail_from)
+				shared_tail_start -= shared->chunks[shared_chunks - 1 - tail_chunks++]->commands.size();
+			if (tail_chunks)
+			{
+				tail_start = shared_tail_start + shift;
+				tail_end = shared->size + shift;
+			}
+		}
+		new_chunks.assign(shared->chunks.begin(), shared->chunks.begin() + head_chunks);
+	}
+	// copy the rest of Input from the source
+	appendChunksFromSource(source, head_end, tail_start, new_chunks);
+	if (tail_chunks)
+		new_chunks.insert(new_chunks.end(), shared->chunks.end() - tail_chunks, shared->chunks.end());
+	appendChunksFromSource(source, tail_end, frames, new_chunks);
+	chunks.swap(new_chunks);
+	size = frames;
+	updateChunkStarts();
+#ifndef NDEBUG
+	// the shared frames were taken on the caller's word, compare them to the source as snapshots used to be compared
+	checkSharedFrames(source, 0, head_end);
+	if (tail_chunks)
+		checkSharedFrames(source, tail_start, tail_end);
+#endif
+}
+#ifndef NDEBUG
+// asserts that the frames from start up to end are the same in the source and in this InputLog
+template<class SOURCE> void INPUTLOG::checkSharedFrames(SOURCE& source, int start, int end)
+{
+	int num_joys = joysticksPerFrame[inputType];
+	uint8_t joys[4 * BYTES_PER_JOYSTICK], cmd;
+	for (int frame = start; frame < end; ++frame)
+	{
+		source.read(frame, joys, cmd);
+		assert(cmd == getCommandsData(frame) && "a frame outside the changed range given to the snapshot was changed!");
+		for (int joy = 0; joy < num_joys; ++joy)
+			assert(joys[joy * BYTES_PER_JOYSTICK] == getJoystickData(frame, joy) && "a frame outside the changed range given to the snapshot was changed!");
+	}
+}
+#endif
+// copies the frames from start up to end from the source into new chunks
+template<class SOURCE> void INPUTLOG::appendChunksFromSource(SOURCE& source, int start, int end, std::vector<std::shared_ptr<INPUTLOG_CHUNK>>& list)
+{
+	int num_joys = joysticksPerFrame[inputType];
+	for (int frame = start; frame < end; )
+	{
+		int len = end - frame;
+		if (len > INPUTLOG_CHUNK_FRAMES)
+			len = INPUTLOG_CHUNK_FRAMES;
+		std::shared_ptr<INPUTLOG_CHUNK> chunk = std::make_shared<INPUTLOG_CHUNK>();
+		chunk->joysticks.resize(len * num_joys * BYTES_PER_JOYSTICK);
+		chunk->commands.resize(len);
+		for (int pos = 0; pos < len; ++pos, ++frame)
+			source.read(frame, &chunk->joysticks[pos * num_joys * BYTES_PER_JOYSTICK], chunk->commands[pos]);
+		list.push_back(chunk);
+	}
+}
+// appends empty frames to the end of Input or cuts it
+void INPUTLOG::resizeChunks(int frames)
+{
+	int bytes = BYTES_PER_JOYSTICK * joysticksPerFrame[inputType];
+	while (chunks.size() && chunkStarts.back() >= frames)
+	{
+		chunks.pop_back();
+		chunkStarts.pop_back();
+	}
+	int current_size = chunks.size() ? chunkStarts.back() + chunks.back()->commands.size() : 0;
+	if (current_size > frames)
+	{
+		INPUTLOG_CHUNK& chunk = getWritableChunk(chunks.size() - 1);
+		chunk.commands.resize(frames - chunkStarts.back());
+		chunk.joysticks.resize(chunk.commands.size() * bytes);
+	} else if (current_size < frames)
+	{
+		if (chunks.size() && chunks.back()->commands.size() < INPUTLOG_CHUNK_FRAMES)
+		{
+			INPUTLOG_CHUNK& chunk = getWritableChunk(chunks.size() - 1);
+			int len = frames - current_size;
+			if (len > INPUTLOG_CHUNK_FRAMES - (int)chunk.commands.size())
+				len = INPUTLOG_CHUNK_FRAMES - chunk.commands.size();
+			chunk.commands.resize(chunk.commands.size() + len, 0);
+			chunk.joysticks.resize(chunk.commands.size() * bytes, 0);
+			current_size += len;
+		}
+		while (current_size < frames)
+		{
+			int len = frames - current_size;
+			if (len > INPUTLOG_CHUNK_FRAMES)
+				len = INPUTLOG_CHUNK_FRAMES;
+			std::shared_ptr<INPUTLOG_CHUNK> chunk = std::make_shared<INPUTLOG_CHUNK>();
+			chunk->commands.resize(len, 0);
+			chunk->joysticks.resize(len * bytes, 0);
+			chunks.push_back(chunk);
+			current_size += len;
+		}
+	}
+	size = frames;
+	updateChunkStarts();
+}
+void INPUTLOG::updateChunkStarts()
+{
+	chunkStarts.resize(chunks.size());
+	int frame = 0;
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		chunkStarts[i] = frame;
+		frame += chunks[i]->commands.size();
+	}
+}
+// returns the index of the chunk that contains the frame
+int INPUTLOG::findChunk(int frame)
+{
+	return (std::upper_bound(chunkStarts.begin(), chunkStarts.end(), frame) - chunkStarts.begin()) - 1;
+}
+// the chunk may be shared with other InputLogs, so it's copied before the first change
+INPUTLOG_CHUNK& INPUTLOG::getWritableChunk(int index)
+{
+	if (chunks[index].use_count() > 1)
+		chunks[index] = std::make_shared<INPUTLOG_CHUNK>(*chunks[index]);
+	INPUTLOG_CHUNK& chunk = *chunks[index];
+	chunk.compressedJoysticks.resize(0);
+	chunk.compressedCommands.resize(0);
+	chunk.compressed = false;
+	return chunk;
+}
+// -----------------------------------------------------------------------------------------------
 void INPUTLOG::compressData()
 {
-	// compress joysticks
-	int len = joysticks.size();
-	uLongf comprlen = (len>>9)+12 + len;
-	compressedJoysticks.resize(comprlen);
-	compress(&compressedJoysticks[0], &comprlen, &joysticks[0], len);
-	compressedJoysticks.resize(comprlen);
-	// compress commands
-	len = commands.size();
-	comprlen = (len>>9)+12 + len;
-	compressedCommands.resize(comprlen);
-	compress(&compressedCommands[0], &comprlen, &commands[0], len);
-	compressedCommands.resize(comprlen);
-	if (hasHotChanges)
+	// compress the chunks that weren't compressed yet, the others may be shared with other InputLogs
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		INPUTLOG_CHUNK& chunk = *chunks[i];
+		if (chunk.compressed)
+			continue;
+		deflateChunkData(chunk.joysticks, chunk.compressedJoysticks, chunk.joysticksAdler);
+		deflateChunkData(chunk.commands, chunk.compressedCommands, chunk.commandsAdler);
+		chunk.compressed = true;
+	}
+	if (hasHotChanges && !hotChangesCompressed)
 	{
 		// compress hot_changes
-		len = hotChanges.size();
-		comprlen = (len>>9)+12 + len;
+		int len = hotChanges.size();
+		uLongf comprlen = (len>>9)+12 + len;
 		compressedHotChanges.resize(comprlen);
 		compress(&compressedHotChanges[0], &comprlen, &hotChanges[0], len);
 		compressedHotChanges.resize(comprlen);
+		hotChangesCompressed = true;
 	}
 	// don't recompress anymore
 	alreadyCompressed = true;
@@ -153,12 +360,35 @@ void INPUTLOG::save(EMUFILE *os)
 	// write data
 	if (!alreadyCompressed)
 		compressData();
-	// save joysticks data
-	write32le(compressedJoysticks.size(), os);
-	os->fwrite(&compressedJoysticks[0], compressedJoysticks.size());
-	// save commands data
-	write32le(compressedCommands.size(), os);
-	os->fwrite(&compressedCommands[0], compressedCommands.size());
+	// the compressed chunks are joined into one zlib stream for joysticks data and one for commands data
+	static const uint8 zlib_header[2] = {0x78, 0x9C};
+	static const uint8 final_block[2] = {0x03, 0x00};
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		uint32 comprlen = sizeof(zlib_header) + sizeof(final_block) + 4;
+		uLong adler = adler32(0, NULL, 0);
+		for (size_t i = 0; i < chunks.size(); ++i)
+		{
+			INPUTLOG_CHUNK& chunk = *chunks[i];
+			comprlen += pass ? chunk.compressedCommands.size() : chunk.compressedJoysticks.size();
+			if (pass)
+				adler = adler32_combine(adler, chunk.commandsAdler, chunk.commands.size());
+			else
+				adler = adler32_combine(adler, chunk.joysticksAdler, chunk.joysticks.size());
+		}
+		// save joysticks data, then commands data
+		write32le(comprlen, os);
+		os->fwrite(zlib_header, sizeof(zlib_header));
+		for (size_t i = 0; i < chunks.size(); ++i)
+		{
+			std::vector<uint8_t>& compressed = pass ? chunks[i]->compressedCommands : chunks[i]->compressedJoysticks;
+			if (compressed.size())
+				os->fwrite(&compressed[0], compressed.size());
+		}
+		os->fwrite(final_block, sizeof(final_block));
+		uint8 adler_bytes[4] = {(uint8)(adler >> 24), (uint8)(adler >> 16), (uint8)(adler >> 8), (uint8)adler};
+		os->fwrite(adler_bytes, sizeof(adler_bytes));
+	}
 	if (hasHotChanges)
 	{
 		write8le((uint8)1, os);
@@ -179,18 +409,19 @@ bool INPUTLOG::load(EMUFILE *is)
 	if (!read8le(&tmp, is)) return true;
 	inputType = tmp;
 	// read data
-	alreadyCompressed = true;
+	alreadyCompressed = false;
 	unsigned int comprlen;
 	uLongf destlen;
+	std::vector<uint8_t> compressed, joysticks, commands;
 	// read and uncompress joysticks data
 	destlen = size * BYTES_PER_JOYSTICK * joysticksPerFrame[inputType];
 	joysticks.resize(destlen);
 	// read size
 	if (!read32le(&comprlen, is)) return true;
 	if (comprlen == 0) return true;
-	compressedJoysticks.resize(comprlen);
-	if (is->fread(&compressedJoysticks[0], comprlen) != comprlen) return true;
-	int e = uncompress(&joysticks[0], &destlen, &compressedJoysticks[0], comprlen);
+	compressed.resize(comprlen);
+	if (is->fread(&compressed[0], comprlen) != comprlen) return true;
+	int e = uncompress(joysticks.data(), &destlen, &compressed[0], comprlen);
 	if (e != Z_OK && e != Z_BUF_ERROR) return true;
 	// read and uncompress commands data
 	destlen = size;
@@ -198,10 +429,13 @@ bool INPUTLOG::load(EMUFILE *is)
 	// read size
 	if (!read32le(&comprlen, is)) return true;
 	if (comprlen <= 0) return true;
-	compressedCommands.resize(comprlen);
-	if (is->fread(&compressedCommands[0], comprlen) != comprlen) return true;
-	e = uncompress(&commands[0], &destlen, &compressedCommands[0], comprlen);
+	compressed.resize(comprlen);
+	if (is->fread(&compressed[0], comprlen) != comprlen) return true;
+	e = uncompress(commands.data(), &destlen, &compressed[0], comprlen);
 	if (e != Z_OK && e != Z_BUF_ERROR) return true;
+	// split Input into chunks
+	ARRAY_INPUT_SOURCE source = {joysticks.data(), commands.data(), size, joysticksPerFrame[inputType]};
+	buildChunks(source, NULL, 0, -1, 0);
 	// read hotchanges
 	if (!read8le(&tmp, is)) return true;
 	hasHotChanges = (tmp != 0);
@@ -217,6 +451,7 @@ bool INPUTLOG::load(EMUFILE *is)
 		if (is->fread(&compressedHotChanges[0], comprlen) != comprlen) return true;
 		e = uncompress(&hotChanges[0], &destlen, &compressedHotChanges[0], comprlen);
 		if (e != Z_OK && e != Z_BUF_ERROR) return true;
+		hotChangesCompressed = true;
 	}
 	return false;
 }
@@ -253,8 +488,34 @@ int INPUTLOG::findFirstChange(INPUTLOG& theirLog, int start, int end)
 
 	int joy;
 	int num_joys = joysticksPerFrame[inputType];
+	int index = -1, chunk_end = 0, their_index = -1, their_chunk_end = 0;
 	for (int frame = start; frame <= end; ++frame)
 	{
+		if (theirLog.inputType == inputType && frame < their_log_end)
+		{
+			if (index < 0 || frame >= chunk_end)
+			{
+				index = findChunk(frame);
+				chunk_end = chunkStarts[index] + chunks[index]->commands.size();
+			}
+			if (their_index < 0 || frame >= their_chunk_end)
+			{
+				their_index = theirLog.findChunk(frame);
+				their_chunk_end = theirLog.chunkStarts[their_index] + theirLog.chunks[their_index]->commands.size();
+			}
+			INPUTLOG_CHUNK& chunk = *chunks[index];
+			INPUTLOG_CHUNK& their_chunk = *theirLog.chunks[their_index];
+			if (&chunk == &their_chunk && chunkStarts[index] == theirLog.chunkStarts[their_index])
+			{
+				// both InputLogs share this chunk
+				frame = chunk_end - 1;
+				continue;
+			}
+			int pos = frame - chunkStarts[index], their_pos = frame - theirLog.chunkStarts[their_index];
+			if (chunk.commands[pos] != their_chunk.commands[their_pos]) return frame;
+			if (memcmp(&chunk.joysticks[pos * num_joys * BYTES_PER_JOYSTICK], &their_chunk.joysticks[their_pos * num_joys * BYTES_PER_JOYSTICK], num_joys * BYTES_PER_JOYSTICK)) return frame;
+			continue;
+		}
 		for (joy = num_joys - 1; joy >= 0; joy--)
 			if (getJoystickData(frame, joy) != theirLog.getJoystickData(frame, joy)) return frame;
 		if (getCommandsData(frame) != theirLog.getCommandsData(frame)) return frame;
@@ -275,11 +536,19 @@ int INPUTLOG::findFirstChange(MovieData& md, int start, int end)
 
 	int joy;
 	int num_joys = joysticksPerFrame[inputType];
+	int index = -1, chunk_end = 0;
 	for (int frame = start; frame <= end; ++frame)
 	{
+		if (index < 0 || frame >= chunk_end)
+		{
+			index = findChunk(frame);
+			chunk_end = chunkStarts[index] + chunks[index]->commands.size();
+		}
+		INPUTLOG_CHUNK& chunk = *chunks[index];
+		int pos = frame - chunkStarts[index];
 		for (joy = num_joys - 1; joy >= 0; joy--)
-			if (getJoystickData(frame, joy) != md.records[frame].joysticks[joy]) return frame;
-		if (getCommandsData(frame) != md.records[frame].commands) return frame;
+			if (chunk.joysticks[pos * num_joys * BYTES_PER_JOYSTICK + joy * BYTES_PER_JOYSTICK] != md.records[frame].joysticks[joy]) return frame;
+		if (chunk.commands[pos] != md.records[frame].commands) return frame;
 	}
 	// no difference was found
 
@@ -296,25 +565,26 @@ int INPUTLOG::getJoystickData(int frame, int joy)
 {
 	if (frame < 0 || frame >= size)
 		return 0;
-	if (joy > joysticksPerFrame[inputType])
+	if (joy >= joysticksPerFrame[inputType])
 		return 0;
-	return joysticks[frame * BYTES_PER_JOYSTICK * joysticksPerFrame[inputType] + joy];
+	int index = findChunk(frame);
+	return chunks[index]->joysticks[(frame - chunkStarts[index]) * BYTES_PER_JOYSTICK * joysticksPerFrame[inputType] + joy];
 }
 int INPUTLOG::getCommandsData(int frame)
 {
 	if (frame < 0 || frame >= size)
 		return 0;
-	return commands[frame];
+	int index = findChunk(frame);
+	return chunks[index]->commands[frame - chunkStarts[index]];
 }
 
 void INPUTLOG::insertFrames(int at, int frames)
 {
-	size += frames;
-	if (at == -1) 
+	hotChangesCompressed = false;
+	if (at == -1 || at >= size) 
 	{
 		// append frames to the end
-		commands.resize(size);
-		joysticks.resize(BYTES_PER_JOYSTICK * joysticksPerFrame[inputType] * size);
+		resizeChunks(size + frames);
 		if (hasHotChanges)
 		{
 			hotChanges.resize(joysticksPerFrame[inputType] * size * HOTCHANGE_BYTES_PER_JOY);
@@ -325,12 +595,34 @@ void INPUTLOG::insertFrames(int at, int frames)
 		}
 	} else
 	{
-		// insert frames
+		size += frames;
+		// insert frames into the chunk that contains the frame "at"
+		int index = findChunk(at);
+		INPUTLOG_CHUNK& chunk = getWritableChunk(index);
+		int pos = at - chunkStarts[index];
 		// insert 1 byte of commands
-		commands.insert(commands.begin() + at, frames, 0);
+		chunk.commands.insert(chunk.commands.begin() + pos, frames, 0);
 		// insert X bytes of joystics
 		int bytes = BYTES_PER_JOYSTICK * joysticksPerFrame[inputType];
-		joysticks.insert(joysticks.begin() + (at * bytes), frames * bytes, 0);
+		chunk.joysticks.insert(chunk.joysticks.begin() + (pos * bytes), frames * bytes, 0);
+		if ((int)chunk.commands.size() > INPUTLOG_CHUNK_FRAMES * 2)
+		{
+			// split the grown chunk
+			std::vector<std::shared_ptr<INPUTLOG_CHUNK>> pieces;
+			for (int piece_start = 0; piece_start < (int)chunk.commands.size(); piece_start += INPUTLOG_CHUNK_FRAMES)
+			{
+				int len = chunk.commands.size() - piece_start;
+				if (len > INPUTLOG_CHUNK_FRAMES)
+					len = INPUTLOG_CHUNK_FRAMES;
+				std::shared_ptr<INPUTLOG_CHUNK> piece = std::make_shared<INPUTLOG_CHUNK>();
+				piece->commands.assign(chunk.commands.begin() + piece_start, chunk.commands.begin() + piece_start + len);
+				piece->joysticks.assign(chunk.joysticks.begin() + piece_start * bytes, chunk.joysticks.begin() + (piece_start + len) * bytes);
+				pieces.push_back(piece);
+			}
+			chunks.erase(chunks.begin() + index);
+			chunks.insert(chunks.begin() + index, pieces.begin(), pieces.end());
+		}
+		updateChunkStarts();
 		if (hasHotChanges)
 		{
 			// insert X bytes of hot_changes
@@ -343,11 +635,18 @@ void INPUTLOG::insertFrames(int at, int frames)
 }
 void INPUTLOG::eraseFrame(int frame)
 {
+	hotChangesCompressed = false;
+	int index = findChunk(frame);
+	INPUTLOG_CHUNK& chunk = getWritableChunk(index);
+	int pos = frame - chunkStarts[index];
 	// erase 1 byte of commands
-	commands.erase(commands.begin() + frame);
+	chunk.commands.erase(chunk.commands.begin() + pos);
 	// erase X bytes of joystics
 	int bytes = BYTES_PER_JOYSTICK * joysticksPerFrame[inputType];
-	joysticks.erase(joysticks.begin() + (frame * bytes), joysticks.begin() + ((frame + 1) * bytes));
+	chunk.joysticks.erase(chunk.joysticks.begin() + (pos * bytes), chunk.joysticks.begin() + ((pos + 1) * bytes));
+	if (chunk.commands.empty())
+		chunks.erase(chunks.begin() + index);
+	updateChunkStarts();
 	if (hasHotChanges)
 	{
 		// erase X bytes of hot_changes
@@ -361,11 +660,13 @@ void INPUTLOG::eraseFrame(int frame)
 // -----------------------------------------------------------------------------------------------
 void INPUTLOG::initHotChanges()
 {
+	hotChangesCompressed = false;
 	hotChanges.resize(joysticksPerFrame[inputType] * size * HOTCHANGE_BYTES_PER_JOY);
 }
 
 void INPUTLOG::copyHotChanges(INPUTLOG* sourceOfHotChanges, int limiterFrameOfSource)
 {
+	hotChangesCompressed = false;
 	// copy hot changes from source InputLog
 	if (sourceOfHotChanges && sourceOfHotChanges->hasHotChanges && sourceOfHotChanges->inputType == inputType)
 	{
@@ -378,10 +679,17 @@ void INPUTLOG::copyHotChanges(INPUTLOG* sourceOfHotChanges, int limiterFrameOfSo
 
 		int bytes_to_copy = frames_to_copy * joysticksPerFrame[inputType] * HOTCHANGE_BYTES_PER_JOY;
 		memcpy(&hotChanges[0], &sourceOfHotChanges->hotChanges[0], bytes_to_copy);
+		// an exact copy can take the compressed data too
+		if (bytes_to_copy == (int)hotChanges.size() && bytes_to_copy == (int)sourceOfHotChanges->hotChanges.size() && sourceOfHotChanges->hotChangesCompressed)
+		{
+			compressedHotChanges = sourceOfHotChanges->compressedHotChanges;
+			hotChangesCompressed = true;
+		}
 	}
 } 
 void INPUTLOG::inheritHotChanges(INPUTLOG* sourceOfHotChanges)
 {
+	hotChangesCompressed = false;
 	// copy hot changes from source InputLog and fade them
 	if (sourceOfHotChanges && sourceOfHotChanges->hasHotChanges && sourceOfHotChanges->inputType == inputType)
 	{
@@ -396,6 +704,7 @@ void INPUTLOG::inheritHotChanges(INPUTLOG* sourceOfHotChanges)
 } 
 void INPUTLOG::inheritHotChanges_DeleteSelection(INPUTLOG* sourceOfHotChanges, RowsSelection* frameset)
 {
+	hotChangesCompressed = false;
 	// copy hot changes from source InputLog, but omit deleted frames (which are represented by the "frameset")
 	if (sourceOfHotChanges && sourceOfHotChanges->hasHotChanges && sourceOfHotChanges->inputType == inputType)
 	{
@@ -425,6 +734,7 @@ void INPUTLOG::inheritHotChanges_DeleteSelection(INPUTLOG* sourceOfHotChanges, R
 } 
 void INPUTLOG::inheritHotChanges_InsertSelection(INPUTLOG* sourceOfHotChanges, RowsSelection* frameset)
 {
+	hotChangesCompressed = false;
 	// copy hot changes from source InputLog, but insert filled lines for inserted frames (which are represented by the "frameset")
 	RowsSelection::iterator it(frameset->begin());
 	RowsSelection::iterator frameset_end(frameset->end());
@@ -486,6 +796,7 @@ void INPUTLOG::inheritHotChanges_InsertSelection(INPUTLOG* sourceOfHotChanges, R
 }
 void INPUTLOG::inheritHotChanges_DeleteNum(INPUTLOG* sourceOfHotChanges, int start, int frames, bool fadeOld)
 {
+	hotChangesCompressed = false;
 	int bytes = joysticksPerFrame[inputType] * HOTCHANGE_BYTES_PER_JOY;
 	// copy hot changes from source InputLog up to "start" and from "start+frames" to end
 	if (sourceOfHotChanges && sourceOfHotChanges->hasHotChanges && sourceOfHotChanges->inputType == inputType)
@@ -508,6 +819,7 @@ void INPUTLOG::inheritHotChanges_DeleteNum(INPUTLOG* sourceOfHotChanges, int sta
 } 
 void INPUTLOG::inheritHotChanges_InsertNum(INPUTLOG* sourceOfHotChanges, int start, int frames, bool fadeOld)
 {
+	hotChangesCompressed = false;
 	int bytes = joysticksPerFrame[inputType] * HOTCHANGE_BYTES_PER_JOY;
 	// copy hot changes from source InputLog up to "start", then make a gap, then copy from "start+frames" to end
 	if (sourceOfHotChanges && sourceOfHotChanges->hasHotChanges && sourceOfHotChanges->inputType == inputType)
@@ -532,6 +844,7 @@ void INPUTLOG::inheritHotChanges_InsertNum(INPUTLOG* sourceOfHotChanges, int sta
 }
 void INPUTLOG::inheritHotChanges_PasteInsert(INPUTLOG* sourceOfHotChanges, RowsSelection* insertedSet)
 {
+	hotChangesCompressed = false;
 	// copy hot changes from source InputLog and insert filled lines for inserted frames (which are represented by "inserted_set")
 	int bytes = joysticksPerFrame[inputType] * HOTCHANGE_BYTES_PER_JOY;
 	int frame = 0, pos = 0;
@@ -586,6 +899,7 @@ void INPUTLOG::inheritHotChanges_PasteInsert(INPUTLOG* sourceOfHotChanges, RowsS
 } 
 void INPUTLOG::fillHotChanges(INPUTLOG& theirLog, int start, int end)
 {
+	hotChangesCompressed = false;
 	// compare InputLogs to the specified end (or to the end of this InputLog)
 	if (end < 0 || end >= size) end = size-1;
 	uint8 my_joy, their_joy;
@@ -603,6 +917,7 @@ void INPUTLOG::fillHotChanges(INPUTLOG& theirLog, int start, int end)
 
 void INPUTLOG::setMaxHotChangeBits(int frame, int joypad, uint8 joyBits)
 {
+	hotChangesCompressed = false;
 	uint8 mask = 1;
 	// check all 8 buttons and set max hot_changes for bits that are set
 	for (int i = 0; i < BUTTONS_PER_JOYSTICK; ++i)
@@ -614,6 +929,7 @@ void INPUTLOG::setMaxHotChangeBits(int frame, int joypad, uint8 joyBits)
 }
 void INPUTLOG::setMaxHotChanges(int frame, int absoluteButtonNumber)
 {
+	hotChangesCompressed = false;
 	if (frame < 0 || frame >= size || !hasHotChanges) return;
 	// set max value to the button hotness
 	if (absoluteButtonNumber & 1)
@@ -624,6 +940,7 @@ void INPUTLOG::setMaxHotChanges(int frame, int absoluteButtonNumber)
 
 void INPUTLOG::fadeHotChanges(int startByte, int endByte)
 {
+	hotChangesCompressed = false;
 	uint8 hi_half, low_half;
 	if (endByte < 0)
 		endByte = hotChanges.size();
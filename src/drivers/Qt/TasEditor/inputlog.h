@@ -2,6 +2,7 @@
 #pragma once
 #include <stdint.h>
 #include <vector>
+#include <memory>
 
 #include "fceu.h"
 #include "movie.h"
@@ -20,6 +21,8 @@ enum INPUT_TYPES
 #define BUTTONS_PER_JOYSTICK 8
 #define BYTES_PER_JOYSTICK 1			// 1 byte per 1 joystick (8 buttons)
 
+#define INPUTLOG_CHUNK_FRAMES 1024		// Input is kept in pieces of up to this many frames (twice as many after insertions)
+
 #define HOTCHANGE_BITS_PER_VALUE 4		// any HotChange value takes 4 bits
 #define HOTCHANGE_BITMASK 0xF			// "1111"
 #define HOTCHANGE_MAX_VALUE 0xF			// "1111" max
@@ -29,11 +32,26 @@ enum INPUT_TYPES
 #define BYTE_VALUE_CONTAINING_MAX_HOTCHANGE_LO HOTCHANGE_MAX_VALUE														// "0x0F"
 #define HOTCHANGE_BYTES_PER_JOY (BYTES_PER_JOYSTICK * HOTCHANGE_BITS_PER_VALUE)	// 4 bytes per 8 buttons
 
+// a piece of Input Log, shared by all InputLogs that have the same Input in these frames
+struct INPUTLOG_CHUNK
+{
+	INPUTLOG_CHUNK();
+
+	std::vector<uint8_t> joysticks;		// same format as INPUTLOG used to keep for the whole movie
+	std::vector<uint8_t> commands;
+	// raw deflate data ending with a full flush, so that the chunks of a log can be joined into one zlib stream
+	std::vector<uint8_t> compressedJoysticks;
+	std::vector<uint8_t> compressedCommands;
+	uint32_t joysticksAdler;
+	uint32_t commandsAdler;
+	bool compressed;
+};
+
 class INPUTLOG
 {
 public:
 	INPUTLOG();
-	void init(MovieData& md, bool hotchanges, int force_input_type = -1);
+	void init(MovieData& md, bool hotchanges, int force_input_type = -1, INPUTLOG* sharedChunksSource = NULL, int firstChange = 0, int lastChange = -1, int shift = 0);
 	void reinit(MovieData& md, bool hotchanges, int frame_of_change);		// used when combining consecutive Recordings
 	void toMovie(MovieData& md, int start = 0, int end = -1);
 
@@ -77,17 +95,25 @@ public:
 	bool hasHotChanges;
 
 private:
+	template<class SOURCE> void buildChunks(SOURCE& source, INPUTLOG* sharedChunksSource, int firstChange, int lastChange, int shift);
+	template<class SOURCE> void appendChunksFromSource(SOURCE& source, int start, int end, std::vector<std::shared_ptr<INPUTLOG_CHUNK>>& list);
+#ifndef NDEBUG
+	template<class SOURCE> void checkSharedFrames(SOURCE& source, int start, int end);
+#endif
+	void resizeChunks(int frames);
+	void updateChunkStarts();
+	int findChunk(int frame);
+	INPUTLOG_CHUNK& getWritableChunk(int index);
 	
 	// also saved data
-	std::vector<uint8_t> compressedJoysticks;
-	std::vector<uint8_t> compressedCommands;
 	std::vector<uint8_t> compressedHotChanges;
 
 	// not saved data
 	std::vector<uint8_t> hotChanges;		// Format: buttons01joy0-for-frame0, buttons23joy0-for-frame0, buttons45joy0-for-frame0, buttons67joy0-for-frame0, buttons01joy1-for-frame0, ...
-	std::vector<uint8_t> joysticks;		// Format: joy0-for-frame0, joy1-for-frame0, joy2-for-frame0, joy3-for-frame0, joy0-for-frame1, joy1-for-frame1, ...
-	std::vector<uint8_t> commands;		// Format: commands-for-frame0, commands-for-frame1, ...
+	std::vector<std::shared_ptr<INPUTLOG_CHUNK>> chunks;		// Format of chunk joysticks: joy0-for-frame0, joy1-for-frame0, joy2-for-frame0, joy3-for-frame0, joy0-for-frame1, ...
+	std::vector<int> chunkStarts;		// first frame of every chunk
 	bool alreadyCompressed;			// to compress only once
+	bool hotChangesCompressed;		// compressedHotChanges holds the current hotChanges
 };
 
 extern int joysticksPerFrame[INPUT_TYPES_TOTAL];
@@ -33,9 +33,10 @@ SNAPSHOT::SNAPSHOT()
 	description[0] = 0;
 }
 
-void SNAPSHOT::init(MovieData& md, LAGLOG& lagLog, bool hotchanges, int enforceInputType)
+// if sharedChunksSource is given, the new InputLog shares its unchanged chunks of Input
+void SNAPSHOT::init(MovieData& md, LAGLOG& lagLog, bool hotchanges, int enforceInputType, INPUTLOG* sharedChunksSource, int firstChange, int lastChange, int shift)
 {
-	inputlog.init(md, hotchanges, enforceInputType);
+	inputlog.init(md, hotchanges, enforceInputType, sharedChunksSource, firstChange, lastChange, shift);
 
 	// make a copy of the given laglog
 	laglog = lagLog;
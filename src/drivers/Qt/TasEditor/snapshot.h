@@ -11,7 +11,7 @@ class SNAPSHOT
 {
 public:
 	SNAPSHOT();
-	void init(MovieData& md, LAGLOG& lagLog, bool hotChanges, int enforceInputType = -1);
+	void init(MovieData& md, LAGLOG& lagLog, bool hotChanges, int enforceInputType = -1, INPUTLOG* sharedChunksSource = NULL, int firstChange = 0, int lastChange = -1, int shift = 0);
 	void reinit(MovieData& md, LAGLOG& lagLog, bool hotChanges, int frameOfChanges);	// used when combining consecutive Recordings
 
 	bool areMarkersDifferentFromCurrentMarkers();
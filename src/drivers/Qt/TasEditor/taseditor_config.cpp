@@ -54,8 +54,11 @@ TASEDITOR_CONFIG::TASEDITOR_CONFIG(void)
 	followMarkerNoteContext = true;
 
 	greenzoneCapacity = GREENZONE_CAPACITY_DEFAULT;
+	greenzoneHotFrames = GREENZONE_HOT_FRAMES_DEFAULT;
+	greenzoneSpillToDisk = true;
 	maxUndoLevels = UNDO_LEVELS_DEFAULT;
 	enableGreenzoning = true;
+	enableBackgroundGreenzoning = true;
 	autofirePatternSkipsLag = true;
 	autoAdjustInputAccordingToLag = true;
 	drawInputByDragging = true;
@@ -120,8 +123,11 @@ void TASEDITOR_CONFIG::load(void)
 	g_config->getOption("SDL.TasFollowUndoContext"                       , &followUndoContext  );
 	g_config->getOption("SDL.TasFollowMarkerNoteContext"                 , &followMarkerNoteContext  );
 	g_config->getOption("SDL.TasGreenzoneCapacity"                       , &greenzoneCapacity  );
+	g_config->getOption("SDL.TasGreenzoneHotFrames"                      , &greenzoneHotFrames  );
+	g_config->getOption("SDL.TasGreenzoneSpillToDisk"                    , &greenzoneSpillToDisk  );
 	g_config->getOption("SDL.TasMaxUndoLevels"                           , &maxUndoLevels  );
 	g_config->getOption("SDL.TasEnableGreenzoning"                       , &enableGreenzoning  );
+	g_config->getOption("SDL.TasEnableBackgroundGreenzoning"             , &enableBackgroundGreenzoning  );
 	g_config->getOption("SDL.TasAutofirePatternSkipsLag"                 , &autofirePatternSkipsLag  );
 	g_config->getOption("SDL.TasAutoAdjustInputAccordingToLag"           , &autoAdjustInputAccordingToLag  );
 	g_config->getOption("SDL.TasDrawInputByDragging"                     , &drawInputByDragging  );
@@ -176,8 +182,11 @@ void TASEDITOR_CONFIG::save(void)
 	g_config->setOption("SDL.TasFollowUndoContext"                       , followUndoContext  );
 	g_config->setOption("SDL.TasFollowMarkerNoteContext"                 , followMarkerNoteContext  );
 	g_config->setOption("SDL.TasGreenzoneCapacity"                       , greenzoneCapacity  );
+	g_config->setOption("SDL.TasGreenzoneHotFrames"                      , greenzoneHotFrames  );
+	g_config->setOption("SDL.TasGreenzoneSpillToDisk"                    , greenzoneSpillToDisk  );
 	g_config->setOption("SDL.TasMaxUndoLevels"                           , maxUndoLevels  );
 	g_config->setOption("SDL.TasEnableGreenzoning"                       , enableGreenzoning  );
+	g_config->setOption("SDL.TasEnableBackgroundGreenzoning"             , enableBackgroundGreenzoning  );
 	g_config->setOption("SDL.TasAutofirePatternSkipsLag"                 , autofirePatternSkipsLag  );
 	g_config->setOption("SDL.TasAutoAdjustInputAccordingToLag"           , autoAdjustInputAccordingToLag  );
 	g_config->setOption("SDL.TasDrawInputByDragging"                     , drawInputByDragging  );
@@ -5,6 +5,10 @@
 #define GREENZONE_CAPACITY_MAX 50000	// this limitation is here just because we're running in 32-bit OS, so there's 2GB limit of RAM
 #define GREENZONE_CAPACITY_DEFAULT 10000
 
+#define GREENZONE_HOT_FRAMES_MIN 0
+#define GREENZONE_HOT_FRAMES_MAX 10000
+#define GREENZONE_HOT_FRAMES_DEFAULT 300		// ~24 MB of uncompressed savestates
+
 #define UNDO_LEVELS_MIN 1
 #define UNDO_LEVELS_MAX 1000			// this limitation is here just because we're running in 32-bit OS, so there's 2GB limit of RAM
 #define UNDO_LEVELS_DEFAULT 100
@@ -65,9 +69,12 @@ public:
 	bool followMarkerNoteContext;
 
 	int greenzoneCapacity;
+	int greenzoneHotFrames;
+	bool greenzoneSpillToDisk;
 	int maxUndoLevels;
 
 	bool enableGreenzoning;
+	bool enableBackgroundGreenzoning;
 	bool autofirePatternSkipsLag;
 	bool autoAdjustInputAccordingToLag;
 	bool drawInputByDragging;
@@ -536,8 +536,9 @@ InitConfig()
 	config->addOption("pcmvol", "SDL.Sound.PCMVolume", 255);
 	config->addOption("soundrate", "SDL.Sound.Rate", 44100);
 	config->addOption("soundq", "SDL.Sound.Quality", 1);
+	config->addOption("soundsteps", "SDL.Sound.StepSynth", 0);
 	config->addOption("soundrecord", "SDL.Sound.RecordFile", "");
-	config->addOption("soundbufsize", "SDL.Sound.BufSize", 128);
+	config->addOption("soundbufsize", "SDL.Sound.BufSize", 48);
 	config->addOption("lowpass", "SDL.Sound.LowPass", 0);
 	config->addOption("SDL.Sound.UseGlobalFocus", 1);
     
@@ -796,6 +797,7 @@ InitConfig()
 	config->addOption("SDL.StateRecorderTimeBetweenSnapsMin", 0);
 	config->addOption("SDL.StateRecorderTimeBetweenSnapsSec", 3);
 	config->addOption("SDL.StateRecorderCompressionLevel", 0);
+	config->addOption("SDL.StateRecorderKeyFrameInterval", 20);
 	config->addOption("SDL.StateRecorderPauseOnLoad", 1);
 	config->addOption("SDL.StateRecorderPauseDuration", 3);
 
@@ -855,8 +857,11 @@ InitConfig()
 	config->addOption("SDL.TasFollowUndoContext"                       , tasCfg.followUndoContext  );
 	config->addOption("SDL.TasFollowMarkerNoteContext"                 , tasCfg.followMarkerNoteContext  );
 	config->addOption("SDL.TasGreenzoneCapacity"                       , tasCfg.greenzoneCapacity  );
+	config->addOption("SDL.TasGreenzoneHotFrames"                      , tasCfg.greenzoneHotFrames  );
+	config->addOption("SDL.TasGreenzoneSpillToDisk"                    , tasCfg.greenzoneSpillToDisk  );
 	config->addOption("SDL.TasMaxUndoLevels"                           , tasCfg.maxUndoLevels  );
 	config->addOption("SDL.TasEnableGreenzoning"                       , tasCfg.enableGreenzoning  );
+	config->addOption("SDL.TasEnableBackgroundGreenzoning"             , tasCfg.enableBackgroundGreenzoning  );
 	config->addOption("SDL.TasAutofirePatternSkipsLag"                 , tasCfg.autofirePatternSkipsLag  );
 	config->addOption("SDL.TasAutoAdjustInputAccordingToLag"           , tasCfg.autoAdjustInputAccordingToLag  );
 	config->addOption("SDL.TasDrawInputByDragging"                     , tasCfg.drawInputByDragging  );
@@ -663,6 +663,7 @@ static const char *DriverUsage =
 "--sound        {0|1}   Enable sound.\n"
 "--soundrate    x       Set sound playback rate to x Hz.\n"
 "--soundq      {0|1|2}  Set sound quality. (0 = Low 1 = High 2 = Very High)\n"
+"--soundsteps   {0|1}   Render high quality sound from band-limited steps.\n"
 "--soundbufsize x       Set sound buffer size to x ms.\n"
 "--volume      {0-256}  Set volume to x.\n"
 "--soundrecord  f       Record sound to file f.\n"
@@ -1028,6 +1029,7 @@ int  fceuWrapperInit( int argc, char *argv[] )
 		int srTimeBtwSnapsMin = 0;
 		int srTimeBtwSnapsSec = 3;
 		int srCompressionLevel = 0;
+		int srKeyFrameInterval = 20;
 		int pauseOnLoadTime = 3;
 		int pauseOnLoad = StateRecorderConfigData::TEMPORARY_PAUSE;
 
@@ -1038,6 +1040,7 @@ int  fceuWrapperInit( int argc, char *argv[] )
 		g_config->getOption("SDL.StateRecorderTimeBetweenSnapsMin", &srTimeBtwSnapsMin);
 		g_config->getOption("SDL.StateRecorderTimeBetweenSnapsSec", &srTimeBtwSnapsSec);
 		g_config->getOption("SDL.StateRecorderCompressionLevel", &srCompressionLevel);
+		g_config->getOption("SDL.StateRecorderKeyFrameInterval", &srKeyFrameInterval);
 		g_config->getOption("SDL.StateRecorderPauseOnLoad", &pauseOnLoad);
 		g_config->getOption("SDL.StateRecorderPauseDuration", &pauseOnLoadTime);
 
@@ -1050,6 +1053,7 @@ int  fceuWrapperInit( int argc, char *argv[] )
 			                          ( static_cast<float>( srTimeBtwSnapsSec ) / 60.0f );
 		srConfig.framesBetweenSnaps = srFramesBtwSnaps;
 		srConfig.compressionLevel = srCompressionLevel;
+		srConfig.keyFrameInterval = srKeyFrameInterval;
 		srConfig.loadPauseTimeSeconds = pauseOnLoadTime;
 		srConfig.pauseOnLoad = static_cast<StateRecorderConfigData::PauseType>(pauseOnLoad);
 
@@ -77,7 +77,8 @@ static int PPUView_sprite16Mode[2] = { 0, 0 };
 static int pindex[2] = { 0, 0 };
 static uint8_t pallast[32+3] = { 0 }; // palette cache for change comparison
 static uint8_t palcache[36] = { 0 }; //palette cache for drawing
-static uint8_t chrcache0[0x1000] = {0}, chrcache1[0x1000] = {0}, logcache0[0x1000] = {0}, logcache1[0x1000] = {0}; //cache CHR, fixes a refresh problem when right-clicking
+static uint32_t chrcache0[0x800] = {0}, chrcache1[0x800] = {0}; //cache decoded CHR rows (see FCEUPPU_GetDecodedTile), fixes a refresh problem when right-clicking
+static uint8_t logcache0[0x1000] = {0}, logcache1[0x1000] = {0};
 static uint8_t oam[256];
 static bool	redrawWindow = true;
 
@@ -1364,10 +1365,12 @@ static int writeMemPPU( unsigned int addr, int value )
 	if (addr < 0x2000)
 	{
 		VPage[addr >> 10][addr] = value; //todo: detect if this is vrom and turn it red if so
+		FCEUPPU_InvalidateCHR(addr);
 	}
 	if ((addr >= 0x2000) && (addr < 0x3F00))
 	{
 		vnapage[(addr >> 10) & 0x3][addr & 0x3FF] = value; //todo: this causes 0x3000-0x3f00 to mirror 0x2000-0x2f00, is this correct?
+		FCEUPPU_InvalidateNametable(vnapage[(addr >> 10) & 0x3], addr);
 	}
 	if ((addr >= 0x3F00) && (addr < 0x3FFF))
 	{
@@ -1398,11 +1401,12 @@ static void initPPUViewer(void)
 
 }
 //----------------------------------------------------
-static void DrawPatternTable( ppuPatternTable_t *pattern, uint8_t *table, uint8_t *log, uint8_t pal)
+static void DrawPatternTable( ppuPatternTable_t *pattern, const uint32_t *table, uint8_t *log, uint8_t pal)
 {
 	int i,j,x,y,index=0;
-	int p=0,tmp;
-	uint8_t chr0,chr1,logs,shift;
+	int p=0;
+	uint32_t row;
+	uint8_t logs,shift;
 
 	if (palo == NULL)
 	{
@@ -1418,20 +1422,16 @@ static void DrawPatternTable( ppuPatternTable_t *pattern, uint8_t *table, uint8_
 			//-----------------------------------------------
 			for (y = 0; y < 8; y++)
 			{
-				chr0 = table[index];
-				chr1 = table[index + 8];
+				row  = table[((index >> 4) << 3) | (index & 7)];
 				logs = log[index] & log[index + 8];
-				tmp = 7;
 				shift=(PPUView_maskUnusedGraphics && debug_loggingCD && (((logs & 3) != 0) == PPUView_invertTheMask))?3:0;
 				for (x = 0; x < 8; x++)
 				{
-					p  =  (chr0 >> tmp) & 1;
-					p |= ((chr1 >> tmp) & 1) << 1;
+					p = (row >> (x << 2)) & 3;
 
 					pattern->tile[i][j].pixel[y][x].val = p;
 
 					p = palcache[p | pal];
-					tmp--;
 					pattern->tile[i][j].pixel[y][x].color.setBlue( palo[p].b >> shift );
 					pattern->tile[i][j].pixel[y][x].color.setGreen( palo[p].g >> shift );
 					pattern->tile[i][j].pixel[y][x].color.setRed( palo[p].r >> shift );
@@ -1451,8 +1451,9 @@ static void DrawPatternTable( ppuPatternTable_t *pattern, uint8_t *table, uint8_
 //----------------------------------------------------
 static void drawSpriteTable(void)
 {
-	int j=0, y,x,yy,xx,p,tmp,idx,chr0,chr1,pal,t0,t1;
-	uint8_t *chrcache;
+	int j=0, y,x,yy,xx,p,idx,pal,t0,t1;
+	uint32_t row;
+	const uint32_t *chrcache;
 	struct oamSpriteData_t *spr;
 
 	if (palo == NULL)
@@ -1519,9 +1520,7 @@ static void drawSpriteTable(void)
 				y = yy;
 			}
 
-			chr0 = chrcache[idx];
-			chr1 = chrcache[idx + 8];
-			tmp = 7;
+			row = chrcache[((idx >> 4) << 3) | (idx & 7)];
 
 			for (xx = 0; xx < 8; xx++)
 			{
@@ -1534,13 +1533,11 @@ static void drawSpriteTable(void)
 					x = xx;
 				}
 
-				p  =  (chr0 >> tmp) & 1;
-				p |= ((chr1 >> tmp) & 1) << 1;
+				p = (row >> (xx << 2)) & 3;
 
 				spr->tile[t0].pixel[y][x].val = p;
 
 				p = palcache[p | pal];
-				tmp--;
 				spr->tile[t0].pixel[y][x].color.setBlue( palo[p].b );
 				spr->tile[t0].pixel[y][x].color.setGreen( palo[p].g );
 				spr->tile[t0].pixel[y][x].color.setRed( palo[p].r );
@@ -1564,9 +1561,7 @@ static void drawSpriteTable(void)
 			{
 				y = yy;
 			}
-			chr0 = chrcache[idx];
-			chr1 = chrcache[idx + 8];
-			tmp = 7;
+			row = chrcache[((idx >> 4) << 3) | (idx & 7)];
 
 			for (xx = 0; xx < 8; xx++)
 			{
@@ -1579,13 +1574,11 @@ static void drawSpriteTable(void)
 					x = xx;
 				}
 
-				p  =  (chr0 >> tmp) & 1;
-				p |= ((chr1 >> tmp) & 1) << 1;
+				p = (row >> (xx << 2)) & 3;
 
 				spr->tile[t1].pixel[y][x].val = p;
 
 				p = palcache[p | pal];
-				tmp--;
 				spr->tile[t1].pixel[y][x].color.setBlue( palo[p].b );
 				spr->tile[t1].pixel[y][x].color.setGreen( palo[p].g );
 				spr->tile[t1].pixel[y][x].color.setRed( palo[p].r );
@@ -1624,7 +1617,22 @@ void FCEUD_UpdatePPUView(int scanline, int refreshchr)
 	if (refreshchr)
 	{
 		int i10, x10;
-		for (i = 0, x=0x1000; i < 0x1000; i++, x++)
+
+		// Decoded tiles come from the core's cache, which only decodes a CHR
+		// page again after it has been written or banked in for the first time.
+		for (i = 0, x=0x1000; i < 0x1000; i += 16, x += 16)
+		{
+			if ( VPage[i>>10] != NULL )
+			{
+				memcpy( &chrcache0[i >> 1], FCEUPPU_GetDecodedTile(i), 8 * sizeof(uint32_t) );
+			}
+			if ( VPage[x>>10] != NULL )
+			{
+				memcpy( &chrcache1[i >> 1], FCEUPPU_GetDecodedTile(x), 8 * sizeof(uint32_t) );
+			}
+		}
+
+		for (i = 0, x=0x1000; debug_loggingCD && (i < 0x1000); i++, x++)
 		{
 			i10 = i>>10;
 			x10 = x>>10;
@@ -1633,26 +1641,21 @@ void FCEUD_UpdatePPUView(int scanline, int refreshchr)
 			{
 				continue;
 			}
-			chrcache0[i] = VPage[i10][i];
-			chrcache1[i] = VPage[x10][x];
 
-			if (debug_loggingCD) 
+			if (cdloggerVideoDataSize)
 			{
-				if (cdloggerVideoDataSize)
-				{
-					int addr;
-					addr = &VPage[i10][i] - CHRptr[0];
-					if ((addr >= 0) && (addr < (int)cdloggerVideoDataSize))
-						logcache0[i] = cdloggervdata[addr];
-					addr = &VPage[x10][x] - CHRptr[0];
-					if ((addr >= 0) && (addr < (int)cdloggerVideoDataSize))
-						logcache1[i] = cdloggervdata[addr];
-				}
-			  	else
-			  	{
-					logcache0[i] = cdloggervdata[i];
-					logcache1[i] = cdloggervdata[x];
-				}
+				int addr;
+				addr = &VPage[i10][i] - CHRptr[0];
+				if ((addr >= 0) && (addr < (int)cdloggerVideoDataSize))
+					logcache0[i] = cdloggervdata[addr];
+				addr = &VPage[x10][x] - CHRptr[0];
+				if ((addr >= 0) && (addr < (int)cdloggerVideoDataSize))
+					logcache1[i] = cdloggervdata[addr];
+			}
+			else
+			{
+				logcache0[i] = cdloggervdata[i];
+				logcache1[i] = cdloggervdata[x];
 			}
 		}
 	}
@@ -31,19 +31,38 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <atomic>
 
 extern Config *g_config;
 extern bool turbo;
 
-static volatile int *s_Buffer = 0;
-static unsigned int s_BufferSize;
-static unsigned int s_BufferSize25;
-static unsigned int s_BufferSize50;
-static unsigned int s_BufferSize75;
-static unsigned int s_BufferRead;
-static unsigned int s_BufferWrite;
-static volatile unsigned int s_BufferIn = 0;
+// Sound ring buffer: WriteSound on the emulator thread is the only producer and
+// fillaudio on the SDL audio thread the only consumer. Each side stores only its
+// own index, so no audio lock is needed. One slot is kept empty to tell full from empty.
+static int *s_Buffer = 0;
+static unsigned int s_BufferSize;   // usable capacity in samples
+static unsigned int s_RingSize;     // s_BufferSize + 1
+static unsigned int s_BufferTarget; // fill level WriteSound steers toward
+static std::atomic<unsigned int> s_BufferRead(0);
+static std::atomic<unsigned int> s_BufferWrite(0);
 static unsigned int s_SampleRate = 44100;
+
+// Dynamic rate control: WriteSound resamples by a ratio that is nudged from the
+// buffer fill level, so the buffer settles at s_BufferTarget instead of drifting
+// into underflow or overflow. A slow integral term soaks up the steady clock drift
+// between emulation and sound card. Their sum is capped well below audible pitch change.
+static const double maxRateAdjust = 0.005;
+static const double rateTrimGain  = 0.000016;
+static double s_RateTrim     = 0.0;
+static double s_ResamplePos  = 0.0;
+static int    s_ResampleLast = 0;
+
+// Buffer statistics for the frame timing window, sampled on each audio callback.
+static std::atomic<unsigned int> s_FillCur(0);
+static std::atomic<unsigned int> s_FillMin(0);
+static std::atomic<unsigned int> s_FillMax(0);
+static std::atomic<unsigned int> s_UnderrunCount(0);
+static std::atomic<bool>         s_FillStatReset(true);
 static double noiseGate = 0.0;
 static double noiseGateRate = 0.010;
 static bool   noiseGateActive = true;
@@ -72,7 +91,26 @@ fillaudio(void *udata,
 	int16 *tmps = (int16*)stream;
 	len >>= 1;
 
-	if ( s_BufferIn > s_BufferSize25 )
+	unsigned int head = s_BufferWrite.load(std::memory_order_acquire);
+	unsigned int tail = s_BufferRead.load(std::memory_order_relaxed);
+	unsigned int avail = (head + s_RingSize - tail) % s_RingSize;
+
+	if ( s_FillStatReset.exchange(false) )
+	{
+		s_FillMin = avail;
+		s_FillMax = avail;
+	}
+	else if ( avail < s_FillMin )
+	{
+		s_FillMin = avail;
+	}
+	else if ( avail > s_FillMax )
+	{
+		s_FillMax = avail;
+	}
+	s_FillCur = avail;
+
+	if ( avail > s_BufferTarget / 2 )
 	{
 		fillInit = 0;
 	}
@@ -120,7 +158,7 @@ fillaudio(void *udata,
 			}
 			else
 			{
-				if ( s_BufferIn )
+				if ( avail )
 				{	
 					noiseGate += noiseGateRate;
 
@@ -131,11 +169,11 @@ fillaudio(void *udata,
 					}
 				}
 			}
-			if (s_BufferIn) 
+			if (avail) 
 			{
-				sample = s_Buffer[s_BufferRead] * noiseGate;
-				s_BufferRead = (s_BufferRead + 1) % s_BufferSize;
-				s_BufferIn--;
+				sample = s_Buffer[tail] * noiseGate;
+				tail = (tail + 1) % s_RingSize;
+				avail--;
 
 				*tmps = sample * noiseGate;
 			}
@@ -154,11 +192,11 @@ fillaudio(void *udata,
 	{
 		while (len) 
 		{
-			if (s_BufferIn) 
+			if (avail) 
 			{
-				sample = s_Buffer[s_BufferRead];
-				s_BufferRead = (s_BufferRead + 1) % s_BufferSize;
-				s_BufferIn--;
+				sample = s_Buffer[tail];
+				tail = (tail + 1) % s_RingSize;
+				avail--;
 			} else {
         	 		// Retain last known sample value, helps avoid clicking
         	 		// noise when sound system is starved of audio data.
@@ -174,8 +212,11 @@ fillaudio(void *udata,
 			len--;
 		}
 	}
+	s_BufferRead.store(tail, std::memory_order_release);
+
 	if ( bufStarveDetected )
 	{
+		s_UnderrunCount++;
 		//s_StarveCounter = nes_shm->sndBuf.starveCounter - starve_lp;
 		//printf("Starve:%u\n", s_StarveCounter );
 	}
@@ -187,7 +228,7 @@ fillaudio(void *udata,
 int
 InitSound()
 {
-	int i, sound, soundrate, soundbufsize, soundvolume, soundtrianglevolume, soundsquare1volume, soundsquare2volume, soundnoisevolume, soundpcmvolume, soundq;
+	int i, sound, soundrate, soundbufsize, soundvolume, soundtrianglevolume, soundsquare1volume, soundsquare2volume, soundnoisevolume, soundpcmvolume, soundq, soundsteps;
 	SDL_AudioSpec spec;
 	const char *driverName;
 	int frmRateSampleAdj = 0;
@@ -214,6 +255,7 @@ InitSound()
 	g_config->getOption("SDL.Sound.BufSize", &soundbufsize);
 	g_config->getOption("SDL.Sound.Volume", &soundvolume);
 	g_config->getOption("SDL.Sound.Quality", &soundq);
+	g_config->getOption("SDL.Sound.StepSynth", &soundsteps);
 	g_config->getOption("SDL.Sound.TriangleVolume", &soundtrianglevolume);
 	g_config->getOption("SDL.Sound.Square1Volume", &soundsquare1volume);
 	g_config->getOption("SDL.Sound.Square2Volume", &soundsquare2volume);
@@ -240,8 +282,8 @@ InitSound()
 
 	if ( (soundbufsize < 15) || (soundbufsize > 200) )
 	{
-		printf("Error: Audio Buffer Size of %i ms is invalid, reverting to default of 128\n", soundbufsize);
-		soundbufsize = 128;
+		printf("Error: Audio Buffer Size of %i ms is invalid, reverting to default of 48\n", soundbufsize);
+		soundbufsize = 48;
 		g_config->setOption("SDL.Sound.BufSize", soundbufsize);
 	}
 
@@ -266,9 +308,10 @@ InitSound()
 	{
 		s_BufferSize = spec.samples * 4;
 	}
-	s_BufferSize25 =    s_BufferSize/4;
-	s_BufferSize50 =    s_BufferSize/2;
-	s_BufferSize75 = (3*s_BufferSize)/4;
+	// WriteSound sees the buffer just before adding a whole frame of samples,
+	// so aim for the middle of what is left once a frame has been set aside.
+	s_RingSize     = s_BufferSize + 1;
+	s_BufferTarget = (s_BufferSize - samplesPerFrame) / 2;
 
 	//printf("Audio Buffer: %i  %i \n", spec.samples, s_BufferSize );
 
@@ -277,13 +320,19 @@ InitSound()
 	noiseGateActive = true;
 	fillInit = 1;
 
-	s_Buffer = (int *)FCEU_dmalloc(sizeof(int) * s_BufferSize);
+	s_Buffer = (int *)FCEU_dmalloc(sizeof(int) * s_RingSize);
 
 	if (!s_Buffer)
 	{
 		return 0;
 	}
-	s_BufferRead = s_BufferWrite = s_BufferIn = 0;
+	s_BufferRead = 0;
+	s_BufferWrite = 0;
+	s_RateTrim = 0.0;
+	s_ResamplePos = 0.0;
+	s_ResampleLast = 0;
+	s_UnderrunCount = 0;
+	s_FillStatReset = true;
 
 	if (SDL_OpenAudio(&spec, 0) < 0)
 	{
@@ -306,6 +355,7 @@ InitSound()
 
 	FCEUI_SetSoundVolume(soundvolume);
 	FCEUI_SetSoundQuality(soundq);
+	FCEUI_SetSoundStepSynth(soundsteps);
 	FCEUI_Sound(soundrate + frmRateSampleAdj);
 	FCEUI_SetTriangleVolume(soundtrianglevolume);
 	FCEUI_SetSquare1Volume(soundsquare1volume);
@@ -331,171 +381,145 @@ GetMaxSound(void)
 uint32
 GetWriteSound(void)
 {
-	return(s_BufferSize - s_BufferIn);
+	unsigned int head = s_BufferWrite.load(std::memory_order_relaxed);
+	unsigned int tail = s_BufferRead.load(std::memory_order_acquire);
+
+	if (!s_Buffer)
+	{
+		return 0;
+	}
+	return(s_BufferSize - (head + s_RingSize - tail) % s_RingSize);
+}
+
+/**
+ * Fills in the audio buffer fill level (in seconds) and underrun count
+ * for the frame timing statistics window.
+ */
+void
+getSoundBufferStats( struct frameTimingStat_t *stats )
+{
+	double sec = s_Buffer ? 1.0 / (double)s_SampleRate : 0.0;
+
+	stats->audioBufferFill.tgt = s_BufferTarget * sec;
+	stats->audioBufferFill.cur = s_FillCur * sec;
+	stats->audioBufferFill.min = s_FillMin * sec;
+	stats->audioBufferFill.max = s_FillMax * sec;
+
+	stats->audioUnderrunCount = s_UnderrunCount;
+}
+
+void
+resetSoundBufferStats(void)
+{
+	s_UnderrunCount = 0;
+	s_FillStatReset = true;
 }
 
 /**
  * Send a sound clip to the audio subsystem.
+ *
+ * The clip is resampled by the emulation speed, so fast forward drops and
+ * slow motion stretches samples, and by a small rate correction that keeps
+ * the buffer near its target fill level.
  */
 void
 WriteSound(int32 *buf,
            int Count)
 {
-
-	int uflowMode = 0;
-	int ovrFlowSkip = 1;
-	int udrFlowDup  = 1;
-	static int skipCounter = 0;
+	int waitCount = 0;
 
 	if ( (NoWaiting & 0x01) || turbo )
 	{	// During Turbo mode, don't bother with sound as
 		// overflowing the audio buffer can cause delays.
 		return;
 	}
-
-	if ( g_fpsScale >= 0.99995 )
+	if ( EmulationPaused || !s_Buffer )
 	{
-		uflowMode = 0;
-		ovrFlowSkip = (int)(g_fpsScale * 1000);
+		return;
+	}
 
-		if ( s_BufferIn >= s_BufferSize50 )
-		{
-			ovrFlowSkip += 1;
-		}
+	// Get current buffer index values from atomic variables and store in stack variables
+	// Do loop processing with stack variables and then update atomics when finished
+	unsigned int head = s_BufferWrite.load(std::memory_order_relaxed);
+	unsigned int tail = s_BufferRead.load(std::memory_order_acquire);
+	unsigned int fill = (head + s_RingSize - tail) % s_RingSize;
+
+	double fillError = ((double)fill - (double)s_BufferTarget) / (double)s_BufferTarget;
+
+	if ( fillError > 1.0 )
+	{
+		fillError = 1.0;
 	}
-	else
+	else if ( fillError < -1.0 )
 	{
-		udrFlowDup = (int)(1.0 / g_fpsScale);
+		fillError = -1.0;
+	}
+	s_RateTrim += rateTrimGain * fillError;
 
-		if ( udrFlowDup < 1 )
-		{
-			udrFlowDup = 1;
-		}
-		if ( s_BufferIn < s_BufferSize50 )
-		{
-			udrFlowDup++;
-		}
-		else if ( s_BufferIn > s_BufferSize75 )
-		{
-			udrFlowDup--;
-		}
-		uflowMode = (udrFlowDup > 1);
+	if ( s_RateTrim > maxRateAdjust )
+	{
+		s_RateTrim = maxRateAdjust;
 	}
-	extern int EmulationPaused;
-	if (EmulationPaused == 0)
+	else if ( s_RateTrim < -maxRateAdjust )
 	{
-		int waitCount = 0;
+		s_RateTrim = -maxRateAdjust;
+	}
+	double rateAdjust = maxRateAdjust * fillError + s_RateTrim;
 
-		if ( uflowMode )
-		{	// Underflow mode
-			SDL_LockAudio();
-			while (Count)
-			{
-				if ( s_BufferIn == s_BufferSize )
-				{
-					SDL_UnlockAudio();
-					while (s_BufferIn == s_BufferSize) 
-					{
-						SDL_Delay(1); waitCount++;
+	if ( rateAdjust > maxRateAdjust )
+	{
+		rateAdjust = maxRateAdjust;
+	}
+	else if ( rateAdjust < -maxRateAdjust )
+	{
+		rateAdjust = -maxRateAdjust;
+	}
+	// Input samples consumed per output sample.
+	double step = g_fpsScale * (1.0 + rateAdjust);
+	double pos  = s_ResamplePos;
+	int    last = s_ResampleLast;
 
-						if ( waitCount > 1000 )
-						{
-							printf("Error: Sound sink is not draining... Breaking out of audio loop to prevent lockup.\n");
-							return;
-						}
-					}
-					SDL_LockAudio();
-				}
+	while (Count)
+	{
+		int next = *buf;
 
-				for (int i=0; i<udrFlowDup; i++)
-				{
-					s_Buffer[s_BufferWrite] = *buf;
-					s_BufferWrite = (s_BufferWrite + 1) % s_BufferSize;
-            
-					s_BufferIn++;
-				}
-            
-				Count--;
-				buf++;
-			}
-			SDL_UnlockAudio();
-		}
-		else
+		while ( pos < 1.0 )
 		{
-			if ( ovrFlowSkip <= 1000 )
-			{	// Perfect one to one realtime
-				skipCounter = 0;
+			if ( fill >= s_BufferSize )
+			{
+				s_BufferWrite.store(head, std::memory_order_release);
 
-				SDL_LockAudio();
-				while (Count)
+				while ( fill >= s_BufferSize )
 				{
-					if (s_BufferIn == s_BufferSize) 
-					{
-						SDL_UnlockAudio();
-						while (s_BufferIn == s_BufferSize) 
-						{
-							SDL_Delay(1); waitCount++;
-
-							if ( waitCount > 1000 )
-							{
-								printf("Error: Sound sink is not draining... Breaking out of audio loop to prevent lockup.\n");
-								return;
-							}
-						}
-						SDL_LockAudio();
-					}
+					SDL_Delay(1); waitCount++;
 
-					s_Buffer[s_BufferWrite] = *buf;
-					Count--;
-					s_BufferWrite = (s_BufferWrite + 1) % s_BufferSize;
-            
-					s_BufferIn++;
-					buf++;
-				}
-				SDL_UnlockAudio();
-			}
-			else
-			{	// Overflow mode
-				SDL_LockAudio();
-				while (Count)
-				{
-					if (s_BufferIn == s_BufferSize) 
+					if ( waitCount > 1000 )
 					{
-						SDL_UnlockAudio();
-						while (s_BufferIn == s_BufferSize) 
-						{
-							SDL_Delay(1); waitCount++;
-
-							if ( waitCount > 1000 )
-							{
-								printf("Error: Sound sink is not draining... Breaking out of audio loop to prevent lockup.\n");
-								return;
-							}
-						}
-						SDL_LockAudio();
+						printf("Error: Sound sink is not draining... Breaking out of audio loop to prevent lockup.\n");
+						s_ResamplePos  = 0.0;
+						s_ResampleLast = next;
+						return;
 					}
-
-					//printf("%i >= %i \n", skipCounter, ovrFlowSkip );
-
-					if ( skipCounter >= ovrFlowSkip )
-					{
-						s_Buffer[s_BufferWrite] = *buf;
-						s_BufferWrite = (s_BufferWrite + 1) % s_BufferSize;
-            
-						s_BufferIn++;
-
-						skipCounter -= ovrFlowSkip;
-					}
-					skipCounter = (skipCounter+1000);
-            
-					Count--;
-					buf++;
+					tail = s_BufferRead.load(std::memory_order_acquire);
+					fill = (head + s_RingSize - tail) % s_RingSize;
 				}
-				SDL_UnlockAudio();
 			}
+			s_Buffer[head] = last + (int)((next - last) * pos);
+			head = (head + 1) % s_RingSize;
+			fill++;
 
+			pos += step;
 		}
+		pos -= 1.0;
+		last = next;
+
+		Count--;
+		buf++;
 	}
+	s_BufferWrite.store(head, std::memory_order_release);
+
+	s_ResamplePos  = pos;
+	s_ResampleLast = last;
 }
 
 /**
@@ -520,7 +544,8 @@ KillSound(void)
 		free((void *)s_Buffer);
 		s_Buffer = 0;
 	}
-	s_BufferIn = 0;
+	s_BufferRead = 0;
+	s_BufferWrite = 0;
 	return 0;
 }
 
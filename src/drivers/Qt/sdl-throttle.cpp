@@ -205,6 +205,8 @@ int  getFrameTimingStats( struct frameTimingStat_t *stats )
 	stats->emuSignalDelay.min = emuLatencyMin;
 	stats->emuSignalDelay.max = emuLatencyMax;
 
+	getSoundBufferStats( stats );
+
 	return 0;
 }
 
@@ -267,6 +269,8 @@ void resetFrameTiming(void)
 	videoPeriodMax = 0.0;
 	emuLatencyMin =  1.0;
 	emuLatencyMax =  0.0;
+
+	resetSoundBufferStats();
 }
 
 /* LOGMUL = exp(log(2) / 3)
@@ -50,7 +50,15 @@ struct frameTimingStat_t
 		double max;
 	} emuSignalDelay;
 
+	struct {
+		double tgt;
+		double cur;
+		double min;
+		double max;
+	} audioBufferFill;
+
 	unsigned int lateCount;
+	unsigned int audioUnderrunCount;
 
 	bool enabled;
 };
@@ -58,6 +66,8 @@ struct frameTimingStat_t
 void resetFrameTiming(void);
 void setFrameTimingEnable( bool enable );
 int  getFrameTimingStats( struct frameTimingStat_t *stats );
+void getSoundBufferStats( struct frameTimingStat_t *stats ); // sdl-sound.cpp
+void resetSoundBufferStats(void);
 void videoBufferSwapMark(void);
 void emuSignalSendMark(void);
 void guiSignalRecvMark(void);
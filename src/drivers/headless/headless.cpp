@@ -0,0 +1,278 @@
+/* FCE Ultra - NES/Famicom Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+/// \file
+/// \brief Stub driver layer for linking the emulator core without a GUI.
+///
+/// Every FCEUD_* callback the core makes is answered here without touching
+/// video, audio, timers or windowing. The batch runner in main.cpp and any
+/// other program linking fceux-core get these definitions.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "../../types.h"
+#include "../../fceu.h"
+#include "../../driver.h"
+#include "../../utils/timeStamp.h"
+
+#include "headless.h"
+
+//*****************************************************************
+// Driver state expected by the core
+//*****************************************************************
+
+FCEU_THREAD_LOCAL int noGui = 1;
+FCEU_THREAD_LOCAL int isloaded = 0;
+
+FCEU_THREAD_LOCAL int dendy = 0;
+FCEU_THREAD_LOCAL int pal_emulation = 0;
+FCEU_THREAD_LOCAL bool swapDuty = 0;
+FCEU_THREAD_LOCAL bool turbo = false;
+FCEU_THREAD_LOCAL int eoptions = 0;
+
+FCEU_THREAD_LOCAL int closeFinishedMovie = 0;
+FCEU_THREAD_LOCAL int KillFCEUXonFrame = 0;
+
+FCEU_THREAD_LOCAL bool paldeemphswap = 0;
+
+// Input buffers handed to the core by FCEUI_SetInput.
+FCEU_THREAD_LOCAL uint32 headlessJoyData = 0;
+static FCEU_THREAD_LOCAL uint32 powerpadbuf[2] = { 0, 0 };
+static FCEU_THREAD_LOCAL uint32 MouseData[3] = { 0, 0, 0 };
+static FCEU_THREAD_LOCAL uint32 MouseRelative[3] = { 0, 0, 0 };
+static FCEU_THREAD_LOCAL unsigned int keyboardState[256];
+
+static FCEU_THREAD_LOCAL bool quietMessages = false;
+
+void HeadlessSetQuiet(bool quiet)
+{
+	quietMessages = quiet;
+}
+
+//*****************************************************************
+// Messages and files
+//*****************************************************************
+
+void FCEUD_Message(const char *text)
+{
+	if (!quietMessages)
+	{
+		fputs(text, stdout);
+	}
+}
+
+void FCEUD_PrintError(const char *errormsg)
+{
+	fprintf(stderr, "%s\n", errormsg);
+}
+
+FILE *FCEUD_UTF8fopen(const char *fn, const char *mode)
+{
+	return ::fopen(fn, mode);
+}
+
+EMUFILE_FILE* FCEUD_UTF8_fstream(const char *fn, const char *m)
+{
+	return new EMUFILE_FILE(fn, m);
+}
+
+// Archives are not supported; every file is opened as a plain file.
+ArchiveScanRecord FCEUD_ScanArchive(std::string fname)
+{
+	return ArchiveScanRecord();
+}
+
+FCEUFILE* FCEUD_OpenArchive(ArchiveScanRecord& asr, std::string& fname, std::string* innerFilename, int* userCancel)
+{
+	return nullptr;
+}
+
+FCEUFILE* FCEUD_OpenArchive(ArchiveScanRecord& asr, std::string& fname, std::string* innerFilename)
+{
+	return nullptr;
+}
+
+FCEUFILE* FCEUD_OpenArchiveIndex(ArchiveScanRecord& asr, std::string &fname, int innerIndex, int* userCancel)
+{
+	return nullptr;
+}
+
+FCEUFILE* FCEUD_OpenArchiveIndex(ArchiveScanRecord& asr, std::string &fname, int innerIndex)
+{
+	return nullptr;
+}
+
+#if defined(__GNUC__)
+ #define __COMPILER__STRING__ "gcc " __VERSION__
+#elif defined(__clang__)
+ #define __COMPILER__STRING__ "clang " __VERSION__
+#else
+ #define __COMPILER__STRING__ "unknown"
+#endif
+
+const char *FCEUD_GetCompilerString(void)
+{
+	return __COMPILER__STRING__;
+}
+
+//*****************************************************************
+// Timing
+//*****************************************************************
+
+uint64 FCEUD_GetTime(void)
+{
+	FCEU::timeStampRecord ts;
+
+	ts.readNew();
+
+	return ts.toCounts();
+}
+
+uint64 FCEUD_GetTimeFreq(void)
+{
+	return FCEU::timeStampRecord::countFreq();
+}
+
+// There is no throttle; frames run as fast as the host allows.
+void RefreshThrottleFPS(void) { }
+void FCEUD_SetEmulationSpeed(int cmd) { }
+void FCEUD_TurboOn(void) { turbo = true; }
+void FCEUD_TurboOff(void) { turbo = false; }
+void FCEUD_TurboToggle(void) { turbo = !turbo; }
+
+//*****************************************************************
+// Video and sound
+//*****************************************************************
+
+void FCEUD_Update(uint8 *XBuf, int32 *Buffer, int Count) { }
+void FCEUD_SetPalette(uint8 index, uint8 r, uint8 g, uint8 b) { }
+
+void FCEUD_GetPalette(uint8 index, uint8 *r, uint8 *g, uint8 *b)
+{
+	*r = *g = *b = 0;
+}
+
+void FCEUD_VideoChanged(void) { }
+bool FCEUD_ShouldDrawInputAids(void) { return false; }
+int FCEUD_ShowStatusIcon(void) { return 0; }
+void FCEUD_ToggleStatusIcon(void) { }
+void FCEUD_HideMenuToggle(void) { }
+void FCEUD_SoundToggle(void) { }
+void FCEUD_SoundVolumeAdjust(int n) { }
+
+u32 ModernDeemphColorMap(const u8* src, const u8* srcbuf, int scale)
+{
+	return 0;
+}
+
+int FCEUI_AviBegin(const char* fname) { return 0; }
+void FCEUI_AviEnd(void) { }
+void FCEUI_AviVideoUpdate(const unsigned char* buffer) { }
+void FCEUI_AviSoundUpdate(void* soundData, int soundLen) { }
+bool FCEUI_AviIsRecording(void) { return false; }
+bool FCEUI_AviEnableHUDrecording(void) { return false; }
+void FCEUI_SetAviEnableHUDrecording(bool enable) { }
+bool FCEUI_AviDisableMovieMessages(void) { return true; }
+void FCEUI_SetAviDisableMovieMessages(bool disable) { }
+void FCEUD_AviRecordTo(void) { }
+void FCEUD_AviStop(void) { }
+
+//*****************************************************************
+// Input
+//*****************************************************************
+
+void GetMouseData(uint32 (&d)[3])
+{
+	memcpy(d, MouseData, sizeof(d));
+}
+
+unsigned int *GetKeyboard(void)
+{
+	return keyboardState;
+}
+
+void FCEUI_UseInputPreset(int preset) { }
+
+/**
+ * Connects the requested devices to the driver-side input buffers.
+ * Only devices a movie can drive are given data.
+ */
+void FCEUD_SetInput(bool fourscore, bool microphone, ESI port0, ESI port1, ESIFC fcexp)
+{
+	ESI ports[2] = { port0, port1 };
+
+	if (fourscore)
+	{
+		ports[0] = ports[1] = SI_GAMEPAD;
+		fcexp = SIFC_NONE;
+	}
+	FCEUI_SetInputFourscore(fourscore);
+
+	for (int x = 0; x < 2; x++)
+	{
+		void *InputDPtr = nullptr;
+
+		switch (ports[x])
+		{
+		case SI_POWERPADA:
+		case SI_POWERPADB:
+			InputDPtr = &powerpadbuf[x];
+			break;
+		case SI_GAMEPAD:
+		case SI_SNES:
+			InputDPtr = &headlessJoyData;
+			break;
+		case SI_ARKANOID:
+		case SI_ZAPPER:
+			InputDPtr = MouseData;
+			break;
+		case SI_MOUSE:
+		case SI_SNES_MOUSE:
+			InputDPtr = MouseRelative;
+			break;
+		default:
+			break;
+		}
+		FCEUI_SetInput(x, ports[x], InputDPtr, 0);
+	}
+	FCEUI_SetInputFC(fcexp, (fcexp == SIFC_NONE) ? nullptr : MouseData, 0);
+}
+
+//*****************************************************************
+// Debugger and tool windows
+//*****************************************************************
+
+void FCEUD_DebugBreakpoint(int bp_num) { }
+void FCEUD_FlushTrace(void) { }
+void FCEUD_UpdateNTView(int scanline, bool drawall) { }
+void FCEUD_UpdatePPUView(int scanline, int refreshchr) { }
+bool FCEUD_PauseAfterPlayback(void) { return false; }
+
+void FCEUD_SaveStateAs(void) { }
+void FCEUD_LoadStateFrom(void) { }
+void FCEUD_MovieRecordTo(void) { }
+void FCEUD_MovieReplayFrom(void) { }
+
+//*****************************************************************
+// Netplay
+//*****************************************************************
+
+int FCEUD_SendData(void *data, uint32 len) { return 0; }
+int FCEUD_RecvData(void *data, uint32 len) { return 0; }
+void FCEUD_NetworkClose(void) { }
+void FCEUD_NetplayText(uint8 *text) { }
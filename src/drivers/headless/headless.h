@@ -0,0 +1,20 @@
+#ifndef __FCEU_HEADLESS_H
+#define __FCEU_HEADLESS_H
+
+#include "../../driver.h"
+
+// Driver globals the emulator core expects every frontend to provide.
+extern FCEU_THREAD_LOCAL int noGui;
+extern FCEU_THREAD_LOCAL int isloaded;
+
+extern FCEU_THREAD_LOCAL int dendy;
+extern FCEU_THREAD_LOCAL int pal_emulation;
+extern FCEU_THREAD_LOCAL bool swapDuty;
+
+void FCEUD_Update(uint8 *XBuf, int32 *Buffer, int Count);
+uint64 FCEUD_GetTime();
+
+// Silences FCEUD_Message output (errors are still printed).
+void HeadlessSetQuiet(bool quiet);
+
+#endif
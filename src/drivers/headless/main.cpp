@@ -0,0 +1,422 @@
+/* FCE Ultra - NES/Famicom Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+/// \file
+/// \brief Batch runner: loads a ROM and optionally an FM2, then emulates
+/// unthrottled with no video or audio output and reports frames per second.
+///
+/// The core keeps its state in thread-local storage when built as fceux-core,
+/// so --instances runs several independent emulators side by side.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+#include "../../types.h"
+#include "../../fceu.h"
+#include "../../driver.h"
+#include "../../movie.h"
+#include "../../state.h"
+#include "../../emufile.h"
+#include "../../video.h"
+#include "../../x6502.h"
+#include "../../utils/crc32.h"
+#include "../../utils/timeStamp.h"
+
+#include "headless.h"
+
+extern FCEU_THREAD_LOCAL int newppu;
+extern FCEU_THREAD_LOCAL int newppu_catchup;
+
+struct RunOptions
+{
+	const char *romFile = nullptr;
+	const char *movieFile = nullptr;
+	const char *baseDir = nullptr;
+	int maxFrames = -1;
+	int soundRate = 0;
+	int soundQuality = 0;
+	bool soundSteps = false;
+	bool pal = false;
+	bool newPPU = false;
+	bool ppuCatchUp = false;
+	bool idleSkip = false;
+	bool noVideo = false;
+	int checkStates = 0;
+	bool quiet = false;
+};
+
+struct RunResult
+{
+	bool ok = false;
+	int frames = 0;
+	double elapsed = 0.0;
+	uint32 ramCRC = 0;
+	uint32 frameCRC = 0;
+	uint32 soundCRC = 0;
+	double soundSquares = 0.0;
+	uint64 soundSamples = 0;
+	int stateChecks = 0;
+};
+
+static void ShowUsage(const char *prog)
+{
+	printf("Usage: %s [options] <rom>\n", prog);
+	printf("Options:\n");
+	printf("  --movie <file>    Replay an FM2 movie read-only\n");
+	printf("  --frames <n>      Stop after n frames (default: movie length, or 3600)\n");
+	printf("  --pal             Emulate a PAL console\n");
+	printf("  --newppu          Use the new PPU\n");
+	printf("  --ppu-catchup     Use the new PPU, letting the CPU run ahead of it between register accesses\n");
+	printf("  --idle-skip       Step over polling loops in one go (same results, less work)\n");
+	printf("  --no-video        Only emulate what the game can see of the PPU; no frame is drawn\n");
+	printf("  --sound <rate>    Emulate sound at the given rate; output is discarded (default: off)\n");
+	printf("  --soundq <q>      Sound quality: 0 low, 1 high, 2 very high (default: 0)\n");
+	printf("  --sound-steps     Render high quality sound from band-limited steps\n");
+	printf("  --check-states <n> Every n frames, check that the previous savestate plus an incremental one gives the current state\n");
+	printf("  --basedir <dir>   Base directory for battery saves and other files\n");
+	printf("  --instances <n>   Run n independent emulator instances on n threads (default: 1)\n");
+	printf("  --hash            Print CRC32 of RAM and of the last frame at exit, and CRC32 and RMS of all sound output\n");
+	printf("  --quiet           Suppress emulator messages\n");
+}
+
+/**
+ * Makes an incremental savestate against the state of the previous check, then
+ * loads that state and the incremental one on top of it.  The result has to
+ * save byte for byte like the current state.
+ */
+static bool CheckIncrementalState(std::vector<uint8> &prevState)
+{
+	std::vector<uint8> incState, state, restored;
+	EMUFILE_MEMORY inc(&incState);
+	EMUFILE_MEMORY ms(&state);
+
+	if (!FCEUSS_SaveMSIncremental(&inc) || !FCEUSS_SaveMS(&ms, Z_NO_COMPRESSION))
+	{
+		return false;
+	}
+	inc.trim();
+	ms.trim();
+
+	if (!prevState.empty())
+	{
+		EMUFILE_MEMORY prev(&prevState);
+		EMUFILE_MEMORY incIn(&incState);
+		EMUFILE_MEMORY rs(&restored);
+
+		if (!FCEUSS_LoadFP(&prev, SSLOADPARAM_NOBACKUP) || !FCEUSS_LoadMSIncremental(&incIn))
+		{
+			return false;
+		}
+		if (!FCEUSS_SaveMS(&rs, Z_NO_COMPRESSION))
+		{
+			return false;
+		}
+		rs.trim();
+		if (restored != state)
+		{
+			return false;
+		}
+	}
+	prevState.swap(state);
+	return true;
+}
+
+/**
+ * Runs one emulator instance from start to finish on the calling thread.
+ * All emulator state touched here is local to that thread.
+ */
+static void RunInstance(const RunOptions &opt, RunResult &result)
+{
+	HeadlessSetQuiet(opt.quiet);
+
+	if (!FCEUI_Initialize())
+	{
+		fprintf(stderr, "Error: Initializing FCEUI\n");
+		return;
+	}
+
+	if (opt.baseDir)
+	{
+		FCEUI_SetBaseDirectory(opt.baseDir);
+	}
+	newppu = opt.newPPU;
+	newppu_catchup = opt.ppuCatchUp;
+	X6502_SetIdleLoopSkip(opt.idleSkip);
+	FCEUI_SetNoVideo(opt.noVideo);
+	pal_emulation = opt.pal;
+	FCEUI_SetVidSystem(opt.pal);
+	FCEUI_SetSoundQuality(opt.soundQuality);
+	FCEUI_SetSoundStepSynth(opt.soundSteps);
+	FCEUI_Sound(opt.soundRate);
+
+	if (!FCEUI_LoadGame(opt.romFile, 1, true))
+	{
+		fprintf(stderr, "Error: Could not load ROM %s\n", opt.romFile);
+		FCEUI_Kill();
+		return;
+	}
+	isloaded = 1;
+
+	FCEUD_SetInput(false, false, SI_GAMEPAD, SI_GAMEPAD, SIFC_NONE);
+
+	int maxFrames = opt.maxFrames;
+
+	if (opt.movieFile)
+	{
+		if (!FCEUI_LoadMovie(opt.movieFile, true, 0))
+		{
+			fprintf(stderr, "Error: Could not load movie %s\n", opt.movieFile);
+			FCEUI_CloseGame();
+			FCEUI_Kill();
+			return;
+		}
+		if (maxFrames < 0)
+		{
+			maxFrames = FCEUI_GetMovieLength();
+		}
+	}
+	if (maxFrames < 0)
+	{
+		maxFrames = 3600;
+	}
+
+	uint8 *gfx = nullptr;
+	int32 *sound = nullptr;
+	int32 ssize = 0;
+	int frames = 0;
+	std::vector<uint8> checkedState;
+
+	FCEU::timeStampRecord start, finish;
+
+	start.readNew();
+
+	while (frames < maxFrames)
+	{
+		if (opt.movieFile && !FCEUMOV_IsPlaying())
+		{
+			break;
+		}
+		FCEUI_Emulate(&gfx, &sound, &ssize, 1);
+		if (ssize > 0)
+		{
+			result.soundCRC = CalcCRC32(result.soundCRC, (uint8 *)sound, ssize * sizeof(int32));
+			for (int32 s = 0; s < ssize; s++)
+			{
+				result.soundSquares += (double)sound[s] * sound[s];
+			}
+			result.soundSamples += ssize;
+		}
+		frames++;
+
+		if (opt.checkStates > 0 && frames % opt.checkStates == 0)
+		{
+			if (!CheckIncrementalState(checkedState))
+			{
+				fprintf(stderr, "Error: Incremental savestate check failed at frame %i\n", frames);
+				FCEUI_CloseGame();
+				FCEUI_Kill();
+				return;
+			}
+			result.stateChecks++;
+		}
+	}
+
+	finish.readNew();
+
+	result.ok = true;
+	result.frames = frames;
+	result.elapsed = (finish - start).toSeconds();
+	result.ramCRC = CalcCRC32(0, RAM, 0x800);
+	result.frameCRC = CalcCRC32(0, XBuf, 256 * 256);
+
+	FCEUI_CloseGame();
+	FCEUI_Kill();
+}
+
+int main(int argc, char *argv[])
+{
+	RunOptions opt;
+	int numInstances = 1;
+	bool printHash = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char *arg = argv[i];
+		bool hasValue = (i + 1) < argc;
+
+		if (!strcmp(arg, "--movie") && hasValue)
+		{
+			opt.movieFile = argv[++i];
+		}
+		else if (!strcmp(arg, "--frames") && hasValue)
+		{
+			opt.maxFrames = atoi(argv[++i]);
+		}
+		else if (!strcmp(arg, "--sound") && hasValue)
+		{
+			opt.soundRate = atoi(argv[++i]);
+		}
+		else if (!strcmp(arg, "--soundq") && hasValue)
+		{
+			opt.soundQuality = atoi(argv[++i]);
+		}
+		else if (!strcmp(arg, "--sound-steps"))
+		{
+			opt.soundSteps = true;
+		}
+		else if (!strcmp(arg, "--check-states") && hasValue)
+		{
+			opt.checkStates = atoi(argv[++i]);
+		}
+		else if (!strcmp(arg, "--basedir") && hasValue)
+		{
+			opt.baseDir = argv[++i];
+		}
+		else if (!strcmp(arg, "--instances") && hasValue)
+		{
+			numInstances = atoi(argv[++i]);
+		}
+		else if (!strcmp(arg, "--idle-skip"))
+		{
+			opt.idleSkip = true;
+		}
+		else if (!strcmp(arg, "--no-video"))
+		{
+			opt.noVideo = true;
+		}
+		else if (!strcmp(arg, "--pal"))
+		{
+			opt.pal = true;
+		}
+		else if (!strcmp(arg, "--newppu"))
+		{
+			opt.newPPU = true;
+		}
+		else if (!strcmp(arg, "--ppu-catchup"))
+		{
+			opt.newPPU = true;
+			opt.ppuCatchUp = true;
+		}
+		else if (!strcmp(arg, "--hash"))
+		{
+			printHash = true;
+		}
+		else if (!strcmp(arg, "--quiet"))
+		{
+			opt.quiet = true;
+		}
+		else if (!strcmp(arg, "--help") || !strcmp(arg, "-h"))
+		{
+			ShowUsage(argv[0]);
+			return 0;
+		}
+		else if (arg[0] != '-' && opt.romFile == nullptr)
+		{
+			opt.romFile = arg;
+		}
+		else
+		{
+			fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+			ShowUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (opt.romFile == nullptr || numInstances < 1)
+	{
+		ShowUsage(argv[0]);
+		return 1;
+	}
+
+	std::vector<RunResult> results(numInstances);
+
+	FCEU::timeStampRecord start, finish;
+
+	start.readNew();
+
+	if (numInstances == 1)
+	{
+		RunInstance(opt, results[0]);
+	}
+	else
+	{
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < numInstances; i++)
+		{
+			threads.emplace_back(RunInstance, std::cref(opt), std::ref(results[i]));
+		}
+		for (size_t i = 0; i < threads.size(); i++)
+		{
+			threads[i].join();
+		}
+	}
+
+	finish.readNew();
+
+	int totalFrames = 0;
+
+	for (int i = 0; i < numInstances; i++)
+	{
+		const RunResult &r = results[i];
+
+		if (!r.ok)
+		{
+			return 1;
+		}
+		totalFrames += r.frames;
+
+		if (numInstances > 1)
+		{
+			printf("instance %i: ", i);
+		}
+		printf("frames: %i  time: %.3f s  fps: %.1f\n", r.frames, r.elapsed,
+				(r.elapsed > 0.0) ? (double)r.frames / r.elapsed : 0.0);
+
+		if (printHash)
+		{
+			printf("ram crc32: %08X\n", r.ramCRC);
+			printf("frame crc32: %08X\n", r.frameCRC);
+
+			if (opt.soundRate)
+			{
+				printf("sound crc32: %08X\n", r.soundCRC);
+				printf("sound rms: %.1f\n", r.soundSamples ? sqrt(r.soundSquares / r.soundSamples) : 0.0);
+			}
+		}
+		if (opt.checkStates > 0)
+		{
+			printf("incremental state checks passed: %i\n", r.stateChecks);
+		}
+	}
+
+	if (numInstances > 1)
+	{
+		double elapsed = (finish - start).toSeconds();
+
+		printf("total frames: %i  time: %.3f s  fps: %.1f\n", totalFrames, elapsed,
+				(elapsed > 0.0) ? (double)totalFrames / elapsed : 0.0);
+	}
+
+	return 0;
+}
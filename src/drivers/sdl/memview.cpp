@@ -25,6 +25,7 @@
 #include "../../fds.h"
 #include "../../cart.h"
 #include "../../ines.h"
+#include "../../ppu.h"
 #include "../common/configSys.h"
 
 #include "sdl.h"
@@ -256,10 +257,12 @@ struct memViewWin_t
 				if (addr < 0x2000)
 				{
 					VPage[addr >> 10][addr] = value; //todo: detect if this is vrom and turn it red if so
+					FCEUPPU_InvalidateCHR(addr);
 				}
 				if ((addr >= 0x2000) && (addr < 0x3F00))
 				{
 					vnapage[(addr >> 10) & 0x3][addr & 0x3FF] = value; //todo: this causes 0x3000-0x3f00 to mirror 0x2000-0x2f00, is this correct?
+					FCEUPPU_InvalidateNametable(vnapage[(addr >> 10) & 0x3], addr);
 				}
 				if ((addr >= 0x3F00) && (addr < 0x3FFF))
 				{
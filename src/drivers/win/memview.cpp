@@ -27,6 +27,7 @@
 #include "../../cheat.h"
 #include "../../cart.h"
 #include "../../ines.h"
+#include "../../ppu.h"
 #include "memview.h"
 #include "debugger.h"
 #include "cdlogger.h"
@@ -1031,9 +1032,15 @@ void InputData(char *input){
 					// PPU
 					addr &= 0x3FFF;
 					if (addr < 0x2000)
+					{
 						VPage[addr >> 10][addr] = data[i]; //todo: detect if this is vrom and turn it red if so
+						FCEUPPU_InvalidateCHR(addr);
+					}
 					if ((addr >= 0x2000) && (addr < 0x3F00))
+					{
 						vnapage[(addr >> 10) & 0x3][addr & 0x3FF] = data[i]; //todo: this causes 0x3000-0x3f00 to mirror 0x2000-0x2f00, is this correct?
+						FCEUPPU_InvalidateNametable(vnapage[(addr >> 10) & 0x3], addr);
+					}
 					if ((addr >= 0x3F00) && (addr < 0x3FFF))
 						PalettePoke(addr, data[i]);
 					break;
@@ -2237,9 +2244,15 @@ LRESULT CALLBACK MemViewCallB(HWND hwnd, UINT message, WPARAM wParam, LPARAM lPa
 				{
 					char v = bar[addr];
 					if(addr < 0x2000)
+					{
 						VPage[addr>>10][addr] = v; //todo: detect if this is vrom and turn it red if so
+						FCEUPPU_InvalidateCHR(addr);
+					}
 					if((addr >= 0x2000) && (addr < 0x3F00))
+					{
 						vnapage[(addr>>10)&0x3][addr&0x3FF] = v; //todo: this causes 0x3000-0x3f00 to mirror 0x2000-0x2f00, is this correct?
+						FCEUPPU_InvalidateNametable(vnapage[(addr>>10)&0x3], addr);
+					}
 					if((addr >= 0x3F00) && (addr < 0x3FFF))
 						PalettePoke(addr,v);
 				}
@@ -50,6 +50,7 @@ void GREENZONE::init()
 void GREENZONE::free()
 {
 	savestates.resize(0);
+	pendingSavestates.clear();
 	greenzoneSize = 0;
 	lagLog.reset();
 }
@@ -59,6 +60,9 @@ void GREENZONE::reset()
 }
 void GREENZONE::update()
 {
+	// take in the savestates that worker threads have finished compressing
+	collectCompressedSavestates();
+
 	// keep collecting savestates, this code must be executed at the end of every frame
 	if (taseditorConfig.enableGreenzoning)
 	{
@@ -115,13 +119,44 @@ void GREENZONE::collectCurrentState()
 	// if frame is not saved - log savestate
 	if (!savestates[currFrameCounter].size())
 	{
+		// log it uncompressed, so it can be loaded right away, and let a worker thread compress it
 		EMUFILE_MEMORY ms(&savestates[currFrameCounter]);
-		FCEUSS_SaveMS(&ms, Z_DEFAULT_COMPRESSION);
+		FCEUSS_SaveMS(&ms, Z_NO_COMPRESSION);
 		ms.trim();
+		dropPendingSavestate(currFrameCounter);
+		PendingSavestate pending;
+		pending.frame = currFrameCounter;
+		pending.compressed = FCEUSS_CompressMSAsync(&savestates[currFrameCounter][0], savestates[currFrameCounter].size(), Z_DEFAULT_COMPRESSION);
+		pendingSavestates.push_back(std::move(pending));
 	}
 	if (greenzoneSize <= currFrameCounter)
 		greenzoneSize = currFrameCounter + 1;
 }
+// moves the savestates that have been compressed in place of their uncompressed copies
+// if "wait" is true, waits for the ones that are still being compressed
+void GREENZONE::collectCompressedSavestates(bool wait)
+{
+	for (int i = pendingSavestates.size() - 1; i >= 0; i--)
+	{
+		PendingSavestate& pending = pendingSavestates[i];
+		if (!wait && pending.compressed.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			continue;
+		std::vector<uint8> compressed = pending.compressed.get();
+		// if compression failed, the uncompressed savestate is kept
+		if (compressed.size() && pending.frame < (int)savestates.size() && savestates[pending.frame].size())
+			savestates[pending.frame].swap(compressed);
+		pendingSavestates.erase(pendingSavestates.begin() + i);
+	}
+}
+// forgets about the compression of a savestate that is being replaced or cleared
+void GREENZONE::dropPendingSavestate(int frame)
+{
+	for (int i = pendingSavestates.size() - 1; i >= 0; i--)
+	{
+		if (pendingSavestates[i].frame == frame)
+			pendingSavestates.erase(pendingSavestates.begin() + i);
+	}
+}
 
 bool GREENZONE::loadSavestateOfFrame(unsigned int frame)
 {
@@ -192,6 +227,7 @@ bool GREENZONE::clearSavestateOfFrame(unsigned int frame)
 {
 	if (frame < savestates.size() && savestates[frame].size())
 	{
+		dropPendingSavestate(frame);
 	    savestates[frame].resize(0);
 		return true;
 	} else
@@ -203,6 +239,7 @@ bool GREENZONE::clearSavestateAndFreeMemory(unsigned int frame)
 {
 	if (frame < savestates.size() && savestates[frame].size())
 	{
+		dropPendingSavestate(frame);
 	    savestates[frame].swap(std::vector<uint8>());
 		return true;
 	} else
@@ -235,6 +272,7 @@ void GREENZONE::save(EMUFILE *os, int save_type)
 	if (save_type != GREENZONE_SAVING_MODE_NO)
 	{
 		collectCurrentState();		// in case the project is being saved before the greenzone.update() was called within current frame
+		collectCompressedSavestates(true);
 		runGreenzoneCleaning();
 		if (greenzoneSize > (int)savestates.size())
 			greenzoneSize = savestates.size();
@@ -336,6 +374,7 @@ void GREENZONE::save(EMUFILE *os, int save_type)
 			{
 				// write ONE savestate for currFrameCounter
 				collectCurrentState();
+				collectCompressedSavestates(true);
 				int size = savestates[currFrameCounter].size();
 				write32le(size, os);
 				os->fwrite(&savestates[currFrameCounter][0], size);
@@ -642,6 +681,7 @@ int GREENZONE::getSize()
 // this should only be used by Bookmark Set procedure
 std::vector<uint8>& GREENZONE::getSavestateOfFrame(int frame)
 {
+	collectCompressedSavestates(true);
 	return savestates[frame];
 }
 // this function should only be used by Bookmark Deploy procedure
@@ -649,6 +689,7 @@ void GREENZONE::writeSavestateForFrame(int frame, std::vector<uint8>& savestate)
 {
 	if ((int)savestates.size() <= frame)
 		savestates.resize(frame + 1);
+	dropPendingSavestate(frame);
 	savestates[frame] = savestate;
 	if (greenzoneSize <= frame)
 		greenzoneSize = frame + 1;
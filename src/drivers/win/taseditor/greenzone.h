@@ -1,5 +1,7 @@
 // Specification file for Greenzone class
 
+#include <future>
+
 #include "laglog.h"
 
 #define GREENZONE_ID_LEN 10
@@ -46,6 +48,8 @@ public:
 
 private:
 	void collectCurrentState();
+	void collectCompressedSavestates(bool wait = false);
+	void dropPendingSavestate(int frame);
 	bool clearSavestateOfFrame(unsigned int frame);
 	bool clearSavestateAndFreeMemory(unsigned int frame);
 
@@ -57,6 +61,12 @@ private:
 	std::vector<std::vector<uint8>> savestates;
 
 	// not saved data
+	struct PendingSavestate
+	{
+		int frame;
+		std::future<std::vector<uint8>> compressed;
+	};
+	std::vector<PendingSavestate> pendingSavestates;		// savestates being compressed by worker threads
 	int nextCleaningTime;
 	
 };
@@ -78,6 +78,8 @@ extern void RefreshThrottleFPS();
 #else
 #ifdef __QT_DRIVER__
 #include "drivers/Qt/sdl.h"
+#elif defined(__HEADLESS_DRIVER__)
+#include "drivers/headless/headless.h"
 #else
 #include "drivers/sdl/sdl.h"
 #endif
@@ -100,24 +102,24 @@ using namespace std;
 // overclock the console by adding dummy scanlines to PPU loop or to vblank
 // disables DMC DMA, WaveHi filling and image rendering for these dummies
 // doesn't work with new PPU
-bool overclock_enabled = 0;
-bool overclocking = 0;
-bool skip_7bit_overclocking = 1; // 7-bit samples have priority over overclocking
-int normalscanlines;
-int totalscanlines;
-int postrenderscanlines = 0;
-int vblankscanlines = 0;
+FCEU_THREAD_LOCAL bool overclock_enabled = 0;
+FCEU_THREAD_LOCAL bool overclocking = 0;
+FCEU_THREAD_LOCAL bool skip_7bit_overclocking = 1; // 7-bit samples have priority over overclocking
+FCEU_THREAD_LOCAL int normalscanlines;
+FCEU_THREAD_LOCAL int totalscanlines;
+FCEU_THREAD_LOCAL int postrenderscanlines = 0;
+FCEU_THREAD_LOCAL int vblankscanlines = 0;
 //------------
 
-int AFon = 1, AFoff = 1, AutoFireOffset = 0; //For keeping track of autofire settings
-bool justLagged = false;
-bool frameAdvanceLagSkip = false; //If this is true, frame advance will skip over lag frame (i.e. it will emulate 2 frames instead of 1)
-bool AutoSS = false;        //Flagged true when the first auto-savestate is made while a game is loaded, flagged false on game close
-bool movieSubtitles = true; //Toggle for displaying movie subtitles
-bool DebuggerWasUpdated = false; //To prevent the debugger from updating things without being updated.
-bool AutoResumePlay = false;
-char romNameWhenClosingEmulator[2048] = {0};
-static unsigned int pauseTimer = 0;
+FCEU_THREAD_LOCAL int AFon = 1, AFoff = 1, AutoFireOffset = 0; //For keeping track of autofire settings
+FCEU_THREAD_LOCAL bool justLagged = false;
+FCEU_THREAD_LOCAL bool frameAdvanceLagSkip = false; //If this is true, frame advance will skip over lag frame (i.e. it will emulate 2 frames instead of 1)
+FCEU_THREAD_LOCAL bool AutoSS = false;        //Flagged true when the first auto-savestate is made while a game is loaded, flagged false on game close
+FCEU_THREAD_LOCAL bool movieSubtitles = true; //Toggle for displaying movie subtitles
+FCEU_THREAD_LOCAL bool DebuggerWasUpdated = false; //To prevent the debugger from updating things without being updated.
+FCEU_THREAD_LOCAL bool AutoResumePlay = false;
+FCEU_THREAD_LOCAL char romNameWhenClosingEmulator[2048] = {0};
+static FCEU_THREAD_LOCAL unsigned int pauseTimer = 0;
 
 
 FCEUGI::FCEUGI()
@@ -221,7 +223,7 @@ static void FCEU_CloseGame(void)
 		ResetExState(0, 0);
 
 		//clear screen when game is closed
-		extern uint8 *XBuf;
+		extern FCEU_THREAD_LOCAL uint8 *XBuf;
 		if (XBuf)
 			memset(XBuf, 0, 256 * 256);
 
@@ -244,38 +246,40 @@ static void FCEU_CloseGame(void)
 }
 
 
-uint64 timestampbase;
+FCEU_THREAD_LOCAL uint64 timestampbase;
 
 
-FCEUGI *GameInfo = nullptr;
+FCEU_THREAD_LOCAL FCEUGI *GameInfo = nullptr;
 
-void (*GameInterface)(GI h);
-void (*GameStateRestore)(int version);
+FCEU_THREAD_LOCAL void (*GameInterface)(GI h);
+FCEU_THREAD_LOCAL void (*GameStateRestore)(int version);
 
-readfunc ARead[0x10000];
-writefunc BWrite[0x10000];
-static readfunc *AReadG;
-static writefunc *BWriteG;
-static int RWWrap = 0;
+FCEU_THREAD_LOCAL readfunc ARead[0x10000];
+FCEU_THREAD_LOCAL writefunc BWrite[0x10000];
+FCEU_THREAD_LOCAL uint8 *AReadPage[0x100];
+FCEU_THREAD_LOCAL uint8 *BWritePage[0x100];
+static FCEU_THREAD_LOCAL readfunc *AReadG;
+static FCEU_THREAD_LOCAL writefunc *BWriteG;
+static FCEU_THREAD_LOCAL int RWWrap = 0;
 
 //mbg merge 7/18/06 docs
 //bit0 indicates whether emulation is paused
 //bit1 indicates whether emulation is in frame step mode
-int EmulationPaused = 0;
-bool frameAdvanceRequested=false;
-int frameAdvance_Delay_count = 0;
-int frameAdvance_Delay = FRAMEADVANCE_DELAY_DEFAULT;
+FCEU_THREAD_LOCAL int EmulationPaused = 0;
+FCEU_THREAD_LOCAL bool frameAdvanceRequested=false;
+FCEU_THREAD_LOCAL int frameAdvance_Delay_count = 0;
+FCEU_THREAD_LOCAL int frameAdvance_Delay = FRAMEADVANCE_DELAY_DEFAULT;
 
 //indicates that the emulation core just frame advanced (consumed the frame advance state and paused)
-bool JustFrameAdvanced = false;
+FCEU_THREAD_LOCAL bool JustFrameAdvanced = false;
 
-static int *AutosaveStatus; //is it safe to load Auto-savestate
-static int AutosaveIndex = 0; //which Auto-savestate we're on
-int AutosaveQty = 4; // Number of Autosaves to store
-int AutosaveFrequency = 256; // Number of frames between autosaves
+static FCEU_THREAD_LOCAL int *AutosaveStatus; //is it safe to load Auto-savestate
+static FCEU_THREAD_LOCAL int AutosaveIndex = 0; //which Auto-savestate we're on
+FCEU_THREAD_LOCAL int AutosaveQty = 4; // Number of Autosaves to store
+FCEU_THREAD_LOCAL int AutosaveFrequency = 256; // Number of frames between autosaves
 
 // Flag that indicates whether the Auto-save option is enabled or not
-int EnableAutosave = 0;
+FCEU_THREAD_LOCAL int EnableAutosave = 0;
 
 ///a wrapper for unzip.c
 extern "C"
@@ -293,6 +297,9 @@ static DECLFR(ANull) {
 	return(X.DB);
 }
 
+static void RefreshReadPages(int32 start, int32 end);
+static void RefreshWritePages(int32 start, int32 end);
+
 int AllocGenieRW(void) {
 	if (!(AReadG = (readfunc*)FCEU_malloc(0x8000 * sizeof(readfunc))))
 		return 0;
@@ -315,6 +322,7 @@ void FlushGenieRW(void) {
 		AReadG = nullptr;
 		BWriteG = nullptr;
 		RWWrap = 0;
+		FCEU_RefreshMemPages(0x8000, 0xFFFF);
 	}
 }
 
@@ -341,6 +349,8 @@ void SetReadHandler(int32 start, int32 end, readfunc func) {
 	else
 		for (x = end; x >= start; x--)
 			ARead[x] = func;
+
+	RefreshReadPages(start, end);
 }
 
 writefunc GetWriteHandler(int32 a) {
@@ -366,9 +376,12 @@ void SetWriteHandler(int32 start, int32 end, writefunc func) {
 	else
 		for (x = end; x >= start; x--)
 			BWrite[x] = func;
+
+	RefreshWritePages(start, end);
 }
 
-uint8 *RAM;
+FCEU_THREAD_LOCAL uint8 *RAM;
+FCEU_THREAD_LOCAL uint8 RAMDirtyPages[8];
 
 //---------
 //windows might need to allocate these differently, so we have some special code
@@ -383,14 +396,16 @@ static void FreeBuffers() {
 }
 //------
 
-uint8 PAL = 0;
+FCEU_THREAD_LOCAL uint8 PAL = 0;
 
 static DECLFW(BRAML) {
 	RAM[A] = V;
+	RAMDirtyPages[A >> 8] = 1;
 }
 
 static DECLFW(BRAMH) {
 	RAM[A & 0x7FF] = V;
+	RAMDirtyPages[(A >> 8) & 7] = 1;
 }
 
 static DECLFR(ARAML) {
@@ -401,6 +416,100 @@ static DECLFR(ARAMH) {
 	return RAM[A & 0x7FF];
 }
 
+//The CPU memory page tables.  A page whose 256 addresses all use the same
+//plain memory handler gets a direct pointer, biased so that AReadPage[A >> 8][A]
+//is the byte at A; every other page is left null and goes through ARead/BWrite.
+enum EMEMPAGE {
+	MEMPAGE_HANDLER = 0,
+	MEMPAGE_RAM,
+	MEMPAGE_CART
+};
+
+static FCEU_THREAD_LOCAL uint8 AReadPageType[0x100];
+static FCEU_THREAD_LOCAL uint8 BWritePageType[0x100];
+
+static uint8 ReadPageType(readfunc func) {
+	if (func == ARAML || func == ARAMH)
+		return MEMPAGE_RAM;
+	if (func == CartBR || func == CartBROB)
+		return MEMPAGE_CART;
+	return MEMPAGE_HANDLER;
+}
+
+static uint8 WritePageType(writefunc func) {
+	if (func == BRAML || func == BRAMH)
+		return MEMPAGE_RAM;
+	if (func == CartBW)
+		return MEMPAGE_CART;
+	return MEMPAGE_HANDLER;
+}
+
+static uint8 ClassifyReadPage(uint32 base) {
+	for (uint32 x = 1; x < 0x100; x++)
+		if (ARead[base + x] != ARead[base])
+			return MEMPAGE_HANDLER;
+	return ReadPageType(ARead[base]);
+}
+
+static uint8 ClassifyWritePage(uint32 base) {
+	for (uint32 x = 1; x < 0x100; x++)
+		if (BWrite[base + x] != BWrite[base])
+			return MEMPAGE_HANDLER;
+	return WritePageType(BWrite[base]);
+}
+
+void FCEU_SyncMemPages(int32 start, int32 end) {
+	for (int32 page = start >> 8; page <= (end >> 8); page++) {
+		uint32 base = page << 8;
+		uint8 *cart = Page[page >> 3];
+		uint8 *ram = RAM ? RAM + (base & 0x7FF) - base : nullptr;
+
+		switch (AReadPageType[page]) {
+		case MEMPAGE_RAM: AReadPage[page] = ram; break;
+		case MEMPAGE_CART: AReadPage[page] = cart; break;
+		default: AReadPage[page] = nullptr; break;
+		}
+
+		switch (BWritePageType[page]) {
+		case MEMPAGE_RAM: BWritePage[page] = ram; break;
+		case MEMPAGE_CART: BWritePage[page] = PRGIsRAM[page >> 3] ? cart : nullptr; break;
+		default: BWritePage[page] = nullptr; break;
+		}
+	}
+}
+
+void FCEU_RefreshMemPages(int32 start, int32 end) {
+	for (int32 page = start >> 8; page <= (end >> 8); page++) {
+		AReadPageType[page] = ClassifyReadPage(page << 8);
+		BWritePageType[page] = ClassifyWritePage(page << 8);
+	}
+	FCEU_SyncMemPages(start, end);
+}
+
+//SetReadHandler/SetWriteHandler put one handler on the whole range, so only
+//the partly covered pages at either end need scanning.
+static bool CoversPage(int32 start, int32 end, int32 page) {
+	return start <= (page << 8) && end >= ((page << 8) | 0xFF);
+}
+
+static void RefreshReadPages(int32 start, int32 end) {
+	for (int32 page = start >> 8; page <= (end >> 8); page++) {
+		if (RWWrap && page >= 0x80)
+			break;
+		AReadPageType[page] = CoversPage(start, end, page) ? ReadPageType(ARead[page << 8]) : ClassifyReadPage(page << 8);
+	}
+	FCEU_SyncMemPages(start, end);
+}
+
+static void RefreshWritePages(int32 start, int32 end) {
+	for (int32 page = start >> 8; page <= (end >> 8); page++) {
+		if (RWWrap && page >= 0x80)
+			break;
+		BWritePageType[page] = CoversPage(start, end, page) ? WritePageType(BWrite[page << 8]) : ClassifyWritePage(page << 8);
+	}
+	FCEU_SyncMemPages(start, end);
+}
+
 
 void ResetGameLoaded(void) {
 	if (GameInfo) FCEU_CloseGame();
@@ -414,6 +523,7 @@ void ResetGameLoaded(void) {
 		GameExpSound.Kill();
 	memset(&GameExpSound, 0, sizeof(GameExpSound));
 	MapIRQHook = nullptr;
+	MapIRQHookNext = nullptr;
 	MMC5Hack = 0;
 	PEC586Hack = 0;
 	QTAIHack = 0;
@@ -662,9 +772,9 @@ void FCEUI_Kill(void) {
 	FreeBuffers();
 }
 
-int rapidAlternator = 0;
+FCEU_THREAD_LOCAL int rapidAlternator = 0;
 //int AutoFirePattern[8] = { 1, 0, 0, 0, 0, 0, 0, 0 };
-int AutoFirePatternLength = 2;
+FCEU_THREAD_LOCAL int AutoFirePatternLength = 2;
 
 void SetAutoFirePattern(int onframes, int offframes) 
 {
@@ -711,7 +821,7 @@ bool GetAutoFireState(int btnIdx)
 
 void AutoFire(void) 
 {
-	static int counter = 0;
+	static FCEU_THREAD_LOCAL int counter = 0;
 	if (justLagged == false)
 	{
 		//counter = (counter + 1) % (8 * 7 * 5 * 3);
@@ -866,11 +976,11 @@ void FCEUI_Emulate(uint8 **pXBuf, int32 **SoundBuf, int32 *SoundBufSize, int ski
 	RamChange();
 	//FCEUI_AviVideoUpdate(XBuf);
 
-	extern int KillFCEUXonFrame;
+	extern FCEU_THREAD_LOCAL int KillFCEUXonFrame;
 	if (KillFCEUXonFrame && (FCEUMOV_GetFrame() >= KillFCEUXonFrame))
 		DoFCEUExit();
 #else
-		extern int KillFCEUXonFrame;
+		extern FCEU_THREAD_LOCAL int KillFCEUXonFrame;
 	if (KillFCEUXonFrame && (FCEUMOV_GetFrame() >= KillFCEUXonFrame))
 		exit(0);
 #endif
@@ -909,6 +1019,22 @@ void FCEUI_Emulate(uint8 **pXBuf, int32 **SoundBuf, int32 *SoundBufSize, int ski
 		ProcessSubtitles();
 }
 
+void FCEUI_EmulateQuiet(void) {
+	FCEU_UpdateInput();
+	lagFlag = 1;
+
+	if (geniestage != 1) FCEU_ApplyPeriodicCheats();
+	FCEUPPU_Loop(1);
+	FlushEmulateSound();
+
+	timestampbase += timestamp;
+	timestamp = 0;
+	soundtimestamp = 0;
+
+	if (lagFlag)
+		lagCounter++;
+}
+
 void FCEUI_CloseGame(void) {
 	if (!FCEU_IsValidUI(FCEUI_CLOSEGAME))
 		return;
@@ -923,17 +1049,18 @@ void ResetNES(void) {
 	FCEUSND_Reset();
 	FCEUPPU_Reset();
 	X6502_Reset();
+	FCEUSS_MarkAllDirty();
 
 	// clear back baffer
-	extern uint8 *XBackBuf;
+	extern FCEU_THREAD_LOCAL uint8 *XBackBuf;
 	memset(XBackBuf, 0, 256 * 256);
 
 	FCEU_DispMessage("Reset", 0);
 }
 
 
-int RAMInitSeed = 0;
-int RAMInitOption = 0;
+FCEU_THREAD_LOCAL int RAMInitSeed = 0;
+FCEU_THREAD_LOCAL int RAMInitOption = 0;
 
 u64 splitmix64(u32 input) {
 	u64 z = (input + 0x9e3779b97f4a7c15);
@@ -946,7 +1073,7 @@ static inline u64 xoroshiro128plus_rotl(const u64 x, int k) {
 	return (x << k) | (x >> (64 - k));
 }
 
-u64 xoroshiro128plus_s[2];
+FCEU_THREAD_LOCAL u64 xoroshiro128plus_s[2];
 void xoroshiro128plus_seed(u32 input)
 {
 //http://xoroshiro.di.unimi.it/splitmix64.c
@@ -1018,7 +1145,7 @@ void PowerNES(void) {
 	if (!GameInfo) return;
 
 	//reseed random, unless we're in a movie
-	extern int disableBatteryLoading;
+	extern FCEU_THREAD_LOCAL int disableBatteryLoading;
 	if(FCEUMOV_Mode(MOVIEMODE_INACTIVE) && !disableBatteryLoading)
 	{
 		RAMInitSeed = rand() ^ (u32)xoroshiro128plus_next();
@@ -1051,12 +1178,16 @@ void PowerNES(void) {
 	GameInterface(GI_POWER);
 	if (GameInfo->type == GIT_VSUNI)
 		FCEU_VSUniPower();
+	//the mapper may have filled CHR RAM or moved it
+	FCEUPPU_InvalidateCHRCache();
 
 	//if we are in a movie, then reset the saveram
-	extern int disableBatteryLoading;
+	extern FCEU_THREAD_LOCAL int disableBatteryLoading;
 	if (disableBatteryLoading)
 		GameInterface(GI_RESETSAVE);
 
+	FCEUSS_MarkAllDirty();
+
 	timestampbase = 0;
 	X6502_Power();
 #ifdef __WIN_DRIVER__
@@ -1065,7 +1196,7 @@ void PowerNES(void) {
 	FCEU_PowerCheats();
 	LagCounterReset();
 	// clear back buffer
-	extern uint8 *XBackBuf;
+	extern FCEU_THREAD_LOCAL uint8 *XBackBuf;
 	memset(XBackBuf, 0, 256 * 256);
 
 #ifdef __WIN_DRIVER__
@@ -1100,7 +1231,7 @@ void FCEU_ResetVidSys(void) {
 	SetSoundVariables();
 }
 
-FCEUS FSettings;
+FCEU_THREAD_LOCAL FCEUS FSettings;
 
 void FCEU_printf( __FCEU_PRINTF_FORMAT const char *format, ...)
 {
@@ -1334,7 +1465,7 @@ void FCEUI_SetNetPlayPause(bool value)
 	}
 }
 
-static int AutosaveCounter = 0;
+static FCEU_THREAD_LOCAL int AutosaveCounter = 0;
 
 void UpdateAutosave(void) {
 	if (!EnableAutosave || turbo)
@@ -1446,6 +1577,7 @@ bool FCEU_IsValidUI(EFCEUI ui) {
 //---------------------
 //experimental new mapper and ppu system follows
 
+//the cart state lives in the object, so each instance gets its own through the thread local cart pointer below
 class FCEUXCart {
 public:
 int mirroring;
@@ -1470,7 +1602,7 @@ protected:
 //void SetReadHandler(int32 start, int32 end, readfunc func) {
 };
 
-FCEUXCart* cart = 0;
+FCEU_THREAD_LOCAL FCEUXCart* cart = 0;
 
 //uint8 Read_ByteFromRom(uint32 A) {
 //	if(A>=cart->prgSize) return 0xFF;
@@ -1564,7 +1696,7 @@ bool FCEUXLoad(const char *name, FCEUFILE *fp) {
 }
 
 uint8 FCEU_ReadRomByte(uint32 i) {
-	extern iNES_HEADER head;
+	extern FCEU_THREAD_LOCAL iNES_HEADER head;
 	if (i < 16)
 		return *((unsigned char*)&head + i);
 	if (i < 16 + PRGsize[0])
@@ -3,22 +3,23 @@
 
 #include "types.h"
 
-extern int fceuindbg;
-extern int newppu;
+extern FCEU_THREAD_LOCAL int fceuindbg;
+extern FCEU_THREAD_LOCAL int newppu;
+extern FCEU_THREAD_LOCAL int newppu_catchup;
 void ResetGameLoaded(void);
 
 //overclocking-related
-extern bool overclock_enabled;
-extern bool overclocking;
-extern bool skip_7bit_overclocking;
-extern int normalscanlines;
-extern int totalscanlines;
-extern int postrenderscanlines;
-extern int vblankscanlines;
-
-extern bool AutoResumePlay;
-extern bool frameAdvanceLagSkip;
-extern char romNameWhenClosingEmulator[];
+extern FCEU_THREAD_LOCAL bool overclock_enabled;
+extern FCEU_THREAD_LOCAL bool overclocking;
+extern FCEU_THREAD_LOCAL bool skip_7bit_overclocking;
+extern FCEU_THREAD_LOCAL int normalscanlines;
+extern FCEU_THREAD_LOCAL int totalscanlines;
+extern FCEU_THREAD_LOCAL int postrenderscanlines;
+extern FCEU_THREAD_LOCAL int vblankscanlines;
+
+extern FCEU_THREAD_LOCAL bool AutoResumePlay;
+extern FCEU_THREAD_LOCAL bool frameAdvanceLagSkip;
+extern FCEU_THREAD_LOCAL char romNameWhenClosingEmulator[];
 
 #define DECLFR(x) uint8 x (uint32 A)
 #define DECLFW(x) void x (uint32 A, uint8 V)
@@ -48,38 +49,43 @@ void FCEUI_RewindToLastAutosave(void);
 //mbg 7/23/06
 const char *FCEUI_GetAboutString(void);
 
-extern uint64 timestampbase;
+extern FCEU_THREAD_LOCAL uint64 timestampbase;
 
 // MMC5 external shared buffers/vars
-extern int MMC5Hack;
-extern uint32 MMC5HackVROMMask;
-extern uint8 *MMC5HackExNTARAMPtr;
-extern uint8 *MMC5HackVROMPTR;
-extern uint8 MMC5HackCHRMode;
-extern uint8 MMC5HackSPMode;
-extern uint8 MMC50x5130;
-extern uint8 MMC5HackSPScroll;
-extern uint8 MMC5HackSPPage;
-
-extern int PEC586Hack;
+extern FCEU_THREAD_LOCAL int MMC5Hack;
+extern FCEU_THREAD_LOCAL uint32 MMC5HackVROMMask;
+extern FCEU_THREAD_LOCAL uint8 *MMC5HackExNTARAMPtr;
+extern FCEU_THREAD_LOCAL uint8 *MMC5HackVROMPTR;
+extern FCEU_THREAD_LOCAL uint8 MMC5HackCHRMode;
+extern FCEU_THREAD_LOCAL uint8 MMC5HackSPMode;
+extern FCEU_THREAD_LOCAL uint8 MMC50x5130;
+extern FCEU_THREAD_LOCAL uint8 MMC5HackSPScroll;
+extern FCEU_THREAD_LOCAL uint8 MMC5HackSPPage;
+
+extern FCEU_THREAD_LOCAL int PEC586Hack;
 
 // VRCV extarnal shared buffers/vars
-extern int QTAIHack;
-extern uint8 QTAINTRAM[2048];
-extern uint8 qtaintramreg;
+extern FCEU_THREAD_LOCAL int QTAIHack;
+extern FCEU_THREAD_LOCAL uint8 QTAINTRAM[2048];
+extern FCEU_THREAD_LOCAL uint8 qtaintramreg;
 
 #define GAME_MEM_BLOCK_SIZE 131072
 
-extern  uint8  *RAM;            //shared memory modifications
-extern int EmulationPaused;
-extern int frameAdvance_Delay;
-extern int RAMInitOption;
+extern  FCEU_THREAD_LOCAL uint8  *RAM;            //shared memory modifications
+extern FCEU_THREAD_LOCAL uint8 RAMDirtyPages[8];   //256 byte pages of RAM written since the last incremental savestate
+extern FCEU_THREAD_LOCAL int EmulationPaused;
+extern FCEU_THREAD_LOCAL int frameAdvance_Delay;
+extern FCEU_THREAD_LOCAL int RAMInitOption;
 
 uint8 FCEU_ReadRomByte(uint32 i);
 void FCEU_WriteRomByte(uint32 i, uint8 value);
 
-extern readfunc ARead[0x10000];
-extern writefunc BWrite[0x10000];
+extern FCEU_THREAD_LOCAL readfunc ARead[0x10000];
+extern FCEU_THREAD_LOCAL writefunc BWrite[0x10000];
+extern FCEU_THREAD_LOCAL uint8 *AReadPage[0x100];
+extern FCEU_THREAD_LOCAL uint8 *BWritePage[0x100];
+void FCEU_RefreshMemPages(int32 start, int32 end);
+void FCEU_SyncMemPages(int32 start, int32 end);
 
 enum GI {
 	GI_RESETM2	=1,
@@ -88,17 +94,17 @@ enum GI {
 	GI_RESETSAVE = 4
 };
 
-extern void (*GameInterface)(GI h);
-extern void (*GameStateRestore)(int version);
+extern FCEU_THREAD_LOCAL void (*GameInterface)(GI h);
+extern FCEU_THREAD_LOCAL void (*GameStateRestore)(int version);
 
 
 #include "git.h"
-extern FCEUGI *GameInfo;
+extern FCEU_THREAD_LOCAL FCEUGI *GameInfo;
 extern int GameAttributes;
 
-extern uint8 PAL;
-extern int dendy;
-extern bool movieSubtitles;
+extern FCEU_THREAD_LOCAL uint8 PAL;
+extern FCEU_THREAD_LOCAL int dendy;
+extern FCEU_THREAD_LOCAL bool movieSubtitles;
 
 //#include "driver.h"
 
@@ -130,12 +136,15 @@ typedef struct fceu_settings_struct {
 	uint32 SndRate;
 	int soundq;
 	int lowpass;
+
+	//High quality sound from band-limited steps instead of WaveHi.
+	int stepsynth;
 } FCEUS;
 
 int FCEU_TextScanlineOffset(int y);
 int FCEU_TextScanlineOffsetFromBottom(int y);
 
-extern FCEUS FSettings;
+extern FCEU_THREAD_LOCAL FCEUS FSettings;
 
 bool CheckFileExists(const char* filename);	//Receives a filename (fullpath) and checks to see if that file exists
 
@@ -158,8 +167,8 @@ extern void PushCurrentVideoSettings();
 #endif
 
 extern uint8 Exit;
-extern int default_palette_selection;
-extern uint8 vsdip;
+extern FCEU_THREAD_LOCAL int default_palette_selection;
+extern FCEU_THREAD_LOCAL uint8 vsdip;
 
 //#define FCEUDEF_DEBUGGER //mbg merge 7/17/06 - cleaning out conditional compiles
 
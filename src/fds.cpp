@@ -42,9 +42,9 @@
 //	and the when it can be successfully read/written to.  This should
 //	prevent writes to wrong places OR add code to prevent disk ejects
 //	when the virtual motor is on (mmm...virtual motor).
-extern int disableBatteryLoading;
+extern FCEU_THREAD_LOCAL int disableBatteryLoading;
 
-bool isFDS = false; //flag for determining if a FDS game is loaded, movie.cpp needs this
+FCEU_THREAD_LOCAL bool isFDS = false; //flag for determining if a FDS game is loaded, movie.cpp needs this
 
 static DECLFR(FDSRead4030);
 static DECLFR(FDSRead4031);
@@ -64,38 +64,38 @@ static void FDSClose(void);
 
 static void FDSFix(int a);
 
-static uint8 FDSRegs[6];
-static int32 IRQLatch, IRQCount;
-static uint8 IRQa;
+static FCEU_THREAD_LOCAL uint8 FDSRegs[6];
+static FCEU_THREAD_LOCAL int32 IRQLatch, IRQCount;
+static FCEU_THREAD_LOCAL uint8 IRQa;
 
-static uint8 *FDSRAM = NULL;
-static uint32 FDSRAMSize;
-static uint8 *FDSBIOS = NULL;
-static uint32 FDSBIOSsize;
-static uint8 *CHRRAM = NULL;
-static uint32 CHRRAMSize;
+static FCEU_THREAD_LOCAL uint8 *FDSRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 FDSRAMSize;
+static FCEU_THREAD_LOCAL uint8 *FDSBIOS = NULL;
+static FCEU_THREAD_LOCAL uint32 FDSBIOSsize;
+static FCEU_THREAD_LOCAL uint8 *CHRRAM = NULL;
+static FCEU_THREAD_LOCAL uint32 CHRRAMSize;
 
 /* Original disk data backup, to help in creating save states. */
-static uint8 *diskdatao[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+static FCEU_THREAD_LOCAL uint8 *diskdatao[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
 
-static uint8 *diskdata[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+static FCEU_THREAD_LOCAL uint8 *diskdata[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
 
-static int TotalSides; //mbg merge 7/17/06 - unsignedectomy
-static uint8 DiskWritten = 0;    /* Set to 1 if disk was written to. */
-static uint8 writeskip;
-static int32 DiskPtr;
-static int32 DiskSeekIRQ;
-static uint8 SelectDisk, InDisk;
+static FCEU_THREAD_LOCAL int TotalSides; //mbg merge 7/17/06 - unsignedectomy
+static FCEU_THREAD_LOCAL uint8 DiskWritten = 0;    /* Set to 1 if disk was written to. */
+static FCEU_THREAD_LOCAL uint8 writeskip;
+static FCEU_THREAD_LOCAL int32 DiskPtr;
+static FCEU_THREAD_LOCAL int32 DiskSeekIRQ;
+static FCEU_THREAD_LOCAL uint8 SelectDisk, InDisk;
 
 /* 4024(w), 4025(w), 4031(r) by dink(fbneo) */
 enum FDS_DiskBlockIDs { DSK_INIT = 0, DSK_VOLUME, DSK_FILECNT, DSK_FILEHDR, DSK_FILEDATA };
-static uint8  mapperFDS_control;    // 4025(w) control register
-static uint16 mapperFDS_filesize;	// size of file being read/written
-static uint8  mapperFDS_block;		// block-id of current block
-static uint16 mapperFDS_blockstart;	// start-address of current block
-static uint16 mapperFDS_blocklen;	// length of current block
-static uint16 mapperFDS_diskaddr;   // current address relative to blockstart
-static uint8  mapperFDS_diskaccess;	// disk needs to be accessed at least once before writing
+static FCEU_THREAD_LOCAL uint8  mapperFDS_control;    // 4025(w) control register
+static FCEU_THREAD_LOCAL uint16 mapperFDS_filesize;	// size of file being read/written
+static FCEU_THREAD_LOCAL uint8  mapperFDS_block;		// block-id of current block
+static FCEU_THREAD_LOCAL uint16 mapperFDS_blockstart;	// start-address of current block
+static FCEU_THREAD_LOCAL uint16 mapperFDS_blocklen;	// length of current block
+static FCEU_THREAD_LOCAL uint16 mapperFDS_diskaddr;   // current address relative to blockstart
+static FCEU_THREAD_LOCAL uint8  mapperFDS_diskaccess;	// disk needs to be accessed at least once before writing
 #define fds_disk() (diskdata[InDisk][mapperFDS_blockstart + mapperFDS_diskaddr])
 #define mapperFDS_diskinsert (InDisk != 255)
 
@@ -133,6 +133,7 @@ void FDSSoundReset(void);
 void FDSSoundStateAdd(void);
 static void RenderSound(void);
 static void RenderSoundHQ(void);
+static void RenderSoundStep(void);
 
 static void FDSInit(void) {
 	memset(FDSRegs, 0, sizeof(FDSRegs));
@@ -272,7 +273,7 @@ static DECLFR(FDSRead4030) {
 }
 
 static DECLFR(FDSRead4031) {
-	static uint8 ret = 0;
+	static FCEU_THREAD_LOCAL uint8 ret = 0;
 
 	ret = 0xff;
 	if (mapperFDS_diskinsert && mapperFDS_control & 0x04) {
@@ -350,7 +351,7 @@ typedef struct {
 	uint8 SPSG[0xB];
 } FDSSOUND;
 
-static FDSSOUND fdso;
+static FCEU_THREAD_LOCAL FDSSOUND fdso;
 
 #define  SPSG  fdso.SPSG
 #define b19shiftreg60  fdso.b19shiftreg60
@@ -387,7 +388,9 @@ static DECLFR(FDSSRead) {
 
 static DECLFW(FDSSWrite) {
 	if (FSettings.SndRate) {
-		if (FSettings.soundq >= 1)
+		if (FSettings.soundq >= 1 && FSettings.stepsynth)
+			RenderSoundStep();
+		else if (FSettings.soundq >= 1)
 			RenderSoundHQ();
 		else
 			RenderSound();
@@ -426,7 +429,7 @@ static void DoEnv() {
 
 	for (x = 0; x < 2; x++)
 		if (!(SPSG[x << 2] & 0x80) && !(SPSG[0x3] & 0x40)) {
-			static int counto[2] = { 0, 0 };
+			static FCEU_THREAD_LOCAL int counto[2] = { 0, 0 };
 
 			if (counto[x] <= 0) {
 				if (!(SPSG[x << 2] & 0x80)) {
@@ -453,7 +456,7 @@ static DECLFW(FDSWaveWrite) {
 		fdso.cwave[A & 0x3f] = V & 0x3F;
 }
 
-static int ta;
+static FCEU_THREAD_LOCAL int ta;
 static INLINE void ClockRise(void) {
 	if (!clockcount) {
 		ta++;
@@ -515,7 +518,8 @@ static INLINE int32 FDSDoSound(void) {
 	}
 }
 
-static int32 FBC = 0;
+static FCEU_THREAD_LOCAL int32 FBC = 0;
+static FCEU_THREAD_LOCAL int32 FStepOut = 0;
 
 static void RenderSound(void) {
 	int32 end, start;
@@ -548,6 +552,28 @@ static void RenderSoundHQ(void) {
 	FBC = SOUNDTS;
 }
 
+// Step synthesis.  The wave unit still has to be run every cycle, but only
+// the cycles where its output changes are reported.
+static void RenderSoundStep(void) {
+	uint32 x;
+	int32 t;
+
+	if (!(SPSG[0x9] & 0x80))
+		for (x = FBC; x < SOUNDTS; x++) {
+			t = FDSDoSound();
+			t += t >> 1;
+			if (t != FStepOut) {
+				StepSynthAdd(x, t - FStepOut);
+				FStepOut = t;
+			}
+		}
+	else if (FStepOut) {
+		StepSynthAdd(FBC, -FStepOut);
+		FStepOut = 0;
+	}
+	FBC = SOUNDTS;
+}
+
 static void HQSync(int32 ts) {
 	FBC = ts;
 }
@@ -561,6 +587,7 @@ static void FDS_ESI(void) {
 	if (FSettings.SndRate) {
 		if (FSettings.soundq >= 1) {
 			fdso.cycles = (int64)1 << 39;
+			FStepOut = 0;
 		} else {
 			fdso.cycles = ((int64)1 << 40) * FDSClock;
 			fdso.cycles /= FSettings.SndRate * 16;
@@ -577,6 +604,7 @@ void FDSSoundReset(void) {
 	FDS_ESI();
 	GameExpSound.HiSync = HQSync;
 	GameExpSound.HiFill = RenderSoundHQ;
+	GameExpSound.StepFill = RenderSoundStep;
 	GameExpSound.Fill = FDSSound;
 	GameExpSound.RChange = FDS_ESI;
 }
@@ -1,4 +1,4 @@
-extern bool isFDS;
+extern FCEU_THREAD_LOCAL bool isFDS;
 void FDSSoundReset(void);
 
 void FCEU_FDSInsert(void);
@@ -55,11 +55,11 @@
 
 using namespace std;
 
-bool bindSavestate = true;	//Toggle that determines if a savestate filename will include the movie filename
-static std::string BaseDirectory;
-static char FileExt[2048];	//Includes the . character, as in ".nes"
-char FileBase[2048];
-static char FileBaseDirectory[2048];
+FCEU_THREAD_LOCAL bool bindSavestate = true;	//Toggle that determines if a savestate filename will include the movie filename
+static FCEU_THREAD_LOCAL_OBJECT std::string BaseDirectory;
+static FCEU_THREAD_LOCAL char FileExt[2048];	//Includes the . character, as in ".nes"
+FCEU_THREAD_LOCAL char FileBase[2048];
+static FCEU_THREAD_LOCAL char FileBaseDirectory[2048];
 
 
 void ApplyIPS(FILE *ips, FCEUFILE* fp)
@@ -469,7 +469,7 @@ const char *FCEUI_GetBaseDirectory(void)
 	return BaseDirectory.c_str();
 }
 
-static char *odirs[FCEUIOD__COUNT]={0,0,0,0,0,0,0,0,0,0,0,0,0};     // odirs, odors. ^_^
+static FCEU_THREAD_LOCAL char *odirs[FCEUIOD__COUNT]={0,0,0,0,0,0,0,0,0,0,0,0,0};     // odirs, odors. ^_^
 
 void FCEUI_SetDirOverride(int which, char *n)
 {
@@ -9,7 +9,7 @@
 #include <string>
 #include <iostream>
 
-extern bool bindSavestate;
+extern FCEU_THREAD_LOCAL bool bindSavestate;
 
 struct FCEUFILE {
 	//the stream you can use to access the data
@@ -8,16 +8,215 @@
 #include "fceu.h"
 #include "filter.h"
 
-#include "fcoeffs.h"
-
 #include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+//The resampler's inner products use AVX2+FMA or SSE on x86 (picked at run
+//time) and NEON on 64 bit ARM, which always has it.  GCC and clang only
+//compile the intrinsics in functions marked for the instruction set;
+//MSVC takes them anywhere.
+#if (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))) || defined(_M_IX86) || defined(_M_X64)
+#define FILTER_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define FILTER_TARGET(x) __attribute__((target(x)))
+#else
+#define FILTER_TARGET(x)
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FILTER_NEON
+#include <arm_neon.h>
+#endif
+
+//High quality sound is resampled from the CPU clock to the output rate with
+//a Kaiser windowed sinc that MakeFilters() designs for the rate in use.  Each
+//output sample falls between two input samples; NeoFilterSound() takes the
+//filter at both and blends them, which is the same as running a polyphase
+//filter whose phases are interpolated from this one set of taps.  At the
+//CPU clock that is as good as a table of phases, and the taps stay in L1.
+//Longest filter the WaveHi history can hold next to a frame of samples.
+#define FILTER_MAXTAPS 3072
+
+static FCEU_THREAD_LOCAL_OBJECT std::vector<float> filterTaps;
+static FCEU_THREAD_LOCAL_OBJECT std::vector<float> filterIn;
+static FCEU_THREAD_LOCAL uint32 filterLen;
+
+static FCEU_THREAD_LOCAL uint32 mrindex;
+static FCEU_THREAD_LOCAL uint32 mrratio;
+
+//Sets *d0 to the inner product of the n taps at c with the samples at S, and
+//*d1 to the same one sample later.  n is a multiple of 8.
+typedef void (*DotPairFunc)(const float *S, const float *c, uint32 n, float *d0, float *d1);
+
+static void DotPair_C(const float *S, const float *c, uint32 n, float *d0, float *d1)
+{
+	float acc[4]={0,0,0,0},acc2[4]={0,0,0,0};
+
+	for(uint32 x=0;x<n;x+=4)
+		for(int k=0;k<4;k++)
+		{
+			acc[k]+=S[x+k]*c[x+k];
+			acc2[k]+=S[x+k+1]*c[x+k];
+		}
+	*d0=(acc[0]+acc[1])+(acc[2]+acc[3]);
+	*d1=(acc2[0]+acc2[1])+(acc2[2]+acc2[3]);
+}
+
+#ifdef FILTER_X86
+static FILTER_TARGET("sse") void DotPair_SSE(const float *S, const float *c, uint32 n, float *d0, float *d1)
+{
+	__m128 acc=_mm_setzero_ps(),acc2=_mm_setzero_ps();
+	__m128 accb=_mm_setzero_ps(),acc2b=_mm_setzero_ps();
+	float t[4];
+
+	for(uint32 x=0;x<n;x+=8)
+	{
+		__m128 k=_mm_loadu_ps(c+x),kb=_mm_loadu_ps(c+x+4);
+		acc=_mm_add_ps(acc,_mm_mul_ps(_mm_loadu_ps(S+x),k));
+		accb=_mm_add_ps(accb,_mm_mul_ps(_mm_loadu_ps(S+x+4),kb));
+		acc2=_mm_add_ps(acc2,_mm_mul_ps(_mm_loadu_ps(S+x+1),k));
+		acc2b=_mm_add_ps(acc2b,_mm_mul_ps(_mm_loadu_ps(S+x+5),kb));
+	}
+	_mm_storeu_ps(t,_mm_add_ps(acc,accb));
+	*d0=(t[0]+t[1])+(t[2]+t[3]);
+	_mm_storeu_ps(t,_mm_add_ps(acc2,acc2b));
+	*d1=(t[0]+t[1])+(t[2]+t[3]);
+}
+
+static FILTER_TARGET("avx2,fma") void DotPair_AVX2(const float *S, const float *c, uint32 n, float *d0, float *d1)
+{
+	__m256 acc[4],acc2[4];
+	uint32 x=0;
+	int k;
+
+	//four independent sums per product so the FMA latency is covered
+	for(k=0;k<4;k++)
+		acc[k]=acc2[k]=_mm256_setzero_ps();
+	for(;x+32<=n;x+=32)
+		for(k=0;k<4;k++)
+		{
+			__m256 t=_mm256_loadu_ps(c+x+k*8);
+			acc[k]=_mm256_fmadd_ps(_mm256_loadu_ps(S+x+k*8),t,acc[k]);
+			acc2[k]=_mm256_fmadd_ps(_mm256_loadu_ps(S+x+k*8+1),t,acc2[k]);
+		}
+	for(k=0;x<n;x+=8,k++)
+	{
+		__m256 t=_mm256_loadu_ps(c+x);
+		acc[k]=_mm256_fmadd_ps(_mm256_loadu_ps(S+x),t,acc[k]);
+		acc2[k]=_mm256_fmadd_ps(_mm256_loadu_ps(S+x+1),t,acc2[k]);
+	}
+	acc[0]=_mm256_add_ps(_mm256_add_ps(acc[0],acc[1]),_mm256_add_ps(acc[2],acc[3]));
+	acc2[0]=_mm256_add_ps(_mm256_add_ps(acc2[0],acc2[1]),_mm256_add_ps(acc2[2],acc2[3]));
+	{
+		__m128 a=_mm_add_ps(_mm256_castps256_ps128(acc[0]),_mm256_extractf128_ps(acc[0],1));
+		__m128 b=_mm_add_ps(_mm256_castps256_ps128(acc2[0]),_mm256_extractf128_ps(acc2[0],1));
+		//a0+a1, a2+a3, b0+b1, b2+b3
+		__m128 h=_mm_add_ps(_mm_shuffle_ps(a,b,_MM_SHUFFLE(2,0,2,0)),_mm_shuffle_ps(a,b,_MM_SHUFFLE(3,1,3,1)));
+		float t[4];
+		_mm_storeu_ps(t,h);
+		*d0=t[0]+t[1];
+		*d1=t[2]+t[3];
+	}
+}
+#endif
+
+#ifdef FILTER_NEON
+static void DotPair_NEON(const float *S, const float *c, uint32 n, float *d0, float *d1)
+{
+	float32x4_t acc=vdupq_n_f32(0),acc2=vdupq_n_f32(0);
+	float32x4_t accb=vdupq_n_f32(0),acc2b=vdupq_n_f32(0);
+
+	for(uint32 x=0;x<n;x+=8)
+	{
+		float32x4_t k=vld1q_f32(c+x),kb=vld1q_f32(c+x+4);
+		acc=vfmaq_f32(acc,vld1q_f32(S+x),k);
+		accb=vfmaq_f32(accb,vld1q_f32(S+x+4),kb);
+		acc2=vfmaq_f32(acc2,vld1q_f32(S+x+1),k);
+		acc2b=vfmaq_f32(acc2b,vld1q_f32(S+x+5),kb);
+	}
+	*d0=vaddvq_f32(vaddq_f32(acc,accb));
+	*d1=vaddvq_f32(vaddq_f32(acc2,acc2b));
+}
+#endif
+
+#if defined(FILTER_X86) && !defined(__GNUC__)
+//MSVC has no __builtin_cpu_supports, so read CPUID.  AVX2 also needs the
+//OS to save the YMM registers, which XCR0 bits 1 and 2 say it does.
+static bool CPUHasAVX2FMA(void)
+{
+	int info[4];
+
+	__cpuid(info,0);
+	if(info[0]<7)
+		return false;
+	__cpuid(info,1);
+	//FMA, OSXSAVE, AVX
+	if((info[2]&((1<<12)|(1<<27)|(1<<28)))!=((1<<12)|(1<<27)|(1<<28)))
+		return false;
+	if((_xgetbv(0)&6)!=6)
+		return false;
+	__cpuidex(info,7,0);
+	return (info[1]&(1<<5))!=0;
+}
+
+static bool CPUHasSSE(void)
+{
+	int info[4];
+
+	__cpuid(info,1);
+	return (info[3]&(1<<25))!=0;
+}
+#endif
+
+static DotPairFunc PickDotPair(void)
+{
+#if defined(FILTER_X86) && defined(__GNUC__)
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return DotPair_AVX2;
+	if(__builtin_cpu_supports("sse"))
+		return DotPair_SSE;
+	return DotPair_C;
+#elif defined(FILTER_X86)
+	if(CPUHasAVX2FMA())
+		return DotPair_AVX2;
+	if(CPUHasSSE())
+		return DotPair_SSE;
+	return DotPair_C;
+#elif defined(FILTER_NEON)
+	return DotPair_NEON;
+#else
+	return DotPair_C;
+#endif
+}
+
+static FCEU_THREAD_LOCAL DotPairFunc DotPair=DotPair_C;
 
-static int32 sq2coeffs[SQ2NCOEFFS];
-static int32 coeffs[NCOEFFS];
+//Step synthesis (FSettings.stepsynth) skips WaveHi: the channels report each
+//change of their output through StepSynthAdd(), which adds a band-limited step
+//to stepBuf at the output rate, and StepSynthRead() sums the steps back into
+//samples.  A step is drawn from two neighbouring phases of stepKernel, blended
+//by how far between them it falls.
+#define STEP_PHASEBITS 6
+#define STEP_PHASES (1<<STEP_PHASEBITS)
+#define STEP_MAXTAPS 40
 
-static uint32 mrindex;
-static uint32 mrratio;
+static FCEU_THREAD_LOCAL_OBJECT std::vector<float> stepKernel;
+static FCEU_THREAD_LOCAL float stepBuf[2048+512+2*STEP_MAXTAPS];
+static FCEU_THREAD_LOCAL uint32 stepLen;
+static FCEU_THREAD_LOCAL uint64 stepPos;		//Output position of SOUNDTS 0, 32.32 fixed point.
+static FCEU_THREAD_LOCAL uint64 stepRatio;	//Output samples per CPU cycle, 32.32 fixed point.
+static FCEU_THREAD_LOCAL double stepAcc;
 
 void SexyFilter2(int32 *in, int32 count)
 {
@@ -32,7 +231,7 @@ void SexyFilter2(int32 *in, int32 count)
  c=p*0x100000;
  //printf("%f\n",(double)c/0x100000);
  #endif
- static int64 acc=0;
+ static FCEU_THREAD_LOCAL int64 acc=0;
 
  while(count--)
  {
@@ -50,7 +249,7 @@ void SexyFilter2(int32 *in, int32 count)
 
 void SexyFilter(int32 *in, int32 *out, int32 count)
 {
- static int64 acc1=0,acc2=0;
+ static FCEU_THREAD_LOCAL int64 acc1=0,acc2=0;
  int32 mul1,mul2,vmul;
 
  mul1=(94<<16)/FSettings.SndRate;
@@ -81,6 +280,17 @@ void SexyFilter(int32 *in, int32 *out, int32 count)
  }
 }
 
+//Expansion sound rendered at the output rate, then the output filters.
+static void FinishSound(int32 *out, int32 count)
+{
+	if(GameExpSound.NeoFill)
+	 GameExpSound.NeoFill(out,count);
+
+	SexyFilter(out,out,count);
+	if(FSettings.lowpass)
+	 SexyFilter2(out,count);
+}
+
 /* Returns number of samples written to out. */
 /* leftover is set to the number of samples that need to be copied
    from the end of in to the beginning of in.
@@ -99,111 +309,202 @@ int32 NeoFilterSound(int32 *in, int32 *out, uint32 inlen, int32 *leftover)
 	uint32 max;
 	int32 *outsave=out;
 	int32 count=0;
+	float *S;
 
-//	for(x=0;x<inlen;x++)
-//	{
-//	 if(in[x]>mva){ mva=in[x]; printf("%ld\n",in[x]);}
-//	}
         max=(inlen-1)<<16;
 
-	if(FSettings.soundq==2)
-        for(x=mrindex;x<max;x+=mrratio)
-        {
-			int32 acc=0,acc2=0;
-			unsigned int c;
-			int32 *S,*D;
-
-			for(c=SQ2NCOEFFS,S=&in[(x>>16)-SQ2NCOEFFS],D=sq2coeffs;c;c--,D++)
-			{
-				acc+=(S[c]**D)>>6;
-				acc2+=(S[1+c]**D)>>6;
-			}
-
-			acc=((int64)acc*(65536-(x&65535))+(int64)acc2*(x&65535))>>(16+11);
-			*out=acc;
-			out++;
-			count++;
-        }
-	else
-		for(x=mrindex;x<max;x+=mrratio)
-		{
-			int32 acc=0,acc2=0;
-			unsigned int c;
-			const int32 *S,*D;
-
-			for(c=NCOEFFS,S=&in[(x>>16)-NCOEFFS],D=coeffs;c;c--,D++)
-			{
-				acc+=(S[c]**D)>>6;
-				acc2+=(S[1+c]**D)>>6;
-			}
-
-			acc=((int64)acc*(65536-(x&65535))+(int64)acc2*(x&65535))>>(16+11);
-			*out=acc;
-			out++;
-			count++;
-		}
-
-	mrindex=x-max;
+	if(filterIn.size()<inlen)
+		filterIn.resize(inlen);
+	S=filterIn.data();
+	for(x=0;x<inlen;x++)
+		S[x]=(float)in[x];
 
-	if(FSettings.soundq==2)
+	for(x=mrindex;x<max;x+=mrratio)
 	{
-         mrindex+=SQ2NCOEFFS*65536;
-         *leftover=SQ2NCOEFFS+1;
+		float acc,acc2;
+
+		DotPair(&S[(x>>16)+1-filterLen],filterTaps.data(),filterLen,&acc,&acc2);
+
+		*out=(int32)(acc+(acc2-acc)*((x&65535)*(1.0f/65536)));
+		out++;
+		count++;
 	}
-	else
+
+	mrindex=x-max;
+	mrindex+=filterLen*65536;
+	*leftover=filterLen+1;
+
+	FinishSound(outsave,count);
+	return(count);
+}
+
+void StepSynthAdd(uint32 ts, int32 delta)
+{
+	uint64 pos=stepPos+ts*stepRatio;
+	uint32 frac=(uint32)pos;
+	const float *k=&stepKernel[(frac>>(32-STEP_PHASEBITS))*stepLen];
+	const float *k2=k+stepLen;
+	float *d=&stepBuf[pos>>32];
+	float b=delta*((frac&((1<<(32-STEP_PHASEBITS))-1))*(1.0f/(1<<(32-STEP_PHASEBITS))));
+	float a=delta-b;
+
+	for(uint32 x=0;x<stepLen;x+=8)
+		for(int j=0;j<8;j++)
+			d[x+j]+=a*k[x+j]+b*k2[x+j];
+}
+
+/* Returns the number of samples written to out, covering inlen CPU cycles. */
+int32 StepSynthRead(int32 *out, uint32 inlen)
+{
+	uint64 end=stepPos+inlen*stepRatio;
+	int32 count=(int32)(end>>32);
+	double acc=stepAcc;
+
+	for(int32 x=0;x<count;x++)
 	{
-         mrindex+=NCOEFFS*65536;
-         *leftover=NCOEFFS+1;
+		acc+=stepBuf[x];
+		out[x]=(int32)acc;
 	}
+	stepAcc=acc;
 
-	if(GameExpSound.NeoFill)
-	 GameExpSound.NeoFill(outsave,count);
+	//Steps near the end of the frame reach into the next one.
+	memmove(stepBuf,stepBuf+count,stepLen*sizeof(float));
+	memset(stepBuf+stepLen,0,count*sizeof(float));
+	stepPos=end-((uint64)count<<32);
 
-	SexyFilter(outsave,outsave,count);
-	if(FSettings.lowpass)
-	 SexyFilter2(outsave,count);
+	FinishSound(out,count);
 	return(count);
 }
 
+//Zeroth order modified Bessel function of the first kind, for the Kaiser window.
+static double BesselI0(double x)
+{
+ double sum=1,term=1;
+
+ for(int k=1;k<50 && term>sum*1e-12;k++)
+ {
+  term*=(x/(2*k))*(x/(2*k));
+  sum+=term;
+ }
+ return sum;
+}
+
+//Kaiser window of half width half for stopband attenuation atten, at t.
+static double KaiserWindow(double t, double half, double atten)
+{
+ const double beta=0.1102*(atten-8.7);
+
+ return BesselI0(beta*sqrt(1-(t/half)*(t/half)))/BesselI0(beta);
+}
+
+//Designs the band-limited step for step synthesis: the same Kaiser windowed
+//sinc as MakeFilters() uses, at the output rate, integrated into a step and
+//stored as one sample to the next differences.  Each phase adds up to the 8
+//the FIR filter has at DC, so steps never drift.
+static void MakeStepKernel(int32 rate, double pass, double atten)
+{
+ const double clock=PAL?PAL_CPU:NTSC_CPU;
+ const double cutoff=(0.5+pass)/2;
+ const uint32 sub=8;
+ double width,half,total;
+ uint32 x,p,n,len;
+ std::vector<double> S;
+
+ width=2*M_PI*(0.5-pass);
+ n=(uint32)ceil((atten-8)/(2.285*width))+1;
+ n=(n+7)&~7;
+ if(n>STEP_MAXTAPS)
+  n=STEP_MAXTAPS;
+ stepLen=n;
+ half=(n-1)/2.0;
+
+ //S[q] is the step at time q/STEP_PHASES from the start of the window,
+ //integrated with Simpson's rule over sub pieces per phase.
+ len=(n-1)*STEP_PHASES;
+ S.assign(len+1,0);
+ for(x=0;x<len;x++)
+ {
+  double sum=0;
+
+  for(uint32 j=0;j<=2*sub;j++)
+  {
+   double t=(double)x/STEP_PHASES+(double)j/(2*sub*STEP_PHASES)-half;
+   double h=(t==0)?2*cutoff:sin(2*M_PI*cutoff*t)/(M_PI*t);
+
+   h*=KaiserWindow(t,half,atten);
+   sum+=h*((j==0 || j==2*sub)?1:(j&1)?4:2);
+  }
+  S[x+1]=S[x]+sum/(6*sub*STEP_PHASES);
+ }
+ total=S[len];
+
+ //One more phase than STEP_PHASES so blending never runs off the end.
+ stepKernel.assign((STEP_PHASES+1)*n,0);
+ for(p=0;p<=STEP_PHASES;p++)
+  for(x=0;x<n;x++)
+  {
+   int32 hi=(x+1)*STEP_PHASES-p,lo=x*STEP_PHASES-p;
+   double v=S[std::min<int32>(std::max<int32>(hi,0),len)]-S[std::min<int32>(std::max<int32>(lo,0),len)];
+
+   stepKernel[p*n+x]=(float)(v*8/total);
+  }
+
+ stepRatio=(uint64)((double)rate/clock*4294967296.0);
+ stepPos=0;
+ stepAcc=0;
+ memset(stepBuf,0,sizeof(stepBuf));
+}
+
 void MakeFilters(int32 rate)
 {
- const int32 *tabs[8]={C44100NTSC,C44100PAL,C48000NTSC,C48000PAL,C96000NTSC,
-        C96000PAL, nullptr, nullptr};
- const int32 *sq2tabs[8]={SQ2C44100NTSC,SQ2C44100PAL,SQ2C48000NTSC,SQ2C48000PAL,
-	SQ2C96000NTSC,SQ2C96000PAL, nullptr, nullptr};
+ //Passband edge as a fraction of the output rate and stopband attenuation
+ //in dB; the stopband starts at half the output rate.
+ const double pass=(FSettings.soundq==2)?0.34:0.27;
+ const double atten=(FSettings.soundq==2)?80:66;
+ const double clock=PAL?PAL_CPU:NTSC_CPU;
+ double width,cutoff,half;
+ uint32 x,nco;
+
+ if(FSettings.stepsynth)
+ {
+  MakeStepKernel(rate,pass,atten);
+  return;
+ }
 
- const int32 *tmp;
- int32 x;
- uint32 nco;
+ DotPair=PickDotPair();
 
- if(FSettings.soundq==2)
-  nco=SQ2NCOEFFS;
- else
-  nco=NCOEFFS;
+ //Kaiser's estimate of the length needed for the transition band, rounded up
+ //to whole vectors.
+ width=2*M_PI*(0.5-pass)*rate/clock;
+ nco=(uint32)ceil((atten-8)/(2.285*width))+1;
+ nco=(nco+7)&~7;
+ if(nco>FILTER_MAXTAPS)
+  nco=FILTER_MAXTAPS;
+ filterLen=nco;
+
+ cutoff=(0.5+pass)/2*rate/clock;
+ half=(nco-1)/2.0;
 
  mrindex=(nco+1)<<16;
  mrratio=(PAL?(int64)(PAL_CPU*65536):(int64)(NTSC_CPU*65536))/rate;
 
- if(FSettings.soundq==2)
-  tmp=sq2tabs[(PAL?1:0)|(rate==48000?2:0)|(rate==96000?4:0)];
- else
-  tmp=tabs[(PAL?1:0)|(rate==48000?2:0)|(rate==96000?4:0)];
+ //The last tap lines up with the newest input sample, as in the tables this
+ //replaced.
+ filterTaps.assign(nco,0);
+ {
+  double sum=0;
 
- if(FSettings.soundq==2)
-  for(x=0;x<SQ2NCOEFFS>>1;x++)
-   sq2coeffs[x]=sq2coeffs[SQ2NCOEFFS-1-x]=tmp[x];
- else
-  for(x=0;x<NCOEFFS>>1;x++)
-   coeffs[x]=coeffs[NCOEFFS-1-x]=tmp[x];
+  for(x=0;x<nco;x++)
+  {
+   double t=x-half;
+   double h=(t==0)?2*cutoff:sin(2*M_PI*cutoff*t)/(M_PI*t);
 
- #ifdef MOO
- /* Some tests involving precision and error. */
- {
-  static int64 acc=0;
-  int x;
-  for(x=0;x<SQ2NCOEFFS;x++)
-   acc+=(int64)32767*sq2coeffs[x];
-  printf("Foo: %lld\n",acc);
+   h*=KaiserWindow(t,half,atten);
+   filterTaps[x]=(float)h;
+   sum+=h;
+  }
+  //Unity gain at DC, times the 8 the old integer tables had built in.
+  for(x=0;x<nco;x++)
+   filterTaps[x]=(float)(filterTaps[x]*8/sum);
  }
- #endif
 }
@@ -1,3 +1,4 @@
 int32 NeoFilterSound(int32 *in, int32 *out, uint32 inlen, int32 *leftover);
+int32 StepSynthRead(int32 *out, uint32 inlen);
 void MakeFilters(int32 rate);
 void SexyFilter(int32 *in, int32 *out, int32 count);
@@ -1,512 +0,0 @@
--116,
--8,
--8,
--8,
--8,
--8,
--8,
--8,
--8,
--7,
--7,
--6,
--5,
--5,
--4,
--3,
--2,
--1,
-0,
-1,
-2,
-4,
-5,
-7,
-9,
-10,
-12,
-14,
-16,
-18,
-19,
-21,
-23,
-25,
-27,
-28,
-30,
-32,
-33,
-34,
-36,
-37,
-38,
-38,
-39,
-40,
-40,
-40,
-40,
-39,
-39,
-38,
-37,
-36,
-34,
-33,
-31,
-29,
-26,
-24,
-21,
-18,
-14,
-11,
-7,
-4,
-0,
--3,
--8,
--12,
--16,
--21,
--25,
--29,
--34,
--38,
--43,
--47,
--51,
--55,
--59,
--62,
--66,
--69,
--72,
--75,
--77,
--79,
--80,
--81,
--82,
--83,
--83,
--82,
--81,
--80,
--78,
--75,
--72,
--69,
--65,
--61,
--56,
--51,
--45,
--39,
--33,
--26,
--19,
--11,
--4,
-3,
-12,
-20,
-29,
-37,
-46,
-55,
-64,
-72,
-81,
-89,
-97,
-105,
-112,
-119,
-126,
-132,
-138,
-143,
-147,
-151,
-154,
-156,
-158,
-159,
-159,
-158,
-157,
-154,
-151,
-146,
-141,
-135,
-128,
-121,
-112,
-103,
-93,
-82,
-70,
-58,
-45,
-31,
-17,
-3,
--11,
--26,
--41,
--57,
--72,
--88,
--104,
--119,
--134,
--149,
--163,
--177,
--191,
--203,
--215,
--226,
--236,
--246,
--254,
--261,
--267,
--271,
--274,
--276,
--277,
--276,
--274,
--270,
--264,
--258,
--249,
--240,
--228,
--216,
--201,
--186,
--169,
--151,
--132,
--111,
--90,
--68,
--44,
--20,
-3,
-28,
-54,
-80,
-106,
-132,
-158,
-184,
-209,
-234,
-258,
-281,
-304,
-325,
-345,
-364,
-381,
-397,
-411,
-423,
-433,
-441,
-447,
-451,
-453,
-452,
-449,
-444,
-436,
-426,
-413,
-399,
-381,
-362,
-340,
-316,
-289,
-261,
-231,
-199,
-165,
-130,
-93,
-55,
-16,
--23,
--63,
--104,
--145,
--187,
--228,
--269,
--310,
--349,
--388,
--425,
--461,
--495,
--528,
--558,
--586,
--612,
--635,
--655,
--673,
--687,
--698,
--705,
--709,
--710,
--707,
--700,
--690,
--675,
--657,
--636,
--610,
--581,
--549,
--513,
--473,
--431,
--385,
--336,
--285,
--232,
--176,
--118,
--59,
-1,
-64,
-127,
-190,
-254,
-318,
-381,
-444,
-505,
-566,
-624,
-680,
-734,
-786,
-834,
-879,
-920,
-957,
-990,
-1019,
-1043,
-1062,
-1076,
-1085,
-1088,
-1086,
-1079,
-1065,
-1046,
-1022,
-991,
-955,
-913,
-866,
-814,
-756,
-693,
-626,
-554,
-478,
-398,
-314,
-228,
-138,
-46,
--47,
--143,
--240,
--337,
--435,
--532,
--628,
--723,
--817,
--907,
--995,
--1080,
--1161,
--1237,
--1309,
--1375,
--1436,
--1490,
--1538,
--1579,
--1612,
--1639,
--1657,
--1667,
--1669,
--1662,
--1647,
--1623,
--1590,
--1548,
--1498,
--1439,
--1372,
--1296,
--1212,
--1120,
--1020,
--913,
--800,
--680,
--553,
--422,
--286,
--145,
-0,
-146,
-296,
-447,
-599,
-752,
-904,
-1054,
-1203,
-1348,
-1490,
-1627,
-1759,
-1885,
-2004,
-2115,
-2218,
-2312,
-2396,
-2470,
-2533,
-2584,
-2623,
-2650,
-2664,
-2665,
-2652,
-2625,
-2584,
-2529,
-2460,
-2376,
-2278,
-2167,
-2041,
-1902,
-1750,
-1585,
-1407,
-1218,
-1018,
-808,
-588,
-359,
-123,
--120,
--369,
--623,
--881,
--1142,
--1403,
--1665,
--1926,
--2184,
--2439,
--2688,
--2931,
--3166,
--3392,
--3607,
--3810,
--4000,
--4176,
--4335,
--4478,
--4602,
--4706,
--4790,
--4852,
--4891,
--4906,
--4897,
--4862,
--4801,
--4713,
--4598,
--4454,
--4283,
--4082,
--3853,
--3595,
--3308,
--2992,
--2647,
--2274,
--1873,
--1445,
--990,
--509,
--3,
-527,
-1081,
-1657,
-2254,
-2870,
-3505,
-4156,
-4823,
-5504,
-6196,
-6898,
-7609,
-8326,
-9048,
-9773,
-10498,
-11222,
-11943,
-12658,
-13366,
-14065,
-14753,
-15427,
-16086,
-16728,
-17351,
-17953,
-18533,
-19088,
-19616,
-20118,
-20590,
-21032,
-21441,
-21818,
-22160,
-22467,
-22738,
-22971,
-23167,
-23324,
-23443,
-23522,
-23561,
@@ -1,512 +0,0 @@
-113,
-14,
-15,
-15,
-16,
-16,
-17,
-17,
-18,
-18,
-18,
-18,
-18,
-17,
-17,
-16,
-16,
-15,
-14,
-12,
-11,
-10,
-8,
-6,
-4,
-2,
-0,
--1,
--3,
--6,
--8,
--11,
--13,
--16,
--18,
--21,
--24,
--26,
--29,
--31,
--33,
--35,
--37,
--39,
--41,
--42,
--44,
--45,
--46,
--46,
--47,
--47,
--46,
--46,
--45,
--44,
--42,
--40,
--38,
--36,
--33,
--30,
--26,
--23,
--19,
--15,
--10,
--6,
--1,
-3,
-8,
-13,
-19,
-24,
-29,
-35,
-40,
-45,
-50,
-55,
-60,
-64,
-68,
-72,
-75,
-79,
-81,
-83,
-85,
-86,
-87,
-87,
-87,
-86,
-84,
-82,
-79,
-76,
-72,
-67,
-62,
-56,
-50,
-43,
-36,
-28,
-20,
-11,
-2,
--6,
--15,
--25,
--34,
--44,
--54,
--63,
--73,
--82,
--91,
--100,
--109,
--117,
--124,
--131,
--137,
--142,
--147,
--151,
--154,
--156,
--158,
--158,
--157,
--156,
--153,
--149,
--145,
--139,
--132,
--124,
--115,
--105,
--95,
--83,
--71,
--58,
--44,
--29,
--14,
-0,
-16,
-32,
-48,
-65,
-81,
-98,
-114,
-129,
-145,
-159,
-174,
-187,
-199,
-211,
-221,
-231,
-239,
-246,
-251,
-255,
-257,
-258,
-257,
-255,
-251,
-245,
-237,
-228,
-217,
-205,
-191,
-175,
-158,
-140,
-120,
-99,
-77,
-54,
-30,
-6,
--19,
--44,
--70,
--96,
--123,
--148,
--174,
--199,
--223,
--247,
--269,
--291,
--311,
--329,
--346,
--361,
--374,
--385,
--393,
--400,
--404,
--406,
--405,
--401,
--395,
--387,
--376,
--362,
--346,
--327,
--306,
--282,
--256,
--228,
--198,
--166,
--133,
--98,
--61,
--23,
-14,
-53,
-93,
-133,
-173,
-212,
-251,
-290,
-327,
-363,
-397,
-430,
-461,
-489,
-515,
-538,
-558,
-575,
-589,
-600,
-607,
-610,
-609,
-605,
-597,
-585,
-569,
-549,
-526,
-498,
-467,
-432,
-395,
-353,
-309,
-262,
-213,
-161,
-107,
-51,
--5,
--63,
--122,
--181,
--240,
--299,
--357,
--414,
--469,
--523,
--575,
--623,
--669,
--712,
--751,
--786,
--817,
--843,
--865,
--881,
--893,
--899,
--899,
--894,
--884,
--867,
--845,
--817,
--784,
--745,
--701,
--651,
--597,
--537,
--474,
--406,
--334,
--259,
--181,
--100,
--17,
-67,
-152,
-239,
-325,
-412,
-497,
-581,
-663,
-742,
-818,
-890,
-959,
-1022,
-1081,
-1133,
-1180,
-1220,
-1254,
-1280,
-1299,
-1310,
-1313,
-1308,
-1295,
-1273,
-1243,
-1205,
-1159,
-1104,
-1042,
-972,
-894,
-809,
-718,
-621,
-517,
-409,
-296,
-179,
-58,
--64,
--190,
--316,
--443,
--570,
--696,
--820,
--941,
--1059,
--1173,
--1281,
--1384,
--1480,
--1569,
--1649,
--1722,
--1785,
--1838,
--1881,
--1912,
--1933,
--1942,
--1939,
--1924,
--1897,
--1858,
--1806,
--1741,
--1665,
--1576,
--1476,
--1365,
--1243,
--1110,
--968,
--816,
--657,
--490,
--316,
--136,
-47,
-235,
-426,
-619,
-811,
-1003,
-1193,
-1380,
-1563,
-1740,
-1910,
-2072,
-2225,
-2368,
-2499,
-2618,
-2723,
-2814,
-2889,
-2949,
-2991,
-3016,
-3022,
-3010,
-2979,
-2929,
-2859,
-2769,
-2660,
-2531,
-2384,
-2217,
-2032,
-1830,
-1611,
-1376,
-1126,
-862,
-585,
-297,
-0,
--307,
--621,
--940,
--1262,
--1586,
--1910,
--2232,
--2550,
--2862,
--3165,
--3459,
--3740,
--4007,
--4258,
--4491,
--4703,
--4893,
--5059,
--5200,
--5313,
--5396,
--5449,
--5470,
--5457,
--5409,
--5326,
--5206,
--5048,
--4853,
--4618,
--4345,
--4032,
--3681,
--3290,
--2861,
--2393,
--1888,
--1347,
--769,
--158,
-486,
-1162,
-1868,
-2602,
-3362,
-4146,
-4952,
-5777,
-6619,
-7475,
-8342,
-9219,
-10102,
-10988,
-11874,
-12757,
-13635,
-14504,
-15361,
-16204,
-17029,
-17833,
-18615,
-19370,
-20096,
-20790,
-21451,
-22075,
-22660,
-23205,
-23707,
-24164,
-24574,
-24937,
-25250,
-25513,
-25725,
-25884,
-25991,
-26044,
@@ -1,512 +0,0 @@
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
--1,
--1,
--1,
--1,
--1,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-0,
-1,
-1,
-1,
-1,
-2,
-2,
-2,
-2,
-2,
-2,
-2,
-2,
-2,
-1,
-1,
-0,
-0,
-0,
-0,
--1,
--1,
--2,
--3,
--3,
--4,
--4,
--5,
--5,
--5,
--5,
--5,
--5,
--4,
--4,
--3,
--2,
--1,
-0,
-0,
-1,
-2,
-4,
-5,
-6,
-7,
-8,
-9,
-10,
-10,
-10,
-10,
-10,
-9,
-8,
-7,
-6,
-4,
-2,
-0,
--1,
--4,
--6,
--8,
--11,
--13,
--15,
--16,
--18,
--19,
--19,
--19,
--19,
--18,
--17,
--15,
--13,
--10,
--6,
--3,
-0,
-4,
-8,
-12,
-17,
-20,
-24,
-27,
-30,
-32,
-33,
-34,
-34,
-33,
-31,
-28,
-25,
-20,
-15,
-9,
-3,
--3,
--10,
--17,
--24,
--31,
--37,
--43,
--48,
--52,
--55,
--57,
--57,
--56,
--54,
--50,
--45,
--38,
--30,
--21,
--11,
-0,
-10,
-21,
-33,
-44,
-55,
-64,
-73,
-80,
-86,
-90,
-92,
-91,
-88,
-84,
-76,
-67,
-56,
-42,
-27,
-11,
--5,
--23,
--41,
--59,
--76,
--92,
--106,
--119,
--129,
--136,
--141,
--142,
--140,
--134,
--125,
--112,
--96,
--77,
--56,
--32,
--6,
-19,
-47,
-74,
-100,
-125,
-149,
-169,
-186,
-199,
-208,
-213,
-212,
-206,
-195,
-179,
-158,
-132,
-102,
-68,
-32,
--6,
--46,
--86,
--126,
--164,
--200,
--232,
--259,
--282,
--298,
--308,
--311,
--307,
--294,
--275,
--248,
--214,
--173,
--128,
--77,
--23,
-33,
-91,
-149,
-205,
-258,
-307,
-350,
-386,
-415,
-434,
-443,
-442,
-431,
-408,
-375,
-332,
-280,
-219,
-151,
-76,
--1,
--82,
--164,
--245,
--322,
--394,
--459,
--515,
--561,
--595,
--615,
--622,
--613,
--590,
--552,
--499,
--433,
--354,
--264,
--165,
--59,
-51,
-164,
-277,
-387,
-490,
-586,
-670,
-741,
-797,
-835,
-854,
-853,
-832,
-790,
-729,
-647,
-548,
-433,
-304,
-163,
-15,
--138,
--293,
--445,
--592,
--729,
--852,
--959,
--1046,
--1111,
--1151,
--1165,
--1151,
--1110,
--1040,
--944,
--822,
--677,
--512,
--329,
--133,
-71,
-280,
-489,
-693,
-886,
-1063,
-1220,
-1353,
-1458,
-1530,
-1569,
-1571,
-1535,
-1462,
-1352,
-1206,
-1027,
-818,
-584,
-328,
-57,
--222,
--505,
--785,
--1054,
--1306,
--1534,
--1733,
--1896,
--2019,
--2097,
--2128,
--2108,
--2038,
--1917,
--1747,
--1529,
--1269,
--970,
--639,
--283,
-90,
-474,
-857,
-1233,
-1590,
-1921,
-2216,
-2467,
-2667,
-2810,
-2890,
-2904,
-2849,
-2724,
-2530,
-2270,
-1946,
-1566,
-1135,
-664,
-160,
--363,
--895,
--1425,
--1938,
--2423,
--2866,
--3256,
--3582,
--3834,
--4003,
--4082,
--4067,
--3953,
--3741,
--3431,
--3028,
--2537,
--1967,
--1328,
--632,
-106,
-871,
-1646,
-2413,
-3154,
-3849,
-4482,
-5034,
-5489,
-5833,
-6051,
-6134,
-6074,
-5864,
-5504,
-4994,
-4339,
-3546,
-2628,
-1599,
-477,
--716,
--1958,
--3223,
--4482,
--5708,
--6869,
--7936,
--8878,
--9666,
--10273,
--10671,
--10839,
--10755,
--10402,
--9767,
--8843,
--7623,
--6110,
--4308,
--2228,
-114,
-2701,
-5505,
-8499,
-11650,
-14923,
-18277,
-21673,
-25068,
-28417,
-31678,
-34807,
-37762,
-40502,
-42991,
-45192,
-47076,
-48617,
-49792,
-50584,
-50983,
@@ -43,32 +43,32 @@
 #include <cstdlib>
 #include <cstring>
 
-extern SFORMAT FCEUVSUNI_STATEINFO[];
+extern FCEU_THREAD_LOCAL_OBJECT SFORMAT FCEUVSUNI_STATEINFO[];
 
 //mbg merge 6/29/06 - these need to be global
-uint8 *trainerpoo = NULL;
-uint8 *ROM = NULL;
-uint8 *VROM = NULL;
-uint8 *MiscROM = NULL;
-uint8 *ExtraNTARAM = NULL;
-iNES_HEADER head;
-
-static CartInfo iNESCart;
-
-uint8 Mirroring = 0;
-uint8 MirroringAs2bits = 0;
-uint32 ROM_size = 0;
-uint32 VROM_size = 0;
-uint32 MiscROM_size = 0;
-char LoadedRomFName[4096]; //mbg merge 7/17/06 added
-char LoadedRomFNamePatchToUse[4096];
-
-static int CHRRAMSize = -1;
+FCEU_THREAD_LOCAL uint8 *trainerpoo = NULL;
+FCEU_THREAD_LOCAL uint8 *ROM = NULL;
+FCEU_THREAD_LOCAL uint8 *VROM = NULL;
+FCEU_THREAD_LOCAL uint8 *MiscROM = NULL;
+FCEU_THREAD_LOCAL uint8 *ExtraNTARAM = NULL;
+FCEU_THREAD_LOCAL iNES_HEADER head;
+
+static FCEU_THREAD_LOCAL_OBJECT CartInfo iNESCart;
+
+FCEU_THREAD_LOCAL uint8 Mirroring = 0;
+FCEU_THREAD_LOCAL uint8 MirroringAs2bits = 0;
+FCEU_THREAD_LOCAL uint32 ROM_size = 0;
+FCEU_THREAD_LOCAL uint32 VROM_size = 0;
+FCEU_THREAD_LOCAL uint32 MiscROM_size = 0;
+FCEU_THREAD_LOCAL char LoadedRomFName[4096]; //mbg merge 7/17/06 added
+FCEU_THREAD_LOCAL char LoadedRomFNamePatchToUse[4096];
+
+static FCEU_THREAD_LOCAL int CHRRAMSize = -1;
 static int iNES_Init(int num);
 
-static int MapperNo = 0;
+static FCEU_THREAD_LOCAL int MapperNo = 0;
 
-int iNES2 = 0;
+FCEU_THREAD_LOCAL int iNES2 = 0;
 
 static DECLFR(TrainerRead) {
 	return(trainerpoo[A & 0x1FF]);
@@ -132,7 +132,7 @@ void iNESGI(GI h) { //bbit edited: removed static keyword
 	}
 }
 
-uint32 iNESGameCRC32 = 0;
+FCEU_THREAD_LOCAL uint32 iNESGameCRC32 = 0;
 
 struct CRCMATCH {
 	uint32 crc;
@@ -150,7 +150,7 @@ struct INPSEL {
 * Function to set input controllers based on CRC
 */
 static void SetInput(void) {
-	static struct INPSEL moo[] =
+	static FCEU_THREAD_LOCAL struct INPSEL moo[] =
 	{
 		{0x19b0a9f1,	SI_GAMEPAD,		SI_ZAPPER,		SIFC_NONE		},	// 6-in-1 (MGC-023)(Unl)[!]
 		{0x29de87af,	SI_GAMEPAD,		SI_GAMEPAD,		SIFC_FTRAINERB	},	// Aerobics Studio
@@ -247,9 +247,9 @@ struct INPSEL_NES20 {
 /*
 * Function to set input controllers based on NES 2.0 header
 */
-extern int eoptions;
+extern FCEU_THREAD_LOCAL int eoptions;
 static void SetInputNes20(uint8 expansion) {
-	static struct INPSEL_NES20 moo[] =
+	static FCEU_THREAD_LOCAL struct INPSEL_NES20 moo[] =
 	{
 		{0x01,			SI_GAMEPAD,		SI_GAMEPAD,		SIFC_UNSET		}, // Standard NES/Famicom controllers
 		{0x02,			SI_GAMEPAD,		SI_GAMEPAD,		SIFC_NONE		}, // NES Four Score/Satellite with two additional standard controllers
@@ -305,7 +305,7 @@ struct BADINF {
 	uint32 type;
 };
 
-static struct BADINF BadROMImages[] =
+static FCEU_THREAD_LOCAL struct BADINF BadROMImages[] =
 {
 	#include "ines-bad.h"
 };
@@ -340,8 +340,8 @@ static const TMasterRomInfo sMasterRomInfo[] = {
 	{ 0x9342bf9bae1c798aULL, "bonus=0" }, //4-in-1 (FK23C8079) [p1][!].nes
 	{ 0x164eea6097a1e313ULL, "busc=1" }, //Cybernoid - The Fighting Machine (U)[!].nes -- needs bus conflict emulation
 };
-const TMasterRomInfo* MasterRomInfo;
-TMasterRomInfoParams MasterRomInfoParams;
+FCEU_THREAD_LOCAL const TMasterRomInfo* MasterRomInfo;
+FCEU_THREAD_LOCAL_OBJECT TMasterRomInfoParams MasterRomInfoParams;
 
 static void CheckHInfo(uint64 partialmd5) {
 	/* ROM images that have the battery-backed bit set in the header that really
@@ -351,7 +351,7 @@ static void CheckHInfo(uint64 partialmd5) {
 	Lower 64 bits of the MD5 hash.
 	*/
 
-	static uint64 savie[] =
+	static FCEU_THREAD_LOCAL uint64 savie[] =
 	{
 		0xc04361e499748382ULL,	/* AD&D Heroes of the Lance */
 		0xb72ee2337ced5792ULL,	/* AD&D Hillsfar */
@@ -389,7 +389,7 @@ static void CheckHInfo(uint64 partialmd5) {
 		0						/* Abandon all hope if the game has 0 in the lower 64-bits of its MD5 hash */
 	};
 
-	static struct CHINF moo[] =
+	static FCEU_THREAD_LOCAL struct CHINF moo[] =
 	{
 		#include "ines-correct.h"
 	};
@@ -523,12 +523,12 @@ typedef struct {
 // so we need either add here ALL ines 2.0 mappers 
 // with not power2 roms or change logic here
 // to something more unified for ines 2.0 specific
-static int not_power2[] =
+static FCEU_THREAD_LOCAL int not_power2[] =
 {
 	53, 198, 228, 547
 };
 
-BMAPPINGLocal bmap[] = {
+FCEU_THREAD_LOCAL BMAPPINGLocal bmap[] = {
 	{"NROM",				  0, NROM_Init},
 	{"MMC1",				  1, Mapper1_Init},
 	{"UNROM",				  2, UNROM_Init},
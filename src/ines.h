@@ -40,21 +40,21 @@ public:
 };
 
 //mbg merge 6/29/06
-extern uint8 *ROM;
-extern uint8 *VROM;
-extern uint8 *MiscROM;
-extern uint32 VROM_size;
-extern uint32 ROM_size;
-extern uint32 MiscROM_size;
-extern uint8 *ExtraNTARAM;
-extern uint8 **VPageR;
+extern FCEU_THREAD_LOCAL uint8 *ROM;
+extern FCEU_THREAD_LOCAL uint8 *VROM;
+extern FCEU_THREAD_LOCAL uint8 *MiscROM;
+extern FCEU_THREAD_LOCAL uint32 VROM_size;
+extern FCEU_THREAD_LOCAL uint32 ROM_size;
+extern FCEU_THREAD_LOCAL uint32 MiscROM_size;
+extern FCEU_THREAD_LOCAL uint8 *ExtraNTARAM;
+extern FCEU_THREAD_LOCAL_OBJECT uint8 **VPageR;
 extern int iNesSave(void); //bbit Edited: line added
 extern int iNesSaveAs(const char* name);
-extern char LoadedRomFName[4096]; //bbit Edited: line added
-extern char LoadedRomFNamePatchToUse[4096];
+extern FCEU_THREAD_LOCAL char LoadedRomFName[4096]; //bbit Edited: line added
+extern FCEU_THREAD_LOCAL char LoadedRomFNamePatchToUse[4096];
 extern char *iNesShortFName(void);
-extern const TMasterRomInfo* MasterRomInfo;
-extern TMasterRomInfoParams MasterRomInfoParams;
+extern FCEU_THREAD_LOCAL const TMasterRomInfo* MasterRomInfo;
+extern FCEU_THREAD_LOCAL_OBJECT TMasterRomInfoParams MasterRomInfoParams;
 
 //mbg merge 7/19/06 changed to c++ decl format
 struct iNES_HEADER {
@@ -87,7 +87,7 @@ struct iNES_HEADER {
 	}
 };
 
-extern struct iNES_HEADER head; //for mappers usage
+extern FCEU_THREAD_LOCAL struct iNES_HEADER head; //for mappers usage
 
 void NSFVRC6_Init(void);
 void NSFMMC5_Init(void);
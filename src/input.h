@@ -8,8 +8,8 @@
 
 void LagCounterToggle(void);
 
-extern FILE* PlayInputFile;
-extern FILE* DumpInputFile;
+extern FCEU_THREAD_LOCAL FILE* PlayInputFile;
+extern FCEU_THREAD_LOCAL FILE* DumpInputFile;
 
 
 class MovieRecord;
@@ -71,7 +71,7 @@ struct INPUTCFC
 	void (*_Load)(MovieRecord* mr);
 };
 
-extern struct JOYPORT
+extern FCEU_THREAD_LOCAL struct JOYPORT
 {
 	JOYPORT(int _w)
 		: w(_w), attrib(0), type(SI_UNSET), ptr(0), driver(0)
@@ -87,7 +87,7 @@ extern struct JOYPORT
 	void load(MovieRecord* mr) { driver->Load(w,mr); }
 } joyports[2];
 
-extern struct FCPORT
+extern FCEU_THREAD_LOCAL struct FCPORT
 {
 	int attrib;
 	ESIFC type;
@@ -104,6 +104,8 @@ extern void (*PStrobe[2])(void);
 
 //called from PPU on scanline events.
 extern void InputScanlineHook(uint8 *bg, uint8 *spr, uint32 linets, int final);
+//whether any attached device looks at the picture through InputScanlineHook
+bool InputScanlineHooked(void);
 
 void FCEU_DoSimpleCommand(int cmd);
 
@@ -280,7 +282,7 @@ enum EMUCMDTYPE
 	EMUCMDTYPE_MAX
 };
 
-extern const char* FCEUI_CommandTypeNames[];
+extern FCEU_THREAD_LOCAL const char* FCEUI_CommandTypeNames[];
 
 typedef void EMUCMDFN(void);
 
@@ -301,12 +303,12 @@ struct EMUCMDTABLE
 	int flags; //EMUCMDFLAG
 };
 
-extern struct EMUCMDTABLE FCEUI_CommandTable[];
+extern FCEU_THREAD_LOCAL struct EMUCMDTABLE FCEUI_CommandTable[];
 
-extern unsigned int lagCounter;
-extern bool lagCounterDisplay;
-extern char lagFlag;
-extern bool turbo;
+extern FCEU_THREAD_LOCAL unsigned int lagCounter;
+extern FCEU_THREAD_LOCAL bool lagCounterDisplay;
+extern FCEU_THREAD_LOCAL char lagFlag;
+extern FCEU_THREAD_LOCAL bool turbo;
 void LagCounterReset();
 EMUCMDTABLE* GetEmuCommandById(int cmd);
 
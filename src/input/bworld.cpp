@@ -21,8 +21,8 @@
 #include <string.h>
 #include "share.h"
 
-static int seq,ptr,bit,cnt,have;
-static uint8 bdata[32];
+static FCEU_THREAD_LOCAL int seq,ptr,bit,cnt,have;
+static FCEU_THREAD_LOCAL uint8 bdata[32];
 
 
 static uint8 Read(int w, uint8 ret)
@@ -65,7 +65,7 @@ static void Update(void *data, int arg)
  }
 }
 
-static INPUTCFC BarcodeWorld={Read,Write,0,Update,0,0};
+static FCEU_THREAD_LOCAL INPUTCFC BarcodeWorld={Read,Write,0,Update,0,0};
 
 INPUTCFC *FCEU_InitBarcodeWorld(void)
 {
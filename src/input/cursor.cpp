@@ -1,6 +1,6 @@
 #include "share.h"
 
-static uint8 GunSight[]={
+static FCEU_THREAD_LOCAL uint8 GunSight[]={
         0,0,0,0,0,0,1,0,0,0,0,0,0,
         0,0,0,0,0,0,2,0,0,0,0,0,0,
         0,0,0,0,0,0,1,0,0,0,0,0,0,
@@ -15,7 +15,7 @@ static uint8 GunSight[]={
         0,0,0,0,0,0,2,0,0,0,0,0,0,
         0,0,0,0,0,0,1,0,0,0,0,0,0,
 };
-static uint8 FCEUcursor[11*19]=
+static FCEU_THREAD_LOCAL uint8 FCEUcursor[11*19]=
 {
  1,0,0,0,0,0,0,0,0,0,0,
  1,1,0,0,0,0,0,0,0,0,0,
@@ -23,11 +23,11 @@
 #include "fkb.h"
 #define AK(x)	FKB_ ## x
 
-static uint8 bufit[0x49];
-static uint8 ksmode;
-static uint8 ksindex;
+static FCEU_THREAD_LOCAL uint8 bufit[0x49];
+static FCEU_THREAD_LOCAL uint8 ksmode;
+static FCEU_THREAD_LOCAL uint8 ksindex;
 
-static uint16 matrix[9][2][4] =
+static FCEU_THREAD_LOCAL uint16 matrix[9][2][4] =
 {
 	{ { AK(F8), AK(RETURN), AK(BRACKETLEFT), AK(BRACKETRIGHT) },
 	  { AK(KANA), AK(RIGHTSHIFT), AK(BACKSLASH), AK(STOP) } },
@@ -80,7 +80,7 @@ static void FKB_Update(void *data, int arg) {
 	memcpy(bufit + 1, data, sizeof(bufit) - 1);
 }
 
-static INPUTCFC FKB = { FKB_Read, FKB_Write, FKB_Strobe, FKB_Update, 0, 0 };
+static FCEU_THREAD_LOCAL INPUTCFC FKB = { FKB_Read, FKB_Write, FKB_Strobe, FKB_Update, 0, 0 };
 
 INPUTCFC *FCEU_InitFKB(void) {
 	memset(bufit, 0, sizeof(bufit));
@@ -21,7 +21,7 @@
 #include <string.h>
 #include "share.h"
 
-static uint8 HSVal,HSValR;
+static FCEU_THREAD_LOCAL uint8 HSVal,HSValR;
 
 
 static uint8 HS_Read(int w, uint8 ret)
@@ -41,7 +41,7 @@ static void HS_Update(void *data, int arg)
  HSVal=*(uint8*)data;
 }
 
-static INPUTCFC HyperShot={HS_Read,0,HS_Strobe,HS_Update,0,0};
+static FCEU_THREAD_LOCAL INPUTCFC HyperShot={HS_Read,0,HS_Strobe,HS_Update,0,0};
 
 INPUTCFC *FCEU_InitHS(void)
 {
@@ -31,7 +31,7 @@ typedef struct {
 	uint32 mb;
 } MOUSE;
 
-static MOUSE Mouse;
+static FCEU_THREAD_LOCAL MOUSE Mouse;
 
 // since this game only picks up 1 mickey per frame,
 // allow a single delta to spread out over a few frames
@@ -74,7 +74,7 @@ static void UpdateMOUSE(int w, void *data, int arg)
 	else if (Mouse.dy < -INERTIA) Mouse.dy = -INERTIA;
 }
 
-static INPUTC MOUSEC={ReadMOUSE,0,StrobeMOUSE,UpdateMOUSE,0,0};
+static FCEU_THREAD_LOCAL INPUTC MOUSEC={ReadMOUSE,0,StrobeMOUSE,UpdateMOUSE,0,0};
 
 INPUTC *FCEU_InitMouse(int w)
 {
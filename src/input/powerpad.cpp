@@ -23,9 +23,9 @@
 #include        "share.h"
 
 
-static char side;
-static uint32 pprsb[2];
-static uint32 pprdata[2];
+static FCEU_THREAD_LOCAL char side;
+static FCEU_THREAD_LOCAL uint32 pprsb[2];
+static FCEU_THREAD_LOCAL uint32 pprdata[2];
 
 static uint8 ReadPP(int w)
 {
@@ -64,7 +64,7 @@ void UpdatePP(int w, void *data, int arg)
    pprdata[w]|=(((*(uint32 *)data)>>x)&1)<<shifttableB[x];
 }
 
-static INPUTC PwrPadCtrl={ReadPP,0,StrobePP,UpdatePP,0,0};
+static FCEU_THREAD_LOCAL INPUTC PwrPadCtrl={ReadPP,0,StrobePP,UpdatePP,0,0};
 
 static INPUTC *FCEU_InitPowerpad(int w)
 {
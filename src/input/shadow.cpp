@@ -24,7 +24,7 @@
 #include        "share.h"
 #include        "zapper.h"
 
-static ZAPPER ZD;
+static FCEU_THREAD_LOCAL ZAPPER ZD;
 
 static void ZapperFrapper(uint8 *bg, uint8 *spr, uint32  linets, int final)
 {
@@ -132,7 +132,7 @@ static void StrobeShadow(void)
  ZD.zap_readbit=0;
 }
 
-static INPUTCFC SHADOWC={ReadZapper,0,StrobeShadow,UpdateZapper,ZapperFrapper,DrawZapper};
+static FCEU_THREAD_LOCAL INPUTCFC SHADOWC={ReadZapper,0,StrobeShadow,UpdateZapper,ZapperFrapper,DrawZapper};
 
 INPUTCFC *FCEU_InitSpaceShadow(void)
 {
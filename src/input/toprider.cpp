@@ -21,8 +21,8 @@
 #include <string.h>
 #include "share.h"
 
-static uint32 bs,bss;
-static uint32 boop;
+static FCEU_THREAD_LOCAL uint32 bs,bss;
+static FCEU_THREAD_LOCAL uint32 boop;
 
 static uint8 Read(int w, uint8 ret)
 {
@@ -52,7 +52,7 @@ static void Update(void *data, int arg)
  bss|=bss<<8;
 }
 
-static INPUTCFC TopRider={Read,Write,0,Update,0,0};
+static FCEU_THREAD_LOCAL INPUTCFC TopRider={Read,Write,0,Update,0,0};
 
 INPUTCFC *FCEU_InitTopRider(void)
 {
@@ -17,8 +17,8 @@
 
 #include "share.h"
 
-static uint32 vbrsb[2];
-static uint32 vbrdata[2];
+static FCEU_THREAD_LOCAL uint32 vbrsb[2];
+static FCEU_THREAD_LOCAL uint32 vbrdata[2];
 
 static uint8 ReadVB(int w)
 {
@@ -49,7 +49,7 @@ void UpdateVB(int w, void *data, int arg)
 	vbrdata[w]|=(1<<14); // fixed signature bit
 }
 
-static INPUTC VirtualBoyCtrl={ReadVB,0,StrobeVB,UpdateVB,0,0};
+static FCEU_THREAD_LOCAL INPUTC VirtualBoyCtrl={ReadVB,0,StrobeVB,UpdateVB,0,0};
 
 INPUTC *FCEU_InitVirtualBoy(int w)
 {
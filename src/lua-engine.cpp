@@ -37,7 +37,7 @@
 #include "utils/crc32.h"
 #include "fceulua.h"
 
-extern char FileBase[];
+extern FCEU_THREAD_LOCAL char FileBase[];
 
 #ifdef __WIN_DRIVER__
 #include "drivers/win/common.h"
@@ -172,7 +172,7 @@ extern "C"
 extern void AddRecentLuaFile(const char *filename);
 #endif
 
-extern bool turbo;
+extern FCEU_THREAD_LOCAL bool turbo;
 extern int32 fps_scale;
 
 struct LuaSaveState {
@@ -2223,6 +2223,28 @@ struct TieredRegion
 };
 TieredRegion hookedRegions [LUAMEMHOOK_COUNT];
 
+// narrows the CPU's memory hook down to the hooked bytes,
+// so that the emulator doesn't call into us for every other address
+static void WatchMemHookRegions(LuaMemHookType hookType)
+{
+	X6502_MemHook::Type type = X6502_MemHook::Read;
+	void (*func)(unsigned int address, unsigned int value, void *userData) = luaReadMemHook;
+
+	switch(hookType)
+	{
+		case LUAMEMHOOK_WRITE: type = X6502_MemHook::Write; func = luaWriteMemHook; break;
+		case LUAMEMHOOK_READ:  type = X6502_MemHook::Read;  func = luaReadMemHook;  break;
+		case LUAMEMHOOK_EXEC:  type = X6502_MemHook::Exec;  func = luaExecMemHook;  break;
+		default: return;
+	}
+
+	X6502_MemHook::Watch(type, func, nullptr, 0, 0x10000, false);
+
+	const std::vector<TieredRegion::Region<0>::Island>& islands = hookedRegions[hookType].narrow.islands;
+	for(size_t i = 0; i != islands.size(); ++i)
+		X6502_MemHook::Watch(type, func, nullptr, islands[i].start, islands[i].end - islands[i].start);
+}
+
 
 static void CalculateMemHookRegions(LuaMemHookType hookType)
 {
@@ -2255,6 +2277,7 @@ static void CalculateMemHookRegions(LuaMemHookType hookType)
 //		++iter;
 //	}
 	hookedRegions[hookType].Calculate(hookedBytes);
+	WatchMemHookRegions(hookType);
 }
 
 static void CallRegisteredLuaMemHook_LuaMatch(unsigned int address, int size, unsigned int value, LuaMemHookType hookType)
@@ -2863,7 +2886,7 @@ static int joy_get_internal(lua_State *L, bool reportUp, bool reportDown) {
 	}
 
 	// Use the OS-specific code to do the reading.
-	extern SFORMAT FCEUCTRL_STATEINFO[];
+	extern FCEU_THREAD_LOCAL_OBJECT SFORMAT FCEUCTRL_STATEINFO[];
 	uint8 buttons = ((uint8 *) FCEUCTRL_STATEINFO[1].v)[which - 1];
 
 	lua_newtable(L);
@@ -4885,19 +4908,19 @@ static int gui_register(lua_State *L) {
 // table sound.get()
 static int sound_get(lua_State *L)
 {
-	extern ENVUNIT EnvUnits[3];
+	extern FCEU_THREAD_LOCAL ENVUNIT EnvUnits[3];
 	extern int CheckFreq(uint32 cf, uint8 sr);
-	extern int32 curfreq[2];
-	extern uint8 PSG[0x10];
-	extern int32 lengthcount[4];
-	extern uint8 TriCount;
+	extern FCEU_THREAD_LOCAL int32 curfreq[2];
+	extern FCEU_THREAD_LOCAL uint8 PSG[0x10];
+	extern FCEU_THREAD_LOCAL int32 lengthcount[4];
+	extern FCEU_THREAD_LOCAL uint8 TriCount;
 	extern const uint32 NoiseFreqTableNTSC[0x10];
 	extern const uint32 NoiseFreqTablePAL[0x10];
-	extern int32 DMCPeriod;
-	extern uint8 DMCAddressLatch, DMCSizeLatch;
-	extern uint8 DMCFormat;
-	extern char DMCHaveSample;
-	extern uint8 InitialRawDALatch;
+	extern FCEU_THREAD_LOCAL int32 DMCPeriod;
+	extern FCEU_THREAD_LOCAL uint8 DMCAddressLatch, DMCSizeLatch;
+	extern FCEU_THREAD_LOCAL uint8 DMCFormat;
+	extern FCEU_THREAD_LOCAL char DMCHaveSample;
+	extern FCEU_THREAD_LOCAL uint8 InitialRawDALatch;
 
 	int freqReg;
 	double freq;
@@ -6685,6 +6708,9 @@ int FCEU_LoadLuaCode(const char *filename, const char *arg)
 		X6502_MemHook::Add( X6502_MemHook::Read , luaReadMemHook , nullptr );
 		X6502_MemHook::Add( X6502_MemHook::Write, luaWriteMemHook, nullptr );
 		X6502_MemHook::Add( X6502_MemHook::Exec , luaExecMemHook , nullptr );
+
+		for(int i = 0; i < LUAMEMHOOK_COUNT; i++)
+			WatchMemHookRegions((LuaMemHookType)i);
 	}
 
 	// We make our thread NOW because we want it at the bottom of the stack.
@@ -18,10 +18,12 @@
 #include "fceulua.h"
 #endif
 #include "utils/guid.h"
+#include "utils/md5.h"
 #include "utils/memory.h"
 #include "utils/xstring.h"
 #include <sstream>
 #include <algorithm>
+#include <map>
 
 #ifdef CREATE_AVI
 #include "drivers/videolog/nesvideos-piece.h"
@@ -44,8 +46,8 @@ extern bool mustEngageTaseditor;
 #include "./drivers/Qt/TasEditor/TasEditorWindow.h"
 #endif
 
-extern int RAMInitOption;
-extern int RAMInitSeed;
+extern FCEU_THREAD_LOCAL int RAMInitOption;
+extern FCEU_THREAD_LOCAL int RAMInitSeed;
 
 #include <cstdio>
 #include <cstdlib>
@@ -61,20 +63,22 @@ using namespace std;
 
 #define MOVIE_VERSION           3
 
-extern char FileBase[];
-extern bool AutoSS;		//Declared in fceu.cpp, keeps track if a auto-savestate has been made
+extern FCEU_THREAD_LOCAL char FileBase[];
+extern FCEU_THREAD_LOCAL bool AutoSS;		//Declared in fceu.cpp, keeps track if a auto-savestate has been made
 
-std::vector<int> subtitleFrames;		//Frame numbers for subtitle messages
-std::vector<string> subtitleMessages;	//Messages of subtitles
+FCEU_THREAD_LOCAL_OBJECT std::vector<int> subtitleFrames;		//Frame numbers for subtitle messages
+FCEU_THREAD_LOCAL_OBJECT std::vector<string> subtitleMessages;	//Messages of subtitles
 
-bool subtitlesOnAVI = false;
-bool autoMovieBackup = false; //Toggle that determines if movies should be backed up automatically before altering them
-bool freshMovie = false;	  //True when a movie loads, false when movie is altered.  Used to determine if a movie has been altered since opening
-bool movieFromPoweron = true;
+FCEU_THREAD_LOCAL bool subtitlesOnAVI = false;
+FCEU_THREAD_LOCAL bool autoMovieBackup = false; //Toggle that determines if movies should be backed up automatically before altering them
+FCEU_THREAD_LOCAL bool freshMovie = false;	  //True when a movie loads, false when movie is altered.  Used to determine if a movie has been altered since opening
+FCEU_THREAD_LOCAL bool movieFromPoweron = true;
 
-static int _currCommand = 0;
+static FCEU_THREAD_LOCAL int _currCommand = 0;
 
 // Function declarations------------------------
+static void TimelineChanged(int frame);
+static void TimelineReset();
 
 
 //TODO - remove the synchack stuff from the replay gui and require it to be put into the fm2 file
@@ -90,36 +94,36 @@ static int _currCommand = 0;
 //that would be faster than several reads, perhaps.
 
 //sometimes we accidentally produce movie stop signals while we're trying to do other things with movies..
-bool suppressMovieStop=false;
+FCEU_THREAD_LOCAL bool suppressMovieStop=false;
 
 //----movie engine main state
-EMOVIEMODE movieMode = MOVIEMODE_INACTIVE;
+FCEU_THREAD_LOCAL EMOVIEMODE movieMode = MOVIEMODE_INACTIVE;
 
 //this should not be set unless we are in MOVIEMODE_RECORD!
 //FILE* fpRecordingMovie = 0;
-EMUFILE* osRecordingMovie = NULL;
-
-int currFrameCounter;
-uint32 cur_input_display = 0;
-int pauseframe = -1;
-bool movie_readonly = true;
-int input_display = 0;
-int frame_display = 0;
-int rerecord_display = 0;
-bool fullSaveStateLoads = false;	//Option for loading a savestates full contents in read+write mode instead of up to the frame count in the savestate (useful as a recovery option)
-int movieRecordMode = 0;			//Option for various movie recording modes such as TRUNCATE (normal), OVERWRITE etc.
-
-SFORMAT FCEUMOV_STATEINFO[]={
+FCEU_THREAD_LOCAL EMUFILE* osRecordingMovie = NULL;
+
+FCEU_THREAD_LOCAL int currFrameCounter;
+FCEU_THREAD_LOCAL uint32 cur_input_display = 0;
+FCEU_THREAD_LOCAL int pauseframe = -1;
+FCEU_THREAD_LOCAL bool movie_readonly = true;
+FCEU_THREAD_LOCAL int input_display = 0;
+FCEU_THREAD_LOCAL int frame_display = 0;
+FCEU_THREAD_LOCAL int rerecord_display = 0;
+FCEU_THREAD_LOCAL bool fullSaveStateLoads = false;	//Option for loading a savestates full contents in read+write mode instead of up to the frame count in the savestate (useful as a recovery option)
+FCEU_THREAD_LOCAL int movieRecordMode = 0;			//Option for various movie recording modes such as TRUNCATE (normal), OVERWRITE etc.
+
+FCEU_THREAD_LOCAL_OBJECT SFORMAT FCEUMOV_STATEINFO[]={
 	{ &currFrameCounter, 4|FCEUSTATE_RLSB, "FCNT"},
 	{ 0 }
 };
 
-std::string curMovieFilename;
-MovieData currMovieData;
-MovieData defaultMovieData;
-int currRerecordCount; // Keep the global value
+FCEU_THREAD_LOCAL_OBJECT std::string curMovieFilename;
+FCEU_THREAD_LOCAL_OBJECT MovieData currMovieData;
+FCEU_THREAD_LOCAL_OBJECT MovieData defaultMovieData;
+FCEU_THREAD_LOCAL int currRerecordCount; // Keep the global value
 
-char lagcounterbuf[32] = {0};
+FCEU_THREAD_LOCAL char lagcounterbuf[32] = {0};
 
 void MovieData::clearRecordRange(int start, int len)
 {
@@ -245,90 +249,208 @@ void MovieRecord::dumpJoy(EMUFILE* os, uint8 joystate)
 	}
 }
 
-void MovieRecord::parseJoy(EMUFILE* is, uint8& joystate)
+#define FM2_READ_BLOCK_SIZE (1 << 20)
+
+//reads the text of a movie a block at a time, so that the parser doesn't make a virtual EMUFILE call for every character.
+//the block is fetched with a single fread and never reaches past "limit" bytes from where reading started.
+class FM2Reader
 {
-	char buf[8] = {0};
-	is->fread(buf,8);
-	joystate = 0;
-	for(int i=0;i<8;i++)
+public:
+	FM2Reader(EMUFILE* fp, int limit)
+		: fp(fp)
+		, start(fp->ftell())
+		, bufferStart(start)
+		, limit(std::max(limit, 0))
+		, pos(0)
+		, len(0)
+		, exhausted(false)
 	{
-		joystate <<= 1;
-		joystate |= ((buf[i]=='.'||buf[i]==' ')?0:1);
 	}
-}
 
-void MovieRecord::parse(MovieData* md, EMUFILE* is)
-{
-	//by the time we get in here, the initial pipe has already been extracted
-
-	//extract the commands
-	commands = uint32DecFromIstream(is);
-	//*is >> commands;
-	is->fgetc(); //eat the pipe
+	int getc()
+	{
+		if(pos == len && !refill())
+			return -1;
+		return buffer[pos++];
+	}
+	//steps back over the character that the last getc returned
+	void unget() { pos--; }
 
-	//a special case: if fourscore is enabled, parse four gamepads
-	if(md->fourscore)
+	//makes sure that at least "count" unread bytes are in the buffer, false when the input ends before that
+	bool ensure(int count)
 	{
-		parseJoy(is,joysticks[0]); is->fgetc(); //eat the pipe
-		parseJoy(is,joysticks[1]); is->fgetc(); //eat the pipe
-		parseJoy(is,joysticks[2]); is->fgetc(); //eat the pipe
-		parseJoy(is,joysticks[3]); is->fgetc(); //eat the pipe
+		while(len - pos < count)
+			if(!refill())
+				return false;
+		return true;
 	}
-	else
+	const uint8* data() { return &buffer[pos]; }
+	void skip(int count) { pos += count; }
+
+	//the number of bytes that may still be read
+	int remaining() { return limit - consumed(); }
+
+	//guesses how many lines are left by counting the ones that are already buffered
+	int estimateLines()
 	{
-		for(int port=0;port<2;port++)
+		ensure(1);
+		int lines = 0;
+		const uint8* p = data();
+		const uint8* end = &buffer[0] + len;
+		while(p < end && (p = (const uint8*)memchr(p, '\n', end - p)) != NULL)
 		{
-			if(md->ports[port] == SI_GAMEPAD)
-				parseJoy(is, joysticks[port]);
-			else if(md->ports[port] == SI_ZAPPER)
-			{
-				zappers[port].x = uint32DecFromIstream(is);
-				zappers[port].y = uint32DecFromIstream(is);
-				zappers[port].b = uint32DecFromIstream(is);
-				zappers[port].bogo = uint32DecFromIstream(is);
-				zappers[port].zaphit = uint64DecFromIstream(is);
-			}
+			lines++;
+			p++;
+		}
+		int buffered = len - pos;
+		if(exhausted || !buffered)
+			return lines;
+		long left = std::min<long>(remaining(), (long)fp->size() - (bufferStart + pos));
+		if(left <= buffered)
+			return lines;
+		return (int)((double)lines * left / buffered);
+	}
+
+	//leaves the file at the first character that wasn't read through the reader
+	void sync() { fp->fseek(bufferStart + pos, SEEK_SET); }
+
+private:
+	int consumed() { return bufferStart + pos - start; }
 
-			is->fgetc(); //eat the pipe
+	bool refill()
+	{
+		if(exhausted)
+			return false;
+		//the unread tail moves to the front, the next block is appended after it
+		if(pos)
+		{
+			buffer.erase(buffer.begin(), buffer.begin() + pos);
+			bufferStart += pos;
+			len -= pos;
+			pos = 0;
 		}
+		int todo = std::min(FM2_READ_BLOCK_SIZE, limit - (int)(bufferStart + len - start));
+		if(todo <= 0)
+		{
+			exhausted = true;
+			return false;
+		}
+		buffer.resize(len + todo);
+		int got = fp->fread(&buffer[len], todo);
+		len += got;
+		buffer.resize(len);
+		if(got < todo)
+			exhausted = true;
+		return got > 0;
 	}
 
-	//(no fcexp data is logged right now)
-	is->fgetc(); //eat the pipe
+	EMUFILE* fp;
+	long start, bufferStart;
+	int limit;
+	std::vector<uint8> buffer;
+	int pos, len;
+	bool exhausted;
+};
 
-	//should be left at a newline
+//extracts a decimal uint from the reader, the same way templateIntegerDecFromIstream does
+static uint32 FM2DecFromReader(FM2Reader& in)
+{
+	unsigned int ret = 0;
+	bool pre = true;
+
+	for(;;)
+	{
+		int c = in.getc();
+		if(c == -1) return ret;
+		int d = c - '0';
+		if((d<0 || d>9))
+		{
+			if(!pre)
+				break;
+		}
+		else
+		{
+			pre = false;
+			ret *= 10;
+			ret += d;
+		}
+	}
+	in.unget();
+	return ret;
 }
 
+//the joystick bit that each character stands for: ' ' and '.' are unset bits, anything else (even a missing character) is set
+static const struct FM2JoyTable
+{
+	uint8 bit[256];
+	FM2JoyTable()
+	{
+		for(int i=0;i<256;i++)
+			bit[i] = (i=='.' || i==' ') ? 0 : 1;
+	}
+} fm2JoyTable;
 
-bool MovieRecord::parseBinary(MovieData* md, EMUFILE* is)
+void MovieRecord::parseJoy(FM2Reader& in, uint8& joystate)
 {
-	commands = (uint8)is->fgetc();
+	uint8 buf[8] = {0};
+	if(in.ensure(8))
+	{
+		memcpy(buf, in.data(), 8);
+		in.skip(8);
+	}
+	else
+	{
+		for(int i=0;i<8;i++)
+		{
+			int c = in.getc();
+			if(c == -1) break;
+			buf[i] = c;
+		}
+	}
+	const uint8* bit = fm2JoyTable.bit;
+	joystate = (bit[buf[0]] << 7) | (bit[buf[1]] << 6) | (bit[buf[2]] << 5) | (bit[buf[3]] << 4)
+		| (bit[buf[4]] << 3) | (bit[buf[5]] << 2) | (bit[buf[6]] << 1) | bit[buf[7]];
+}
 
-	//check for eof
-	if(is->eof()) return false;
+void MovieRecord::parse(MovieData* md, FM2Reader& in)
+{
+	//by the time we get in here, the initial pipe has already been extracted
 
+	//extract the commands
+	commands = FM2DecFromReader(in);
+	in.getc(); //eat the pipe
+
+	//a special case: if fourscore is enabled, parse four gamepads
 	if(md->fourscore)
 	{
-		is->fread((char*)&joysticks,4);
+		parseJoy(in,joysticks[0]); in.getc(); //eat the pipe
+		parseJoy(in,joysticks[1]); in.getc(); //eat the pipe
+		parseJoy(in,joysticks[2]); in.getc(); //eat the pipe
+		parseJoy(in,joysticks[3]); in.getc(); //eat the pipe
 	}
 	else
 	{
 		for(int port=0;port<2;port++)
 		{
 			if(md->ports[port] == SI_GAMEPAD)
-				joysticks[port] = (uint8)is->fgetc();
+				parseJoy(in, joysticks[port]);
 			else if(md->ports[port] == SI_ZAPPER)
 			{
-				zappers[port].x = (uint8)is->fgetc();
-				zappers[port].y = (uint8)is->fgetc();
-				zappers[port].b = (uint8)is->fgetc();
-				zappers[port].bogo = (uint8)is->fgetc();
-				read64le(&zappers[port].zaphit,is);
+				zappers[port].x = FM2DecFromReader(in);
+				zappers[port].y = FM2DecFromReader(in);
+				zappers[port].b = FM2DecFromReader(in);
+				zappers[port].bogo = FM2DecFromReader(in);
+				zappers[port].zaphit = FM2DecFromReader(in);
 			}
+
+			in.getc(); //eat the pipe
 		}
 	}
 
-	return true;
+	//(no fcexp data is logged right now)
+	in.getc(); //eat the pipe
+
+	//should be left at a newline
 }
 
 
@@ -604,7 +726,8 @@ bool FCEUMOV_Mode(int modemask)
 	return FCEUMOV_Mode((EMOVIEMODE)modemask);
 }
 
-static void LoadFM2_binarychunk(MovieData& movieData, EMUFILE* fp, int size)
+//size of a record as MovieRecord::dumpBinary writes it
+static int BinaryRecordSize(MovieData& movieData)
 {
 	int recordsize = 1; //1 for the command
 	if(movieData.fourscore)
@@ -620,6 +743,72 @@ static void LoadFM2_binarychunk(MovieData& movieData, EMUFILE* fp, int size)
 			}
 		}
 	}
+	return recordsize;
+}
+
+static void PackBinaryRecords(MovieData& movieData, int start, int count, uint8* out)
+{
+	for(int i=start;i<start+count;i++)
+	{
+		MovieRecord& rec = movieData.records[i];
+		*out++ = rec.commands;
+		if(movieData.fourscore)
+		{
+			for(int j=0;j<4;j++)
+				*out++ = rec.joysticks[j];
+			continue;
+		}
+		for(int port=0;port<2;port++)
+		{
+			if(movieData.ports[port] == SI_GAMEPAD)
+				*out++ = rec.joysticks[port];
+			else if(movieData.ports[port] == SI_ZAPPER)
+			{
+				*out++ = rec.zappers[port].x;
+				*out++ = rec.zappers[port].y;
+				*out++ = rec.zappers[port].b;
+				*out++ = rec.zappers[port].bogo;
+				for(int j=0;j<8;j++)
+					*out++ = (uint8)(rec.zappers[port].zaphit >> (j*8));
+			}
+		}
+	}
+}
+
+static void UnpackBinaryRecords(MovieData& movieData, const uint8* in, int count)
+{
+	movieData.records.resize(count);
+	for(int i=0;i<count;i++)
+	{
+		MovieRecord& rec = movieData.records[i];
+		rec.commands = *in++;
+		if(movieData.fourscore)
+		{
+			for(int j=0;j<4;j++)
+				rec.joysticks[j] = *in++;
+			continue;
+		}
+		for(int port=0;port<2;port++)
+		{
+			if(movieData.ports[port] == SI_GAMEPAD)
+				rec.joysticks[port] = *in++;
+			else if(movieData.ports[port] == SI_ZAPPER)
+			{
+				rec.zappers[port].x = *in++;
+				rec.zappers[port].y = *in++;
+				rec.zappers[port].b = *in++;
+				rec.zappers[port].bogo = *in++;
+				rec.zappers[port].zaphit = 0;
+				for(int j=0;j<8;j++)
+					rec.zappers[port].zaphit |= (uint64)(*in++) << (j*8);
+			}
+		}
+	}
+}
+
+static void LoadFM2_binarychunk(MovieData& movieData, EMUFILE* fp, int size)
+{
+	int recordsize = BinaryRecordSize(movieData);
 
 	//find out how much remains in the file
 	int curr = fp->ftell();
@@ -635,11 +824,11 @@ static void LoadFM2_binarychunk(MovieData& movieData, EMUFILE* fp, int size)
 	if (movieData.loadFrameCount!=-1 && movieData.loadFrameCount<numRecords)
 		numRecords=movieData.loadFrameCount;
 
-	movieData.records.resize(numRecords);
-	for(int i=0;i<numRecords;i++)
-	{
-		movieData.records[i].parseBinary(&movieData,fp);
-	}
+	//read all the records at once instead of going through fgetc for every byte
+	std::vector<uint8> packed(numRecords * recordsize);
+	if(numRecords)
+		numRecords = fp->fread(&packed[0], packed.size()) / recordsize;
+	UnpackBinaryRecords(movieData, packed.empty() ? NULL : &packed[0], numRecords);
 }
 
 //yuck... another custom text parser.
@@ -673,6 +862,8 @@ bool LoadFM2(MovieData& movieData, EMUFILE* fp, int size, bool stopAfterHeader)
 	if(memcmp(buf,"version 3",9))
 		return false;
 
+	//everything up to "size" bytes goes through the reader; fp is moved to where parsing stopped before returning
+	FM2Reader in(fp, size);
 	std::string key,value;
 	enum {
 		NEWLINE, KEY, SEPARATOR, VALUE, RECORD, COMMENT, SUBTITLE
@@ -682,8 +873,7 @@ bool LoadFM2(MovieData& movieData, EMUFILE* fp, int size, bool stopAfterHeader)
 	int c;
 	for(;;)
 	{
-		if(size--<=0) goto bail;
-		c = fp->fgetc();
+		c = in.getc();
 		if(c == -1)
 			goto bail;
 		iswhitespace = (c==' '||c=='\t');
@@ -691,11 +881,16 @@ bool LoadFM2(MovieData& movieData, EMUFILE* fp, int size, bool stopAfterHeader)
 		isnewline = (c==10||c==13);
 		if(isrecchar && movieData.binaryFlag && !stopAfterHeader)
 		{
-			LoadFM2_binarychunk(movieData, fp, size);
+			int remaining = in.remaining();
+			in.sync();
+			LoadFM2_binarychunk(movieData, fp, remaining);
 			return true;
 		} else if (isnewline && static_cast<size_t>(movieData.loadFrameCount) == movieData.records.size())
+		{
 			// exit prematurely if loaded the specified amound of records
+			in.sync();
 			return true;
+		}
 		switch(state)
 		{
 		case NEWLINE:
@@ -711,13 +906,22 @@ bool LoadFM2(MovieData& movieData, EMUFILE* fp, int size, bool stopAfterHeader)
 		case RECORD:
 			{
 				dorecord:
-				if (stopAfterHeader) return true;
+				if (stopAfterHeader)
+				{
+					in.sync();
+					return true;
+				}
 				int currcount = movieData.records.size();
+				if(!currcount)
+				{
+					//the header is over, so the rest is (about) one record per line
+					if(movieData.loadFrameCount >= 0)
+						movieData.records.reserve(std::min(movieData.loadFrameCount, in.remaining() / 2));
+					else
+						movieData.records.reserve(in.estimateLines() + 1);
+				}
 				movieData.records.resize(currcount+1);
-				int preparse = fp->ftell();
-				movieData.records[currcount].parse(&movieData, fp);
-				int postparse = fp->ftell();
-				size -= (postparse-preparse);
+				movieData.records[currcount].parse(&movieData, in);
 				state = NEWLINE;
 				break;
 			}
@@ -757,6 +961,7 @@ bool LoadFM2(MovieData& movieData, EMUFILE* fp, int size, bool stopAfterHeader)
 		if(bail) break;
 	}
 
+	in.sync();
 	return true;
 }
 
@@ -854,7 +1059,7 @@ static void FinishPlayback()
 {
 	assert(movieMode != MOVIEMODE_RECORD);
 
-	extern int closeFinishedMovie;
+	extern FCEU_THREAD_LOCAL int closeFinishedMovie;
 	if (closeFinishedMovie)
 		StopPlayback();
 	else
@@ -887,7 +1092,7 @@ static void OnMovieClosed()
 #endif
 }
 
-bool bogorf;
+FCEU_THREAD_LOCAL bool bogorf;
 
 void FCEUI_StopMovie()
 {
@@ -925,7 +1130,7 @@ void poweron(bool shouldDisableBatteryLoading)
 	//if(shouldDisableBatteryLoading) disableBatteryLoading=0;
 	//suppressAddPowerCommand=0;
 
-	extern int disableBatteryLoading;
+	extern FCEU_THREAD_LOCAL int disableBatteryLoading;
 	if(!bogorf) disableBatteryLoading = 1;
 	PowerNES();
 	if(!bogorf) disableBatteryLoading = 0;
@@ -934,6 +1139,7 @@ void poweron(bool shouldDisableBatteryLoading)
 void FCEUMOV_CreateCleanMovie()
 {
 	currMovieData = MovieData();
+	TimelineReset();
 	currMovieData.palFlag = FCEUI_GetCurrentVidSystem(0,0)!=0;
 	currMovieData.romFilename = FileBase;
 	if ( GameInfo )
@@ -955,6 +1161,14 @@ void FCEUMOV_ClearCommands()
 {
 	_currCommand = 0;
 }
+int FCEUMOV_GetCommands()
+{
+	return _currCommand;
+}
+void FCEUMOV_SetCommands(int commands)
+{
+	_currCommand = commands;
+}
 
 bool FCEUMOV_FromPoweron()
 {
@@ -1041,6 +1255,7 @@ bool FCEUI_LoadMovie(const char *fname, bool _read_only, int _pauseframe)
 	//--------------
 
 	currMovieData = MovieData();
+	TimelineReset();
 
 	curMovieFilename.assign(fname);
 	FCEUFILE *fp = FCEU_fopen(fname,0,"rb",0);
@@ -1297,16 +1512,19 @@ void FCEUMOV_AddInputState()
 			{
 			case MOVIE_RECORD_MODE_OVERWRITE:
 				currMovieData.records[currFrameCounter].Clone(mr);
+				TimelineChanged(currFrameCounter);
 				break;
 			case MOVIE_RECORD_MODE_INSERT:
 				//FIXME: this could be very insufficient
 				currMovieData.records.insert(currMovieData.records.begin() + currFrameCounter, mr);
+				TimelineChanged(currFrameCounter);
 				break;
 			//case MOVIE_RECORD_MODE_TRUNCATE:
 			default:
 				//Adelikat: in normal mode, this is done at the time of loading a savestate in read+write mode
 				currMovieData.truncateAt(currFrameCounter);
 				currMovieData.records.push_back(mr);
+				TimelineChanged(currFrameCounter);
 				break;
 			}
 		else
@@ -1317,7 +1535,7 @@ void FCEUMOV_AddInputState()
 
 	currFrameCounter++;
 
-	extern uint8 joy[4];
+	extern FCEU_THREAD_LOCAL uint8 joy[4];
 	memcpy(&cur_input_display,joy,4);
 }
 
@@ -1428,9 +1646,141 @@ int CheckTimelines(MovieData& stateMovie, MovieData& currMovie)
 }
 
 
-static bool load_successful = false;
+//the movie part of savestates in the timeline format:
+//version, guid, rerecord count, the layout of records, the number of records, the number of records in the prefix
+//and its key, then the records after the prefix as MovieRecord::dumpBinary writes them.
+//The prefix is made of whole blocks of TIMELINE_BLOCK records. Every block is kept once in timelineBlocks, keyed by
+//the MD5 of the previous block's key and its packed records, so a savestate holds less than one block of records
+//and any savestate made in this session can still get its whole movie back. The keys of the blocks of
+//currMovieData are cached until a change reaches them (TimelineChanged).
+//Savestates that can outlive the session carry the movie text (chunk 7) as well, see CaptureState.
+#define TIMELINE_STATE_VERSION 2
+#define TIMELINE_STATE_HEADER_SIZE (1 + 16 + 4 + 1 + 4 + 4 + 4 + 4 + 16)
+#define TIMELINE_BLOCK 1024
 
-bool FCEUMOV_ReadState(EMUFILE* is, uint32 size)
+struct TimelineKey
+{
+	uint8 md5[16];
+	bool operator<(const TimelineKey& other) const { return memcmp(md5, other.md5, 16) < 0; }
+	bool operator==(const TimelineKey& other) const { return !memcmp(md5, other.md5, 16); }
+};
+
+struct TimelineBlock
+{
+	TimelineKey prev;
+	std::vector<uint8> packed;
+};
+
+static FCEU_THREAD_LOCAL_OBJECT std::map<TimelineKey, TimelineBlock> timelineBlocks;
+//keys of the first blocks of currMovieData, for the movie and record layout in timelineGuid and timelineLayout
+static FCEU_THREAD_LOCAL_OBJECT std::vector<TimelineKey> timelineKeys;
+static FCEU_THREAD_LOCAL_OBJECT FCEU_Guid timelineGuid;
+static FCEU_THREAD_LOCAL int timelineLayout = -1;
+
+static int TimelineLayout(MovieData& movieData)
+{
+	return (movieData.fourscore ? 1 : 0) | (movieData.ports[0] << 1) | (movieData.ports[1] << 9);
+}
+
+//the records of currMovieData from frame on have changed
+static void TimelineChanged(int frame)
+{
+	size_t keep = (frame > 0) ? frame / TIMELINE_BLOCK : 0;
+	if (timelineKeys.size() > keep)
+		timelineKeys.resize(keep);
+}
+
+//another movie: the blocks of the old one are no use any more
+static void TimelineReset()
+{
+	timelineKeys.clear();
+	timelineBlocks.clear();
+}
+
+//key of the first "blocks" blocks of currMovieData, storing the blocks that are not in timelineBlocks yet
+static TimelineKey TimelinePrefixKey(int blocks)
+{
+	if (timelineGuid != currMovieData.guid || timelineLayout != TimelineLayout(currMovieData))
+	{
+		timelineKeys.clear();
+		timelineGuid = currMovieData.guid;
+		timelineLayout = TimelineLayout(currMovieData);
+	}
+
+	int blockSize = TIMELINE_BLOCK * BinaryRecordSize(currMovieData);
+	while ((int)timelineKeys.size() < blocks)
+	{
+		TimelineBlock block;
+		if (timelineKeys.empty())
+			memset(block.prev.md5, 0, 16);
+		else
+			block.prev = timelineKeys.back();
+		block.packed.resize(blockSize);
+		PackBinaryRecords(currMovieData, (int)timelineKeys.size() * TIMELINE_BLOCK, TIMELINE_BLOCK, &block.packed[0]);
+
+		TimelineKey key;
+		md5_context ctx;
+		md5_starts(&ctx);
+		md5_update(&ctx, block.prev.md5, 16);
+		md5_update(&ctx, &block.packed[0], blockSize);
+		md5_finish(&ctx, key.md5);
+
+		if (timelineBlocks.find(key) == timelineBlocks.end())
+			timelineBlocks[key] = block;
+		timelineKeys.push_back(key);
+	}
+
+	TimelineKey key;
+	if (blocks)
+		key = timelineKeys[blocks - 1];
+	else
+		memset(key.md5, 0, 16);
+	return key;
+}
+
+//the packed records of the prefix the key stands for, or false if any of its blocks is unknown
+static bool TimelinePrefixRecords(TimelineKey key, int blocks, int blockSize, std::vector<uint8>& out)
+{
+	out.resize((size_t)blocks * blockSize);
+	for (int i = blocks - 1; i >= 0; i--)
+	{
+		std::map<TimelineKey, TimelineBlock>::iterator block = timelineBlocks.find(key);
+		if (block == timelineBlocks.end() || (int)block->second.packed.size() != blockSize)
+			return false;
+		memcpy(&out[(size_t)i * blockSize], &block->second.packed[0], blockSize);
+		key = block->second.prev;
+	}
+	return true;
+}
+
+int FCEUMOV_WriteTimelineState(EMUFILE* os)
+{
+	if(!(movieMode == MOVIEMODE_RECORD || movieMode == MOVIEMODE_PLAY || movieMode == MOVIEMODE_FINISHED))
+		return 0;
+
+	int count = currMovieData.getNumRecords();
+	int prefix = count / TIMELINE_BLOCK * TIMELINE_BLOCK;
+	TimelineKey key = TimelinePrefixKey(prefix / TIMELINE_BLOCK);
+	int tailSize = (count - prefix) * BinaryRecordSize(currMovieData);
+	std::vector<uint8> packed(std::max(tailSize, 1));
+	PackBinaryRecords(currMovieData, prefix, count - prefix, &packed[0]);
+
+	write8le((uint8)TIMELINE_STATE_VERSION, os);
+	os->fwrite(currMovieData.guid.data, 16);
+	write32le(currMovieData.rerecordCount, os);
+	write8le((uint8)(currMovieData.fourscore ? 1 : 0), os);
+	write32le(currMovieData.ports[0], os);
+	write32le(currMovieData.ports[1], os);
+	write32le(count, os);
+	write32le(prefix, os);
+	os->fwrite(key.md5, 16);
+	os->fwrite(&packed[0], tailSize);
+	return TIMELINE_STATE_HEADER_SIZE + tailSize;
+}
+
+static FCEU_THREAD_LOCAL bool load_successful = false;
+
+static void PrepareStateMovieLoad(void)
 {
 	load_successful = false;
 
@@ -1455,21 +1805,12 @@ bool FCEUMOV_ReadState(EMUFILE* is, uint32 size)
 			movie_readonly = true;
 		}
 	}
+}
 
-	MovieData tempMovieData = MovieData();
-	std::ios::pos_type curr = is->ftell();
-	if(!LoadFM2(tempMovieData, is, size, false)) {
-		is->fseek((uint32)curr+size,SEEK_SET);
-		extern bool FCEU_state_loading_old_format;
-		if(FCEU_state_loading_old_format) {
-			if(movieMode == MOVIEMODE_PLAY || movieMode == MOVIEMODE_RECORD || movieMode == MOVIEMODE_FINISHED) {
-				//FCEUI_StopMovie();  //No reason to stop the movie, nothing destructive has happened yet.
-				FCEU_PrintError("You have tried to use an old savestate while playing a movie. This is unsupported (since the old savestate has old-format movie data in it which can't be converted on the fly)");
-			}
-		}
-		return false;
-	}
-
+//stateLength is the number of records in the savestate's movie; if recordsInCurrent is set, they are the same as
+//the first records of currMovieData and stateMovie only holds the guid and the rerecord count
+static bool LoadStateMovie(MovieData& stateMovie, int stateLength, bool recordsInCurrent)
+{
 	//----------------
 	//complex TAS logic for loadstate
 	//fully conforms to the savestate logic documented in the Laws of TAS
@@ -1523,11 +1864,11 @@ bool FCEUMOV_ReadState(EMUFILE* is, uint32 size)
 	if(movieMode == MOVIEMODE_PLAY || movieMode == MOVIEMODE_RECORD || movieMode == MOVIEMODE_FINISHED)
 	{
 		//handle moviefile mismatch
-		if(tempMovieData.guid != currMovieData.guid)
+		if(stateMovie.guid != currMovieData.guid)
 		{
 			//mbg 8/18/08 - this code  can be used to turn the error message into an OK/CANCEL
 			#ifdef __WIN_DRIVER__
-				std::string msg = "There is a mismatch between savestate's movie and current movie.\ncurrent: " + currMovieData.guid.toString() + "\nsavestate: " + tempMovieData.guid.toString() + "\n\nThis means that you have loaded a savestate belonging to a different movie than the one you are playing now.\n\nContinue loading this savestate anyway?";
+				std::string msg = "There is a mismatch between savestate's movie and current movie.\ncurrent: " + currMovieData.guid.toString() + "\nsavestate: " + stateMovie.guid.toString() + "\n\nThis means that you have loaded a savestate belonging to a different movie than the one you are playing now.\n\nContinue loading this savestate anyway?";
 				int result = MessageBox(hAppWnd, msg.c_str(), "Error loading savestate", MB_OKCANCEL);
 				if(result == IDCANCEL)
 				{
@@ -1542,11 +1883,11 @@ bool FCEUMOV_ReadState(EMUFILE* is, uint32 size)
 			#else
 				if (!backupSavestates) //If backups are disabled we can just resume normally since we can't restore so stop movie and inform user
 				{
-					FCEU_PrintError("Mismatch between savestate's movie and current movie.\ncurrent: %s\nsavestate: %s\nUnable to restore backup, movie playback stopped.\n",currMovieData.guid.toString().c_str(),tempMovieData.guid.toString().c_str());
+					FCEU_PrintError("Mismatch between savestate's movie and current movie.\ncurrent: %s\nsavestate: %s\nUnable to restore backup, movie playback stopped.\n",currMovieData.guid.toString().c_str(),stateMovie.guid.toString().c_str());
 					FCEUI_StopMovie();
 				}
 				else
-				FCEU_PrintError("Mismatch between savestate's movie and current movie.\ncurrent: %s\nsavestate: %s\n",currMovieData.guid.toString().c_str(),tempMovieData.guid.toString().c_str());
+				FCEU_PrintError("Mismatch between savestate's movie and current movie.\ncurrent: %s\nsavestate: %s\n",currMovieData.guid.toString().c_str(),stateMovie.guid.toString().c_str());
 
 				return false;
 			#endif
@@ -1562,7 +1903,7 @@ bool FCEUMOV_ReadState(EMUFILE* is, uint32 size)
 			}
 
 			// currFrameCounter at this point represents the savestate framecount
-			int frame_of_mismatch = CheckTimelines(tempMovieData, currMovieData);
+			int frame_of_mismatch = recordsInCurrent ? -1 : CheckTimelines(stateMovie, currMovieData);
 			if (frame_of_mismatch >= 0)
 			{
 				// Wrong timeline, do apprioriate logic here
@@ -1573,19 +1914,19 @@ bool FCEUMOV_ReadState(EMUFILE* is, uint32 size)
 				} else
 					FCEU_PrintError("Error: Savestate not in the same timeline as movie!\nFrame %d branches from current timeline", frame_of_mismatch);
 				return false;
-			} else if ((int)tempMovieData.records.size() < currFrameCounter)
+			} else if (stateLength < currFrameCounter)
 			{
 				// this is post-movie savestate and must be checked further
-				if (tempMovieData.records.size() < currMovieData.records.size())
+				if (stateLength < currMovieData.getNumRecords())
 				{
 					// this savestate doesn't contain enough input to be checked
 					//TODO: turn frame counter to red to get attention
 					if (!backupSavestates)	//If backups are disabled we can just resume normally since we can't restore so stop movie and inform user
 					{
-						FCEU_PrintError("Error: Savestate taken from a frame (%d) after the final frame in the savestated movie (%zi) cannot be verified against current movie (%zi). This is not permitted.\nUnable to restore backup, movie playback stopped.", currFrameCounter, tempMovieData.records.size() - 1, currMovieData.records.size() - 1);
+						FCEU_PrintError("Error: Savestate taken from a frame (%d) after the final frame in the savestated movie (%d) cannot be verified against current movie (%d). This is not permitted.\nUnable to restore backup, movie playback stopped.", currFrameCounter, stateLength - 1, currMovieData.getNumRecords() - 1);
 						FCEUI_StopMovie();
 					} else
-						FCEU_PrintError("Savestate taken from a frame (%d) after the final frame in the savestated movie (%zi) cannot be verified against current movie (%zi). This is not permitted.", currFrameCounter, tempMovieData.records.size() - 1, currMovieData.records.size() - 1);
+						FCEU_PrintError("Savestate taken from a frame (%d) after the final frame in the savestated movie (%d) cannot be verified against current movie (%d). This is not permitted.", currFrameCounter, stateLength - 1, currMovieData.getNumRecords() - 1);
 					return false;
 				}
 			}
@@ -1601,23 +1942,42 @@ bool FCEUMOV_ReadState(EMUFILE* is, uint32 size)
 			//Read+Write mode
 			closeRecordingMovie();
 
-			if (currFrameCounter > (int)tempMovieData.records.size())
+			if (currFrameCounter > stateLength)
 			{
 				//This is a post movie savestate, handle it differently
 				//Replace movie contents but then switch to movie finished mode
-				currMovieData = tempMovieData;
+				if (recordsInCurrent)
+				{
+					currMovieData.truncateAt(stateLength);
+					currMovieData.rerecordCount = stateMovie.rerecordCount;
+					TimelineChanged(stateLength);
+				} else
+				{
+					currMovieData = stateMovie;
+					TimelineChanged(0);
+				}
 				movieMode = MOVIEMODE_PLAY;
 				FCEUMOV_IncrementRerecordCount();
 				RedumpWholeMovieFile();
 				FinishPlayback();
 			} else
 			{
-				//truncate before we copy, just to save some time, unless the user selects a full copy option
-				if (!fullSaveStateLoads)
-					//we can only assume this here since we have checked that the frame counter is not greater than the movie data
-					tempMovieData.truncateAt(currFrameCounter);
-				
-				currMovieData = tempMovieData;
+				if (recordsInCurrent)
+				{
+					//the records are already there, only cut off the ones after the savestate's movie or its frame
+					currMovieData.truncateAt(fullSaveStateLoads ? stateLength : currFrameCounter);
+					currMovieData.rerecordCount = stateMovie.rerecordCount;
+					TimelineChanged(fullSaveStateLoads ? stateLength : currFrameCounter);
+				} else
+				{
+					//truncate before we copy, just to save some time, unless the user selects a full copy option
+					if (!fullSaveStateLoads)
+						//we can only assume this here since we have checked that the frame counter is not greater than the movie data
+						stateMovie.truncateAt(currFrameCounter);
+					
+					currMovieData = stateMovie;
+					TimelineChanged(0);
+				}
 				movieMode = MOVIEMODE_RECORD;
 				FCEUMOV_IncrementRerecordCount();
 				RedumpWholeMovieFile(true);
@@ -1630,6 +1990,105 @@ bool FCEUMOV_ReadState(EMUFILE* is, uint32 size)
 	return true;
 }
 
+bool FCEUMOV_ReadState(EMUFILE* is, uint32 size)
+{
+	PrepareStateMovieLoad();
+
+	MovieData tempMovieData = MovieData();
+	std::ios::pos_type curr = is->ftell();
+	if(!LoadFM2(tempMovieData, is, size, false)) {
+		is->fseek((uint32)curr+size,SEEK_SET);
+		extern FCEU_THREAD_LOCAL bool FCEU_state_loading_old_format;
+		if(FCEU_state_loading_old_format) {
+			if(movieMode == MOVIEMODE_PLAY || movieMode == MOVIEMODE_RECORD || movieMode == MOVIEMODE_FINISHED) {
+				//FCEUI_StopMovie();  //No reason to stop the movie, nothing destructive has happened yet.
+				FCEU_PrintError("You have tried to use an old savestate while playing a movie. This is unsupported (since the old savestate has old-format movie data in it which can't be converted on the fly)");
+			}
+		}
+		return false;
+	}
+
+	return LoadStateMovie(tempMovieData, tempMovieData.getNumRecords(), false);
+}
+
+bool FCEUMOV_ReadTimelineState(EMUFILE* is, uint32 size, bool& unavailable)
+{
+	unavailable = false;
+	PrepareStateMovieLoad();
+
+	uint32 end = is->ftell() + size;
+	uint8 version = 0, fourscore = 0;
+	FCEU_Guid guid;
+	int rerecordCount = 0, ports[2] = {0, 0}, count = 0, prefix = 0;
+	TimelineKey key;
+	if (size < TIMELINE_STATE_HEADER_SIZE
+		|| !read8le(&version, is) || version != TIMELINE_STATE_VERSION
+		|| is->fread(guid.data, 16) != 16
+		|| !read32le(&rerecordCount, is)
+		|| !read8le(&fourscore, is)
+		|| !read32le(&ports[0], is)
+		|| !read32le(&ports[1], is)
+		|| !read32le(&count, is)
+		|| !read32le(&prefix, is)
+		|| is->fread(key.md5, 16) != 16
+		|| count < 0 || prefix < 0 || prefix > count || prefix % TIMELINE_BLOCK)
+	{
+		is->fseek(end, SEEK_SET);
+		return false;
+	}
+
+	MovieData stateMovie = MovieData();
+	bool recordsInCurrent = false;
+	if(movieMode == MOVIEMODE_PLAY || movieMode == MOVIEMODE_RECORD || movieMode == MOVIEMODE_FINISHED)
+	{
+		//the rest of the movie header is the current one's
+		std::vector<MovieRecord> currRecords;
+		currRecords.swap(currMovieData.records);
+		stateMovie = currMovieData;
+		currMovieData.records.swap(currRecords);
+		stateMovie.fourscore = (fourscore != 0);
+		stateMovie.ports[0] = ports[0];
+		stateMovie.ports[1] = ports[1];
+
+		int recordsize = BinaryRecordSize(stateMovie);
+		uint32 tailSize = (count - prefix) * recordsize;
+		std::vector<uint8> packed(std::max<uint32>(tailSize, 1));
+		if (size - TIMELINE_STATE_HEADER_SIZE < tailSize || is->fread(&packed[0], tailSize) != tailSize)
+		{
+			is->fseek(end, SEEK_SET);
+			return false;
+		}
+
+		//compare the records to the beginning of the current movie first
+		if (TimelineLayout(currMovieData) == TimelineLayout(stateMovie) && currMovieData.getNumRecords() >= count
+			&& TimelinePrefixKey(prefix / TIMELINE_BLOCK) == key)
+		{
+			std::vector<uint8> currTail(std::max<uint32>(tailSize, 1));
+			PackBinaryRecords(currMovieData, prefix, count - prefix, &currTail[0]);
+			recordsInCurrent = !memcmp(&packed[0], &currTail[0], tailSize);
+		}
+		if (!recordsInCurrent)
+		{
+			//another timeline, so the records are needed
+			std::vector<uint8> records;
+			if (!TimelinePrefixRecords(key, prefix / TIMELINE_BLOCK, TIMELINE_BLOCK * recordsize, records))
+			{
+				//the caller falls back to the movie text (chunk 7) if the state has it
+				unavailable = true;
+				is->fseek(end, SEEK_SET);
+				return false;
+			}
+			records.insert(records.end(), packed.begin(), packed.begin() + tailSize);
+			UnpackBinaryRecords(stateMovie, records.empty() ? NULL : &records[0], count);
+		}
+	}
+	stateMovie.guid = guid;
+	stateMovie.rerecordCount = rerecordCount;
+	is->fseek(end, SEEK_SET);
+
+	return LoadStateMovie(stateMovie, count, recordsInCurrent);
+}
+
 void FCEUMOV_PreLoad(void)
 {
 	load_successful=0;
@@ -1774,7 +2233,7 @@ void FCEUI_MovieToggleRecording()
 		RedumpWholeMovieFile(true);
 		if (currFrameCounter >= (int)currMovieData.records.size())
 		{
-			extern int closeFinishedMovie;
+			extern FCEU_THREAD_LOCAL int closeFinishedMovie;
 			if (closeFinishedMovie)
 			{
 				movieMode = MOVIEMODE_INACTIVE;
@@ -1806,6 +2265,7 @@ void FCEUI_MovieInsertFrame()
 		strcat(message, GetMovieModeStr());
 		std::vector<MovieRecord>::iterator iter = currMovieData.records.begin();
 		currMovieData.records.insert(iter + currFrameCounter, MovieRecord());
+		TimelineChanged(currFrameCounter);
 		FCEUMOV_IncrementRerecordCount();
 		RedumpWholeMovieFile();
 	} else
@@ -1832,12 +2292,13 @@ void FCEUI_MovieDeleteFrame()
 		strcpy(message, "1 frame deleted");
 		std::vector<MovieRecord>::iterator iter = currMovieData.records.begin();
 		currMovieData.records.erase(iter + currFrameCounter);
+		TimelineChanged(currFrameCounter);
 		FCEUMOV_IncrementRerecordCount();
 		RedumpWholeMovieFile();
 
 		if (movieMode != MOVIEMODE_RECORD && currFrameCounter >= (int)currMovieData.records.size())
 		{
-			extern int closeFinishedMovie;
+			extern FCEU_THREAD_LOCAL int closeFinishedMovie;
 			if (closeFinishedMovie)
 			{
 				movieMode = MOVIEMODE_INACTIVE;
@@ -1869,12 +2330,13 @@ void FCEUI_MovieTruncate()
 	{
 		strcpy(message, "Movie truncated");
 		currMovieData.truncateAt(currFrameCounter);
+		TimelineChanged(currFrameCounter);
 		FCEUMOV_IncrementRerecordCount();
 		RedumpWholeMovieFile();
 
 		if (movieMode != MOVIEMODE_RECORD)
 		{
-			extern int closeFinishedMovie;
+			extern FCEU_THREAD_LOCAL int closeFinishedMovie;
 			if (closeFinishedMovie)
 			{
 				movieMode = MOVIEMODE_INACTIVE;
@@ -102,6 +102,8 @@ void FCEUI_SetLagFlag(bool value);
 
 int FCEUMOV_WriteState(EMUFILE* os);
 bool FCEUMOV_ReadState(EMUFILE* is, uint32 size);
+int FCEUMOV_WriteTimelineState(EMUFILE* os);
+bool FCEUMOV_ReadTimelineState(EMUFILE* is, uint32 size, bool& unavailable);
 void FCEUMOV_PreLoad();
 bool FCEUMOV_PostLoad();
 void FCEUMOV_IncrementRerecordCount();
@@ -110,8 +112,11 @@ bool FCEUMOV_FromPoweron();
 
 void FCEUMOV_CreateCleanMovie();
 void FCEUMOV_ClearCommands();
+int FCEUMOV_GetCommands();
+void FCEUMOV_SetCommands(int commands);
 
 class MovieData;
+class FM2Reader;
 class MovieRecord
 {
 
@@ -166,11 +171,10 @@ public:
 	void Clone(MovieRecord& sourceRec);
 	void clear();
 
-	void parse(MovieData* md, EMUFILE* is);
-	bool parseBinary(MovieData* md, EMUFILE* is);
+	void parse(MovieData* md, FM2Reader& in);
 	void dump(MovieData* md, EMUFILE* os, int index);
 	void dumpBinary(MovieData* md, EMUFILE* os, int index);
-	void parseJoy(EMUFILE* is, uint8& joystate);
+	void parseJoy(FM2Reader& in, uint8& joystate);
 	void dumpJoy(EMUFILE* os, uint8 joystate);
 
 	static const char mnemonics[8];
@@ -273,17 +277,17 @@ private:
 	}
 };
 
-extern EMOVIEMODE movieMode;
-extern MovieData currMovieData;
-extern int currFrameCounter;
-extern std::string curMovieFilename;
-extern bool subtitlesOnAVI;
-extern bool freshMovie;
-extern bool movie_readonly;
-extern bool autoMovieBackup;
-extern bool fullSaveStateLoads;
-extern int movieRecordMode;
-extern int input_display;
+extern FCEU_THREAD_LOCAL EMOVIEMODE movieMode;
+extern FCEU_THREAD_LOCAL_OBJECT MovieData currMovieData;
+extern FCEU_THREAD_LOCAL int currFrameCounter;
+extern FCEU_THREAD_LOCAL_OBJECT std::string curMovieFilename;
+extern FCEU_THREAD_LOCAL bool subtitlesOnAVI;
+extern FCEU_THREAD_LOCAL bool freshMovie;
+extern FCEU_THREAD_LOCAL bool movie_readonly;
+extern FCEU_THREAD_LOCAL bool autoMovieBackup;
+extern FCEU_THREAD_LOCAL bool fullSaveStateLoads;
+extern FCEU_THREAD_LOCAL int movieRecordMode;
+extern FCEU_THREAD_LOCAL int input_display;
 
 //--------------------------------------------------
 void FCEUI_MakeBackupMovie(bool dispMessage);
@@ -51,13 +51,13 @@
 
 static const int FIXED_EXWRAM_SIZE = 32768+8192;
 
-static uint8 SongReload;
-static int32 CurrentSong;
+static FCEU_THREAD_LOCAL uint8 SongReload;
+static FCEU_THREAD_LOCAL int32 CurrentSong;
 
 static DECLFW(NSF_write);
 static DECLFR(NSF_read);
 
-static int vismode=1; //we cant consider this state, because the UI may be controlling it and wouldnt know we loadstated it
+static FCEU_THREAD_LOCAL int vismode=1; //we cant consider this state, because the UI may be controlling it and wouldnt know we loadstated it
 
 //mbg 7/31/06 todo - no reason this couldnt be assembled on the fly from actual asm source code. thatd be less obscure.
 //here it is disassembled, for reference
@@ -80,7 +80,7 @@ static int vismode=1; //we cant consider this state, because the UI may be contr
 00:8023:18        CLC
 00:8024:90 FE     BCC $8024
 */
-static uint8 NSFROM[0x30+6]=
+static FCEU_THREAD_LOCAL uint8 NSFROM[0x30+6]=
 {
 	/* 0x00 - NMI */
 	0x8D,0xF4,0x3F,       /* Stop play routine NMIs. */
@@ -111,23 +111,23 @@ static DECLFR(NSFROMRead)
 	return (NSFROM-0x3800)[A];
 }
 
-static uint8 doreset=0; //state
-static uint8 NSFNMIFlags; //state
-uint8 *NSFDATA=0; //configration, loaded from rom?
-int NSFMaxBank; //configuration
+static FCEU_THREAD_LOCAL uint8 doreset=0; //state
+static FCEU_THREAD_LOCAL uint8 NSFNMIFlags; //state
+FCEU_THREAD_LOCAL uint8 *NSFDATA=0; //configration, loaded from rom?
+FCEU_THREAD_LOCAL int NSFMaxBank; //configuration
 
-static int32 NSFSize; //configuration
-static uint8 BSon; //configuration
-static uint8 BankCounter; //configuration
+static FCEU_THREAD_LOCAL int32 NSFSize; //configuration
+static FCEU_THREAD_LOCAL uint8 BSon; //configuration
+static FCEU_THREAD_LOCAL uint8 BankCounter; //configuration
 
-static uint16 PlayAddr; //configuration
-static uint16 InitAddr; //configuration
-static uint16 LoadAddr; //configuration
+static FCEU_THREAD_LOCAL uint16 PlayAddr; //configuration
+static FCEU_THREAD_LOCAL uint16 InitAddr; //configuration
+static FCEU_THREAD_LOCAL uint16 LoadAddr; //configuration
 
-NSF_HEADER NSFHeader; //mbg merge 6/29/06 - needs to be global
+FCEU_THREAD_LOCAL NSF_HEADER NSFHeader; //mbg merge 6/29/06 - needs to be global
 
 void NSFMMC5_Close(void);
-static uint8 *ExWRAM=0;
+static FCEU_THREAD_LOCAL uint8 *ExWRAM=0;
 
 void NSFGI(GI h)
 {
@@ -269,7 +269,7 @@ int NSFLoad(const char *name, FCEUFILE *fp)
 	FCEU_printf(" Name:       %s\n Artist:     %s\n Copyright:  %s\n\n",NSFHeader.SongName,NSFHeader.Artist,NSFHeader.Copyright);
 	if(NSFHeader.SoundChip)
 	{
-		static const char *tab[6]={"Konami VRCVI","Konami VRCVII","Nintendo FDS","Nintendo MMC5","Namco 106","Sunsoft FME-07"};
+		static FCEU_THREAD_LOCAL const char *tab[6]={"Konami VRCVI","Konami VRCVII","Nintendo FDS","Nintendo MMC5","Namco 106","Sunsoft FME-07"};
 
 		for(x=0;x<6;x++)
 			if(NSFHeader.SoundChip&(1<<x))
@@ -319,7 +319,7 @@ void NSFN106_Init(void);
 void NSFAY_Init(void);
 
 //zero 17-apr-2013 - added
-static SFORMAT StateRegs[] = {
+static FCEU_THREAD_LOCAL_OBJECT SFORMAT StateRegs[] = {
 	{&SongReload, 1, "SREL"},
 	{&CurrentSong, 4 | FCEUSTATE_RLSB, "CURS"},
 	{&doreset, 1, "DORE"},
@@ -442,6 +442,7 @@ static DECLFR(NSF_read)
 		if(!fceuindbg)
 		{
 			memset(RAM,0x00,0x800);
+			memset(RAMDirtyPages,1,sizeof(RAMDirtyPages));
 
 			BWrite[0x4015](0x4015,0x0);
 			for(x=0;x<0x14;x++)
@@ -479,7 +480,7 @@ static DECLFR(NSF_read)
 
 uint8 FCEU_GetJoyJoy(void);
 
-static int special=0;
+static FCEU_THREAD_LOCAL int special=0;
 
 void DrawNSF(uint8 *XBuf)
 {
@@ -530,7 +531,7 @@ void DrawNSF(uint8 *XBuf)
 		}
 		else if(special==2)
 		{
-			static double theta=0;
+			static FCEU_THREAD_LOCAL double theta=0;
 			if(FSettings.SoundVolume)
 				mul=8192*240/(16384*FSettings.SoundVolume/50);
 			for(x=0;x<128;x++)
@@ -585,7 +586,7 @@ void DrawNSF(uint8 *XBuf)
 	DrawTextTrans(XBuf+82*256+4+(((31-strlen(snbuf))<<2)), 256, (uint8*)snbuf, kFgColor);
 
 	{
-		static uint8 last=0;
+		static FCEU_THREAD_LOCAL uint8 last=0;
 		uint8 tmp;
 		tmp=FCEU_GetJoyJoy();
 		if((tmp&JOY_RIGHT) && !(last&JOY_RIGHT))
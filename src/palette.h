@@ -2,7 +2,7 @@ typedef struct {
 	uint8 r,g,b;
 } pal;
 
-extern pal *palo;
+extern FCEU_THREAD_LOCAL pal *palo;
 void FCEU_ResetPalette(void);
 
 void FCEU_ResetPalette(void);
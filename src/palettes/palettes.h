@@ -7,21 +7,21 @@
 //this assumes the color is already shifted <<2, as it is in these cases
 #define P64RPC(x) ( ((x)&~3) | (((x)>>6)&3))
 
-pal rp2c04001[512] = {
+FCEU_THREAD_LOCAL pal rp2c04001[512] = {
  #include "rp2c04001.h"
 	EMPTY_PALETTE_DEEMPH_X_7
 };
 
-pal rp2c04002[512] = {
+FCEU_THREAD_LOCAL pal rp2c04002[512] = {
  #include "rp2c04002.h"
 	EMPTY_PALETTE_DEEMPH_X_7
 };
 
-pal rp2c04003[512] = {
+FCEU_THREAD_LOCAL pal rp2c04003[512] = {
  #include "rp2c04003.h"
 	EMPTY_PALETTE_DEEMPH_X_7
 };
-pal rp2c05004[512] = {
+FCEU_THREAD_LOCAL pal rp2c05004[512] = {
  #include "rp2c05004.h"
 	EMPTY_PALETTE_DEEMPH_X_7
 };
@@ -29,7 +29,7 @@ pal rp2c05004[512] = {
 #undef P64RPC
 
 // Fixed palette entries used by the GUI
-pal palette_unvarying[] = {
+FCEU_THREAD_LOCAL pal palette_unvarying[] = {
 { 0x00,0x00,0x00}, //  0 = Black
 { 0xFF,0xFF,0xD3}, //  1 = White
 { 0x00,0x00,0x00}, //  2 = Black
@@ -60,7 +60,7 @@ pal palette_unvarying[] = {
 #define P64(x) (((x)<<2)|((x>>4)&3))
 
 // Default palette 
-pal palette[512] = {
+FCEU_THREAD_LOCAL pal palette[512] = {
 	{ P64(0x1D), P64(0x1D), P64(0x1D)}, /* Value 0 */
 	{ P64(0x09), P64(0x06), P64(0x23)}, /* Value 1 */
 	{ P64(0x00), P64(0x00), P64(0x2A)}, /* Value 2 */
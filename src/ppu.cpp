@@ -40,6 +40,30 @@
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
+#include <unordered_map>
+
+//Background tiles without mapper hooks can have their palette lookups done
+//with a byte shuffle: pshufb on x86 CPUs with SSSE3 (checked at run time)
+//and tbl on 64 bit ARM, which always has it.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PPU_TILE_SIMD
+#define PPU_TILE_TARGET __attribute__((target("ssse3")))
+#include <tmmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PPU_TILE_SIMD
+#define PPU_TILE_TARGET
+#include <arm_neon.h>
+#endif
+
+//Sprite evaluation and the sprite merge use SSE2 or NEON, which every CPU
+//these targets build for has.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PPU_SPRITE_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PPU_SPRITE_NEON
+#include <arm_neon.h>
+#endif
 
 #define VBlankON    (PPU[0] & 0x80)	//Generate VBlank NMI
 #define Sprite16    (PPU[0] & 0x20)	//Sprites 8x16/8x8
@@ -67,13 +91,42 @@ static void RefreshSprites(void);
 static void CopySprites(uint8 *target);
 
 static void Fixit1(void);
-static uint32 ppulut1[256];
-static uint32 ppulut2[256];
-static uint32 ppulut3[128];
+static FCEU_THREAD_LOCAL uint32 ppulut1[256];
+static FCEU_THREAD_LOCAL uint32 ppulut2[256];
+static FCEU_THREAD_LOCAL uint32 ppulut3[128];
+
+#ifdef PPU_TILE_SIMD
+static FCEU_THREAD_LOCAL bool ppuTileSIMD = false;
+
+static bool PPU_TileSIMDSupported(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("ssse3");
+#else
+	return true;
+#endif
+}
 
-static bool new_ppu_reset = false;
+//Writes the 8 pixels of a tile row.  pixdata holds their palette indices,
+//one nibble each, first pixel in the low nibble.
+static INLINE PPU_TILE_TARGET void PPU_PutTile(uint8 *P, const uint8 *S, uint32 pixdata) {
+#if defined(__x86_64__) || defined(__i386__)
+	__m128i nib = _mm_cvtsi32_si128(pixdata);
+	__m128i mask = _mm_set1_epi8(0x0F);
+	__m128i idx = _mm_unpacklo_epi8(_mm_and_si128(nib, mask), _mm_and_si128(_mm_srli_epi16(nib, 4), mask));
+	__m128i pal = _mm_loadu_si128((const __m128i *)S);
+	_mm_storel_epi64((__m128i *)P, _mm_shuffle_epi8(pal, idx));
+#else
+	uint8x8_t nib = vcreate_u8(pixdata);
+	uint8x8_t idx = vzip1_u8(vand_u8(nib, vdup_n_u8(0x0F)), vshr_n_u8(nib, 4));
+	vst1_u8(P, vqtbl1_u8(vld1q_u8(S), idx));
+#endif
+}
+#endif
 
-int test = 0;
+static FCEU_THREAD_LOCAL bool new_ppu_reset = false;
+
+FCEU_THREAD_LOCAL int test = 0;
 
 template<typename T, int BITS>
 struct BITREVLUT {
@@ -102,7 +155,7 @@ struct BITREVLUT {
 		return lut[index];
 	}
 };
-BITREVLUT<uint8, 8> bitrevlut;
+FCEU_THREAD_LOCAL_OBJECT BITREVLUT<uint8, 8> bitrevlut;
 
 struct PPUSTATUS {
 	int32 sl;
@@ -138,16 +191,16 @@ struct SPRITE_READ {
 };
 
 //doesn't need to be savestated as it is just a reflection of the current position in the ppu loop
-PPUPHASE ppuphase;
+FCEU_THREAD_LOCAL PPUPHASE ppuphase;
 
 //this needs to be savestated since a game may be trying to read from this across vblanks
-SPRITE_READ spr_read;
+FCEU_THREAD_LOCAL SPRITE_READ spr_read;
 
 //definitely needs to be savestated
-uint8 idleSynch = 1;
+FCEU_THREAD_LOCAL uint8 idleSynch = 1;
 
 //uses the internal counters concept at http://nesdev.icequake.net/PPU%20addressing.txt
-struct PPUREGS {
+FCEU_THREAD_LOCAL struct PPUREGS {
 	//normal clocked regs. as the game can interfere with these at any time, they need to be savestated
 	uint32 fv;	//3
 	uint32 v;	//1
@@ -322,60 +375,141 @@ static void makeppulut(void) {
 	}
 }
 
-static int ppudead = 1;
-static int kook = 0;
-int fceuindbg = 0;
+//Decoded pattern data for the debugger views.  Each 1K page of CHR memory
+//that has been asked for is kept with every tile row turned into 8 nibbles
+//the way ppulut1/ppulut2 build them, keyed by the page's address so banks
+//mapped into several slots share one copy.  Writes through the PPU mark the
+//page stale, bank switches forget the slot's page; power, reset and savestate
+//loads drop everything.  Only the debugger views read it.
+struct CHRCachePage {
+	uint32 rows[0x400 / 16 * 8];
+	bool valid;
+};
+
+static FCEU_THREAD_LOCAL_OBJECT std::unordered_map<const uint8 *, CHRCachePage> chrCache;
+
+//the page each pattern table slot was last looked up for, cleared by
+//FCEUPPU_InvalidateCHRSlots whenever the slot is remapped
+static FCEU_THREAD_LOCAL CHRCachePage *chrSlotPage[8];
+
+static CHRCachePage *PPU_CHRCachePage(int slot) {
+	if (!chrSlotPage[slot])
+		chrSlotPage[slot] = &chrCache[VPage[slot] + (slot << 10)];
+
+	CHRCachePage *page = chrSlotPage[slot];
+
+	if (!page->valid) {
+		const uint8 *C = VPage[slot] + (slot << 10);
+
+		for (int t = 0; t < 0x400; t += 16, C += 16)
+			for (int y = 0; y < 8; y++)
+				page->rows[(t >> 1) | y] = ppulut1[C[y]] | ppulut2[C[y + 8]];
+		page->valid = true;
+	}
+	return page;
+}
+
+const uint32 *FCEUPPU_GetDecodedTile(uint32 A) {
+	A &= 0x1FF0;
+	return PPU_CHRCachePage(A >> 10)->rows + ((A & 0x3F0) >> 1);
+}
+
+void FCEUPPU_InvalidateCHR(uint32 A) {
+	int slot = (A >> 10) & 7;
+
+	FCEUSS_MarkDirty(VPage[slot] + (A & 0x1FFF));
+
+	if (chrCache.empty())
+		return;
+
+	if (chrSlotPage[slot]) {
+		chrSlotPage[slot]->valid = false;
+		return;
+	}
+
+	std::unordered_map<const uint8 *, CHRCachePage>::iterator page = chrCache.find(VPage[slot] + (slot << 10));
+
+	if (page != chrCache.end())
+		page->second.valid = false;
+}
+
+//Nametable memory can be CHR RAM on some boards.
+void FCEUPPU_InvalidateNametable(uint8 *nt, uint32 A) {
+	FCEUSS_MarkDirty(nt + (A & 0x3FF));
+
+	if (chrCache.empty())
+		return;
+
+	std::unordered_map<const uint8 *, CHRCachePage>::iterator page = chrCache.find(nt);
+
+	if (page != chrCache.end())
+		page->second.valid = false;
+}
+
+void FCEUPPU_InvalidateCHRSlots(int slot, int count) {
+	while (count--)
+		chrSlotPage[slot++] = 0;
+}
+
+void FCEUPPU_InvalidateCHRCache(void) {
+	chrCache.clear();
+	memset(chrSlotPage, 0, sizeof(chrSlotPage));
+}
+
+static FCEU_THREAD_LOCAL int ppudead = 1;
+static FCEU_THREAD_LOCAL int kook = 0;
+FCEU_THREAD_LOCAL int fceuindbg = 0;
 
 //mbg 6/23/08
 //make the no-bg fill color configurable
 //0xFF shall indicate to use palette[0]
-uint8 gNoBGFillColor = 0xFF;
+FCEU_THREAD_LOCAL uint8 gNoBGFillColor = 0xFF;
 
-int MMC5Hack = 0;
-uint32 MMC5HackVROMMask = 0;
-uint8 *MMC5HackExNTARAMPtr = 0;
-uint8 *MMC5HackVROMPTR = 0;
-uint8 MMC5HackCHRMode = 0;
-uint8 MMC5HackSPMode = 0;
-uint8 MMC50x5130 = 0;
-uint8 MMC5HackSPScroll = 0;
-uint8 MMC5HackSPPage = 0;
+FCEU_THREAD_LOCAL int MMC5Hack = 0;
+FCEU_THREAD_LOCAL uint32 MMC5HackVROMMask = 0;
+FCEU_THREAD_LOCAL uint8 *MMC5HackExNTARAMPtr = 0;
+FCEU_THREAD_LOCAL uint8 *MMC5HackVROMPTR = 0;
+FCEU_THREAD_LOCAL uint8 MMC5HackCHRMode = 0;
+FCEU_THREAD_LOCAL uint8 MMC5HackSPMode = 0;
+FCEU_THREAD_LOCAL uint8 MMC50x5130 = 0;
+FCEU_THREAD_LOCAL uint8 MMC5HackSPScroll = 0;
+FCEU_THREAD_LOCAL uint8 MMC5HackSPPage = 0;
 
-int PEC586Hack = 0;
+FCEU_THREAD_LOCAL int PEC586Hack = 0;
 
-int QTAIHack = 0;
-uint8 QTAINTRAM[2048];
-uint8 qtaintramreg;
+FCEU_THREAD_LOCAL int QTAIHack = 0;
+FCEU_THREAD_LOCAL uint8 QTAINTRAM[2048];
+FCEU_THREAD_LOCAL uint8 qtaintramreg;
 
-uint8 VRAMBuffer = 0, PPUGenLatch = 0;
-uint8 *vnapage[4];
-uint8 PPUNTARAM = 0;
-uint8 PPUCHRRAM = 0;
+FCEU_THREAD_LOCAL uint8 VRAMBuffer = 0, PPUGenLatch = 0;
+FCEU_THREAD_LOCAL uint8 *vnapage[4];
+FCEU_THREAD_LOCAL uint8 PPUNTARAM = 0;
+FCEU_THREAD_LOCAL uint8 PPUCHRRAM = 0;
 
 //Color deemphasis emulation.  Joy...
-static uint8 deemp = 0;
-static int deempcnt[8];
+static FCEU_THREAD_LOCAL uint8 deemp = 0;
+static FCEU_THREAD_LOCAL int deempcnt[8];
 
-void (*GameHBIRQHook)(void), (*GameHBIRQHook2)(void);
-void (*PPU_hook)(uint32 A);
+FCEU_THREAD_LOCAL void (*GameHBIRQHook)(void), (*GameHBIRQHook2)(void);
+FCEU_THREAD_LOCAL void (*PPU_hook)(uint32 A);
 
-uint8 vtoggle = 0;
-uint8 XOffset = 0;
-uint8 SpriteDMA = 0; // $4014 / Writing $xx copies 256 bytes by reading from $xx00-$xxFF and writing to $2004 (OAM data)
+FCEU_THREAD_LOCAL uint8 vtoggle = 0;
+FCEU_THREAD_LOCAL uint8 XOffset = 0;
+FCEU_THREAD_LOCAL uint8 SpriteDMA = 0; // $4014 / Writing $xx copies 256 bytes by reading from $xx00-$xxFF and writing to $2004 (OAM data)
 
-uint32 TempAddr = 0, RefreshAddr = 0, DummyRead = 0, NTRefreshAddr = 0;
+FCEU_THREAD_LOCAL uint32 TempAddr = 0, RefreshAddr = 0, DummyRead = 0, NTRefreshAddr = 0;
 
-static int maxsprites = 8;
+static FCEU_THREAD_LOCAL int maxsprites = 8;
 
 //scanline is equal to the current visible scanline we're on.
-int scanline;
-int g_rasterpos;
-static uint32 scanlines_per_frame;
-
-uint8 PPU[4];
-uint8 PPUSPL;
-uint8 NTARAM[0x800], PALRAM[0x20], SPRAM[0x100], SPRBUF[0x100];
-uint8 UPALRAM[0x03];//for 0x4/0x8/0xC addresses in palette, the ones in
+FCEU_THREAD_LOCAL int scanline;
+FCEU_THREAD_LOCAL int g_rasterpos;
+static FCEU_THREAD_LOCAL uint32 scanlines_per_frame;
+
+FCEU_THREAD_LOCAL uint8 PPU[4];
+FCEU_THREAD_LOCAL uint8 PPUSPL;
+FCEU_THREAD_LOCAL uint8 NTARAM[0x800], PALRAM[0x20], SPRAM[0x100], SPRBUF[0x100];
+FCEU_THREAD_LOCAL uint8 UPALRAM[0x03];//for 0x4/0x8/0xC addresses in palette, the ones in
 					//0x20 are 0 to not break fceu rendering.
 
 #define MMC5SPRVRAMADR(V)   &MMC5SPRVPage[(V) >> 10][(V)]
@@ -430,14 +564,18 @@ inline void FFCEUX_PPUWrite_Default(uint32 A, uint8 V) {
 	if (PPU_hook) PPU_hook(A);
 
 	if (tmp < 0x2000) {
-		if (PPUCHRRAM & (1 << (tmp >> 10)))
+		if (PPUCHRRAM & (1 << (tmp >> 10))) {
 			VPage[tmp >> 10][tmp] = V;
+			FCEUPPU_InvalidateCHR(tmp);
+		}
 	} else if (tmp < 0x3F00) {
 		if (QTAIHack && (qtaintramreg & 1)) {
 			QTAINTRAM[((((tmp & 0xF00) >> 10) >> ((qtaintramreg >> 1)) & 1) << 10) | (tmp & 0x3FF)] = V;
 		} else {
-			if (PPUNTARAM & (1 << ((tmp & 0xF00) >> 10)))
+			if (PPUNTARAM & (1 << ((tmp & 0xF00) >> 10))) {
 				vnapage[((tmp & 0xF00) >> 10)][tmp & 0x3FF] = V;
+				FCEUPPU_InvalidateNametable(vnapage[((tmp & 0xF00) >> 10)], tmp);
+			}
 		}
 	} else {
 		if (!(tmp & 3)) {
@@ -452,9 +590,9 @@ inline void FFCEUX_PPUWrite_Default(uint32 A, uint8 V) {
 	}
 }
 
-volatile int rendercount, vromreadcount, undefinedvromcount, LogAddress = -1;
-unsigned char *cdloggervdata = NULL;
-unsigned int cdloggerVideoDataSize = 0;
+FCEU_THREAD_LOCAL volatile int rendercount, vromreadcount, undefinedvromcount, LogAddress = -1;
+FCEU_THREAD_LOCAL unsigned char *cdloggervdata = NULL;
+FCEU_THREAD_LOCAL unsigned int cdloggerVideoDataSize = 0;
 
 int GetCHRAddress(int A) 
 {
@@ -548,15 +686,17 @@ uint8 FASTCALL FFCEUX_PPURead_Default(uint32 A) {
 }
 
 
-uint8 (FASTCALL *FFCEUX_PPURead)(uint32 A) = 0;
-void (*FFCEUX_PPUWrite)(uint32 A, uint8 V) = 0;
+FCEU_THREAD_LOCAL uint8 (FASTCALL *FFCEUX_PPURead)(uint32 A) = 0;
+FCEU_THREAD_LOCAL void (*FFCEUX_PPUWrite)(uint32 A, uint8 V) = 0;
 
 #define CALL_PPUREAD(A) (FFCEUX_PPURead(A))
 
 #define CALL_PPUWRITE(A, V) (FFCEUX_PPUWrite ? FFCEUX_PPUWrite(A, V) : FFCEUX_PPUWrite_Default(A, V))
 
 //whether to use the new ppu
-int newppu = 0;
+FCEU_THREAD_LOCAL int newppu = 0;
+//whether the new ppu lets the cpu run ahead of it (see runppu)
+FCEU_THREAD_LOCAL int newppu_catchup = 0;
 
 void ppu_getScroll(int &xpos, int &ypos) {
 	if (newppu) {
@@ -596,6 +736,13 @@ static DECLFR(A2002) {
 	return ret;
 }
 
+//Whether the CPU may skip reads of A in a loop waiting for the vblank flag
+//to be set.  The old PPU only sets it between X6502_Run calls, and while it
+//is clear another read of $2002 does nothing the next one does not redo.
+bool FCEUPPU_StatusPollable(uint32 A) {
+	return !newppu && ARead[A] == A2002 && !(PPU_status & 0x80);
+}
+
 static DECLFR(A2004) {
 	if (newppu) {
 		if ((ppur.status.sl < 241) && PPUON) {
@@ -974,14 +1121,18 @@ static DECLFW(B2007) {
 	} else {
 		PPUGenLatch = V;
 		if (tmp < 0x2000) {
-			if (PPUCHRRAM & (1 << (tmp >> 10)))
+			if (PPUCHRRAM & (1 << (tmp >> 10))) {
 				VPage[tmp >> 10][tmp] = V;
+				FCEUPPU_InvalidateCHR(tmp);
+			}
 		} else if (tmp < 0x3F00) {
 			if (QTAIHack && (qtaintramreg & 1)) {
 				QTAINTRAM[((((tmp & 0xF00) >> 10) >> ((qtaintramreg >> 1)) & 1) << 10) | (tmp & 0x3FF)] = V;
 			} else {
-				if (PPUNTARAM & (1 << ((tmp & 0xF00) >> 10)))
+				if (PPUNTARAM & (1 << ((tmp & 0xF00) >> 10))) {
 					vnapage[((tmp & 0xF00) >> 10)][tmp & 0x3FF] = V;
+					FCEUPPU_InvalidateNametable(vnapage[((tmp & 0xF00) >> 10)], tmp);
+				}
 			}
 		} else {
 			if (!(tmp & 3)) {
@@ -1014,10 +1165,12 @@ static DECLFW(B4014) {
 
 #define GETLASTPIXEL    (PAL ? ((timestamp * 48 - linestartts) / 15) : ((timestamp * 48 - linestartts) >> 4))
 
-static uint8 *Pline, *Plinef;
-static int firsttile;
-int linestartts;	//no longer static so the debugger can see it
-static int tofix = 0;
+static FCEU_THREAD_LOCAL uint8 *Pline, *Plinef;
+static FCEU_THREAD_LOCAL int firsttile;
+FCEU_THREAD_LOCAL int linestartts;	//no longer static so the debugger can see it
+static FCEU_THREAD_LOCAL int tofix = 0;
+
+#define TOFIXNUM (272 - 0x4)
 
 static void ResetRL(uint8 *target) {
 	memset(target, 0xFF, 256);
@@ -1031,7 +1184,7 @@ static void ResetRL(uint8 *target) {
 	tofix = 1;
 }
 
-static uint8 sprlinebuf[256 + 8];
+static FCEU_THREAD_LOCAL uint8 sprlinebuf[256 + 8];
 
 void FCEUPPU_LineUpdate(void) {
 	if (newppu)
@@ -1046,7 +1199,7 @@ void FCEUPPU_LineUpdate(void) {
 	}
 }
 
-static bool rendersprites = true, renderbg = true;
+static FCEU_THREAD_LOCAL bool rendersprites = true, renderbg = true;
 
 void FCEUI_SetRenderPlanes(bool sprites, bool bg) {
 	rendersprites = sprites;
@@ -1058,6 +1211,19 @@ void FCEUI_GetRenderPlanes(bool& sprites, bool& bg) {
 	bg = renderbg;
 }
 
+//No-video mode: as requested by the driver, and as in effect for the frame
+//being emulated.  It is dropped for frames where something other than the
+//screen looks at the pixels (zapper, CHR logging).
+static FCEU_THREAD_LOCAL bool novideo = false, skipPixels = false;
+
+void FCEUI_SetNoVideo(bool on) {
+	novideo = on;
+}
+
+bool FCEUI_GetNoVideo(void) {
+	return novideo;
+}
+
 static void CheckSpriteHit(int p);
 
 static void EndRL(void) {
@@ -1068,8 +1234,8 @@ static void EndRL(void) {
 	Pline = 0;
 }
 
-static int32 sphitx;
-static uint8 sphitdata;
+static FCEU_THREAD_LOCAL int32 sphitx;
+static FCEU_THREAD_LOCAL uint8 sphitdata;
 
 static void CheckSpriteHit(int p) {
 	int l = p - 16;
@@ -1088,12 +1254,69 @@ static void CheckSpriteHit(int p) {
 
 //spork the world.  Any sprites on this line? Then this will be set to 1.
 //Needed for zapper emulation and *gasp* sprite emulation.
-static int spork = 0;
+static FCEU_THREAD_LOCAL int spork = 0;
+
+//Background shift registers, carried from one RefreshLine call to the next.
+static FCEU_THREAD_LOCAL uint32 pshift[2];
+static FCEU_THREAD_LOCAL uint32 atlatch;
+
+//RefreshLine in no-video mode once no sprite 0 hit is left to find on the
+//line.  Steps the fetch address along the line and gives PPU_hook the same
+//reads the tile loops do, but decodes no pixels.
+static void SkipTiles(int lastpixel, int lasttile, uint32 vofs) {
+	uint32 addr = RefreshAddr;
+	int X1;
+
+	if (ScreenON || SpriteON) {
+		if (PPU_hook && !(MMC5Hack && geniestage != 1)) {
+			for (X1 = firsttile; X1 < lasttile; X1++) {
+				uint8 *C = vnapage[(addr >> 10) & 3];
+				uint32 vadr = (C[addr & 0x3ff] << 4) + vofs;
+
+				PPU_hook(0x2000 | (addr & 0xfff));
+				PPU_hook(vadr);
+				if ((addr & 0x1f) == 0x1f)
+					addr ^= 0x41F;
+				else
+					addr++;
+				PPU_hook(0x2000 | (addr & 0xfff));
+			}
+		} else {
+			for (X1 = firsttile; X1 < lasttile; X1++) {
+				if ((addr & 0x1f) == 0x1f)
+					addr ^= 0x41F;
+				else
+					addr++;
+			}
+		}
+		RefreshAddr = addr;
+	}
+
+	if (lasttile > 2)
+		Pline += (lasttile - (firsttile > 2 ? firsttile : 2)) * 8;
+	firsttile = lasttile;
+
+	if (lastpixel >= TOFIXNUM && tofix) {
+		Fixit1();
+		tofix = 0;
+	}
+}
+
+#ifdef PPU_TILE_SIMD
+//The plain loop at the end of RefreshLine, built for the shuffle kernel.
+static PPU_TILE_TARGET void RefreshTilesSIMD(uint8 *&P, uint32 &smorkus, uint32 vofs, int lasttile) {
+	#define RefreshAddr smorkus
+	#define PPUT_SIMD
+	for (int X1 = firsttile; X1 < lasttile; X1++) {
+		#include "pputile.inc"
+	}
+	#undef PPUT_SIMD
+	#undef RefreshAddr
+}
+#endif
 
 // lasttile is really "second to last tile."
 static void RefreshLine(int lastpixel) {
-	static uint32 pshift[2];
-	static uint32 atlatch;
 	uint32 smorkus = RefreshAddr;
 
 	#define RefreshAddr smorkus
@@ -1103,7 +1326,7 @@ static void RefreshLine(int lastpixel) {
 	uint8 *P = Pline;
 	int lasttile = lastpixel >> 3;
 	int numtiles;
-	static int norecurse = 0;	// Yeah, recursion would be bad.
+	static FCEU_THREAD_LOCAL int norecurse = 0;	// Yeah, recursion would be bad.
 								// PPU_hook() functions can call
 								// mirroring/chr bank switching functions,
 								// which call FCEUPPU_LineUpdate, which call this
@@ -1129,6 +1352,13 @@ static void RefreshLine(int lastpixel) {
 	else
 		vofs = ((PPU[0] & 0x10) << 8) | ((RefreshAddr >> 12) & 7);
 
+	if (skipPixels && (sphitx == 0x100 || (PPU_status & 0x40))) {
+		norecurse = 1;
+		SkipTiles(lastpixel, lasttile, vofs);
+		norecurse = 0;
+		return;
+	}
+
 	if (!ScreenON && !SpriteON) {
 		uint32 tem;
 		tem = READPAL(0) | (READPAL(0) << 8) | (READPAL(0) << 16) | (READPAL(0) << 24);
@@ -1139,7 +1369,6 @@ static void RefreshLine(int lastpixel) {
 
 		firsttile = lasttile;
 
-		#define TOFIXNUM (272 - 0x4)
 		if (lastpixel >= TOFIXNUM && tofix) {
 			Fixit1();
 			tofix = 0;
@@ -1229,6 +1458,11 @@ static void RefreshLine(int lastpixel) {
 			}
 			#undef PPU_VRC5FETCH
 		} else {
+#ifdef PPU_TILE_SIMD
+			if (ppuTileSIMD)
+				RefreshTilesSIMD(P, smorkus, vofs, lasttile);
+			else
+#endif
 			for (X1 = firsttile; X1 < lasttile; X1++) {
 				#include "pputile.inc"
 			}
@@ -1310,24 +1544,12 @@ static void Fixit1(void) {
 	}
 }
 
-void MMC5_hb(int);		//Ugh ugh ugh.
-static void DoLine(void) {
-	if (scanline >= 240 && scanline != totalscanlines) {
-		X6502_Run(256 + 69);
-		scanline++;
-		X6502_Run(16);
-		return;
-	}
-
+//Sprites, greyscale and emphasis for the line just finished.
+static void DrawLine(void) {
 	int x;
 	uint8 *target = XBuf + ((scanline < 240 ? scanline : 240) << 8);
 	u8* dtarget = XDBuf + ((scanline < 240 ? scanline : 240) << 8);
 
-	if (MMC5Hack) MMC5_hb(scanline);
-
-	X6502_Run(256);
-	EndRL();
-
 	if (!renderbg) {// User asked to not display background data.
 		uint32 tem;
 		uint8 col;
@@ -1365,6 +1587,27 @@ static void DoLine(void) {
 	//write the actual deemph
 	for (x = 63; x >= 0; x--)
 		*(uint32*)&dtarget[x << 2] = ((PPU[1]>>5)<<0)|((PPU[1]>>5)<<8)|((PPU[1]>>5)<<16)|((PPU[1]>>5)<<24);
+}
+
+void MMC5_hb(int);		//Ugh ugh ugh.
+static void DoLine(void) {
+	if (scanline >= 240 && scanline != totalscanlines) {
+		X6502_Run(256 + 69);
+		scanline++;
+		X6502_Run(16);
+		return;
+	}
+
+	if (MMC5Hack) MMC5_hb(scanline);
+
+	X6502_Run(256);
+	EndRL();
+
+	if (skipPixels) {
+		if (SpriteON)
+			spork = 0;	//as CopySprites() would
+	} else
+		DrawLine();
 
 	sphitx = 0x100;
 
@@ -1416,7 +1659,72 @@ void FCEUI_DisableSpriteLimitation(int a) {
 	maxsprites = a ? 64 : 8;
 }
 
-static uint8 numsprites, SpriteBlurp;
+static FCEU_THREAD_LOCAL uint8 numsprites, SpriteBlurp;
+
+static INLINE int PPU_LowestBit(uint64 v) {
+#ifdef __GNUC__
+	return __builtin_ctzll(v);
+#else
+	int n = 0;
+	while (!(v & 1)) {
+		v >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+//Returns a bit for each sprite in SPRAM that covers the given scanline with
+//height H, the first sprite in bit 0.  All 64 Y positions are compared at
+//once where SSE2 or NEON is available.
+static uint64 PPU_SpritesOnLine(int line, uint8 H) {
+	uint64 onLine = 0;
+	int n;
+
+#if defined(PPU_SPRITE_SSE2) || defined(PPU_SPRITE_NEON)
+	//a sprite is on the line when 0 <= line - y < H, which needs line to fit
+	//in a byte for the byte wide compares below
+	if ((uint32)line < 256) {
+#ifdef PPU_SPRITE_SSE2
+		const __m128i lo = _mm_set1_epi32(0xFF);
+		const __m128i s = _mm_set1_epi8((char)line);
+		const __m128i h = _mm_set1_epi8((char)(H - 1));
+		const __m128i zero = _mm_setzero_si128();
+
+		for (n = 0; n < 64; n += 16) {
+			const __m128i *oam = (const __m128i *)(SPRAM + (n << 2));
+			__m128i y01 = _mm_packs_epi32(_mm_and_si128(_mm_loadu_si128(oam + 0), lo), _mm_and_si128(_mm_loadu_si128(oam + 1), lo));
+			__m128i y23 = _mm_packs_epi32(_mm_and_si128(_mm_loadu_si128(oam + 2), lo), _mm_and_si128(_mm_loadu_si128(oam + 3), lo));
+			__m128i y = _mm_packus_epi16(y01, y23);
+			__m128i d = _mm_sub_epi8(s, y);
+			//y <= line and line - y <= H - 1, both unsigned
+			__m128i in = _mm_and_si128(_mm_cmpeq_epi8(_mm_subs_epu8(y, s), zero), _mm_cmpeq_epi8(_mm_subs_epu8(d, h), zero));
+			onLine |= (uint64)(uint16)_mm_movemask_epi8(in) << n;
+		}
+#else
+		static const uint8 weights[8] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+		const uint8x8_t w = vld1_u8(weights);
+		const uint8x16_t s = vdupq_n_u8((uint8)line);
+		const uint8x16_t h = vdupq_n_u8((uint8)(H - 1));
+
+		for (n = 0; n < 64; n += 16) {
+			uint8x16_t y = vld4q_u8(SPRAM + (n << 2)).val[0];
+			uint8x16_t in = vandq_u8(vcleq_u8(y, s), vcleq_u8(vsubq_u8(s, y), h));
+			onLine |= (uint64)vaddv_u8(vand_u8(vget_low_u8(in), w)) << n;
+			onLine |= (uint64)vaddv_u8(vand_u8(vget_high_u8(in), w)) << (n + 8);
+		}
+#endif
+		return onLine;
+	}
+#endif
+
+	for (n = 0; n < 64; n++) {
+		if ((uint32)(line - SPRAM[n << 2]) < H)
+			onLine |= (uint64)1 << n;
+	}
+	return onLine;
+}
+
 static void FetchSpriteData(void) {
 	uint8 ns, sb;
 	SPR *spr;
@@ -1433,11 +1741,15 @@ static void FetchSpriteData(void) {
 	vofs = (uint32)(P0 & 0x8 & (((P0 & 0x20) ^ 0x20) >> 2)) << 9;
 	H += (P0 & 0x20) >> 2;
 
-	if (!PPU_hook)
-		for (n = 63; n >= 0; n--, spr++) {
-			if ((uint32)(scanline - spr->y) >= H) continue;
+	if (!PPU_hook) {
+		uint64 onLine = PPU_SpritesOnLine(scanline, H);
+
+		while (onLine) {
+			n = PPU_LowestBit(onLine);
+			onLine &= onLine - 1;
+			spr = (SPR*)SPRAM + n;
 			if (ns < maxsprites) {
-				if (n == 63) sb = 1;
+				if (n == 0) sb = 1;
 
 				{
 					SPRB dst;
@@ -1486,7 +1798,7 @@ static void FetchSpriteData(void) {
 				break;
 			}
 		}
-	else
+	} else
 		for (n = 63; n >= 0; n--, spr++) {
 			if ((uint32)(scanline - spr->y) >= H) continue;
 
@@ -1556,6 +1868,21 @@ static void FetchSpriteData(void) {
 	SpriteBlurp = sb;
 }
 
+//Arms the sprite 0 hit check for the next line with sprite 0's row J.
+static void SetSpriteHit(int x, uint8 J, uint8 atr) {
+	sphitx = x;
+	sphitdata = J;
+	if (atr & H_FLIP)
+		sphitdata = ((J << 7) & 0x80) |
+					((J << 5) & 0x40) |
+					((J << 3) & 0x20) |
+					((J << 1) & 0x10) |
+					((J >> 1) & 0x08) |
+					((J >> 3) & 0x04) |
+					((J >> 5) & 0x02) |
+					((J >> 7) & 0x01);
+}
+
 static void RefreshSprites(void) {
 	int n;
 	SPRB *spr;
@@ -1563,8 +1890,19 @@ static void RefreshSprites(void) {
 	spork = 0;
 	if (!numsprites) return;
 
-	FCEU_dwmemset(sprlinebuf, 0x80808080, 256);
 	numsprites--;
+
+	if (skipPixels) {
+		//Without pixels only sprite 0 matters, for the hit flag.
+		spr = (SPRB*)SPRBUF;
+		if (SpriteBlurp && !(PPU_status & 0x40) && (spr->ca[0] | spr->ca[1]))
+			SetSpriteHit(spr->x, spr->ca[0] | spr->ca[1], spr->atr);
+		SpriteBlurp = 0;
+		spork = 1;
+		return;
+	}
+
+	FCEU_dwmemset(sprlinebuf, 0x80808080, 256);
 	spr = (SPRB*)SPRBUF + numsprites;
 
 	for (n = numsprites; n >= 0; n--, spr--) {
@@ -1580,19 +1918,8 @@ static void RefreshSprites(void) {
 		atr = spr->atr;
 
 		if (J) {
-			if (n == 0 && SpriteBlurp && !(PPU_status & 0x40)) {
-				sphitx = x;
-				sphitdata = J;
-				if (atr & H_FLIP)
-					sphitdata = ((J << 7) & 0x80) |
-								((J << 5) & 0x40) |
-								((J << 3) & 0x20) |
-								((J << 1) & 0x10) |
-								((J >> 1) & 0x08) |
-								((J >> 3) & 0x04) |
-								((J >> 5) & 0x02) |
-								((J >> 7) & 0x01);
-			}
+			if (n == 0 && SpriteBlurp && !(PPU_status & 0x40))
+				SetSpriteHit(x, J, atr);
 
 			C = sprlinebuf + x;
 			VB = (0x10) + ((atr & 3) << 2);
@@ -1686,6 +2013,33 @@ static void CopySprites(uint8 *target) {
 	if(PPU[1] & 0x04)
 		start = 0;
 
+#if defined(PPU_SPRITE_SSE2) || defined(PPU_SPRITE_NEON)
+	//A sprite pixel is drawn when it is not transparent (bit 7 clear) and is
+	//either in front (bit 6 clear) or over a transparent background pixel
+	//(bit 6 set in the line); sixteen pixels are merged at a time.
+	for(int i=0;i<256;i+=16)
+	{
+#ifdef PPU_SPRITE_SSE2
+		__m128i t = _mm_loadu_si128((const __m128i *)(sprlinebuf + i));
+		__m128i p = _mm_loadu_si128((const __m128i *)(P + i));
+		__m128i nt = _mm_xor_si128(t, _mm_set1_epi8(-1));
+		__m128i x = _mm_and_si128(nt, _mm_slli_epi16(_mm_or_si128(nt, p), 1));
+		__m128i m = _mm_cmplt_epi8(x, _mm_setzero_si128());
+		if (i < start)	//the left 8 pixels are clipped
+			m = _mm_and_si128(m, _mm_set_epi32(-1, -1, 0, 0));
+		_mm_storeu_si128((__m128i *)(P + i), _mm_or_si128(_mm_and_si128(m, t), _mm_andnot_si128(m, p)));
+#else
+		uint8x16_t t = vld1q_u8(sprlinebuf + i);
+		uint8x16_t p = vld1q_u8(P + i);
+		uint8x16_t nt = vmvnq_u8(t);
+		uint8x16_t x = vandq_u8(nt, vshlq_n_u8(vorrq_u8(nt, p), 1));
+		uint8x16_t m = vtstq_u8(x, vdupq_n_u8(0x80));
+		if (i < start)	//the left 8 pixels are clipped
+			m = vcombine_u8(vdup_n_u8(0), vget_high_u8(m));
+		vst1q_u8(P + i, vbslq_u8(m, t, p));
+#endif
+	}
+#else
 	for(int i=start;i<256;i++)
 	{
 		uint8 t = sprlinebuf[i];
@@ -1693,6 +2047,7 @@ static void CopySprites(uint8 *target) {
 			if (!(t & 0x40) || (P[i] & 0x40))		// Normal sprite || behind bg sprite
 				P[i] = t;
 	}
+#endif
 }
 
 void FCEUPPU_SetVideoSystem(int w) {
@@ -1712,6 +2067,9 @@ void FCEUPPU_SetVideoSystem(int w) {
 //Initializes the PPU
 void FCEUPPU_Init(void) {
 	makeppulut();
+#ifdef PPU_TILE_SIMD
+	ppuTileSIMD = PPU_TileSIMDSupported();
+#endif
 }
 
 void PPU_ResetHooks() {
@@ -1727,6 +2085,7 @@ void FCEUPPU_Reset(void) {
 	ppudead = 2;
 	kook = 0;
 	idleSynch = 1;
+	FCEUPPU_InvalidateCHRCache();
 
 	new_ppu_reset = true; // delay reset of ppur/spr_read until it's ready to start a new frame
 }
@@ -1766,6 +2125,8 @@ void FCEUPPU_Power(void) {
 		BWrite[x + 7] = B2007;
 	}
 	BWrite[0x4014] = B4014;
+	FCEU_RefreshMemPages(0x2000, 0x3FFF);
+	FCEU_RefreshMemPages(0x4014, 0x4014);
 }
 
 int FCEUPPU_Loop(int skip) {
@@ -1774,6 +2135,8 @@ int FCEUPPU_Loop(int skip) {
 		return FCEUX_PPU_Loop(skip);
 	}
 
+	skipPixels = novideo && !debug_loggingCD && !InputScanlineHooked();
+
 	//Needed for Knight Rider, possibly others.
 	if (ppudead) {
 		memset(XBuf, 0x80, 256 * 240);
@@ -1912,16 +2275,17 @@ int FCEUPPU_Loop(int skip) {
 	}
 }
 
-int (*PPU_MASTER)(int skip) = FCEUPPU_Loop;
+FCEU_THREAD_LOCAL int (*PPU_MASTER)(int skip) = FCEUPPU_Loop;
 
-static uint16 TempAddrT, RefreshAddrT;
+static FCEU_THREAD_LOCAL uint16 TempAddrT, RefreshAddrT;
 
 void FCEUPPU_LoadState(int version) {
 	TempAddr = TempAddrT;
 	RefreshAddr = RefreshAddrT;
+	FCEUPPU_InvalidateCHRCache();
 }
 
-SFORMAT FCEUPPU_STATEINFO[] = {
+FCEU_THREAD_LOCAL_OBJECT SFORMAT FCEUPPU_STATEINFO[] = {
 	{ NTARAM, 0x800, "NTAR" },
 	{ PALRAM, 0x20, "PRAM" },
 	{ SPRAM, 0x100, "SPRA" },
@@ -1938,7 +2302,7 @@ SFORMAT FCEUPPU_STATEINFO[] = {
 	{ 0 }
 };
 
-SFORMAT FCEU_NEWPPU_STATEINFO[] = {
+FCEU_THREAD_LOCAL_OBJECT SFORMAT FCEU_NEWPPU_STATEINFO[] = {
 	{ &idleSynch, 1, "IDLS" },
 	{ &spr_read.num, 4 | FCEUSTATE_RLSB, "SR_0" },
 	{ &spr_read.count, 4 | FCEUSTATE_RLSB, "SR_1" },
@@ -1989,21 +2353,35 @@ uint32 FCEUPPU_PeekAddress()
 }
 
 //---------------------
-int pputime = 0;
-int totpputime = 0;
+FCEU_THREAD_LOCAL int pputime = 0;
+FCEU_THREAD_LOCAL int totpputime = 0;
 const int kLineTime = 341;
 const int kFetchTime = 2;
+//dots from the start of a scanline to where GameHBIRQHook is called:
+//32 background tiles, sprites 0 and 1, and the garbage fetch of sprite 2
+const int kHBIRQHookDot = 32 * 8 + 2 * (2 + 3 * kFetchTime) + 2;
+
+//In catch-up mode the cpu is handed the dots left before the next point where
+//the ppu can raise an NMI or IRQ (or the frame ends) and may run that far
+//ahead, only stopping early to wait for the ppu when it touches a register.
+//FCEUX_PPU_Loop sets this at each of those points.
+static FCEU_THREAD_LOCAL int ppusyncdots = 0;
 
 void runppu(int x) {
 	ppur.status.cycle = (ppur.status.cycle + x) % ppur.status.end_cycle;
 	if (!new_ppu_reset) // if resetting, suspend CPU until the first frame
 	{
-		X6502_Run(x);
+		ppusyncdots -= x;
+		//PPU_hook and MMC5 scanline hooks can raise IRQs on any fetch
+		if (newppu_catchup && !PPU_hook && !MMC5Hack)
+			X6502_RunAhead(x, ppusyncdots);
+		else
+			X6502_Run(x);
 	}
 }
 
 //todo - consider making this a 3 or 4 slot fifo to keep from touching so much memory
-struct BGData {
+FCEU_THREAD_LOCAL struct BGData {
 	struct Record {
 		uint8 nt, pecnt, at, pt[2], qtnt;
 		uint8 ppu1[8];
@@ -2102,7 +2480,7 @@ static inline int PaletteAdjustPixel(int pixel) {
 		return (pixel & 0x3F) | 0x80;
 }
 
-int framectr = 0;
+FCEU_THREAD_LOCAL int framectr = 0;
 int FCEUX_PPU_Loop(int skip) {
 
 	if (new_ppu_reset) // first frame since reset, time to initialize
@@ -2120,6 +2498,7 @@ int FCEUX_PPU_Loop(int skip) {
 		// should write to those regs during that time, it needs
 		// to wait for vblank
 		ppur.status.sl = 241;
+		ppusyncdots = 0;
 		if (PAL)
 			runppu(70 * kLineTime);
 		else
@@ -2143,11 +2522,13 @@ int FCEUX_PPU_Loop(int skip) {
 		ppur.status.sl = 241;	//for sprite reads
 
 		//formerly: runppu(delay);
+		ppusyncdots = delay;
 		for(int dot=0;dot<delay;dot++)
 			runppu(1);
 
 		if (VBlankON) TriggerNMI();
 		int sltodo = PAL?70:20;
+		ppusyncdots = sltodo * kLineTime - delay + kHBIRQHookDot;
 		
 		//formerly: runppu(20 * (kLineTime) - delay);
 		for(int S=0;S<sltodo;S++)
@@ -2171,10 +2552,10 @@ int FCEUX_PPU_Loop(int skip) {
 		//if(PPUON)
 		//	ppur.install_latches();
 
-		static uint8 oams[2][64][8];//[7] turned to [8] for faster indexing
-		static int oamcounts[2] = { 0, 0 };
-		static int oamslot = 0;
-		static int oamcount;
+		static FCEU_THREAD_LOCAL uint8 oams[2][64][8];//[7] turned to [8] for faster indexing
+		static FCEU_THREAD_LOCAL int oamcounts[2] = { 0, 0 };
+		static FCEU_THREAD_LOCAL int oamslot = 0;
+		static FCEU_THREAD_LOCAL int oamcount;
 
 		//capture the initial xscroll
 		//int xscroll = ppur.fh;
@@ -2435,6 +2816,11 @@ int FCEUX_PPU_Loop(int skip) {
 				}
 				if (realSprite) runppu(garbage_todo);
 
+				//the next hook is a line away, or the frame ends further off than that.
+				//the pre-render line can be a dot short.
+				if (s == 2)
+					ppusyncdots = kLineTime - 1;
+
 				//Dragon's Lair (Europe version mapper 4)
 				//does not set SpriteON in the beginning but it does
 				//set the bg on so if using the conditional SpriteON the MMC3 counter
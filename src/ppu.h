@@ -5,23 +5,35 @@ int FCEUPPU_Loop(int skip);
 
 void FCEUPPU_LineUpdate();
 void FCEUPPU_SetVideoSystem(int w);
+bool FCEUPPU_StatusPollable(uint32 A);
 
-extern void (*PPU_hook)(uint32 A);
-extern void (*GameHBIRQHook)(void), (*GameHBIRQHook2)(void);
+extern FCEU_THREAD_LOCAL void (*PPU_hook)(uint32 A);
+extern FCEU_THREAD_LOCAL void (*GameHBIRQHook)(void), (*GameHBIRQHook2)(void);
 
 int newppu_get_scanline();
 int newppu_get_dot();
 void newppu_hacky_emergency_reset();
 
 /* For cart.c and banksw.h, mostly */
-extern uint8 NTARAM[0x800], *vnapage[4];
-extern uint8 PPUNTARAM;
-extern uint8 PPUCHRRAM;
+extern FCEU_THREAD_LOCAL uint8 NTARAM[0x800], *vnapage[4];
+extern FCEU_THREAD_LOCAL uint8 PPUNTARAM;
+extern FCEU_THREAD_LOCAL uint8 PPUCHRRAM;
 
 void FCEUPPU_SaveState(void);
 void FCEUPPU_LoadState(int version);
 uint32 FCEUPPU_PeekAddress();
 uint8* FCEUPPU_GetCHR(uint32 vadr, uint32 refreshaddr);
+
+//Pattern data decoded to one uint32 per tile row, pixel x in bits 4x and 4x+1.
+//Returns the 8 rows of the tile holding PPU address A ($0000-$1FFF).
+const uint32* FCEUPPU_GetDecodedTile(uint32 A);
+//Code that writes CHR memory other than through $2007 tells the cache here.
+void FCEUPPU_InvalidateCHR(uint32 A);
+//Same for a write to byte A of the 1K nametable page at nt.
+void FCEUPPU_InvalidateNametable(uint8 *nt, uint32 A);
+//Code that points VPage[slot]..VPage[slot+count-1] somewhere else tells the cache here.
+void FCEUPPU_InvalidateCHRSlots(int slot, int count);
+void FCEUPPU_InvalidateCHRCache(void);
 int FCEUPPU_GetAttr(int ntnum, int xt, int yt);
 void ppu_getScroll(int &xpos, int &ypos);
 
@@ -33,22 +45,22 @@ void ppu_getScroll(int &xpos, int &ypos);
 #endif
 
 void PPU_ResetHooks();
-extern uint8 (FASTCALL *FFCEUX_PPURead)(uint32 A);
-extern void (*FFCEUX_PPUWrite)(uint32 A, uint8 V);
+extern FCEU_THREAD_LOCAL uint8 (FASTCALL *FFCEUX_PPURead)(uint32 A);
+extern FCEU_THREAD_LOCAL void (*FFCEUX_PPUWrite)(uint32 A, uint8 V);
 extern uint8 FASTCALL FFCEUX_PPURead_Default(uint32 A);
 void FFCEUX_PPUWrite_Default(uint32 A, uint8 V);
 
-extern int g_rasterpos;
-extern uint8 PPU[4];
-extern bool DMC_7bit;
-extern bool paldeemphswap;
+extern FCEU_THREAD_LOCAL int g_rasterpos;
+extern FCEU_THREAD_LOCAL uint8 PPU[4];
+extern FCEU_THREAD_LOCAL bool DMC_7bit;
+extern FCEU_THREAD_LOCAL bool paldeemphswap;
 
 enum PPUPHASE {
 	PPUPHASE_VBL, PPUPHASE_BG, PPUPHASE_OBJ
 };
 
-extern PPUPHASE ppuphase;
+extern FCEU_THREAD_LOCAL PPUPHASE ppuphase;
 
-extern unsigned char *cdloggervdata;
-extern unsigned int cdloggerVideoDataSize;
-extern volatile int rendercount, vromreadcount, undefinedvromcount;
+extern FCEU_THREAD_LOCAL unsigned char *cdloggervdata;
+extern FCEU_THREAD_LOCAL unsigned int cdloggerVideoDataSize;
+extern FCEU_THREAD_LOCAL volatile int rendercount, vromreadcount, undefinedvromcount;
@@ -32,59 +32,59 @@
 #include <cstdio>
 #include <cstring>
 
-static uint32 wlookup1[32];
-static uint32 wlookup2[203];
+static FCEU_THREAD_LOCAL uint32 wlookup1[32];
+static FCEU_THREAD_LOCAL uint32 wlookup2[203];
 
-int32 Wave[2048+512];
-int32 WaveHi[40000];
-int32 WaveFinal[2048+512];
+FCEU_THREAD_LOCAL int32 Wave[2048+512];
+FCEU_THREAD_LOCAL int32 WaveHi[40000];
+FCEU_THREAD_LOCAL int32 WaveFinal[2048+512];
 
-EXPSOUND GameExpSound={0,0,0};
+FCEU_THREAD_LOCAL EXPSOUND GameExpSound={0,0,0};
 
-/*static*/ uint8 TriCount=0;
-static uint8 TriMode=0;
+FCEU_THREAD_LOCAL /*static*/ uint8 TriCount=0;
+static FCEU_THREAD_LOCAL uint8 TriMode=0;
 
-static int32 tristep=0;
+static FCEU_THREAD_LOCAL int32 tristep=0;
 
-static int32 wlcount[4]={0,0,0,0};	// Wave length counters.
+static FCEU_THREAD_LOCAL int32 wlcount[4]={0,0,0,0};	// Wave length counters.
 
 // APU registers:
-uint8 PSG[0x10];			// $4000-$400F / Channels 1-4
-uint8 DMCFormat=0;			// $4010 / Play mode and frequency
-uint8 RawDALatch=0;			// $4011 / 7-bit DAC / 0xxxxxxx
-uint8 DMCAddressLatch=0;	// $4012 / Start of DMC waveform is at address $C000 + $40*$xx
-uint8 DMCSizeLatch=0;		// $4013 / Length of DMC waveform is $10*$xx + 1 bytes (128*$xx + 8 samples)
-uint8 EnabledChannels=0;	// $4015 / Sound channels enable and status
-uint8 IRQFrameMode=0;		// $4017 / Frame counter control / xx000000
-
-uint8 InitialRawDALatch=0; // used only for lua
-bool DMC_7bit = 0; // used to skip overclocking
-ENVUNIT EnvUnits[3];
+FCEU_THREAD_LOCAL uint8 PSG[0x10];			// $4000-$400F / Channels 1-4
+FCEU_THREAD_LOCAL uint8 DMCFormat=0;			// $4010 / Play mode and frequency
+FCEU_THREAD_LOCAL uint8 RawDALatch=0;			// $4011 / 7-bit DAC / 0xxxxxxx
+FCEU_THREAD_LOCAL uint8 DMCAddressLatch=0;	// $4012 / Start of DMC waveform is at address $C000 + $40*$xx
+FCEU_THREAD_LOCAL uint8 DMCSizeLatch=0;		// $4013 / Length of DMC waveform is $10*$xx + 1 bytes (128*$xx + 8 samples)
+FCEU_THREAD_LOCAL uint8 EnabledChannels=0;	// $4015 / Sound channels enable and status
+FCEU_THREAD_LOCAL uint8 IRQFrameMode=0;		// $4017 / Frame counter control / xx000000
+
+FCEU_THREAD_LOCAL uint8 InitialRawDALatch=0; // used only for lua
+FCEU_THREAD_LOCAL bool DMC_7bit = 0; // used to skip overclocking
+FCEU_THREAD_LOCAL ENVUNIT EnvUnits[3];
 
 static const int RectDuties[4]={1,2,4,6};
 
-static int32 RectDutyCount[2];
-static uint8 sweepon[2];
-/*static*/ int32 curfreq[2];
-static uint8 SweepCount[2];
-static uint8 SweepReload[2];
+static FCEU_THREAD_LOCAL int32 RectDutyCount[2];
+static FCEU_THREAD_LOCAL uint8 sweepon[2];
+FCEU_THREAD_LOCAL /*static*/ int32 curfreq[2];
+static FCEU_THREAD_LOCAL uint8 SweepCount[2];
+static FCEU_THREAD_LOCAL uint8 SweepReload[2];
 
-static uint16 nreg=0;
+static FCEU_THREAD_LOCAL uint16 nreg=0;
 
-static uint8 fcnt=0;
-static int32 fhcnt=0;
-static int32 fhinc=0;
+static FCEU_THREAD_LOCAL uint8 fcnt=0;
+static FCEU_THREAD_LOCAL int32 fhcnt=0;
+static FCEU_THREAD_LOCAL int32 fhinc=0;
 
-uint32 soundtsoffs=0;
+FCEU_THREAD_LOCAL uint32 soundtsoffs=0;
 
 /* Variables exclusively for low-quality sound. */
-int32 nesincsize=0;
-uint32 soundtsinc=0;
-uint32 soundtsi=0;
-static int32 sqacc[2];
+FCEU_THREAD_LOCAL int32 nesincsize=0;
+FCEU_THREAD_LOCAL uint32 soundtsinc=0;
+FCEU_THREAD_LOCAL uint32 soundtsi=0;
+static FCEU_THREAD_LOCAL int32 sqacc[2];
 /* LQ variables segment ends. */
 
-/*static*/ int32 lengthcount[4];
+FCEU_THREAD_LOCAL /*static*/ int32 lengthcount[4];
 static const uint8 lengthtable[0x20]=
 {
 	10,254, 20,  2, 40,  4, 80,  6, 160,  8, 60, 10, 14, 12, 26, 14,
@@ -123,35 +123,35 @@ static const uint32 PALDMCTable[0x10]=
 	176, 148, 132, 118,  98,  78,  66,  50
 };
 
-/*static*/ int32 DMCacc=1;
-/*static*/ int32 DMCPeriod=0;
-/*static*/ uint8 DMCBitCount=0;
+FCEU_THREAD_LOCAL /*static*/ int32 DMCacc=1;
+FCEU_THREAD_LOCAL /*static*/ int32 DMCPeriod=0;
+FCEU_THREAD_LOCAL /*static*/ uint8 DMCBitCount=0;
 
-static uint32 DMCAddress=0;
-static int32 DMCSize=0;
-static uint8 DMCShift=0;
-static uint8 SIRQStat=0;
+static FCEU_THREAD_LOCAL uint32 DMCAddress=0;
+static FCEU_THREAD_LOCAL int32 DMCSize=0;
+static FCEU_THREAD_LOCAL uint8 DMCShift=0;
+static FCEU_THREAD_LOCAL uint8 SIRQStat=0;
 
-static char DMCHaveDMA=0;
-static uint8 DMCDMABuf=0;
-/*static*/ char DMCHaveSample=0;
+static FCEU_THREAD_LOCAL char DMCHaveDMA=0;
+static FCEU_THREAD_LOCAL uint8 DMCDMABuf=0;
+FCEU_THREAD_LOCAL /*static*/ char DMCHaveSample=0;
 
 static void Dummyfunc(void) {};
-static void (*DoNoise)(void)=Dummyfunc;
-static void (*DoTriangle)(void)=Dummyfunc;
-static void (*DoPCM)(void)=Dummyfunc;
-static void (*DoSQ1)(void)=Dummyfunc;
-static void (*DoSQ2)(void)=Dummyfunc;
+static FCEU_THREAD_LOCAL void (*DoNoise)(void)=Dummyfunc;
+static FCEU_THREAD_LOCAL void (*DoTriangle)(void)=Dummyfunc;
+static FCEU_THREAD_LOCAL void (*DoPCM)(void)=Dummyfunc;
+static FCEU_THREAD_LOCAL void (*DoSQ1)(void)=Dummyfunc;
+static FCEU_THREAD_LOCAL void (*DoSQ2)(void)=Dummyfunc;
 
-static uint32 ChannelBC[5];
+static FCEU_THREAD_LOCAL uint32 ChannelBC[5];
 
 //savestate sync hack stuff
-int movieSyncHackOn=0,resetDMCacc=0,movieConvertOffset1,movieConvertOffset2;
+FCEU_THREAD_LOCAL int movieSyncHackOn=0,resetDMCacc=0,movieConvertOffset1,movieConvertOffset2;
 
 #ifdef WIN32
-extern volatile int datacount, undefinedcount;
-extern int debug_loggingCD;
-extern unsigned char *cdloggerdata;
+extern FCEU_THREAD_LOCAL volatile int datacount, undefinedcount;
+extern FCEU_THREAD_LOCAL int debug_loggingCD;
+extern FCEU_THREAD_LOCAL unsigned char *cdloggerdata;
 #endif
 
 static void LoadDMCPeriod(uint8 V)
@@ -582,6 +582,22 @@ void FCEU_SoundCPUHook(int cycles)
  }
 }
 
+/* Cycles until FCEU_SoundCPUHook has work to do: a frame counter step, the
+   end of a DMC output bit or a pending DMC fetch. */
+int32 FCEU_SoundCPUHookNext(void)
+{
+ int32 next;
+
+ if(DMCSize && !DMCHaveDMA)
+  return 0;
+ if(fhcnt<=0 || DMCacc<=0)
+  return 0;
+ next=(fhcnt+47)/48;
+ if(DMCacc<next)
+  next=DMCacc;
+ return next;
+}
+
 void RDoPCM(void)
 {
  uint32 V; //mbg merge 7/17/06 made uint32
@@ -803,9 +819,9 @@ static void RDoTriangle(void)
 
 static void RDoTriangleNoisePCMLQ(void)
 {
-   static uint32 tcout=0;
-   static int32 triacc=0;
-   static int32 noiseacc=0;
+   static FCEU_THREAD_LOCAL uint32 tcout=0;
+   static FCEU_THREAD_LOCAL int32 triacc=0;
+   static FCEU_THREAD_LOCAL int32 noiseacc=0;
 
    int32 V;
    int32 start,end;
@@ -1010,6 +1026,190 @@ static void RDoNoise(void)
  ChannelBC[3]=SOUNDTS;
 }
 
+/* Step synthesis.  The mixer is not linear, so the two squares are run
+   together, and so are the triangle, noise and DMC: each group jumps to the
+   next time one of its channels changes, looks the new mix up and reports
+   the difference.  The mix last reported is kept in sqStepOut, tndStepOut. */
+static FCEU_THREAD_LOCAL int32 sqStepOut,tndStepOut,hiStepOut;
+
+/* Runs a square's counters n cycles on, the same as n passes of RDoSQ's loop. */
+static INLINE void StepSQCounters(int32 *rc, int32 *dc, int32 cf, int32 n)
+{
+ if(n<*rc)
+  *rc-=n;
+ else
+ {
+  n-=*rc;
+  *dc=(*dc+1+n/cf)&7;
+  *rc=cf-n%cf;
+ }
+}
+
+static void SDoSquares(void)
+{
+ uint32 t=ChannelBC[0],end=SOUNDTS;
+ int32 amp[2],rthresh[2],cf[2],rc[2],dc[2];
+ bool on[2];
+ int x;
+
+ if(end<=t)
+  return;
+
+ for(x=0;x<2;x++)
+ {
+  int32 ampx;
+
+  on[x]=curfreq[x]>=8 && curfreq[x]<=0x7ff && CheckFreq(curfreq[x],PSG[(x<<2)|0x1]) && lengthcount[x];
+
+  if(EnvUnits[x].Mode&0x1)
+   amp[x]=EnvUnits[x].Speed;
+  else
+   amp[x]=EnvUnits[x].decvolume;
+  ampx = x ? FSettings.Square2Volume : FSettings.Square1Volume;
+  if (ampx != 256) amp[x] = (amp[x] * ampx) / 256;
+
+  rthresh[x]=RectDuties[(PSG[(x<<2)]&0xC0)>>6];
+  cf[x]=(curfreq[x]+1)*2;
+  rc[x]=wlcount[x]<1?1:wlcount[x];
+  dc[x]=RectDutyCount[x];
+ }
+
+ for(;;)
+ {
+  int32 out=0;
+  uint32 next=~0U;
+
+  for(x=0;x<2;x++)
+   if(on[x])
+   {
+    //Duty steps until the output flips, then the cycles to get there.
+    int32 n;
+
+    if(dc[x]<rthresh[x])
+    {
+     out+=amp[x];
+     n=rthresh[x]-dc[x];
+    }
+    else
+     n=8-dc[x];
+    n=rc[x]+(n-1)*cf[x];
+    if(t+n<next)
+     next=t+n;
+   }
+  out=wlookup1[out];
+  if(out!=sqStepOut)
+  {
+   StepSynthAdd(t,out-sqStepOut);
+   sqStepOut=out;
+  }
+
+  if(next>end)
+  {
+   for(x=0;x<2;x++)
+    if(on[x])
+     StepSQCounters(&rc[x],&dc[x],cf[x],end-t);
+   break;
+  }
+  for(x=0;x<2;x++)
+   if(on[x])
+    StepSQCounters(&rc[x],&dc[x],cf[x],next-t);
+  t=next;
+ }
+
+ for(x=0;x<2;x++)
+  if(on[x])
+  {
+   wlcount[x]=rc[x];
+   RectDutyCount[x]=dc[x];
+  }
+ ChannelBC[0]=ChannelBC[1]=end;
+}
+
+static INLINE int32 TriangleStepOut(void)
+{
+ int32 tcout=(tristep&0xF);
+ if(!(tristep&0x10)) tcout^=0xF;
+ return (((tcout*3)<<16)/256*FSettings.TriangleVolume)>>16;
+}
+
+static void SDoTND(void)
+{
+ uint32 t=ChannelBC[2],end=SOUNDTS;
+ int32 tri,noise,noiseamp,pcm;
+ int32 triperiod;
+ int nshift;
+ bool trion;
+
+ if(end<=t)
+  return;
+
+ trion=lengthcount[2] && TriCount;
+ triperiod=(PSG[0xa]|((PSG[0xb]&7)<<8))+1;
+ if(wlcount[2]<1) wlcount[2]=1;
+ tri=TriangleStepOut();
+
+ if(EnvUnits[2].Mode&0x1)
+  noiseamp=EnvUnits[2].Speed;
+ else
+  noiseamp=EnvUnits[2].decvolume;
+ if (FSettings.NoiseVolume != 256) noiseamp = (noiseamp * FSettings.NoiseVolume) / 256;
+ noiseamp<<=1;
+ if(!lengthcount[3])
+  noiseamp=0;
+ nshift=(PSG[0xE]&0x80)?8:13;	// "short" noise
+ if(wlcount[3]<1) wlcount[3]=1;
+ noise=((nreg>>0xe)&1)?0:noiseamp;
+
+ pcm=(((RawDALatch<<16)/256)*FSettings.PCMVolume)>>16;
+
+ for(;;)
+ {
+  int32 out=wlookup2[tri+noise+pcm];
+  uint32 next=t+wlcount[3];
+
+  if(out!=tndStepOut)
+  {
+   StepSynthAdd(t,out-tndStepOut);
+   tndStepOut=out;
+  }
+
+  if(trion && t+wlcount[2]<next)
+   next=t+wlcount[2];
+  if(next>end)
+  {
+   if(trion)
+    wlcount[2]-=end-t;
+   wlcount[3]-=end-t;
+   break;
+  }
+
+  if(trion)
+  {
+   wlcount[2]-=next-t;
+   if(!wlcount[2])
+   {
+    wlcount[2]=triperiod;
+    tristep++;
+    tri=TriangleStepOut();
+   }
+  }
+  wlcount[3]-=next-t;
+  if(!wlcount[3])
+  {
+   if(PAL)
+     wlcount[3]=NoiseFreqTablePAL[PSG[0xE]&0xF];
+   else
+     wlcount[3]=NoiseFreqTableNTSC[PSG[0xE]&0xF];
+   nreg=(nreg<<1)+(((nreg>>nshift)^(nreg>>14))&1);
+   nreg&=0x7fff;
+   noise=((nreg>>0xe)&1)?0:noiseamp;
+  }
+  t=next;
+ }
+
+ ChannelBC[2]=ChannelBC[3]=ChannelBC[4]=end;
+}
+
 DECLFW(Write_IRQFM)
 {
  V=(V&0xC0)>>6;
@@ -1033,7 +1233,7 @@ void SetNESSoundMap(void)
   SetReadHandler(0x4015,0x4015,StatusRead);
 }
 
-static int32 inbuf=0;
+static FCEU_THREAD_LOCAL int32 inbuf=0;
 int FlushEmulateSound(void)
 {
   int x;
@@ -1054,7 +1254,28 @@ int FlushEmulateSound(void)
   DoNoise();
   DoPCM();
 
-  if(FSettings.soundq>=1)
+  if(FSettings.soundq>=1 && FSettings.stepsynth)
+  {
+   if(GameExpSound.StepFill) GameExpSound.StepFill();
+   else if(GameExpSound.HiFill)
+   {
+    GameExpSound.HiFill();
+    for(x=0;x<(int)SOUNDTS;x++)
+     if(WaveHi[x]!=hiStepOut)
+     {
+      StepSynthAdd(x,WaveHi[x]-hiStepOut);
+      hiStepOut=WaveHi[x];
+     }
+    memset(WaveHi,0,SOUNDTS*sizeof(int32));
+   }
+   end=StepSynthRead(WaveFinal,SOUNDTS);
+   left=0;
+
+   if(GameExpSound.HiSync) GameExpSound.HiSync(0);
+   for(x=0;x<5;x++)
+    ChannelBC[x]=0;
+  }
+  else if(FSettings.soundq>=1)
   {
    int32 *tmpo=&WaveHi[soundtsoffs];
 
@@ -1234,7 +1455,16 @@ void SetSoundVariables(void)
     wlookup2[x]=(double)16*16*16*4*163.67/((double)24329/(double)x+100);
     if(!FSettings.soundq) wlookup2[x]>>=4;
    }
-   if(FSettings.soundq>=1)
+   if(FSettings.soundq>=1 && FSettings.stepsynth)
+   {
+    DoSQ1=DoSQ2=SDoSquares;
+    DoTriangle=DoNoise=DoPCM=SDoTND;
+    sqStepOut=tndStepOut=hiStepOut=0;
+    //No history is kept between frames.
+    soundtsoffs=0;
+    memset(WaveHi,0,sizeof(WaveHi));
+   }
+   else if(FSettings.soundq>=1)
    {
     DoNoise=RDoNoise;
     DoTriangle=RDoTriangle;
@@ -1289,6 +1519,12 @@ void FCEUI_SetSoundQuality(int quality)
 	SetSoundVariables();
 }
 
+void FCEUI_SetSoundStepSynth(int on)
+{
+	FSettings.stepsynth=on;
+	SetSoundVariables();
+}
+
 void FCEUI_SetSoundVolume(uint32 volume)
 {
 	FSettings.SoundVolume=volume;
@@ -1319,7 +1555,7 @@ void FCEUI_SetPCMVolume(uint32 volume)
 	FSettings.PCMVolume=volume;
 }
 
-SFORMAT FCEUSND_STATEINFO[]={
+FCEU_THREAD_LOCAL_OBJECT SFORMAT FCEUSND_STATEINFO[]={
 
  { &fhcnt, 4|FCEUSTATE_RLSB,"FHCN"},
  { &fcnt, 1, "FCNT"},
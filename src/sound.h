@@ -34,31 +34,41 @@ typedef struct {
 	   void (*HiFill)(void);
 	   void (*HiSync)(int32 ts);
 
+	   /* Takes the place of HiFill with step synthesis: brings the device
+	      up to SOUNDTS, reporting every change of its output through
+	      StepSynthAdd() rather than adding it to WaveHi.  Devices without
+	      one still fill WaveHi, and the changes are picked out of that. */
+	   void (*StepFill)(void);
+
 	   void (*RChange)(void);
 	   void (*Kill)(void);
 } EXPSOUND;
 
-extern EXPSOUND GameExpSound;
+extern FCEU_THREAD_LOCAL EXPSOUND GameExpSound;
 
-extern int32 nesincsize;
+extern FCEU_THREAD_LOCAL int32 nesincsize;
 
 void SetSoundVariables(void);
 
+/* Step synthesis: changes the sound output by delta (in WaveHi units) at
+   time ts on the SOUNDTS clock. */
+void StepSynthAdd(uint32 ts, int32 delta);
+
 int GetSoundBuffer(int32 **W);
 int FlushEmulateSound(void);
-extern int32 Wave[2048+512];
-extern int32 WaveFinal[2048+512];
-extern int32 WaveHi[];
-extern uint32 soundtsinc;
+extern FCEU_THREAD_LOCAL int32 Wave[2048+512];
+extern FCEU_THREAD_LOCAL int32 WaveFinal[2048+512];
+extern FCEU_THREAD_LOCAL int32 WaveHi[];
+extern FCEU_THREAD_LOCAL uint32 soundtsinc;
 
 #ifdef WIN32
-extern volatile int datacount, undefinedcount;
-extern int debug_loggingCD;
-extern unsigned char *cdloggerdata;
+extern FCEU_THREAD_LOCAL volatile int datacount, undefinedcount;
+extern FCEU_THREAD_LOCAL int debug_loggingCD;
+extern FCEU_THREAD_LOCAL unsigned char *cdloggerdata;
 #endif
 
-extern uint32 soundtsoffs;
-extern bool swapDuty;
+extern FCEU_THREAD_LOCAL uint32 soundtsoffs;
+extern FCEU_THREAD_LOCAL bool swapDuty;
 #define SOUNDTS (soundtimestamp + soundtsoffs)
 
 void SetNESSoundMap(void);
@@ -70,6 +80,7 @@ void FCEUSND_SaveState(void);
 void FCEUSND_LoadState(int version);
 
 void FCEU_SoundCPUHook(int);
+int32 FCEU_SoundCPUHookNext(void);
 void Write_IRQFM (uint32 A, uint8 V); //mbg merge 7/17/06 brought over from latest mmbuild
 
 void LogDPCM(int romaddress, int dpcmsize);
@@ -33,6 +33,7 @@
 #include "state.h"
 #include "movie.h"
 #include "ppu.h"
+#include "cart.h"
 #include "netplay.h"
 #include "video.h"
 #include "input.h"
@@ -57,54 +58,60 @@
 //#include <unistd.h> //mbg merge 7/17/06 removed
 
 #include <vector>
+#include <deque>
 #include <fstream>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 using namespace std;
 
-static void (*SPreSave)(void) = NULL;
-static void (*SPostSave)(void) = NULL;
-static void (*SPostLoad)(bool) = NULL;
+static FCEU_THREAD_LOCAL void (*SPreSave)(void) = NULL;
+static FCEU_THREAD_LOCAL void (*SPostSave)(void) = NULL;
+static FCEU_THREAD_LOCAL void (*SPostLoad)(bool) = NULL;
 
-static int SaveStateStatus[10];
-static int StateShow;
+static FCEU_THREAD_LOCAL int SaveStateStatus[10];
+static FCEU_THREAD_LOCAL int StateShow;
 
 //tells the save system innards that we're loading the old format
-bool FCEU_state_loading_old_format = false;
+FCEU_THREAD_LOCAL bool FCEU_state_loading_old_format = false;
 
-std::string lastSavestateMade; //Stores the filename of the last savestate made (needed for UndoSavestate)
-bool undoSS = false;		  //This will be true if there is lastSavestateMade, it was made since ROM was loaded, a backup state for lastSavestateMade exists
-bool redoSS = false;		  //This will be true if UndoSaveState is run, will turn false when a new savestate is made
+FCEU_THREAD_LOCAL_OBJECT std::string lastSavestateMade; //Stores the filename of the last savestate made (needed for UndoSavestate)
+FCEU_THREAD_LOCAL bool undoSS = false;		  //This will be true if there is lastSavestateMade, it was made since ROM was loaded, a backup state for lastSavestateMade exists
+FCEU_THREAD_LOCAL bool redoSS = false;		  //This will be true if UndoSaveState is run, will turn false when a new savestate is made
 
-std::string lastLoadstateMade; //Stores the filename of the last state loaded (needed for Undo/Redo loadstate)
-bool undoLS = false;		  //This will be true if a backupstate was made and it was made since ROM was loaded
-bool redoLS = false;		  //This will be true if a backupstate was loaded, meaning redoLoadState can be run
+FCEU_THREAD_LOCAL_OBJECT std::string lastLoadstateMade; //Stores the filename of the last state loaded (needed for Undo/Redo loadstate)
+FCEU_THREAD_LOCAL bool undoLS = false;		  //This will be true if a backupstate was made and it was made since ROM was loaded
+FCEU_THREAD_LOCAL bool redoLS = false;		  //This will be true if a backupstate was loaded, meaning redoLoadState can be run
 
-bool internalSaveLoad = false;
+FCEU_THREAD_LOCAL bool internalSaveLoad = false;
 
-bool backupSavestates = true;
-bool compressSavestates = true;  //By default FCEUX compresses savestates when a movie is inactive.
+FCEU_THREAD_LOCAL bool backupSavestates = true;
+FCEU_THREAD_LOCAL bool compressSavestates = true;  //By default FCEUX compresses savestates when a movie is inactive.
 
 // a temp memory stream. We'll be dumping some data here and then compress
-static EMUFILE_MEMORY memory_savestate;
+static FCEU_THREAD_LOCAL_OBJECT EMUFILE_MEMORY memory_savestate;
 // temporary buffer for compressed data of a savestate
-static std::vector<uint8> compressed_buf;
+static FCEU_THREAD_LOCAL_OBJECT std::vector<uint8> compressed_buf;
 
 #define SFMDATA_SIZE (128)
-static SFORMAT SFMDATA[SFMDATA_SIZE];
-static int SFEXINDEX;
+static FCEU_THREAD_LOCAL SFORMAT SFMDATA[SFMDATA_SIZE];
+static FCEU_THREAD_LOCAL int SFEXINDEX;
 
 #define RLSB 		FCEUSTATE_RLSB	//0x80000000
 
 
-extern SFORMAT FCEUPPU_STATEINFO[];
-extern SFORMAT FCEU_NEWPPU_STATEINFO[];
-extern SFORMAT FCEUSND_STATEINFO[];
-extern SFORMAT FCEUCTRL_STATEINFO[];
-extern SFORMAT FCEUMOV_STATEINFO[];
+extern FCEU_THREAD_LOCAL_OBJECT SFORMAT FCEUPPU_STATEINFO[];
+extern FCEU_THREAD_LOCAL_OBJECT SFORMAT FCEU_NEWPPU_STATEINFO[];
+extern FCEU_THREAD_LOCAL_OBJECT SFORMAT FCEUSND_STATEINFO[];
+extern FCEU_THREAD_LOCAL_OBJECT SFORMAT FCEUCTRL_STATEINFO[];
+extern FCEU_THREAD_LOCAL_OBJECT SFORMAT FCEUMOV_STATEINFO[];
 
 //why two separate CPU structs?? who knows
 
-SFORMAT SFCPU[]={
+FCEU_THREAD_LOCAL_OBJECT SFORMAT SFCPU[]={
 	{ &X.PC, 2|RLSB, "PC\0"},
 	{ &X.A, 1, "A\0\0"},
 	{ &X.X, 1, "X\0\0"},
@@ -116,7 +123,7 @@ SFORMAT SFCPU[]={
 	{ 0 }
 };
 
-SFORMAT SFCPUC[]={
+FCEU_THREAD_LOCAL_OBJECT SFORMAT SFCPUC[]={
 	{ &X.jammed, 1, "JAMM"},
 	{ &X.IRQlow, 4|RLSB, "IQLB"},
 	{ &X.tcount, 4|RLSB, "ICoa"},
@@ -128,64 +135,147 @@ SFORMAT SFCPUC[]={
 
 void foo(uint8* test) { (void)test; }
 
-static int SubWrite(EMUFILE* os, SFORMAT *sf)
+//A chunk's SFORMAT list with the links followed, built the first time the chunk
+//is saved or loaded. Saving then needs no sizing pass and loading finds each tag
+//with one hash probe instead of a walk over every entry.
+struct SFLAYOUTENTRY
 {
-	uint32 acc=0;
+	SFORMAT *sf;
+	uint32 tag;
+	uint32 size;	//without flags
+	bool dup;	//tag also appears elsewhere in the chunk: leave it to CheckS
+	uint8 header[8];	//tag and little endian size, as written
+};
+
+struct SFLAYOUT
+{
+	SFORMAT *root;
+	uint32 size;	//chunk size: 8 bytes of tag and size per entry plus the data
+	std::vector<SFLAYOUTENTRY> entries;
+	std::vector<uint32> hash;	//entry index + 1, 0 for an empty slot
+	uint32 hashbits;
+};
+
+//indexed by chunk type; SFMDATA's is rebuilt after AddExState/ResetExState
+#define SFLAYOUT_COUNT 32
+static FCEU_THREAD_LOCAL_OBJECT SFLAYOUT sfLayouts[SFLAYOUT_COUNT];
+
+static inline uint32 SFTag(const char *desc)
+{
+	uint32 tag;
+	memcpy(&tag,desc,4);
+	return tag;
+}
 
+static inline uint32 SFHash(uint32 tag, uint32 bits)
+{
+	return (tag*2654435761u)>>(32-bits);
+}
+
+static void FlattenSF(SFLAYOUT &layout, SFORMAT *sf)
+{
 	while(sf->v)
 	{
 		if(sf->s==~0u)		//Link to another struct
 		{
-			uint32 tmp;
-
-			if(!(tmp=SubWrite(os,(SFORMAT *)sf->v)))
-				return(0);
-			acc+=tmp;
+			FlattenSF(layout,(SFORMAT *)sf->v);
 			sf++;
 			continue;
 		}
 
-		acc+=8;			//Description + size
-		acc+=sf->s&(~FCEUSTATE_FLAGS);
+		SFLAYOUTENTRY e;
+		e.sf=sf;
+		e.tag=SFTag(sf->desc);
+		e.size=sf->s&(~FCEUSTATE_FLAGS);
+		e.dup=false;
+		memcpy(e.header,sf->desc,4);
+		FCEU_en32lsb(e.header+4,e.size);
+		layout.entries.push_back(e);
 
-		if(os)			//Are we writing or calculating the size of this block?
-		{
-			os->fwrite(sf->desc,4);
-			write32le(sf->s&(~FCEUSTATE_FLAGS),os);
+		layout.size+=8+e.size;
+		sf++;
+	}
+}
 
-#ifdef FCEU_BIG_ENDIAN
-			if(sf->s&RLSB)
-				FlipByteOrder((uint8*)sf->v,sf->s&(~FCEUSTATE_FLAGS));
-#endif
+static SFLAYOUT &GetSFLayout(int type, SFORMAT *sf)
+{
+	SFLAYOUT &layout=sfLayouts[type];
 
-			if(sf->s&FCEUSTATE_INDIRECT)
-				os->fwrite(*(char **)sf->v,sf->s&(~FCEUSTATE_FLAGS));
-			else
-				os->fwrite((char*)sf->v,sf->s&(~FCEUSTATE_FLAGS));
+	if(layout.root==sf)
+		return layout;
 
-			//Now restore the original byte order.
-#ifdef FCEU_BIG_ENDIAN
-			if(sf->s&RLSB)
-				FlipByteOrder((uint8*)sf->v,sf->s&(~FCEUSTATE_FLAGS));
-#endif
+	layout.root=sf;
+	layout.size=0;
+	layout.entries.clear();
+	FlattenSF(layout,sf);
+
+	uint32 n=(uint32)layout.entries.size();
+	layout.hashbits=4;
+	while((1u<<layout.hashbits) < n*2)
+		layout.hashbits++;
+	layout.hash.assign(1u<<layout.hashbits,0);
+
+	uint32 mask=(1u<<layout.hashbits)-1;
+	for(uint32 i=0;i<n;i++)
+	{
+		SFLAYOUTENTRY &e=layout.entries[i];
+		uint32 h=SFHash(e.tag,layout.hashbits);
+
+		while(layout.hash[h])
+		{
+			SFLAYOUTENTRY &other=layout.entries[layout.hash[h]-1];
+			if(other.tag==e.tag)
+			{
+				other.dup=e.dup=true;
+				break;
+			}
+			h=(h+1)&mask;
 		}
-		sf++;
+		if(!layout.hash[h])
+			layout.hash[h]=i+1;
 	}
+	return layout;
+}
 
-	return(acc);
+static void InvalidateSFLayout(SFORMAT *sf)
+{
+	for(int i=0;i<SFLAYOUT_COUNT;i++)
+	{
+		if(sfLayouts[i].root==sf)
+			sfLayouts[i].root=0;
+	}
 }
 
 static int WriteStateChunk(EMUFILE* os, int type, SFORMAT *sf)
 {
+	SFLAYOUT &layout=GetSFLayout(type,sf);
+
 	os->fputc(type);
-	int bsize = SubWrite((EMUFILE*)0,sf);
-	write32le(bsize,os);
+	write32le(layout.size,os);
 
-	if(!SubWrite(os,sf))
+	for(size_t i=0;i<layout.entries.size();i++)
 	{
-		return 5;
+		const SFLAYOUTENTRY &e=layout.entries[i];
+
+		os->fwrite(e.header,8);
+
+#ifdef FCEU_BIG_ENDIAN
+		if(e.sf->s&RLSB)
+			FlipByteOrder((uint8*)e.sf->v,e.size);
+#endif
+
+		if(e.sf->s&FCEUSTATE_INDIRECT)
+			os->fwrite(*(char **)e.sf->v,e.size);
+		else
+			os->fwrite((char*)e.sf->v,e.size);
+
+		//Now restore the original byte order.
+#ifdef FCEU_BIG_ENDIAN
+		if(e.sf->s&RLSB)
+			FlipByteOrder((uint8*)e.sf->v,e.size);
+#endif
 	}
-	return (bsize+5);
+	return (layout.size+5);
 }
 
 static SFORMAT *CheckS(SFORMAT *sf, uint32 tsize, char *desc)
@@ -211,9 +301,45 @@ static SFORMAT *CheckS(SFORMAT *sf, uint32 tsize, char *desc)
 	return(0);
 }
 
-static bool ReadStateChunk(EMUFILE* is, SFORMAT *sf, int size)
+//Finds the entry for a tag read from a state. States are normally written by the
+//same layout, so the entry after the last one found is tried before the hash.
+static SFORMAT *FindSF(SFLAYOUT &layout, uint32 tsize, char *desc, uint32 &next)
+{
+	uint32 tag=SFTag(desc);
+	uint32 n=(uint32)layout.entries.size();
+	uint32 i=next;
+
+	if(i>=n || layout.entries[i].tag!=tag)
+	{
+		uint32 mask=(1u<<layout.hashbits)-1;
+		uint32 h=SFHash(tag,layout.hashbits);
+
+		for(;;)
+		{
+			if(!layout.hash[h])
+				return(0);
+			i=layout.hash[h]-1;
+			if(layout.entries[i].tag==tag)
+				break;
+			h=(h+1)&mask;
+		}
+	}
+
+	const SFLAYOUTENTRY &e=layout.entries[i];
+
+	if(e.dup)
+		return CheckS(layout.root,tsize,desc);
+	if(tsize!=e.size)
+		return(0);
+	next=i+1;
+	return e.sf;
+}
+
+static bool ReadStateChunk(EMUFILE* is, int type, SFORMAT *sf, int size)
 {
 	SFORMAT *tmp;
+	SFLAYOUT &layout=GetSFLayout(type,sf);
+	uint32 next=0;
 	int temp = is->ftell();
 
 	while(is->ftell()<temp+size)
@@ -225,7 +351,7 @@ static bool ReadStateChunk(EMUFILE* is, SFORMAT *sf, int size)
 
 		read32le(&tsize,is);
 
-		if((tmp=CheckS(sf,tsize,toa)))
+		if((tmp=FindSF(layout,tsize,toa,next)))
 		{
 			if(tmp->s&FCEUSTATE_INDIRECT)
 				is->fread(*(char **)tmp->v,tmp->s&(~FCEUSTATE_FLAGS));
@@ -243,7 +369,7 @@ static bool ReadStateChunk(EMUFILE* is, SFORMAT *sf, int size)
 	return true;
 }
 
-static int read_sfcpuc=0, read_snd=0;
+static FCEU_THREAD_LOCAL int read_sfcpuc=0, read_snd=0;
 
 void FCEUD_BlitScreen(uint8 *XBuf); //mbg merge 7/17/06 YUCKY had to add
 void UpdateFCEUWindow(void);  //mbg merge 7/17/06 YUCKY had to add
@@ -253,6 +379,7 @@ static bool ReadStateChunks(EMUFILE* is, int32 totalsize)
 	uint32 size;
 	bool ret=true;
 	bool warned=false;
+	bool movieLoaded=false, movieUnavailable=false;
 
 	read_sfcpuc=0;
 	read_snd=0;
@@ -271,25 +398,38 @@ static bool ReadStateChunks(EMUFILE* is, int32 totalsize)
 
 		switch(t)
 		{
-		case 1:if(!ReadStateChunk(is,SFCPU,size)) ret=false;break;
-		case 3:if(!ReadStateChunk(is,FCEUPPU_STATEINFO,size)) ret=false;break;
-		case 31:if(!ReadStateChunk(is,FCEU_NEWPPU_STATEINFO,size)) ret=false;break;
-		case 4:if(!ReadStateChunk(is,FCEUCTRL_STATEINFO,size)) ret=false;break;
+		case 1:if(!ReadStateChunk(is,1,SFCPU,size)) ret=false;break;
+		case 3:if(!ReadStateChunk(is,3,FCEUPPU_STATEINFO,size)) ret=false;break;
+		case 31:if(!ReadStateChunk(is,31,FCEU_NEWPPU_STATEINFO,size)) ret=false;break;
+		case 4:if(!ReadStateChunk(is,4,FCEUCTRL_STATEINFO,size)) ret=false;break;
 		case 7:
+			if(movieLoaded)
+			{
+				//the timeline (chunk 9) had the movie already
+				is->fseek(size,SEEK_CUR);
+				break;
+			}
+			movieUnavailable=false;
 			if(!FCEUMOV_ReadState(is,size)) {
 				//allow this to fail in old-format savestates.
 				if(!FCEU_state_loading_old_format)
 					ret=false;
 			}
 			break;
+		case 9:
+			if(FCEUMOV_ReadTimelineState(is,size,movieUnavailable))
+				movieLoaded=true;
+			else if(!movieUnavailable)
+				ret=false;
+			break;
 		case 0x10:
-			if(!ReadStateChunk(is,SFMDATA,size)) 
+			if(!ReadStateChunk(is,0x10,SFMDATA,size)) 
 				ret=false; 
 			break;
 
 			// now it gets hackier:
 		case 5:
-			if(!ReadStateChunk(is,FCEUSND_STATEINFO,size))
+			if(!ReadStateChunk(is,5,FCEUSND_STATEINFO,size))
 				ret=false;
 			else
 				read_snd=1;
@@ -297,7 +437,7 @@ static bool ReadStateChunks(EMUFILE* is, int32 totalsize)
 		case 6:
 			if(FCEUMOV_Mode(MOVIEMODE_PLAY|MOVIEMODE_RECORD|MOVIEMODE_FINISHED))
 			{
-				if(!ReadStateChunk(is,FCEUMOV_STATEINFO,size)) ret=false;
+				if(!ReadStateChunk(is,6,FCEUMOV_STATEINFO,size)) ret=false;
 			}
 			else
 			{
@@ -307,7 +447,7 @@ static bool ReadStateChunks(EMUFILE* is, int32 totalsize)
 		case 8:
 			// load back buffer
 			{
-				extern uint8 *XBackBuf;
+				extern FCEU_THREAD_LOCAL uint8 *XBackBuf;
 				//ignore 8 garbage bytes, whose idea was it to write these or even have them there in the first place
 				if(size == 256*256+8)
 				{
@@ -336,7 +476,7 @@ static bool ReadStateChunks(EMUFILE* is, int32 totalsize)
 			break;
 		case 2:
 			{
-				if(!ReadStateChunk(is,SFCPUC,size))
+				if(!ReadStateChunk(is,2,SFCPUC,size))
 					ret=false;
 				else
 					read_sfcpuc=1;
@@ -356,6 +496,13 @@ static bool ReadStateChunks(EMUFILE* is, int32 totalsize)
 	}
 	//endo:
 
+	if(movieUnavailable)
+	{
+		//chunk 9 alone, from another session
+		FCEU_PrintError("Error: The savestate's movie is from another session and is no longer available.");
+		ret=false;
+	}
+
 	//mbg 6/16/08 - wtf
 	// if(X.mooPI==0xFF && !scan_chunks)
 	// {
@@ -363,7 +510,7 @@ static bool ReadStateChunks(EMUFILE* is, int32 totalsize)
 	//   X.mooPI=X.P; // "Quick and dirty hack." //begone
 	// }
 
-	extern int resetDMCacc;
+	extern FCEU_THREAD_LOCAL int resetDMCacc;
 	if(read_snd)
 		resetDMCacc=0;
 	else
@@ -372,11 +519,13 @@ static bool ReadStateChunks(EMUFILE* is, int32 totalsize)
 	return ret;
 }
 
-int CurrentState=0;
-extern int geniestage;
+FCEU_THREAD_LOCAL int CurrentState=0;
+extern FCEU_THREAD_LOCAL int geniestage;
 
 
-bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel)
+//Writes the uncompressed state to memory_savestate.
+//sessionOnly states are never kept beyond this session, so the movie goes in as its timeline alone
+static bool CaptureState(bool sessionOnly)
 {
 	// reinit memory_savestate
 	// memory_savestate is global variable which already has its vector of bytes, so no need to allocate memory every time we use save/loadstate
@@ -403,19 +552,34 @@ bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel)
 		//do not save the movie state if we are in Taseditor! That would be a huge waste of time and space!
 		if(!FCEUMOV_Mode(MOVIEMODE_TASEDITOR))
 		{
+			//the movie is saved as its timeline (chunk 9), which only holds the records after the blocks
+			//this session already has. Other states also carry the whole movie text (chunk 7) after it,
+			//for older builds and other sessions; loading skips it when chunk 9 could be used.
 			os->fseek(5,SEEK_CUR);
-			int size = FCEUMOV_WriteState(os);
+			int size = FCEUMOV_WriteTimelineState(os);
 			os->fseek(-(size+5),SEEK_CUR);
-			os->fputc(7);
+			os->fputc(9);
 			write32le(size, os);
 			os->fseek(size,SEEK_CUR);
 
 			totalsize += 5 + size;
+
+			if(!sessionOnly)
+			{
+				os->fseek(5,SEEK_CUR);
+				size = FCEUMOV_WriteState(os);
+				os->fseek(-(size+5),SEEK_CUR);
+				os->fputc(7);
+				write32le(size, os);
+				os->fseek(size,SEEK_CUR);
+
+				totalsize += 5 + size;
+			}
 		}
 	}
 	// save back buffer
 	{
-		extern uint8 *XBackBuf;
+		extern FCEU_THREAD_LOCAL uint8 *XBackBuf;
 		uint32 size = 256 * 256;
 		os->fputc(8);
 		write32le(size, os);
@@ -436,6 +600,16 @@ bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel)
 		FCEUD_PrintError("sanity violation: len != totalsize");
 		return false;
 	}
+	return true;
+}
+
+static bool SaveMS(EMUFILE* outstream, int compressionLevel, bool sessionOnly)
+{
+	if(!CaptureState(sessionOnly))
+		return false;
+
+	size_t len = memory_savestate.size();
+	uint32 totalsize = (uint32)len;
 
 	int error = Z_OK;
 	uint8* cbuf = (uint8*)memory_savestate.buf();
@@ -463,6 +637,526 @@ bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel)
 	return error == Z_OK;
 }
 
+bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel)
+{
+	return SaveMS(outstream, compressionLevel, false);
+}
+
+//Savestate compression worker pool. A job owns a copy of the uncompressed
+//state taken from a pool of buffers, so the caller can go on changing its own.
+namespace
+{
+class SavestateCompressor
+{
+	public:
+		SavestateCompressor(void)
+		{
+			unsigned int n = std::thread::hardware_concurrency();
+
+			numWorkers = (n > 2) ? std::min(n - 1, 4u) : 1;
+			maxQueued  = numWorkers * 4;
+			quit = false;
+		}
+
+		~SavestateCompressor(void)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				quit = true;
+			}
+			jobReady.notify_all();
+
+			for (size_t i = 0; i < workers.size(); i++)
+			{
+				workers[i].join();
+			}
+		}
+
+		std::future< std::vector<uint8> > submit(const uint8 *state, size_t len, int compressionLevel)
+		{
+			Job job;
+
+			job.compressionLevel = compressionLevel;
+
+			std::future< std::vector<uint8> > result = job.done.get_future();
+
+			std::unique_lock<std::mutex> lock(mtx);
+
+			if (workers.empty())
+			{
+				for (unsigned int i = 0; i < numWorkers; i++)
+				{
+					workers.emplace_back( &SavestateCompressor::run, this );
+				}
+			}
+
+			// Only when the workers fall this far behind does the caller wait for them
+			jobTaken.wait( lock, [this]{ return jobs.size() < maxQueued; } );
+
+			if (!freeBuffers.empty())
+			{
+				job.state.swap( freeBuffers.back() );
+				freeBuffers.pop_back();
+			}
+			job.state.assign(state, state + len);
+
+			jobs.push_back( std::move(job) );
+
+			lock.unlock();
+			jobReady.notify_one();
+
+			return result;
+		}
+
+	private:
+		struct Job
+		{
+			std::vector<uint8> state;
+			int compressionLevel;
+			std::promise< std::vector<uint8> > done;
+		};
+
+		void run(void)
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+
+			while (true)
+			{
+				jobReady.wait( lock, [this]{ return quit || !jobs.empty(); } );
+
+				if (jobs.empty())
+				{
+					return;
+				}
+				Job job = std::move( jobs.front() );
+				jobs.pop_front();
+
+				lock.unlock();
+				jobTaken.notify_one();
+
+				job.done.set_value( compress(job.state, job.compressionLevel) );
+
+				lock.lock();
+
+				freeBuffers.push_back( std::move(job.state) );
+			}
+		}
+
+		static std::vector<uint8> compress(std::vector<uint8> &state, int compressionLevel)
+		{
+			std::vector<uint8> out;
+
+			if (state.size() < 16 || FCEU_de32lsb(&state[12]) != ~0u)
+			{
+				return out;
+			}
+			size_t len = state.size() - 16;
+			uLongf comprlen = (len>>9)+12 + len;
+
+			out.resize(16 + comprlen);
+
+			if (compress2(&out[16], &comprlen, &state[16], len, compressionLevel) != Z_OK)
+			{
+				out.clear();
+				return out;
+			}
+			memcpy(&out[0], &state[0], 12);
+			FCEU_en32lsb(&out[12], comprlen);
+
+			out.resize(16 + comprlen);
+			out.shrink_to_fit();
+
+			return out;
+		}
+
+		std::vector<std::thread> workers;
+		std::deque<Job> jobs;
+		std::vector< std::vector<uint8> > freeBuffers;
+		std::mutex mtx;
+		std::condition_variable jobReady;
+		std::condition_variable jobTaken;
+		unsigned int numWorkers;
+		size_t maxQueued;
+		bool quit;
+};
+}
+
+std::future< std::vector<uint8> > FCEUSS_CompressMSAsync(const uint8 *state, size_t len, int compressionLevel)
+{
+	static SavestateCompressor compressor;
+
+	return compressor.submit(state, len, compressionLevel);
+}
+
+//Incremental savestates. The CPU write paths mark RAM pages in RAMDirtyPages and the PPU
+//write paths mark nametable RAM and CHR RAM pages through FCEUSS_MarkDirty, so those only
+//need comparing where they were written. The rest of the state (WRAM, mapper registers,
+//the back buffer...) is compared a page at a time with the parent image. The parent is
+//identified by a CRC over the CRCs of its pages, so a save or load only hashes the pages
+//it changed.
+#define DIRTY_PAGE_SHIFT 8
+#define DIRTY_PAGE_SIZE (1 << DIRTY_PAGE_SHIFT)
+
+struct DIRTYREGION
+{
+	const uint8 *base;
+	uint32 size;
+	std::vector<uint8> dirty;	//one flag per page
+};
+
+struct DIRTYSPAN
+{
+	uint32 offset;	//where the tracked memory sits in the image
+	uint32 size;
+	const uint8 *dirty;
+};
+
+static FCEU_THREAD_LOCAL bool incActive = false;	//nothing is kept until the first incremental save or load
+static FCEU_THREAD_LOCAL_OBJECT std::vector<DIRTYREGION> dirtyRegions;
+static FCEU_THREAD_LOCAL_OBJECT std::vector<DIRTYSPAN> incSpans;
+static FCEU_THREAD_LOCAL_OBJECT std::vector<uint32> incRuns;	//offset and length pairs
+static FCEU_THREAD_LOCAL_OBJECT std::vector<uint8> incParent;	//the image incremental states are made against
+static FCEU_THREAD_LOCAL_OBJECT std::vector<uint8> incLoadBuf;
+static FCEU_THREAD_LOCAL_OBJECT std::vector<uint32> incPageCRCs;	//one per page of incParent
+static FCEU_THREAD_LOCAL_OBJECT std::vector<uint32> incLoadPageCRCs;
+static FCEU_THREAD_LOCAL uint32 incParentCRC = 0;
+static FCEU_THREAD_LOCAL bool incParentCRCValid = false;	//covers incPageCRCs too
+
+void FCEUSS_MarkDirty(const uint8 *p)
+{
+	//chips can share memory, so every region holding p is marked
+	for(size_t i=0;i<dirtyRegions.size();i++)
+	{
+		DIRTYREGION &r=dirtyRegions[i];
+		if(p>=r.base && p<r.base+r.size)
+			r.dirty[(p-r.base)>>DIRTY_PAGE_SHIFT]=1;
+	}
+}
+
+void FCEUSS_MarkAllDirty(void)
+{
+	memset(RAMDirtyPages,1,sizeof(RAMDirtyPages));
+	for(size_t i=0;i<dirtyRegions.size();i++)
+		std::fill(dirtyRegions[i].dirty.begin(),dirtyRegions[i].dirty.end(),1);
+}
+
+static void ClearDirtyPages(void)
+{
+	memset(RAMDirtyPages,0,sizeof(RAMDirtyPages));
+	for(size_t i=0;i<dirtyRegions.size();i++)
+		std::fill(dirtyRegions[i].dirty.begin(),dirtyRegions[i].dirty.end(),0);
+}
+
+static bool DirtyRegionIs(size_t i, const uint8 *base, uint32 size)
+{
+	return i<dirtyRegions.size() && dirtyRegions[i].base==base && dirtyRegions[i].size==size;
+}
+
+static void AddDirtyRegion(const uint8 *base, uint32 size)
+{
+	DIRTYREGION r;
+	r.base=base;
+	r.size=size;
+	r.dirty.assign((size+DIRTY_PAGE_SIZE-1)>>DIRTY_PAGE_SHIFT,1);
+	dirtyRegions.push_back(r);
+}
+
+//Nametable RAM and the cart's CHR RAM chips. A region that is new or has moved starts
+//out with every page dirty.
+static void SyncDirtyRegions(void)
+{
+	bool same=DirtyRegionIs(0,NTARAM,0x800);
+	size_t n=1;
+	for(int i=0;i<32;i++)
+	{
+		if(CHRram[i] && CHRptr[i] && CHRsize[i])
+			same=same && DirtyRegionIs(n++,CHRptr[i],CHRsize[i]);
+	}
+	if(same && n==dirtyRegions.size())
+		return;
+
+	dirtyRegions.clear();
+	AddDirtyRegion(NTARAM,0x800);
+	for(int i=0;i<32;i++)
+	{
+		if(CHRram[i] && CHRptr[i] && CHRsize[i])
+			AddDirtyRegion(CHRptr[i],CHRsize[i]);
+	}
+}
+
+static const uint8 *TrackedPages(const uint8 *v, uint32 size)
+{
+	if(v==RAM && size==0x800)
+		return RAMDirtyPages;
+	for(size_t i=0;i<dirtyRegions.size();i++)
+	{
+		if(dirtyRegions[i].base==v && dirtyRegions[i].size==size)
+			return &dirtyRegions[i].dirty[0];
+	}
+	return 0;
+}
+
+//Finds the tracked memory in an image CaptureState just wrote, using the chunk layouts
+//it was written with.
+static void FindTrackedSpans(uint8 *img, uint32 len)
+{
+	incSpans.clear();
+
+	uint32 pos=0;
+	while(pos+5<=len)
+	{
+		int type=img[pos];
+		uint32 size=FCEU_de32lsb(img+pos+1);
+		pos+=5;
+
+		if(type<SFLAYOUT_COUNT && sfLayouts[type].root && sfLayouts[type].size==size)
+		{
+			const SFLAYOUT &layout=sfLayouts[type];
+			uint32 at=pos;
+			for(size_t i=0;i<layout.entries.size();i++)
+			{
+				const SFLAYOUTENTRY &e=layout.entries[i];
+				const uint8 *v=(e.sf->s&FCEUSTATE_INDIRECT) ? *(uint8 **)e.sf->v : (uint8 *)e.sf->v;
+				at+=8;
+
+				const uint8 *dirty=TrackedPages(v,e.size);
+				if(dirty)
+				{
+					DIRTYSPAN span={at,e.size,dirty};
+					incSpans.push_back(span);
+				}
+				at+=e.size;
+			}
+		}
+		pos+=size;
+	}
+}
+
+static void AddIncRun(uint32 offset, uint32 len)
+{
+	size_t n=incRuns.size();
+	if(n && incRuns[n-2]+incRuns[n-1]==offset)
+		incRuns[n-1]+=len;
+	else
+	{
+		incRuns.push_back(offset);
+		incRuns.push_back(len);
+	}
+}
+
+static void CompareIncPages(const uint8 *img, uint32 start, uint32 end)
+{
+	for(uint32 pos=start;pos<end;pos+=DIRTY_PAGE_SIZE)
+	{
+		uint32 n=std::min<uint32>(DIRTY_PAGE_SIZE,end-pos);
+		if(memcmp(img+pos,&incParent[pos],n))
+			AddIncRun(pos,n);
+	}
+}
+
+//Rehashes the pages of img that bytes offset..offset+len-1 fall in.
+static void UpdateIncPageCRCs(std::vector<uint32> &crcs, const uint8 *img, uint32 size, uint32 offset, uint32 len)
+{
+	if(!len)
+		return;
+	for(uint32 p=offset>>DIRTY_PAGE_SHIFT;p<=(offset+len-1)>>DIRTY_PAGE_SHIFT;p++)
+	{
+		uint32 start=p<<DIRTY_PAGE_SHIFT;
+		crcs[p]=crc32(0,img+start,std::min<uint32>(DIRTY_PAGE_SIZE,size-start));
+	}
+}
+
+static uint32 CombineIncPageCRCs(const std::vector<uint32> &crcs)
+{
+	uint32 crc=0;
+	uint8 buf[4];
+	for(size_t i=0;i<crcs.size();i++)
+	{
+		FCEU_en32lsb(buf,crcs[i]);
+		crc=crc32(crc,buf,4);
+	}
+	return crc;
+}
+
+static uint32 IncParentCRC(void)
+{
+	if(!incParentCRCValid)
+	{
+		uint32 size=(uint32)incParent.size();
+		incPageCRCs.resize((size+DIRTY_PAGE_SIZE-1)>>DIRTY_PAGE_SHIFT);
+		if(size)
+			UpdateIncPageCRCs(incPageCRCs,&incParent[0],size,0,size);
+		incParentCRC=CombineIncPageCRCs(incPageCRCs);
+		incParentCRCValid=true;
+	}
+	return incParentCRC;
+}
+
+//Makes a loaded image the parent, leaving out the movie text (chunk 7) as incremental
+//saves capture the state without it.
+static void SetIncParent(uint8 *img, uint32 size)
+{
+	incParent.clear();
+	uint32 pos=0;
+	while(size-pos>=5)
+	{
+		uint32 chunk=std::min(5+FCEU_de32lsb(img+pos+1),size-pos);
+		if(img[pos]!=7)
+			incParent.insert(incParent.end(),img+pos,img+pos+chunk);
+		pos+=chunk;
+	}
+	incParent.insert(incParent.end(),img+pos,img+size);
+}
+
+bool FCEUSS_SaveMSIncremental(EMUFILE* outstream)
+{
+	if(!incActive)
+	{
+		incActive=true;
+		incParent.clear();
+	}
+
+	SyncDirtyRegions();
+	if(!CaptureState(true))
+		return false;
+
+	uint8 *img=memory_savestate.buf();
+	uint32 len=(uint32)memory_savestate.size();
+
+	//without a parent of the same size the whole image goes out as one run
+	uint32 parentsize=(incParent.size()==len) ? len : 0;
+	uint32 parentcrc=parentsize ? IncParentCRC() : 0;
+
+	incRuns.clear();
+	if(!parentsize)
+		AddIncRun(0,len);
+	else
+	{
+		FindTrackedSpans(img,len);
+
+		uint32 pos=0;
+		for(size_t i=0;i<incSpans.size();i++)
+		{
+			const DIRTYSPAN &span=incSpans[i];
+			CompareIncPages(img,pos,span.offset);
+
+			for(uint32 p=0;p<span.size;p+=DIRTY_PAGE_SIZE)
+			{
+				if(!span.dirty[p>>DIRTY_PAGE_SHIFT])
+					continue;
+				uint32 n=std::min<uint32>(DIRTY_PAGE_SIZE,span.size-p);
+				if(memcmp(img+span.offset+p,&incParent[span.offset+p],n))
+					AddIncRun(span.offset+p,n);
+			}
+			pos=span.offset+span.size;
+		}
+		CompareIncPages(img,pos,len);
+	}
+
+	//the new image becomes the parent
+	if(parentsize)
+	{
+		for(size_t i=0;i<incRuns.size();i+=2)
+		{
+			memcpy(&incParent[incRuns[i]],img+incRuns[i],incRuns[i+1]);
+			UpdateIncPageCRCs(incPageCRCs,&incParent[0],len,incRuns[i],incRuns[i+1]);
+		}
+		incParentCRC=CombineIncPageCRCs(incPageCRCs);
+	}
+	else
+	{
+		incParent.assign(img,img+len);
+		incParentCRCValid=false;
+		IncParentCRC();
+	}
+	ClearDirtyPages();
+
+	uint8 header[24]="FCSI";
+	FCEU_en32lsb(header+4, len);
+	FCEU_en32lsb(header+8, parentsize);
+	FCEU_en32lsb(header+12, parentcrc);
+	FCEU_en32lsb(header+16, incParentCRC);
+	FCEU_en32lsb(header+20, (uint32)(incRuns.size()/2));
+	outstream->fwrite((char*)header,24);
+
+	for(size_t i=0;i<incRuns.size();i+=2)
+	{
+		write32le(incRuns[i],outstream);
+		write32le(incRuns[i+1],outstream);
+		outstream->fwrite((char*)img+incRuns[i],incRuns[i+1]);
+	}
+	return !outstream->fail();
+}
+
+bool FCEUSS_LoadMSIncremental(EMUFILE* is)
+{
+	if(!is) return false;
+
+	uint8 header[24] = {0};
+	if(is->fread((char*)header,24)!=24 || memcmp(header,"FCSI",4))
+		return false;
+
+	uint32 totalsize  = FCEU_de32lsb(header + 4);
+	uint32 parentsize = FCEU_de32lsb(header + 8);
+	uint32 parentcrc  = FCEU_de32lsb(header + 12);
+	uint32 resultcrc  = FCEU_de32lsb(header + 16);
+	uint32 runs       = FCEU_de32lsb(header + 20);
+
+	if(!totalsize)
+		return false;
+	if(parentsize)
+	{
+		if(!incActive || incParent.size()!=parentsize || IncParentCRC()!=parentcrc)
+			return false;
+	}
+
+	//rebuild the image behind a plain uncompressed FCSX header and load that
+	incLoadBuf.resize(16+totalsize);
+	uint8 *img=&incLoadBuf[16];
+	//with a parent of the same size only the pages the runs land in need hashing again
+	bool samesize=(parentsize==totalsize);
+	if(samesize)
+		incLoadPageCRCs=incPageCRCs;
+	if(parentsize)
+		memcpy(img,&incParent[0],std::min(parentsize,totalsize));
+
+	for(uint32 i=0;i<runs;i++)
+	{
+		uint32 offset, len;
+		if(!read32le(&offset,is) || !read32le(&len,is))
+			return false;
+		if(offset>totalsize || len>totalsize-offset)
+			return false;
+		if(is->fread((char*)img+offset,len)!=len)
+			return false;
+		if(samesize)
+			UpdateIncPageCRCs(incLoadPageCRCs,img,totalsize,offset,len);
+	}
+	if(!samesize)
+	{
+		incLoadPageCRCs.resize((totalsize+DIRTY_PAGE_SIZE-1)>>DIRTY_PAGE_SHIFT);
+		UpdateIncPageCRCs(incLoadPageCRCs,img,totalsize,0,totalsize);
+	}
+	if(CombineIncPageCRCs(incLoadPageCRCs)!=resultcrc)
+		return false;
+
+	memcpy(&incLoadBuf[0],"FCSX",4);
+	FCEU_en32lsb(&incLoadBuf[4], totalsize);
+	FCEU_en32lsb(&incLoadBuf[8], FCEU_VERSION_NUMERIC);
+	FCEU_en32lsb(&incLoadBuf[12], ~0u);
+
+	incActive=true;
+	EMUFILE_MEMORY ms(&incLoadBuf);
+	bool ok=FCEUSS_LoadFP(&ms,SSLOADPARAM_NOBACKUP);
+	if(ok)
+	{
+		incPageCRCs.swap(incLoadPageCRCs);
+		incParentCRC=resultcrc;
+		incParentCRCValid=true;
+	}
+	return ok;
+}
+
 
 void FCEUSS_Save(const char *fname, bool display_message)
 {
@@ -655,7 +1349,7 @@ bool FCEUSS_LoadFP(EMUFILE* is, ENUM_SSLOADPARAMS params)
 	EMUFILE_MEMORY msBackupSavestate;
 	if(backup)
 	{
-		FCEUSS_SaveMS(&msBackupSavestate,Z_NO_COMPRESSION);
+		SaveMS(&msBackupSavestate,Z_NO_COMPRESSION,true);
 	}
 
 	uint8 header[16];
@@ -711,6 +1405,18 @@ bool FCEUSS_LoadFP(EMUFILE* is, ENUM_SSLOADPARAMS params)
 
 	bool x = (ReadStateChunks(&memory_savestate, totalsize) != 0);
 
+	//the loaded image is the parent of the next incremental state. Nothing written
+	//since the last one was made is known to match it, so every page gets compared.
+	if(incActive)
+	{
+		if(x)
+			SetIncParent(memory_savestate.buf(),totalsize);
+		else
+			incParent.clear();
+		incParentCRCValid=false;
+	}
+	FCEUSS_MarkAllDirty();
+
 	//mbg 5/24/08 - we don't support old states, so this shouldnt matter.
 	//if(read_sfcpuc && stateversion<9500)
 	//	X.IRQlow=0;
@@ -834,7 +1540,7 @@ bool FCEUSS_Load(const char *fname, bool display_message)
 #endif
 
 		//Update input display if movie is loaded
-		extern uint32 cur_input_display;
+		extern FCEU_THREAD_LOCAL uint32 cur_input_display;
 		extern uint8 FCEU_GetJoyJoy(void);
 
 		cur_input_display = FCEU_GetJoyJoy(); //Input display should show the last buttons pressed (stored in the savestate)
@@ -890,6 +1596,7 @@ void ResetExState(void (*PreSave)(void), void (*PostSave)(void))
 	SPreSave = PreSave;
 	SPostSave = PostSave;
 	SFEXINDEX=0;
+	InvalidateSFLayout(SFMDATA);
 }
 
 void AddExState(void *v, uint32 s, int type, const char *desc)
@@ -934,7 +1641,7 @@ void AddExState(void *v, uint32 s, int type, const char *desc)
 		SFEXINDEX++;
 	else
 	{
-		static int once=1;
+		static FCEU_THREAD_LOCAL int once=1;
 		if(once)
 		{
 			once=0;
@@ -942,6 +1649,7 @@ void AddExState(void *v, uint32 s, int type, const char *desc)
 		}
 	}
 	SFMDATA[SFEXINDEX].v=0;		// End marker.
+	InvalidateSFLayout(SFMDATA);
 }
 
 void FCEUI_SelectStateNext(int n)
@@ -977,7 +1685,7 @@ void FCEUI_SaveState(const char *fname, bool display_message)
 	FCEUSS_Save(fname, display_message);
 }
 
-int loadStateFailed = 0; // hack, this function should return a value instead
+FCEU_THREAD_LOCAL int loadStateFailed = 0; // hack, this function should return a value instead
 
 bool file_exists(const char * filename)
 {
@@ -1209,7 +1917,118 @@ void RedoLoadState()
 //----------- Save State History ----------------
 //-----------------------------------------------------------------------------------------------------
 //-----------------------------------------------------------------------------------------------------
-static StateRecorderConfigData stateRecorderConfig;
+static FCEU_THREAD_LOCAL_OBJECT StateRecorderConfigData stateRecorderConfig;
+
+//A snapshot that is not a full state is stored as the XOR of its image with the
+//previous snapshot's, coded as runs: a varint count of unchanged bytes, a varint
+//count of changed bytes, then the changed bytes XORed.
+static void PutStateDeltaCount(std::vector<uint8> &out, size_t n)
+{
+	while (n >= 0x80)
+	{
+		out.push_back( static_cast<uint8>(n | 0x80) );
+		n >>= 7;
+	}
+	out.push_back( static_cast<uint8>(n) );
+}
+
+static bool GetStateDeltaCount(const std::vector<uint8> &in, size_t &i, size_t &n)
+{
+	int shift = 0;
+
+	n = 0;
+	while (i < in.size())
+	{
+		uint8 b = in[i++];
+
+		n |= static_cast<size_t>(b & 0x7F) << shift;
+
+		if ( !(b & 0x80) )
+		{
+			return true;
+		}
+		shift += 7;
+	}
+	return false;
+}
+
+static void EncodeStateDelta(const uint8 *cur, const uint8 *prev, size_t len, std::vector<uint8> &out)
+{
+	size_t i = 0;
+
+	out.clear();
+
+	while (i < len)
+	{
+		size_t start = i;
+
+		// Unchanged bytes, a word at a time
+		while (i + 8 <= len)
+		{
+			uint64 a, b;
+			memcpy(&a, cur + i, 8);
+			memcpy(&b, prev + i, 8);
+			if (a != b) break;
+			i += 8;
+		}
+		while (i < len && cur[i] == prev[i]) i++;
+
+		size_t same = i - start;
+
+		// Changed bytes; a gap of fewer than 8 unchanged ones costs less to keep in the run
+		start = i;
+		while (i < len)
+		{
+			if (cur[i] != prev[i])
+			{
+				i++;
+				continue;
+			}
+			size_t j = i;
+			while (j < len && j - i < 8 && cur[j] == prev[j]) j++;
+			if (j == len || j - i >= 8) break;
+			i = j;
+		}
+		size_t diff = i - start;
+
+		PutStateDeltaCount(out, same);
+		PutStateDeltaCount(out, diff);
+
+		for (size_t k = 0; k < diff; k++)
+		{
+			out.push_back( cur[start + k] ^ prev[start + k] );
+		}
+	}
+}
+
+//XOR is its own inverse, so this steps an image either way along the chain.
+static bool ApplyStateDelta(uint8 *buf, size_t len, const std::vector<uint8> &delta)
+{
+	size_t i = 0, pos = 0;
+
+	while (i < delta.size())
+	{
+		size_t same, diff;
+
+		if ( !GetStateDeltaCount(delta, i, same) || !GetStateDeltaCount(delta, i, diff) )
+		{
+			return false;
+		}
+		pos += same;
+
+		if (pos + diff > len || i + diff > delta.size())
+		{
+			return false;
+		}
+		for (size_t k = 0; k < diff; k++)
+		{
+			buf[pos + k] ^= delta[i + k];
+		}
+		i += diff;
+		pos += diff;
+	}
+	return true;
+}
 
 class StateRecorder
 {
@@ -1218,25 +2037,19 @@ class StateRecorder
 		{
 			loadConfig( stateRecorderConfig );
 
-			for (int i=0; i<ringBufSize; i++)
-			{
-				EMUFILE_MEMORY *em = new EMUFILE_MEMORY( 0x1000 );
+			ringBuf.resize(ringBufSize);
 
-				ringBuf.push_back(em);
-			}
 			ringStart = ringHead = ringTail = 0;
 			frameCounter = 0;
 			lastState = ringHead;
 			loadIndexReset = false;
 			lastLoadFrame = 0;
+			snapsSinceKey = 0;
+			memUsage = 0;
 		}
 
 		~StateRecorder(void)
 		{
-			for (size_t i=0; i<ringBuf.size(); i++)
-			{
-				delete ringBuf[i];
-			}
 			ringBuf.clear();
 		}
 
@@ -1246,6 +2059,10 @@ class StateRecorder
 			{
 				config.framesBetweenSnaps = 1;
 			}
+			if (config.keyFrameInterval < 1)
+			{
+				config.keyFrameInterval = 1;
+			}
 			if (config.timeBetweenSnapsMinutes < 0.0)
 			{
 				config.timeBetweenSnapsMinutes = 3.0f / 60.0f;
@@ -1287,6 +2104,7 @@ class StateRecorder
 			printf("ringBufSize:%i  framesPerSnap:%i\n", ringBufSize, framesPerSnap );
 
 			compressionLevel = config.compressionLevel;
+			keyFrameInterval = config.keyFrameInterval;
 			loadPauseTime    = config.loadPauseTimeSeconds;
 			pauseOnLoad      = config.pauseOnLoad;
 		}
@@ -1297,12 +2115,24 @@ class StateRecorder
 
 			unsigned int curFrame = static_cast<unsigned int>(currFrameCounter);
 
+			collectCompressed();
+
 			if (!isPaused && loadIndexReset)
 			{
 				ringHead = (lastState + 1) % ringBufSize;
 
 				frameCounter = curFrame;
 
+				// The next snapshot is a delta against the state that was loaded
+				headRaw.swap(loadRaw);
+
+				snapsSinceKey = 0;
+
+				for (int i = lastState; !ringBuf[i].keyFrame; i = (i + ringBufSize - 1) % ringBufSize)
+				{
+					snapsSinceKey++;
+				}
+
 				loadIndexReset = false;
 			}
 
@@ -1312,13 +2142,9 @@ class StateRecorder
 
 				if ( (frameCounter % framesPerSnap) == 0 )
 				{
-					EMUFILE_MEMORY *em = ringBuf[ ringHead ];
-
-					em->set_len(0);
+					doSnap();
 
-					FCEUSS_SaveMS( em, compressionLevel );
-
-					//printf("Frame:%u  Save:%i  Size:%zu  Total:%zukB \n", frameCounter, ringHead, em->size(), dataSize() / 1024 );
+					//printf("Frame:%u  Save:%i  Size:%zu  Total:%zukB \n", frameCounter, ringHead, ringBuf[ringHead].data.size(), dataSize() / 1024 );
 
 					lastState = ringHead;
 
@@ -1327,6 +2153,8 @@ class StateRecorder
 					if (ringStart == ringHead)
 					{
 						ringStart = (ringHead + 1) % ringBufSize;
+
+						promoteStart();
 					}
 				}
 			}
@@ -1355,11 +2183,14 @@ class StateRecorder
 			}
 			snapIdx = snapIdx % ringBufSize;
 
-			EMUFILE_MEMORY *em = ringBuf[ snapIdx ];
+			if ( !rebuildState( snapIdx, loadRaw ) )
+			{
+				return -1;
+			}
 
-			em->fseek(SEEK_SET, 0);
+			EMUFILE_MEMORY em( &loadRaw );
 
-			FCEUSS_LoadFP( em, SSLOADPARAM_NOBACKUP );
+			FCEUSS_LoadFP( &em, SSLOADPARAM_NOBACKUP );
 
 			frameCounter = lastLoadFrame = static_cast<unsigned int>(currFrameCounter);
 
@@ -1438,28 +2269,233 @@ class StateRecorder
 
 		size_t  dataSize(void)
 		{
-			return ringBuf.size() * ringBuf[0]->size();
+			return memUsage;
+		}
+
+		double  minutesSaved(void)
+		{
+			int32_t fps = FCEUI_GetDesiredFPS(); // Do >> 24 to get in Hz
+			double hz = ( ((double)fps) / 16777216.0 );
+
+			return static_cast<double>(numSnapsSaved()) * framesPerSnap / (hz * 60.0);
 		}
 
 		size_t  ringBufferSize(void)
 		{
 			return ringBuf.size();
 		}
-		static bool enabled;
-		static int  lastState;
+		static FCEU_THREAD_LOCAL bool enabled;
+		static FCEU_THREAD_LOCAL int  lastState;
 	private:
 
+		struct Snap
+		{
+			std::vector<uint8> data; // full savestate image, or delta from the previous slot
+			bool keyFrame = false;
+			std::future< std::vector<uint8> > compressed; // full image still being compressed
+		};
+
+		void storeSnap( Snap &snap, std::vector<uint8> &data, bool keyFrame )
+		{
+			memUsage -= snap.data.capacity();
+
+			snap.data.swap(data);
+			snap.keyFrame = keyFrame;
+			snap.compressed = std::future< std::vector<uint8> >();
+
+			memUsage += snap.data.capacity();
+		}
+
+		// A full snapshot is kept uncompressed until the worker pool has compressed
+		// it, so it can be loaded at any time.
+		void storeKeyFrame( Snap &snap, const uint8 *raw, size_t len )
+		{
+			std::vector<uint8> data(raw, raw + len);
+
+			storeSnap( snap, data, true );
+
+			if (compressionLevel != Z_NO_COMPRESSION)
+			{
+				snap.compressed = FCEUSS_CompressMSAsync( raw, len, compressionLevel );
+
+				pendingSnaps.push_back( static_cast<int>(&snap - &ringBuf[0]) );
+			}
+		}
+
+		void collectCompressed(void)
+		{
+			size_t i = 0;
+
+			while (i < pendingSnaps.size())
+			{
+				Snap &snap = ringBuf[ pendingSnaps[i] ];
+
+				if (snap.compressed.valid())
+				{
+					if (snap.compressed.wait_for( std::chrono::seconds(0) ) != std::future_status::ready)
+					{
+						i++;
+						continue;
+					}
+					std::vector<uint8> data = snap.compressed.get();
+
+					if (!data.empty())
+					{
+						storeSnap( snap, data, true );
+					}
+				}
+				pendingSnaps[i] = pendingSnaps.back();
+				pendingSnaps.pop_back();
+			}
+		}
+
+		static bool readKeyFrame( Snap &snap, std::vector<uint8> &raw )
+		{
+			std::vector<uint8> &data = snap.data;
+
+			if (data.size() < 16)
+			{
+				return false;
+			}
+			uint32 totalsize = FCEU_de32lsb(&data[4]);
+			uint32 comprlen  = FCEU_de32lsb(&data[12]);
+
+			if (comprlen == ~0u)
+			{
+				raw = data;
+				return true;
+			}
+			uLongf uncomprlen = totalsize;
+
+			raw.resize(16 + totalsize);
+			memcpy(&raw[0], &data[0], 12);
+			FCEU_en32lsb(&raw[12], ~0u);
+
+			return uncompress(&raw[16], &uncomprlen, &data[16], comprlen) == Z_OK && uncomprlen == totalsize;
+		}
+
 		void doSnap(void)
 		{
+			// Snapshots are taken uncompressed; only full ones go through zlib
+			scratch.set_len(0);
 
+			SaveMS( &scratch, Z_NO_COMPRESSION, true );
+
+			const uint8 *raw = scratch.buf();
+			size_t len = scratch.size();
+
+			Snap &snap = ringBuf[ ringHead ];
+
+			if ( (ringStart == ringHead) || (headRaw.size() != len) || (snapsSinceKey + 1 >= keyFrameInterval) )
+			{
+				storeKeyFrame( snap, raw, len );
+				snapsSinceKey = 0;
+			}
+			else
+			{
+				EncodeStateDelta( raw, &headRaw[0], len, deltaBuf );
+
+				std::vector<uint8> data( deltaBuf );
+
+				storeSnap( snap, data, false );
+				snapsSinceKey++;
+			}
+			headRaw.assign(raw, raw + len);
+		}
+
+		// The oldest snapshot is always a full one: when the ring drops a full
+		// snapshot, the delta after it becomes the new oldest and is expanded.
+		void promoteStart(void)
+		{
+			Snap &start = ringBuf[ ringStart ];
+
+			if (start.keyFrame)
+			{
+				return;
+			}
+			int dropped = (ringStart + ringBufSize - 1) % ringBufSize;
+
+			std::vector<uint8> raw;
+
+			if ( readKeyFrame( ringBuf[dropped], raw ) && ApplyStateDelta( &raw[0], raw.size(), start.data ) )
+			{
+				storeSnap( start, raw, true );
+			}
+			else
+			{	// Should not happen; drop the rest of the chain rather than keep states that cannot be rebuilt
+				while (ringStart != ringHead && !ringBuf[ ringStart ].keyFrame)
+				{
+					ringStart = (ringStart + 1) % ringBufSize;
+				}
+			}
+		}
+
+		// Rebuilds the full image of a slot from the nearest full snapshot before it,
+		// or from the newest state when that is closer and no full snapshot lies between.
+		bool rebuildState( int snapIdx, std::vector<uint8> &raw )
+		{
+			int newest = (ringHead + ringBufSize - 1) % ringBufSize;
+			int key = snapIdx, fwdSteps = 0, backSteps = 0;
+
+			while (!ringBuf[key].keyFrame && key != ringStart)
+			{
+				key = (key + ringBufSize - 1) % ringBufSize;
+				fwdSteps++;
+			}
+
+			bool backOk = !headRaw.empty();
+
+			for (int i = snapIdx; backOk && i != newest; )
+			{
+				i = (i + 1) % ringBufSize;
+				backOk = !ringBuf[i].keyFrame;
+				backSteps++;
+			}
+
+			if (backOk && (backSteps < fwdSteps || !ringBuf[key].keyFrame))
+			{
+				raw = headRaw;
+
+				for (int i = newest; i != snapIdx; i = (i + ringBufSize - 1) % ringBufSize)
+				{
+					if ( !ApplyStateDelta( &raw[0], raw.size(), ringBuf[i].data ) )
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+
+			if ( !readKeyFrame( ringBuf[key], raw ) )
+			{
+				return false;
+			}
+			for (int i = key; i != snapIdx; )
+			{
+				i = (i + 1) % ringBufSize;
+
+				if ( !ApplyStateDelta( &raw[0], raw.size(), ringBuf[i].data ) )
+				{
+					return false;
+				}
+			}
+			return true;
 		}
 
-		std::vector <EMUFILE_MEMORY*> ringBuf;
+		std::vector <Snap> ringBuf;
+		std::vector <uint8> headRaw;	// image of the newest snapshot
+		std::vector <uint8> loadRaw;	// image of the last snapshot loaded
+		std::vector <uint8> deltaBuf;
+		std::vector <int> pendingSnaps;
+		EMUFILE_MEMORY scratch;
+		size_t memUsage;
 		int  ringHead;
 		int  ringTail;
 		int  ringStart;
 		int  ringBufSize;
 		int  compressionLevel;
+		int  keyFrameInterval;
+		int  snapsSinceKey;
 		int  loadPauseTime;
 		StateRecorderConfigData::PauseType pauseOnLoad;
 		unsigned int frameCounter;
@@ -1469,9 +2505,9 @@ class StateRecorder
 
 };
 
-static StateRecorder *stateRecorder = nullptr;
-bool StateRecorder::enabled = false;
-int StateRecorder::lastState = 0;
+static FCEU_THREAD_LOCAL StateRecorder *stateRecorder = nullptr;
+FCEU_THREAD_LOCAL bool StateRecorder::enabled = false;
+FCEU_THREAD_LOCAL int StateRecorder::lastState = 0;
 
 int FCEU_StateRecorderStart(void)
 {
@@ -1537,6 +2573,17 @@ int FCEU_StateRecorderGetNumSnapsSaved(void)
 	return n;
 }
 
+size_t FCEU_StateRecorderGetDataSize(void)
+{
+	size_t n = 0;
+
+	if (stateRecorder != nullptr)
+	{
+		n = stateRecorder->dataSize();
+	}
+	return n;
+}
+
 int FCEU_StateRecorderLoadState(int snapIndex)
 {
 	int ret = -1;
@@ -19,6 +19,8 @@
  */
 #pragma once
 #include <string>
+#include <vector>
+#include <future>
 
 enum ENUM_SSLOADPARAMS
 {
@@ -33,9 +35,26 @@ void FCEUSS_SetLoadCallback( void (*cb)(bool) );
  //zlib values: 0 (none) through 9 (max) or -1 (default)
 bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel);
 
+//Compresses a savestate made with Z_NO_COMPRESSION on a worker thread. The state is copied
+//before this returns. The future yields the compressed savestate, or nothing if it could not
+//be compressed, in which case the uncompressed one is still good to keep and load.
+std::future< std::vector<uint8> > FCEUSS_CompressMSAsync(const uint8 *state, size_t len, int compressionLevel);
+
 bool FCEUSS_LoadFP(EMUFILE* is, ENUM_SSLOADPARAMS params);
 
-extern int CurrentState;
+//Incremental savestates hold only the 256 byte pages that changed since their parent: the
+//state of the last incremental save or load, or the last state loaded with FCEUSS_LoadFP.
+//The first one made, or one made after the state layout changed, holds everything.
+bool FCEUSS_SaveMSIncremental(EMUFILE* outstream);
+//Fails without touching the emulator if the current parent is not the one the state was made from.
+bool FCEUSS_LoadMSIncremental(EMUFILE* is);
+
+//PPU write paths report nametable and CHR RAM writes here for incremental savestates
+void FCEUSS_MarkDirty(const uint8 *p);
+//After memory was changed wholesale (power, reset)
+void FCEUSS_MarkAllDirty(void);
+
+extern FCEU_THREAD_LOCAL int CurrentState;
 void FCEUSS_CheckStates(void);
 
 struct SFORMAT
@@ -70,16 +89,16 @@ void LoadBackup();					 //Loads the backupsavestate
 void RedoLoadState();				 //reloads a loadstate if backupsavestate was run
 void SwapSaveState();				 //Swaps a savestate with its backup state
 
-extern std::string lastSavestateMade; //Filename of last savestate used
-extern bool undoSS;					 //undo savestate flag
-extern bool redoSS;					 //redo savestate flag
-extern std::string lastLoadstateMade; //Filename of last state loaded
-extern bool undoLS;					 //undo loadstate flag
-extern bool redoLS;					 //redo savestate flag
-extern bool backupSavestates;		 //Whether or not to make backups, true by default
+extern FCEU_THREAD_LOCAL_OBJECT std::string lastSavestateMade; //Filename of last savestate used
+extern FCEU_THREAD_LOCAL bool undoSS;					 //undo savestate flag
+extern FCEU_THREAD_LOCAL bool redoSS;					 //redo savestate flag
+extern FCEU_THREAD_LOCAL_OBJECT std::string lastLoadstateMade; //Filename of last state loaded
+extern FCEU_THREAD_LOCAL bool undoLS;					 //undo loadstate flag
+extern FCEU_THREAD_LOCAL bool redoLS;					 //redo savestate flag
+extern FCEU_THREAD_LOCAL bool backupSavestates;		 //Whether or not to make backups, true by default
 bool CheckBackupSaveStateExist();	 //Checks if backupsavestate exists
 
-extern bool compressSavestates;		//Whether or not to compress non-movie savestates (by default, yes)
+extern FCEU_THREAD_LOCAL bool compressSavestates;		//Whether or not to compress non-movie savestates (by default, yes)
 
 struct StateRecorderConfigData
 {
@@ -87,6 +106,7 @@ struct StateRecorderConfigData
 	float timeBetweenSnapsMinutes;
 	int   framesBetweenSnaps;
 	int   compressionLevel;
+	int   keyFrameInterval;
 	int   loadPauseTimeSeconds;
 
 	enum TimingType
@@ -108,6 +128,7 @@ struct StateRecorderConfigData
 		historyDurationMinutes = 15.0f;
 		timeBetweenSnapsMinutes = 3.0f / 60.0f;
 		compressionLevel = 0;
+		keyFrameInterval = 20;
 		loadPauseTimeSeconds = 3;
 		pauseOnLoad = TEMPORARY_PAUSE;
 		timingMode = FRAMES;
@@ -127,6 +148,7 @@ bool FCEU_StateRecorderIsEnabled(void);
 void FCEU_StateRecorderSetEnabled(bool enabled);
 int FCEU_StateRecorderGetMaxSnaps(void);
 int FCEU_StateRecorderGetNumSnapsSaved(void);
+size_t FCEU_StateRecorderGetDataSize(void);
 int FCEU_StateRecorderGetStateIndex(void);
 int FCEU_StateRecorderLoadState(int snapIndex);
 int FCEU_StateRecorderLoadPrevState(void);
@@ -176,6 +176,25 @@ typedef uint8 (*readfunc)(uint32 A);
 #define  FCEU_MAYBE_UNUSED
 #endif
 
+// Emulator state is declared FCEU_THREAD_LOCAL. Builds that define __FCEU_MULTI_INSTANCE__
+// (the headless core) get one independent emulator instance per thread. The GUI drivers
+// touch emulator state from several threads, so there it stays an ordinary global.
+// Plain data uses __thread where available, which GCC and Clang access without the
+// lazy-initialization check that C++ thread_local adds to every extern access.
+// State with a constructor or address-dependent initializer (SFORMAT tables, strings,
+// containers) is declared FCEU_THREAD_LOCAL_OBJECT instead.
+#if defined(__FCEU_MULTI_INSTANCE__)
+	#if defined(__GNUC__)
+	#define  FCEU_THREAD_LOCAL  __thread
+	#else
+	#define  FCEU_THREAD_LOCAL  thread_local
+	#endif
+	#define  FCEU_THREAD_LOCAL_OBJECT  thread_local
+#else
+	#define  FCEU_THREAD_LOCAL
+	#define  FCEU_THREAD_LOCAL_OBJECT
+#endif
+
 #if defined(_MSC_VER)
 	// Microsoft compiler won't catch format issues, but VS IDE can catch on analysis mode
 	#define  __FCEU_PRINTF_FORMAT  _In_z_ _Printf_format_string_
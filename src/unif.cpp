@@ -55,22 +55,22 @@ typedef struct {
 	int (*init)(FCEUFILE *fp);
 } BFMAPPING;
 
-static CartInfo UNIFCart;
+static FCEU_THREAD_LOCAL_OBJECT CartInfo UNIFCart;
 
-static int vramo;
-static int mirrortodo;
-static uint8 *boardname;
-static uint8 *sboardname;
+static FCEU_THREAD_LOCAL int vramo;
+static FCEU_THREAD_LOCAL int mirrortodo;
+static FCEU_THREAD_LOCAL uint8 *boardname;
+static FCEU_THREAD_LOCAL uint8 *sboardname;
 
-static uint32 CHRRAMSize;
-uint8 *UNIFchrrama = 0;
+static FCEU_THREAD_LOCAL uint32 CHRRAMSize;
+FCEU_THREAD_LOCAL uint8 *UNIFchrrama = 0;
 
-static UNIF_HEADER unhead;
-static UNIF_HEADER uchead;
+static FCEU_THREAD_LOCAL UNIF_HEADER unhead;
+static FCEU_THREAD_LOCAL UNIF_HEADER uchead;
 
 
-static uint8 *malloced[32];
-static uint32 mallocedsizes[32];
+static FCEU_THREAD_LOCAL uint8 *malloced[32];
+static FCEU_THREAD_LOCAL uint32 mallocedsizes[32];
 
 static int FixRomSize(uint32 size, uint32 minimum) {
 	uint32 x = 1;
@@ -108,7 +108,7 @@ static void ResetUNIF(void) {
 	UNIFchrrama = 0;
 }
 
-static uint8 exntar[2048];
+static FCEU_THREAD_LOCAL uint8 exntar[2048];
 
 static void MooMirroring(void) {
 	if (mirrortodo < 0x4)
@@ -129,7 +129,7 @@ static int DoMirroring(FCEUFILE *fp) {
 			return(0);
 		mirrortodo = t;
 		{
-			static const char *stuffo[6] = { "Horizontal", "Vertical", "$2000", "$2400", "\"Four-screen\"", "Controlled by Mapper Hardware" };
+			static FCEU_THREAD_LOCAL const char *stuffo[6] = { "Horizontal", "Vertical", "$2000", "$2400", "\"Four-screen\"", "Controlled by Mapper Hardware" };
 			if (t < 6)
 				FCEU_printf(" Name/Attribute Table Mirroring: %s\n", stuffo[t]);
 		}
@@ -318,7 +318,7 @@ static int LoadCHR(FCEUFILE *fp) {
 #define BMCFLAG_128KCHRR  0x08
 #define BMCFLAG_256KCHRR  0x10
 
-static BMAPPING bmap[] = {
+static FCEU_THREAD_LOCAL BMAPPING bmap[] = {
 	{ "11160", BMC11160_Init, 0 },
 	{ "12-IN-1", BMC12IN1_Init, 0 },
 	{ "13in1JY110", BMC13in1JY110_Init, 0 },
@@ -481,7 +481,7 @@ static BMAPPING bmap[] = {
 	{ 0, 0, 0 }
 };
 
-static BFMAPPING bfunc[] = {
+static FCEU_THREAD_LOCAL BFMAPPING bfunc[] = {
 	{ "CTRL", CTRL },
 	{ "TVCI", TVCI },
 	{ "BATR", EnableBattery },
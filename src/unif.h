@@ -165,5 +165,5 @@ void BS4040R_Init(CartInfo *info);
 void AA6023_Init(CartInfo *info);
 void COOLGIRL_Init(CartInfo* info);
 
-extern uint8 *UNIFchrrama;	// Meh.  So I can stop CHR RAM
+extern FCEU_THREAD_LOCAL uint8 *UNIFchrrama;	// Meh.  So I can stop CHR RAM
 							// bank switcherooing with certain boards...
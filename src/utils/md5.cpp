@@ -198,7 +198,7 @@ void md5_update( struct md5_context *ctx, uint8 *input, uint32 length )
     }
 }
 
-static uint8 md5_padding[64] =
+static FCEU_THREAD_LOCAL uint8 md5_padding[64] =
 {
  0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -231,8 +231,8 @@ void md5_finish( struct md5_context *ctx, uint8 digest[16] )
 char *md5_asciistr(MD5DATA& md5)
 {
  uint8* digest = md5.data;
- static char str[33];
- static char trans[16]={'0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f'};
+ static FCEU_THREAD_LOCAL char str[33];
+ static FCEU_THREAD_LOCAL char trans[16]={'0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f'};
  int x;
 
  for(x=0;x<16;x++)
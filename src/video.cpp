@@ -62,27 +62,27 @@
 //64-127 is the most-used emphasis setting per frame
 //128-195 is the palette with no emphasis
 //196-255 is the palette with all emphasis bits on
-u8 *XBuf=NULL; //used for current display
-u8 *XBackBuf=NULL; //ppu output is stashed here before drawing happens
-u8 *XDBuf=NULL; //corresponding to XBuf but with deemph bits
-u8 *XDBackBuf=NULL; //corresponding to XBackBuf but with deemph bits
-int ClipSidesOffset=0;	//Used to move displayed messages when Clips left and right sides is checked
-static u8 *xbsave=NULL;
+FCEU_THREAD_LOCAL u8 *XBuf=NULL; //used for current display
+FCEU_THREAD_LOCAL u8 *XBackBuf=NULL; //ppu output is stashed here before drawing happens
+FCEU_THREAD_LOCAL u8 *XDBuf=NULL; //corresponding to XBuf but with deemph bits
+FCEU_THREAD_LOCAL u8 *XDBackBuf=NULL; //corresponding to XBackBuf but with deemph bits
+FCEU_THREAD_LOCAL int ClipSidesOffset=0;	//Used to move displayed messages when Clips left and right sides is checked
+static FCEU_THREAD_LOCAL u8 *xbsave=NULL;
 
-GUIMESSAGE guiMessage;
-GUIMESSAGE subtitleMessage;
+FCEU_THREAD_LOCAL_OBJECT GUIMESSAGE guiMessage;
+FCEU_THREAD_LOCAL_OBJECT GUIMESSAGE subtitleMessage;
 
-bool vidGuiMsgEna = true;
+FCEU_THREAD_LOCAL bool vidGuiMsgEna = true;
 
 //for input display
-extern int input_display;
-extern uint32 cur_input_display;
+extern FCEU_THREAD_LOCAL int input_display;
+extern FCEU_THREAD_LOCAL uint32 cur_input_display;
 
-bool oldInputDisplay = false;
+FCEU_THREAD_LOCAL bool oldInputDisplay = false;
 
-unsigned int lastu = 0;
+FCEU_THREAD_LOCAL unsigned int lastu = 0;
 
-std::string AsSnapshotName ="";			//adelikat:this will set the snapshot name when for s savesnapshot as function
+FCEU_THREAD_LOCAL_OBJECT std::string AsSnapshotName ="";			//adelikat:this will set the snapshot name when for s savesnapshot as function
 
 void FCEUI_SetSnapshotAsName(std::string name) { AsSnapshotName = name; }
 std::string FCEUI_GetSnapshotAsName() { return AsSnapshotName; }
@@ -152,7 +152,7 @@ void FCEU_PutImageDummy(void)
 }
 #endif
 
-static int dosnapsave=0;
+static FCEU_THREAD_LOCAL int dosnapsave=0;
 void FCEUI_SaveSnapshot(void)
 {
 	dosnapsave=1;
@@ -636,7 +636,7 @@ int SaveSnapshot(char fileName[512])
 	}
 
 	{
-		static uint8 header[8]={137,80,78,71,13,10,26,10};
+		static FCEU_THREAD_LOCAL uint8 header[8]={137,80,78,71,13,10,26,10};
 		if(fwrite(header,8,1,pp)!=1)
 			goto PNGerr;
 	}
@@ -717,7 +717,7 @@ void ResetScreenshotsCounter()
 
 uint64 FCEUD_GetTime(void);
 uint64 FCEUD_GetTimeFreq(void);
-bool Show_FPS = false;
+FCEU_THREAD_LOCAL bool Show_FPS = false;
 // Control whether the frames per second of the emulation is rendered.
 bool FCEUI_ShowFPS()
 {
@@ -738,8 +738,8 @@ void FCEUI_ToggleShowFPS()
 	ResetFPS();
 }
 
-static uint64 boop_ts = 0;
-static unsigned int boopcount = 0;
+static FCEU_THREAD_LOCAL uint64 boop_ts = 0;
+static FCEU_THREAD_LOCAL unsigned int boopcount = 0;
 
 void ResetFPS(void)
 {
@@ -753,7 +753,7 @@ void ShowFPS(void)
 	{
 		return;
 	}
-	static char fpsmsg[16] = { 0 };
+	static FCEU_THREAD_LOCAL char fpsmsg[16] = { 0 };
 	uint64 ts = FCEUD_GetTime();
 	uint64 da;
 
@@ -775,7 +775,7 @@ void ShowFPS(void)
 	DrawTextTrans(XBuf + ((256 - ClipSidesOffset) - 40) + (FSettings.FirstSLine + 4) * 256, 256, (uint8*)fpsmsg, 0xA0);
 }
 
-bool showPauseCountDown = true;
+FCEU_THREAD_LOCAL bool showPauseCountDown = true;
 
 static void FCEU_DrawPauseCountDown(uint8 *XBuf)
 {
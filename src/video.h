@@ -15,13 +15,13 @@ int GetScreenPixelPalette(int x, int y, bool usebackup);
 //bit7 : emph blue
 typedef uint8 xfbuf_t;
 
-extern uint8 *XBuf;
-extern uint8 *XBackBuf;
-extern uint8 *XDBuf;
-extern uint8 *XDBackBuf;
+extern FCEU_THREAD_LOCAL uint8 *XBuf;
+extern FCEU_THREAD_LOCAL uint8 *XBackBuf;
+extern FCEU_THREAD_LOCAL uint8 *XDBuf;
+extern FCEU_THREAD_LOCAL uint8 *XDBackBuf;
 extern xfbuf_t *XFBuf;
 
-extern int ClipSidesOffset;
+extern FCEU_THREAD_LOCAL int ClipSidesOffset;
 
 struct GUIMESSAGE
 {
@@ -47,10 +47,10 @@ struct GUIMESSAGE
 	}
 };
 
-extern GUIMESSAGE guiMessage;
-extern GUIMESSAGE subtitleMessage;
+extern FCEU_THREAD_LOCAL_OBJECT GUIMESSAGE guiMessage;
+extern FCEU_THREAD_LOCAL_OBJECT GUIMESSAGE subtitleMessage;
 
-extern bool vidGuiMsgEna;
+extern FCEU_THREAD_LOCAL bool vidGuiMsgEna;
 
 void FCEU_DrawNumberRow(uint8 *XBuf, int *nstatus, int cur);
 
@@ -32,8 +32,8 @@
 #include <cstring>
 #include <cstdio>
 
-static int DIPS_howlong = 0;
-uint8 vsdip = 0;
+static FCEU_THREAD_LOCAL int DIPS_howlong = 0;
+FCEU_THREAD_LOCAL uint8 vsdip = 0;
 
 void FCEU_VSUniToggleDIP(int w) {
 	if (GameInfo->type != GIT_VSUNI) {
@@ -54,14 +54,14 @@ uint8 FCEUI_VSUniGetDIPs(void) {
 	return(vsdip);
 }
 
-static uint8 secdata_tko[32] =
+static FCEU_THREAD_LOCAL uint8 secdata_tko[32] =
 {
 	0xff, 0xbf, 0xb7, 0x97, 0x97, 0x17, 0x57, 0x4f,
 	0x6f, 0x6b, 0xeb, 0xa9, 0xb1, 0x90, 0x94, 0x14,
 	0x56, 0x4e, 0x6f, 0x6b, 0xeb, 0xa9, 0xb1, 0x90,
 	0xd4, 0x5c, 0x3e, 0x26, 0x87, 0x83, 0x13, 0x00
 };
-static uint8 secdata_rbi[32] =
+static FCEU_THREAD_LOCAL uint8 secdata_rbi[32] =
 {
 	0x00, 0x00, 0x00, 0x00, 0xb4, 0x00, 0x00, 0x00,
 	0x00, 0x6F, 0x00, 0x00, 0x00, 0x00, 0x94, 0x00,
@@ -69,9 +69,9 @@ static uint8 secdata_rbi[32] =
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
 };
 
-static uint8 *secptr;
+static FCEU_THREAD_LOCAL uint8 *secptr;
 
-static uint8 VSindex;
+static FCEU_THREAD_LOCAL uint8 VSindex;
 
 static DECLFR(VSSecRead) {
 	switch (A) {
@@ -81,9 +81,9 @@ static DECLFR(VSSecRead) {
 	return(0x00);
 }
 
-uint8 coinon = 0;
-uint8 coinon2 = 0;
-uint8 service = 0;
+FCEU_THREAD_LOCAL uint8 coinon = 0;
+FCEU_THREAD_LOCAL uint8 coinon2 = 0;
+FCEU_THREAD_LOCAL uint8 service = 0;
 
 void FCEU_VSUniCoin(uint8 slot) {
 	if (GameInfo->type != GIT_VSUNI) 
@@ -105,8 +105,8 @@ void FCEU_VSUniService() {
 		service = 6;
 }
 
-static readfunc OldReadPPU;
-static writefunc OldWritePPU[2];
+static FCEU_THREAD_LOCAL readfunc OldReadPPU;
+static FCEU_THREAD_LOCAL writefunc OldWritePPU[2];
 
 static DECLFR(A2002_Gumshoe) {
 	return((OldReadPPU(A) & ~0x3F) | 0x1C);
@@ -123,7 +123,7 @@ static DECLFW(B2000_2001_2C05) {
 	OldWritePPU[(A & 1) ^ 1](A ^ 1, V);
 }
 
-static uint8 xevselect = 0;
+static FCEU_THREAD_LOCAL uint8 xevselect = 0;
 static DECLFR(XevRead) {
 	if (A == 0x54FF) {
 		return(0x5);
@@ -254,7 +254,7 @@ RC2C05-04:
 - Top Gun
 */
 
-VSUNIENTRY VSUniGames[] =
+FCEU_THREAD_LOCAL VSUNIENTRY VSUniGames[] =
 {
 	{ "Baseball", 0x691d4200ea42be45ULL, 99, 2, GIPPU_RP2C04_0001, 0, 0, EGIVS_NORMAL },
 	{ "Battle City", 0x8540949d74c4d0ebULL, 99, 2, GIPPU_RP2C04_0001, 0, 0, EGIVS_NORMAL },
@@ -437,7 +437,7 @@ void FCEU_VSUniDraw(uint8 *XBuf) {
 }
 
 
-SFORMAT FCEUVSUNI_STATEINFO[] = {
+FCEU_THREAD_LOCAL_OBJECT SFORMAT FCEUVSUNI_STATEINFO[] = {
 	{ &vsdip, 1, "vsdp" },
 	{ &coinon, 1, "vscn" },
 	{ &coinon2, 1, "vsc2" },
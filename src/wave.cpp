@@ -8,8 +8,8 @@
 #include <cstdio>
 #include <cstdlib>
 
-static FILE *soundlog=0;
-static long wsize;
+static FCEU_THREAD_LOCAL FILE *soundlog=0;
+static FCEU_THREAD_LOCAL long wsize;
 
 /* Checking whether the file exists before wiping it out is left up to the
    reader..err...I mean, the driver code, if it feels so inclined(I don't feel
@@ -23,17 +23,21 @@
 #include "fceu.h"
 #include "debug.h"
 #include "sound.h"
+#include "ppu.h"
 #ifdef _S9XLUA_H
 #include "fceulua.h"
 #endif
 
 #include "x6502abbrev.h"
 
+#include <algorithm>
+#include <csetjmp>
 #include <cstring>
-X6502 X;
-uint32 timestamp;
-uint32 soundtimestamp;
-void (*MapIRQHook)(int a);
+FCEU_THREAD_LOCAL X6502 X;
+FCEU_THREAD_LOCAL uint32 timestamp;
+FCEU_THREAD_LOCAL uint32 soundtimestamp;
+FCEU_THREAD_LOCAL void (*MapIRQHook)(int a);
+FCEU_THREAD_LOCAL int32 (*MapIRQHookNext)(void);
 
 #define ADDCYC(x) \
 {                 \
@@ -44,9 +48,76 @@ void (*MapIRQHook)(int a);
  if(!overclocking) soundtimestamp+=__x; \
 }
 
-static X6502_MemHook* readMemHook = nullptr;
-static X6502_MemHook* writeMemHook = nullptr;
-static X6502_MemHook* execMemHook = nullptr;
+static FCEU_THREAD_LOCAL X6502_MemHook* readMemHook = nullptr;
+static FCEU_THREAD_LOCAL X6502_MemHook* writeMemHook = nullptr;
+static FCEU_THREAD_LOCAL X6502_MemHook* execMemHook = nullptr;
+
+//One bit per address for each hook type, set where any hook of that type
+//wants to be called; hookWatching says whether a type has any bit set at all.
+//Both are rebuilt by X6502_MemHook::UpdateMask whenever the hooks change.
+static FCEU_THREAD_LOCAL uint32 hookMask[3][0x10000 >> 5];
+static FCEU_THREAD_LOCAL bool hookWatching[3] = { false, false, false };
+
+static INLINE bool X6502_HookWatches(enum X6502_MemHook::Type type, unsigned int A)
+{
+	return (hookMask[type][(A >> 5) & 0x7FF] >> (A & 31)) & 1;
+}
+
+static INLINE bool X6502_MemHooksActive(void)
+{
+	return hookWatching[X6502_MemHook::Read] || hookWatching[X6502_MemHook::Write] || hookWatching[X6502_MemHook::Exec];
+}
+
+//MapIRQHook and FCEU_SoundCPUHook are not called every instruction.  The
+//cycles each instruction would have handed them pile up in eventCycles until
+//eventBudget, the earliest point either hook has anything to do, is reached;
+//the hooks then get the whole amount in one call.  Any access that goes
+//through a read or write handler settles them first, so registers always
+//see the same state as with per instruction calls.
+static FCEU_THREAD_LOCAL int32 eventCycles = 0;
+static FCEU_THREAD_LOCAL int32 eventBudget = 0;
+
+//idleLoopSkip is the X6502_SetIdleLoopSkip setting; X6502_Run turns
+//idleLoops on from it for runs without the debugger or Lua memory hooks.
+static FCEU_THREAD_LOCAL bool idleLoopSkip = false;
+static FCEU_THREAD_LOCAL bool idleLoops = false;
+static void X6502_SkipIdleLoop(uint32 start, uint32 end);
+
+static int32 X6502_EventBudget(void)
+{
+	int32 budget = X6502_MAX_EVENT_CYCLES;
+
+	if (!overclocking)
+		budget = std::min(budget, FCEU_SoundCPUHookNext());
+	if (MapIRQHook)
+		budget = std::min(budget, MapIRQHookNext ? MapIRQHookNext() : 0);
+	return budget;
+}
+
+static void X6502_RunEvents(void)
+{
+	int32 cycles = eventCycles;
+
+	eventCycles = 0;
+	if (MapIRQHook) MapIRQHook(cycles);
+	if (!overclocking)
+		FCEU_SoundCPUHook(cycles);
+	eventBudget = X6502_EventBudget();
+}
+
+//X6502_RunAhead lets the CPU get ahead of the new PPU for as long as the two
+//cannot see each other: instructions that only touch memory behind the page
+//tables.  The state at the start of each such instruction is kept in the
+//ahead* copies below.  An instruction that reaches a read or write handler,
+//that would have to run the APU and mapper hooks or that an interrupt would
+//have to precede is undone by jumping back to X6502_RunAhead and is left for
+//a later call, once the PPU has caught up with it.
+static FCEU_THREAD_LOCAL bool aheadActive = false;
+static FCEU_THREAD_LOCAL jmp_buf aheadAbort;
+static FCEU_THREAD_LOCAL X6502 aheadX;
+static FCEU_THREAD_LOCAL uint32 aheadTimestamp;
+static FCEU_THREAD_LOCAL uint32 aheadSoundTimestamp;
+static FCEU_THREAD_LOCAL int32 aheadEventCycles;
 
 void X6502_MemHook::Add(enum X6502_MemHook::Type type, void (*func)(unsigned int address, unsigned int value, void *userData), void *userData )
 {
@@ -100,6 +171,7 @@ void X6502_MemHook::Add(enum X6502_MemHook::Type type, void (*func)(unsigned int
 		newHook->refCount = 1;
 		*hookStart = newHook;
 	}
+	UpdateMask(type);
 	//printf("LUA MemHook Added: %p\n", func);
 }
 
@@ -145,7 +217,9 @@ void X6502_MemHook::Remove(enum X6502_MemHook::Type type, void (*func)(unsigned
 					{
 						*hookStart = hook->next;
 					}
+					delete [] hook->watchMask;
 					delete hook;
+					UpdateMask(type);
 					//printf("LUA MemHook Removed: %p\n", func);
 				}
 				return;
@@ -156,11 +230,112 @@ void X6502_MemHook::Remove(enum X6502_MemHook::Type type, void (*func)(unsigned
 	}
 }
 
+void X6502_MemHook::Watch(enum X6502_MemHook::Type type, void (*func)(unsigned int address, unsigned int value, void *userData), void *userData, unsigned int address, unsigned int size, bool watch )
+{
+	X6502_MemHook* hook = nullptr;
+
+	switch (type)
+	{
+		case Read:
+			hook = readMemHook;
+		break;
+		case Write:
+			hook = writeMemHook;
+		break;
+		case Exec:
+			hook = execMemHook;
+		break;
+	}
+
+	while ( (hook != nullptr) && ((hook->func != func) || (hook->userData != userData)) )
+	{
+		hook = hook->next;
+	}
+	if (hook == nullptr)
+	{
+		return;
+	}
+
+	if (hook->watchMask == nullptr)
+	{
+		hook->watchMask = new uint32[0x10000 >> 5];
+		memset(hook->watchMask, 0, (0x10000 >> 5) * sizeof(uint32));
+	}
+
+	for (unsigned int i = 0; (i < size) && (address + i < 0x10000); i++)
+	{
+		unsigned int A = address + i;
+
+		if (watch)
+		{
+			hook->watchMask[A >> 5] |= 1u << (A & 31);
+		}
+		else
+		{
+			hook->watchMask[A >> 5] &= ~(1u << (A & 31));
+		}
+	}
+	UpdateMask(type);
+}
+
+void X6502_MemHook::UpdateMask(enum X6502_MemHook::Type type)
+{
+	X6502_MemHook* hook = nullptr;
+	uint32 *mask = hookMask[type];
+	uint32 any = 0;
+
+	switch (type)
+	{
+		case Read:
+			hook = readMemHook;
+		break;
+		case Write:
+			hook = writeMemHook;
+		break;
+		case Exec:
+			hook = execMemHook;
+		break;
+	}
+
+	memset(mask, 0, sizeof(hookMask[type]));
+
+	for ( ; hook != nullptr; hook = hook->next)
+	{
+		if (hook->watchMask == nullptr)
+		{
+			memset(mask, 0xFF, sizeof(hookMask[type]));
+			any = 1;
+			break;
+		}
+		for (int i = 0; i < (0x10000 >> 5); i++)
+		{
+			mask[i] |= hook->watchMask[i];
+			any |= mask[i];
+		}
+	}
+	hookWatching[type] = (any != 0);
+}
+
+//The memory accessors take memHooks as a template argument so the run loop
+//can be compiled once without any Lua memory hook checks (see X6502_Run).
+
 //normal memory read
-static INLINE uint8 RdMem(unsigned int A)
+//pages backed by plain RAM or PRG are read straight through AReadPage
+template <bool memHooks>
+static INLINE uint8 RdMemT(unsigned int A)
 {
- _DB=ARead[A](A);
- if (readMemHook)
+ uint8 *page = AReadPage[A >> 8];
+ if (page)
+  _DB = page[A];
+ else
+ {
+  if (aheadActive)
+   longjmp(aheadAbort, 1);
+  if (eventCycles)
+   X6502_RunEvents();
+  _DB = ARead[A](A);
+ }
+ if (memHooks && X6502_HookWatches(X6502_MemHook::Read, A))
  {
 	 readMemHook->call(A, _DB);
  }
@@ -168,20 +343,40 @@ static INLINE uint8 RdMem(unsigned int A)
 }
 
 //normal memory write
-static INLINE void WrMem(unsigned int A, uint8 V)
+template <bool memHooks>
+static INLINE void WrMemT(unsigned int A, uint8 V)
 {
-	BWrite[A](A,V);
- 	if (writeMemHook)
+	uint8 *page = BWritePage[A >> 8];
+	if (page)
+	{
+		page[A] = V;
+		//WRAM and other cart pages are compared whole by incremental savestates
+		if (A < 0x2000)
+			RAMDirtyPages[(A >> 8) & 7] = 1;
+	}
+	else
+	{
+		if (aheadActive)
+			longjmp(aheadAbort, 1);
+		if (eventCycles)
+			X6502_RunEvents();
+		BWrite[A](A,V);
+		//the handler may have started or moved a mapper or APU deadline
+		eventBudget = 0;
+	}
+ 	if (memHooks && X6502_HookWatches(X6502_MemHook::Write, A))
  	{
  	        writeMemHook->call(A, V);
  	}
 	_DB = V;
 }
 
-static INLINE uint8 RdRAM(unsigned int A)
+template <bool memHooks>
+static INLINE uint8 RdRAMT(unsigned int A)
 {
-  _DB=ARead[A](A);
-  if (readMemHook)
+  uint8 *page = AReadPage[A >> 8];
+  _DB = page ? page[A] : ARead[A](A);
+  if (memHooks && X6502_HookWatches(X6502_MemHook::Read, A))
   {
           readMemHook->call(A, _DB);
   }
@@ -190,21 +385,29 @@ static INLINE uint8 RdRAM(unsigned int A)
   return(_DB);
 }
 
-static INLINE void WrRAM(unsigned int A, uint8 V)
+template <bool memHooks>
+static INLINE void WrRAMT(unsigned int A, uint8 V)
 {
 	RAM[A]=V;
- 	if (writeMemHook)
+	RAMDirtyPages[A >> 8] = 1;
+ 	if (memHooks && X6502_HookWatches(X6502_MemHook::Write, A))
  	{
  	        writeMemHook->call(A, V);
  	}
 	_DB = V;
 }
 
+static INLINE uint8 RdMem(unsigned int A)
+{
+	return RdMemT<true>(A);
+}
+
 uint8 X6502_DMR(uint32 A)
 {
  ADDCYC(1);
- _DB=ARead[A](A);
-  if (readMemHook)
+ uint8 *page = AReadPage[A >> 8];
+ _DB = page ? page[A] : ARead[A](A);
+  if (X6502_HookWatches(X6502_MemHook::Read, A))
   {
           readMemHook->call(A, _DB);
   }
@@ -214,8 +417,16 @@ uint8 X6502_DMR(uint32 A)
 void X6502_DMW(uint32 A, uint8 V)
 {
  ADDCYC(1);
- BWrite[A](A,V);
- if (writeMemHook)
+ uint8 *page = BWritePage[A >> 8];
+ if (page)
+ {
+	page[A] = V;
+	if (A < 0x2000)
+		RAMDirtyPages[(A >> 8) & 7] = 1;
+ }
+ else
+	BWrite[A](A,V);
+ if (X6502_HookWatches(X6502_MemHook::Write, A))
  {
          writeMemHook->call(A, V);
  }
@@ -231,7 +442,7 @@ void X6502_DMW(uint32 A, uint8 V)
 
 #define POP() RdRAM(0x100+(++_S))
 
-static uint8 ZNTable[256];
+static FCEU_THREAD_LOCAL uint8 ZNTable[256];
 /* Some of these operations will only make sense if you know what the flag
    constants are. */
 
@@ -250,7 +461,11 @@ static uint8 ZNTable[256];
   tmp=_PC;  \
   _PC+=disp;  \
   if((tmp^_PC)&0x100)  \
-  ADDCYC(1);  \
+  {  \
+   ADDCYC(1);  \
+  }  \
+  else if(disp<0 && idleLoops)  \
+   X6502_SkipIdleLoop(_PC,tmp);  \
  }  \
  else _PC++;  \
 }
@@ -468,7 +683,7 @@ static uint8 ZNTable[256];
 #define ST_IX(r)  {unsigned int A; GetIX(A); WrMem(A,r); break; }
 #define ST_IY(r)  {unsigned int A; GetIYWR(A); WrMem(A,r); break; }
 
-static uint8 CycTable[256] =
+static FCEU_THREAD_LOCAL uint8 CycTable[256] =
 {
 /*0x00*/ 7,6,2,8,3,3,5,5,3,2,2,2,4,4,6,6,
 /*0x10*/ 2,5,2,8,4,4,6,6,2,4,2,7,4,4,7,7,
@@ -544,35 +759,150 @@ void X6502_Init(void)
 	}
 }
 
-extern int StackAddrBackup;
+//A loop that does nothing but poll a value that cannot change before the
+//current X6502_Run call ends or the APU and mapper hooks are next due, like
+//	wait: LDA flag / BEQ wait	(a RAM flag set by the NMI handler)
+//	wait: BIT $2002 / BPL wait	(the vblank flag, old PPU)
+//	wait: JMP wait
+//goes the same way every time round.  Called when such a loop has just
+//jumped back to start, this accounts for all the passes that fit before
+//then in one step.  Each pass reloads whatever the one before it left in
+//the registers and flags, so only the time they take shows and the CPU ends
+//up exactly as running them would leave it.
+static void X6502_SkipIdleLoop(uint32 start, uint32 end)
+{
+	uint8 *code = AReadPage[start >> 8];
+	uint8 *data;
+	uint32 pc = start;
+	uint32 addr;
+	int32 cycles, ops, passes;
+	uint8 op, alu = 0, imm = 0, branch, v, p;
+	bool taken;
+
+	if (!code || ((end - 1) >> 8) != (start >> 8))
+		return;
+	//an interrupt would be taken at the next instruction
+	if (_IRQlow && ((_IRQlow & (FCEU_IQRESET | FCEU_IQNMI2 | FCEU_IQNMI)) || !(_P & I_FLAG)))
+		return;
+
+	op = code[pc];
+	if (op == 0x4C)
+	{
+		if (end - start != 3)
+			return;
+		cycles = CycTable[op];
+		ops = 1;
+	}
+	else
+	{
+		switch (op)
+		{
+		case 0xA5: case 0xA6: case 0xA4: case 0x24: //LDA, LDX, LDY, BIT zp
+			addr = code[pc + 1];
+			pc += 2;
+			break;
+		case 0xAD: case 0xAE: case 0xAC: case 0x2C: //LDA, LDX, LDY, BIT abs
+			addr = code[pc + 1] | (code[pc + 2] << 8);
+			pc += 3;
+			break;
+		default:
+			return;
+		}
+		cycles = CycTable[op];
+		ops = 1;
+		//AND #imm or CMP #imm after LDA
+		if ((op == 0xA5 || op == 0xAD) && pc + 2 < end && (code[pc] == 0x29 || code[pc] == 0xC9))
+		{
+			alu = code[pc];
+			imm = code[pc + 1];
+			cycles += CycTable[alu];
+			ops++;
+			pc += 2;
+		}
+		if (pc + 2 != end)
+			return;
+		branch = code[pc];
+		cycles += CycTable[branch] + 1;
+		ops++;
+
+		//The pass just run may have read the value before an interrupt
+		//handler changed it, so check that a pass started now would jump
+		//back too.
+		data = AReadPage[addr >> 8];
+		if (data)
+		{
+			v = data[addr];
+			p = _P & ~(N_FLAG | Z_FLAG);
+			if (op == 0x24 || op == 0x2C)
+				p = (p & ~V_FLAG) | (v & (N_FLAG | V_FLAG)) | ((_A & v) ? 0 : Z_FLAG);
+			else
+			{
+				if (alu == 0x29)
+					v &= imm;
+				else if (alu == 0xC9)
+				{
+					p = (p & ~C_FLAG) | (v >= imm ? C_FLAG : 0);
+					v -= imm;
+				}
+				p |= ZNTable[v];
+			}
+			switch (branch)
+			{
+			case 0x10: taken = !(p & N_FLAG); break;
+			case 0x30: taken = (p & N_FLAG) != 0; break;
+			case 0x50: taken = !(p & V_FLAG); break;
+			case 0x70: taken = (p & V_FLAG) != 0; break;
+			case 0x90: taken = !(p & C_FLAG); break;
+			case 0xB0: taken = (p & C_FLAG) != 0; break;
+			case 0xD0: taken = !(p & Z_FLAG); break;
+			default: taken = (p & Z_FLAG) != 0; break;
+			}
+			if (!taken)
+				return;
+		}
+		//other reads must leave nothing to show for the passes skipped, as
+		//the old PPU's $2002 does while a BPL on it keeps looping
+		else if (alu || branch != 0x10 || !FCEUPPU_StatusPollable(addr))
+			return;
+	}
+
+	//every pass must leave the run loop going and the hooks not yet due
+	passes = (_count - 1) / (cycles * 48);
+	passes = std::min(passes, (eventBudget - eventCycles - _tcount - 1) / cycles);
+	if (passes <= 0)
+		return;
+
+	ADDCYC(passes * cycles);
+	total_instructions += passes * ops;
+	delta_instructions += passes * ops;
+}
+
+extern FCEU_THREAD_LOCAL int StackAddrBackup;
 void X6502_Power(void)
 {
  _count=_tcount=_IRQlow=_PC=_A=_X=_Y=_P=_PI=_DB=_jammed=0;
+ eventCycles=eventBudget=0;
  _S=0xFD;
  timestamp=soundtimestamp=0;
  X6502_Reset();
  StackAddrBackup = -1;
 }
 
-void X6502_Run(int32 cycles)
+//The interpreter loop, specialized at compile time on whether the debugger
+//core (DebugCycle, CD logging) and the Lua memory hooks need servicing.
+#define RdMem(A) RdMemT<memHooks>(A)
+#define WrMem(A,V) WrMemT<memHooks>(A,V)
+#define RdRAM(A) RdRAMT<memHooks>(A)
+#define WrRAM(A,V) WrRAMT<memHooks>(A,V)
+
+//Services a pending reset, NMI or IRQ.  Returns true when the run loop
+//has no cycles left and should return.
+template <bool debugger, bool memHooks>
+static INLINE bool X6502_Interrupt(void)
 {
-  if(PAL)
-   cycles*=15;    // 15*4=60
-  else
-   cycles*=16;    // 16*4=64
-
-  _count+=cycles;
-extern int test; test++;
-  while(_count>0)
-  {
-   int32 temp;
-   uint8 b1;
-
-   if(_IRQlow)
-   {
     if(_IRQlow&FCEU_IQRESET)
     {
-	 DEBUG( if(debug_loggingCD) LogCDVectors(0xFFFC); )
+	 DEBUG( if(debugger && debug_loggingCD) LogCDVectors(0xFFFC); )
      _PC=RdMem(0xFFFC);
      _PC|=RdMem(0xFFFD)<<8;
      _jammed=0;
@@ -593,7 +923,7 @@ extern int test; test++;
       PUSH(_PC);
       PUSH((_P&~B_FLAG)|(U_FLAG));
       _P|=I_FLAG;
-	  DEBUG( if(debug_loggingCD) LogCDVectors(0xFFFA) );
+	  DEBUG( if(debugger && debug_loggingCD) LogCDVectors(0xFFFA); )
       _PC=RdMem(0xFFFA);
       _PC|=RdMem(0xFFFB)<<8;
       _IRQlow&=~FCEU_IQNMI;
@@ -608,7 +938,7 @@ extern int test; test++;
       PUSH(_PC);
       PUSH((_P&~B_FLAG)|(U_FLAG));
       _P|=I_FLAG;
-	  DEBUG( if(debug_loggingCD) LogCDVectors(0xFFFE) );
+	  DEBUG( if(debugger && debug_loggingCD) LogCDVectors(0xFFFE); )
       _PC=RdMem(0xFFFE);
       _PC|=RdMem(0xFFFF)<<8;
      }
@@ -617,13 +947,35 @@ extern int test; test++;
     if(_count<=0)
     {
      _PI=_P;
-     return;
+     return true;
      } //Should increase accuracy without a
               //major speed hit.
+    return false;
+}
+
+template <bool debugger, bool memHooks>
+static void X6502_RunLoop(int32 cycles)
+{
+  if(PAL)
+   cycles*=15;    // 15*4=60
+  else
+   cycles*=16;    // 16*4=64
+
+  _count+=cycles;
+extern FCEU_THREAD_LOCAL int test; test++;
+  while(_count>0)
+  {
+   int32 temp;
+   uint8 b1;
+
+   if(_IRQlow)
+   {
+    if(X6502_Interrupt<debugger, memHooks>())
+     return;
    }
 
 	//will probably cause a major speed decrease on low-end systems
-   DEBUG( DebugCycle() );
+   DEBUG( if(debugger) DebugCycle() );
 
    IncrementInstructionsCounters();
 
@@ -634,11 +986,20 @@ extern int test; test++;
 
    temp=_tcount;
    _tcount=0;
-   if(MapIRQHook) MapIRQHook(temp);
-   
-   if (!overclocking)
-    FCEU_SoundCPUHook(temp);
-   if (execMemHook)
+   if(debugger)
+   {
+    //the debugger may stop anywhere, so it keeps the hooks exact
+    if(MapIRQHook) MapIRQHook(temp);
+    if (!overclocking)
+     FCEU_SoundCPUHook(temp);
+   }
+   else
+   {
+    eventCycles+=temp;
+    if(eventCycles>=eventBudget)
+     X6502_RunEvents();
+   }
+   if (memHooks && X6502_HookWatches(X6502_MemHook::Exec, _PC))
    {
            execMemHook->call(_PC, 0);
    }
@@ -650,6 +1011,133 @@ extern int test; test++;
   }
 }
 
+//X6502_RunLoop for the cycles X6502_RunAhead may take ahead of the PPU.
+//Returns normally when they run out; an instruction that cannot run ahead
+//leaves through longjmp instead.
+template <bool debugger, bool memHooks>
+static void X6502_RunAheadLoop(void)
+{
+  while(_count>0)
+  {
+   int32 temp;
+   uint8 b1;
+
+   aheadX=X;
+   aheadTimestamp=timestamp;
+   aheadSoundTimestamp=soundtimestamp;
+   aheadEventCycles=eventCycles;
+
+   //interrupts are taken by X6502_Run, in step with the PPU.  An IRQ the
+   //I flag masks changes nothing, so the CPU can run on past it.
+   if(_IRQlow)
+   {
+    if((_IRQlow&(FCEU_IQRESET|FCEU_IQNMI2|FCEU_IQNMI)) || (!(_PI&I_FLAG) && !_jammed))
+     longjmp(aheadAbort, 1);
+    _IRQlow&=~FCEU_IQTEMP;
+   }
+
+   _PI=_P;
+   b1=RdMem(_PC);
+
+   ADDCYC(CycTable[b1]);
+
+   temp=_tcount;
+   if(eventCycles+temp>=eventBudget)
+    longjmp(aheadAbort, 1);
+   _tcount=0;
+   eventCycles+=temp;
+   _PC++;
+   switch(b1)
+   {
+    #include "ops.inc"
+   }
+
+   //counted last, so an instruction that is undone is not counted twice
+   IncrementInstructionsCounters();
+  }
+}
+
+#undef RdMem
+#undef WrMem
+#undef RdRAM
+#undef WrRAM
+
+void X6502_SetIdleLoopSkip(bool enable)
+{
+	idleLoopSkip = enable;
+}
+
+bool X6502_GetIdleLoopSkip(void)
+{
+	return idleLoopSkip;
+}
+
+void X6502_Run(int32 cycles)
+{
+	bool memHooks = X6502_MemHooksActive();
+
+	eventBudget = X6502_EventBudget();
+	idleLoops = idleLoopSkip && !memHooks && !DebugCycleActive();
+
+	if (DebugCycleActive())
+	{
+		if (memHooks)
+			X6502_RunLoop<true, true>(cycles);
+		else
+			X6502_RunLoop<true, false>(cycles);
+	}
+	else
+	{
+		if (memHooks)
+			X6502_RunLoop<false, true>(cycles);
+		else
+			X6502_RunLoop<false, false>(cycles);
+	}
+
+	//the PPU, the sound output and the mappers' scanline hooks all run
+	//between calls, so nothing is left owing when control goes back
+	if (eventCycles)
+		X6502_RunEvents();
+}
+
+void X6502_RunAhead(int32 cycles, int32 ahead)
+{
+	int32 scale = PAL ? 15 : 16;
+
+	//most calls from the new PPU add a dot or two to a CPU that is still
+	//busy with its last instruction
+	if (_count + cycles * scale <= 0)
+	{
+		_count += cycles * scale;
+		return;
+	}
+
+	X6502_Run(cycles);
+
+	if (ahead <= 0 || DebugCycleActive() || X6502_MemHooksActive())
+		return;
+
+	eventBudget = X6502_EventBudget();
+	_count += ahead * scale;
+	if (!setjmp(aheadAbort))
+	{
+		aheadActive = true;
+		X6502_RunAheadLoop<false, false>();
+	}
+	else
+	{
+		X = aheadX;
+		timestamp = aheadTimestamp;
+		soundtimestamp = aheadSoundTimestamp;
+		eventCycles = aheadEventCycles;
+	}
+	aheadActive = false;
+	_count -= ahead * scale;
+
+	if (eventCycles)
+		X6502_RunEvents();
+}
+
 //--------------------------
 //---Called from debuggers
 void FCEUI_NMI(void)
@@ -22,7 +22,7 @@
 
 #include "x6502struct.h"
 
-extern X6502 X;
+extern FCEU_THREAD_LOCAL X6502 X;
 
 
 //the opsize table is used to quickly grab the instruction sizes (in bytes)
@@ -47,11 +47,16 @@ void X6502_Debug(void (*CPUHook)(X6502 *),
 //#endif
 void X6502_RunDebug(int32 cycles);
 #define X6502_Run(x) X6502_RunDebug(x)
+
+//X6502_Run for the new PPU's catch-up mode: after running cycles, the CPU may
+//carry on for up to ahead more while it does not touch any read or write
+//handler.  Later calls start by using up what it ran ahead.
+void X6502_RunAhead(int32 cycles, int32 ahead);
 //------------
 
-extern uint32 timestamp;
-extern uint32 soundtimestamp;
-extern int scanline;
+extern FCEU_THREAD_LOCAL uint32 timestamp;
+extern FCEU_THREAD_LOCAL uint32 soundtimestamp;
+extern FCEU_THREAD_LOCAL int scanline;
 
 #define N_FLAG  0x80
 #define V_FLAG  0x40
@@ -62,7 +67,16 @@ extern int scanline;
 #define Z_FLAG  0x02
 #define C_FLAG  0x01
 
-extern void (*MapIRQHook)(int a);
+extern FCEU_THREAD_LOCAL void (*MapIRQHook)(int a);
+
+//Optional companion to MapIRQHook: how many more CPU cycles the hook can go
+//uncalled before it has something to do, such as raising an IRQ.  Boards that
+//leave it null get MapIRQHook called every instruction.  Return
+//X6502_MAX_EVENT_CYCLES when the counter is stopped.
+extern FCEU_THREAD_LOCAL int32 (*MapIRQHookNext)(void);
+
+//The most cycles MapIRQHook and FCEU_SoundCPUHook are ever handed in one call.
+#define X6502_MAX_EVENT_CYCLES 0x1000
 
 #define NTSC_CPU (dendy ? 1773447.467 : 1789772.7272727272727272)
 #define PAL_CPU  1662607.125
@@ -92,6 +106,12 @@ void X6502_IRQEnd(int w);
 
 int X6502_GetOpcodeCycles( int op );
 
+//Lets the interpreter step over the passes of a loop that only polls a value,
+//such as a wait for the NMI handler to set a RAM flag, instead of running
+//each one.  The outcome is exactly the same with it on or off.
+void X6502_SetIdleLoopSkip(bool enable);
+bool X6502_GetIdleLoopSkip(void);
+
 class X6502_MemHook
 {
 	public:
@@ -100,9 +120,17 @@ class X6502_MemHook
 		static void Add(enum Type type, void (*func)(unsigned int address, unsigned int value, void *userData), void *userData = nullptr );
 		static void Remove(enum Type type, void (*func)(unsigned int address, unsigned int value, void *userData), void *userData = nullptr );
 
+		//A hook is called for every address until Watch narrows it down to the
+		//addresses it asks for; memory accesses outside every hook's range then
+		//cost the CPU a single bit test.
+		static void Watch(enum Type type, void (*func)(unsigned int address, unsigned int value, void *userData), void *userData, unsigned int address, unsigned int size, bool watch = true );
+
 		inline void call( unsigned int address, unsigned int value )
 		{
-			func(address, value, userData);
+			if ( (watchMask == nullptr) || ((watchMask[address >> 5] >> (address & 31)) & 1) )
+			{
+				func(address, value, userData);
+			}
 
 			if (next != nullptr)
 			{
@@ -113,7 +141,10 @@ class X6502_MemHook
 		void (*func)(unsigned int address, unsigned int value, void *userData) = nullptr;
 		void  *userData = nullptr;
 		X6502_MemHook* next = nullptr;
+		uint32 *watchMask = nullptr;
 		int refCount = 0;
+
+		static void UpdateMask(enum Type type);
 };
 
 #define _X6502H